@@ -489,6 +489,102 @@ extern DECLSPEC SDL_AudioSpec *SDLCALL SDL_LoadWAV_RW(SDL_RWops * src,
  */
 extern DECLSPEC void SDLCALL SDL_FreeWAV(Uint8 * audio_buf);
 
+/**
+ *  A WAVE file that is decoded a few sample frames at a time.
+ *
+ *  \sa SDL_OpenWAVStream_RW
+ */
+struct SDL_WAVStream;
+typedef struct SDL_WAVStream SDL_WAVStream;
+
+/**
+ *  Open a WAVE file for decoding on demand, instead of all at once like
+ *  SDL_LoadWAV_RW().
+ *
+ *  This reads the headers and leaves the audio data in (src) until it's
+ *  asked for, so the memory needed doesn't grow with the length of the file.
+ *  It supports the same encodings and hints as SDL_LoadWAV_RW(), and the
+ *  decoded audio is the same, in the format it reports in (spec).
+ *
+ *  The stream reads from (src) whenever it decodes, so (src) must stay open
+ *  and must not be used by anything else until the stream is closed.
+ *
+ *  \param src The data source with the WAVE data
+ *  \param freesrc Non-zero to close (src) when the stream is closed, or if this fails
+ *  \param spec Filled in with the audio format of the decoded audio
+ *  \return A new WAVE stream, or NULL on error.
+ *
+ *  \sa SDL_WAVStreamRead
+ *  \sa SDL_WAVStreamSeek
+ *  \sa SDL_AudioStreamPutWAV
+ *  \sa SDL_CloseWAVStream
+ */
+extern DECLSPEC SDL_WAVStream *SDLCALL SDL_OpenWAVStream_RW(SDL_RWops * src,
+                                                           int freesrc,
+                                                           SDL_AudioSpec * spec);
+
+/**
+ *  Opens a WAVE file from a file for decoding on demand.
+ *  Convenience function.
+ */
+#define SDL_OpenWAVStream(file, spec) \
+    SDL_OpenWAVStream_RW(SDL_RWFromFile(file, "rb"), 1, spec)
+
+/**
+ *  Decode sample frames from a WAVE stream.
+ *
+ *  \param wav The stream to decode from
+ *  \param buf Filled in with decoded audio, with room for (frames) sample frames
+ *  \param frames The most sample frames to decode
+ *  \return The number of sample frames decoded, 0 at the end of the stream,
+ *          or -1 on error.
+ *
+ *  \sa SDL_OpenWAVStream_RW
+ *  \sa SDL_AudioStreamPutWAV
+ */
+extern DECLSPEC int SDLCALL SDL_WAVStreamRead(SDL_WAVStream *wav, void *buf, int frames);
+
+/**
+ *  Move a WAVE stream to another sample frame.
+ *
+ *  Compressed WAVE files store audio in blocks that can only be decoded
+ *  from the start. The block holding (frame) gets decoded on the next read,
+ *  so seeking doesn't cost more than reading from the start of a block.
+ *
+ *  \param wav The stream to seek in
+ *  \param frame The sample frame to read next, from 0 to SDL_WAVStreamLength()
+ *  \return 0 on success, or -1 on error.
+ *
+ *  \sa SDL_WAVStreamTell
+ *  \sa SDL_WAVStreamLength
+ */
+extern DECLSPEC int SDLCALL SDL_WAVStreamSeek(SDL_WAVStream *wav, Sint64 frame);
+
+/**
+ *  Get the sample frame a WAVE stream will decode next.
+ *
+ *  \return The sample frame, or -1 on error.
+ *
+ *  \sa SDL_WAVStreamSeek
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_WAVStreamTell(SDL_WAVStream *wav);
+
+/**
+ *  Get the number of sample frames in a WAVE stream.
+ *
+ *  \return The number of sample frames, or -1 on error.
+ *
+ *  \sa SDL_WAVStreamSeek
+ */
+extern DECLSPEC Sint64 SDLCALL SDL_WAVStreamLength(SDL_WAVStream *wav);
+
+/**
+ *  Close a WAVE stream, and its data source if it was opened with freesrc.
+ *
+ *  \sa SDL_OpenWAVStream_RW
+ */
+extern DECLSPEC void SDLCALL SDL_CloseWAVStream(SDL_WAVStream *wav);
+
 /**
  *  This function takes a source format and rate and a destination format
  *  and rate, and initializes the \c cvt structure with information needed
@@ -634,6 +730,57 @@ extern DECLSPEC int SDLCALL SDL_AudioStreamFlush(SDL_AudioStream *stream);
  */
 extern DECLSPEC void SDLCALL SDL_AudioStreamClear(SDL_AudioStream *stream);
 
+/**
+ *  Quality levels for the resampler used by an SDL_AudioStream.
+ *
+ *  Lower levels cost much less CPU, which makes sense for many short sound
+ *  effects; SDL_RESAMPLER_QUALITY_SINC is the default.
+ */
+typedef enum
+{
+    SDL_RESAMPLER_QUALITY_NEAREST,    /**< Repeat or drop samples, no filtering at all */
+    SDL_RESAMPLER_QUALITY_LINEAR,     /**< Linear interpolation between neighbouring samples */
+    SDL_RESAMPLER_QUALITY_CUBIC,      /**< Catmull-Rom interpolation over four samples */
+    SDL_RESAMPLER_QUALITY_SHORT_SINC, /**< Bandlimited interpolation over a short windowed sinc */
+    SDL_RESAMPLER_QUALITY_SINC        /**< SDL's full bandlimited resampler (the default) */
+} SDL_AudioResamplerQuality;
+
+/**
+ *  Choose how an audio stream resamples its data.
+ *
+ *  This can be changed at any time; data already put into the stream has
+ *  already been resampled. If the stream resamples with libsamplerate
+ *  (see SDL_HINT_AUDIO_RESAMPLING_MODE), choosing any quality other than
+ *  SDL_RESAMPLER_QUALITY_SINC switches it to SDL's built-in resampler.
+ *
+ *  \param stream The stream to change
+ *  \param quality The resampler quality to use
+ *  \return 0 on success, or -1 on error.
+ *
+ *  \sa SDL_NewAudioStream
+ *  \sa SDL_AudioResamplerQuality
+ */
+extern DECLSPEC int SDLCALL SDL_AudioStreamSetResamplerQuality(SDL_AudioStream *stream, SDL_AudioResamplerQuality quality);
+
+/**
+ *  Decode sample frames from a WAVE stream straight into an audio stream.
+ *
+ *  The audio stream must have been created with the source format, channels
+ *  and rate that SDL_OpenWAVStream_RW() reported for (wav). Compressed WAVE
+ *  audio is put into the audio stream without an extra copy.
+ *
+ *  \param stream The audio stream to put the decoded audio into
+ *  \param wav The WAVE stream to decode from
+ *  \param frames The most sample frames to decode
+ *  \return The number of sample frames put into (stream), 0 at the end of
+ *          (wav), or -1 on error.
+ *
+ *  \sa SDL_OpenWAVStream_RW
+ *  \sa SDL_WAVStreamRead
+ *  \sa SDL_AudioStreamPut
+ */
+extern DECLSPEC int SDLCALL SDL_AudioStreamPutWAV(SDL_AudioStream *stream, SDL_WAVStream *wav, int frames);
+
 /**
  * Free an audio stream
  *
@@ -646,6 +793,39 @@ extern DECLSPEC void SDLCALL SDL_AudioStreamClear(SDL_AudioStream *stream);
  */
 extern DECLSPEC void SDLCALL SDL_FreeAudioStream(SDL_AudioStream *stream);
 
+/**
+ *  Convert a complete buffer of audio at once, splitting the work across
+ *  several threads.
+ *
+ *  The output is the same as putting all of (src) into an SDL_AudioStream
+ *  with one SDL_AudioStreamPut() call, calling SDL_AudioStreamFlush(), and
+ *  reading everything back. Buffers too small to be worth splitting are
+ *  converted that way. When converting to an integer format, samples near
+ *  the edges of each thread's piece may differ from the stream's output
+ *  by one step of rounding.
+ *
+ *  \param src_format The format of the source audio
+ *  \param src_channels The number of channels of the source audio
+ *  \param src_rate The sampling rate of the source audio
+ *  \param src The audio data to convert
+ *  \param src_len The number of bytes in (src), a multiple of the frame size
+ *  \param dst_format The format of the desired audio output
+ *  \param dst_channels The number of channels of the desired audio output
+ *  \param dst_rate The sampling rate of the desired audio output
+ *  \param dst Filled in with the converted audio, which must be freed with SDL_free()
+ *  \param dst_len Filled in with the number of bytes in (*dst)
+ *  \param num_threads The most threads to use, or 0 for one per CPU core
+ *  \return 0 on success, or -1 on error.
+ *
+ *  \sa SDL_NewAudioStream
+ *  \sa SDL_AudioStreamPut
+ *  \sa SDL_AudioStreamFlush
+ */
+extern DECLSPEC int SDLCALL SDL_ConvertAudioSamples(SDL_AudioFormat src_format, Uint8 src_channels, int src_rate,
+                                                    const void *src, int src_len,
+                                                    SDL_AudioFormat dst_format, Uint8 dst_channels, int dst_rate,
+                                                    void **dst, int *dst_len, int num_threads);
+
 #define SDL_MIX_MAXVOLUME 128
 /**
  *  This takes two audio buffers of the playing audio format and mixes
@@ -826,6 +1006,87 @@ extern DECLSPEC Uint32 SDLCALL SDL_GetQueuedAudioSize(SDL_AudioDeviceID dev);
  */
 extern DECLSPEC void SDLCALL SDL_ClearQueuedAudio(SDL_AudioDeviceID dev);
 
+/**
+ *  Get the number of times queued audio couldn't keep up with the device.
+ *
+ *  For playback devices, this counts each time the device needed more audio
+ *  than was queued and had to play silence, but not every callback while the
+ *  queue stays empty. For capture devices, this counts each time the device
+ *  had data that was dropped because the queue couldn't hold it.
+ *
+ *  Together with SDL_GetQueuedAudioSize(), which tells you how much audio
+ *  is waiting, this lets you tune how far ahead you queue.
+ *
+ *  \param dev The device ID to query.
+ *  \return The number of underruns or overruns since the device was opened,
+ *          or 0 if the device doesn't use queued audio.
+ *
+ *  \sa SDL_QueueAudio
+ *  \sa SDL_DequeueAudio
+ *  \sa SDL_GetQueuedAudioSize
+ */
+extern DECLSPEC Uint32 SDLCALL SDL_GetQueuedAudioXruns(SDL_AudioDeviceID dev);
+
+/**
+ *  \brief Timing and buffering statistics for an open audio device.
+ *
+ *  A "buffer" here is one trip through SDL's audio device thread: one
+ *  callback (or one read from the audio queue), plus any conversion between
+ *  the callback's format and the device's.
+ *
+ *  \sa SDL_GetAudioDeviceStats
+ */
+typedef struct SDL_AudioDeviceStats
+{
+    Uint32 callbacks;           /**< Number of times the audio callback ran */
+    Uint64 callback_ns_min;     /**< Shortest callback, in nanoseconds */
+    Uint64 callback_ns_avg;     /**< Average callback, in nanoseconds */
+    Uint64 callback_ns_max;     /**< Longest callback, in nanoseconds */
+    Uint64 conversion_ns_avg;   /**< Average time converting each buffer, in nanoseconds */
+    Uint64 conversion_ns_max;   /**< Longest time converting a buffer, in nanoseconds */
+    Uint32 underruns;           /**< Times SDL played silence because audio wasn't ready; a queue that stays empty counts once, as in SDL_GetQueuedAudioXruns() */
+    Uint32 overruns;            /**< Times captured audio was dropped because the audio queue was full, as in SDL_GetQueuedAudioXruns() */
+    Uint64 silence_frames;      /**< Sample frames of silence that SDL inserted for underruns, over every buffer they padded */
+    Uint32 stream_bytes;        /**< Bytes waiting in the conversion stream after the last buffer */
+    Uint32 stream_bytes_max;    /**< Most bytes waiting in the conversion stream after a buffer */
+    Uint32 queued_bytes;        /**< Bytes in the audio queue after the last buffer, for SDL_QueueAudio()/SDL_DequeueAudio() */
+    Uint32 queued_bytes_max;    /**< Most bytes in the audio queue after a buffer */
+} SDL_AudioDeviceStats;
+
+/**
+ *  Get timing and buffering statistics for an open audio device.
+ *
+ *  The device thread gathers these as it runs, without taking any locks,
+ *  and makes a new copy available after each buffer, so they're cheap
+ *  enough to leave on all the time. They cover everything since the device
+ *  was opened or since SDL_ResetAudioDeviceStats().
+ *
+ *  Some backends run the audio callback from their own thread instead of
+ *  SDL's; on those, only devices using SDL_QueueAudio()/SDL_DequeueAudio()
+ *  gather statistics, and callback and conversion times aren't measured.
+ *
+ *  \param dev The device ID to query.
+ *  \param stats Filled in with the device's statistics.
+ *  \return 0 on success, or -1 on error.
+ *
+ *  \sa SDL_ResetAudioDeviceStats
+ *  \sa SDL_GetQueuedAudioXruns
+ */
+extern DECLSPEC int SDLCALL SDL_GetAudioDeviceStats(SDL_AudioDeviceID dev, SDL_AudioDeviceStats *stats);
+
+/**
+ *  Start an open audio device's statistics over.
+ *
+ *  The device thread does this before it makes its next copy of the
+ *  statistics available, so SDL_GetAudioDeviceStats() may still return the
+ *  old statistics until the device has processed another buffer.
+ *
+ *  \param dev The device ID to reset.
+ *
+ *  \sa SDL_GetAudioDeviceStats
+ */
+extern DECLSPEC void SDLCALL SDL_ResetAudioDeviceStats(SDL_AudioDeviceID dev);
+
 
 /**
  *  \name Audio lock functions
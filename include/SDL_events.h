@@ -701,6 +701,25 @@ extern DECLSPEC void SDLCALL SDL_FlushEvents(Uint32 minType, Uint32 maxType);
  */
 extern DECLSPEC int SDLCALL SDL_PollEvent(SDL_Event * event);
 
+/**
+ *  \brief Polls for many currently pending events at once.
+ *
+ *  This pumps the event loop once, then removes up to \c numevents events
+ *  from the front of the event queue while holding the queue lock only once.
+ *  It is equivalent to calling SDL_PollEvent() repeatedly, but much cheaper
+ *  when many events arrive per frame (mouse motion, sensor updates, etc).
+ *
+ *  \return The number of events stored in \c events, which is 0 if there are
+ *          none available, or -1 if there was an error.
+ *
+ *  \param events A buffer that the pending events are stored in.
+ *  \param numevents The maximum number of events to store in \c events.
+ *
+ *  \sa SDL_PollEvent
+ *  \sa SDL_PeepEvents
+ */
+extern DECLSPEC int SDLCALL SDL_PollEvents(SDL_Event * events, int numevents);
+
 /**
  *  \brief Waits indefinitely for the next available event.
  *
@@ -807,6 +826,18 @@ extern DECLSPEC Uint8 SDLCALL SDL_EventState(Uint32 type, int state);
 /* @} */
 #define SDL_GetEventState(type) SDL_EventState(type, SDL_QUERY)
 
+/**
+ *  \brief Get the number of events of the given type that were merged into
+ *         an earlier queued event because of ::SDL_HINT_EVENT_COALESCING.
+ *
+ *  \param type One of ::SDL_MOUSEMOTION, ::SDL_FINGERMOTION,
+ *              ::SDL_SENSORUPDATE or ::SDL_CONTROLLERSENSORUPDATE.
+ *
+ *  \return The number of merged events since the event subsystem was
+ *          initialized, or 0 for event types that are never merged.
+ */
+extern DECLSPEC Uint32 SDLCALL SDL_GetCoalescedEventCount(Uint32 type);
+
 /**
  *  This function allocates a set of user-defined events, and returns
  *  the beginning event number for that set of events.
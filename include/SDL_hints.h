@@ -1381,6 +1381,31 @@ extern "C" {
  */
 #define SDL_HINT_AUDIO_RESAMPLING_MODE   "SDL_AUDIO_RESAMPLING_MODE"
 
+/**
+ *  \brief  A variable controlling whether queued audio uses a lock-free ring buffer.
+ *
+ *  This variable can be set to the following values:
+ *
+ *    "0"     - Queued audio goes through a growable queue shared with the device thread under a lock (default)
+ *    "1"     - Queued audio goes through a lock-free ring holding about one second of audio
+ *    N       - Queued audio goes through a lock-free ring of at least N bytes
+ *
+ *  With the lock-free ring, the device thread never waits for the
+ *  application while it reads or writes queued audio, so an application
+ *  thread calling SDL_QueueAudio() can't make the device miss its deadline.
+ *  The ring has a fixed size: SDL_QueueAudio() fails without queueing
+ *  anything if the data doesn't fit in the space left, and a capture device
+ *  drops data the application hasn't dequeued in time. Data bigger than the
+ *  whole ring is queued a piece at a time, with SDL_QueueAudio() waiting for
+ *  the device to play each piece; that fails if the device is paused. Only one application thread at a
+ *  time may queue, dequeue or clear audio on the device.
+ *
+ *  This hint is checked when an audio device without a callback is opened.
+ *
+ *  \sa SDL_GetQueuedAudioXruns
+ */
+#define SDL_HINT_AUDIO_QUEUE_LOCKFREE   "SDL_AUDIO_QUEUE_LOCKFREE"
+
 /**
  *  \brief  A variable controlling the audio category on iOS and Mac OS X
  *
@@ -1418,6 +1443,24 @@ extern "C" {
  */
 #define SDL_HINT_RENDER_BATCHING  "SDL_RENDER_BATCHING"
 
+/**
+ *  \brief  A variable controlling how many threads the software renderer draws with.
+ *
+ *  This variable can be set to the following values:
+ *
+ *    "1"     - Draw everything on the thread that flushes the render queue (default)
+ *    "0"     - Use one thread per CPU
+ *    "N"     - Use N threads
+ *
+ *  With more than one thread, the software renderer splits its target into
+ *  tiles and draws the tiles in parallel. The output is identical to drawing
+ *  on one thread. Lines, scaled copies and rotated copies are still drawn
+ *  one at a time on the calling thread.
+ *
+ *  This hint is checked when the renderer is created.
+ */
+#define SDL_HINT_RENDER_SOFTWARE_THREADS  "SDL_RENDER_SOFTWARE_THREADS"
+
 
 /**
  *  \brief  A variable controlling whether SDL updates joystick state when getting input events
@@ -1466,6 +1509,48 @@ extern "C" {
  */
 #define SDL_HINT_EVENT_LOGGING   "SDL_EVENT_LOGGING"
 
+/**
+ *  \brief  A variable controlling whether SDL_PushEvent() uses a lock-free queue.
+ *
+ *  This variable can be set to the following values:
+ *
+ *    "0"     - All events go through the locked event queue (default)
+ *    "1"     - Events are pushed into a preallocated lock-free ring of 4096 entries
+ *    N       - Events are pushed into a lock-free ring of at least N entries
+ *
+ *  With the lock-free ring enabled, threads calling SDL_PushEvent() don't
+ *  contend with each other or with the thread polling for events. Events are
+ *  moved from the ring onto the regular event queue whenever the queue is
+ *  examined, so SDL_PeepEvents(), SDL_FlushEvents() and SDL_FilterEvents()
+ *  behave exactly as before. If the ring fills up, pushes fall back to the
+ *  locked queue.
+ *
+ *  This hint must be set before the event subsystem is initialized.
+ */
+#define SDL_HINT_EVENT_QUEUE_LOCKFREE   "SDL_EVENT_QUEUE_LOCKFREE"
+
+/**
+ *  \brief  A variable controlling whether high-rate motion and sensor events are merged in the event queue.
+ *
+ *  This variable can be set to the following values:
+ *
+ *    "0"     - Every motion and sensor sample is queued as its own event (default)
+ *    "1"     - Consecutive queued events from the same device are merged
+ *
+ *  When enabled, an SDL_MOUSEMOTION, SDL_FINGERMOTION, SDL_SENSORUPDATE or
+ *  SDL_CONTROLLERSENSORUPDATE event that would be queued right behind an
+ *  unread event of the same type for the same device and window is merged
+ *  into it instead: the absolute position and sensor data are replaced with
+ *  the newest values and the relative motion is accumulated. Events are never
+ *  merged across other events, so ordering relative to button and key events
+ *  is preserved. Event watchers still see every individual event.
+ *
+ *  SDL_GetCoalescedEventCount() reports how many events have been merged.
+ *
+ *  This hint can be toggled on and off at runtime.
+ */
+#define SDL_HINT_EVENT_COALESCING   "SDL_EVENT_COALESCING"
+
 
 
 /**
@@ -1615,6 +1700,23 @@ extern "C" {
  */
 #define SDL_HINT_PREFERRED_LOCALES "SDL_PREFERRED_LOCALES"
 
+/**
+ *  \brief  A variable controlling whether SDL_RWFromFile() memory-maps files opened for reading.
+ *
+ *  A memory-mapped stream reads with a plain memory copy from the mapping, and
+ *  SDL_RWGetMemory() gives direct access to the file contents. This works best
+ *  for large, read-only assets. Passing 'm' in the mode string of
+ *  SDL_RWFromFile() requests a mapping for a single file.
+ *
+ *  Files that can't be mapped, such as pipes or empty files, are opened as
+ *  regular files.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Only map files with 'm' in the mode string (default)
+ *    "1"       - Map every file opened with mode "r" or "rb"
+ */
+#define SDL_HINT_RWOPS_MMAP "SDL_RWOPS_MMAP"
+
 
 /**
  *  \brief  An enumeration of hint priorities
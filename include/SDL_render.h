@@ -137,6 +137,45 @@ typedef struct SDL_Renderer SDL_Renderer;
 struct SDL_Texture;
 typedef struct SDL_Texture SDL_Texture;
 
+/**
+ *  \brief Vertex structure used by SDL_RenderGeometry()
+ */
+typedef struct SDL_Vertex
+{
+    SDL_FPoint position;        /**< Vertex position, in SDL_Renderer coordinates  */
+    SDL_Color  color;           /**< Vertex color */
+    SDL_FPoint tex_coord;       /**< Normalized texture coordinates, if needed */
+} SDL_Vertex;
+
+/**
+ *  \brief Counters for one frame of rendering, filled in by SDL_RenderGetStats()
+ *
+ *  Commands are counted as they are handed to the renderer backend, so
+ *  copies of one texture that were queued back to back and merged into a
+ *  single command count as one copy command.
+ */
+typedef struct SDL_RenderStats
+{
+    Uint32 flushes;             /**< Times queued commands were sent to the backend */
+    Uint32 texture_flushes;     /**< Flushes forced by changing a texture the queue uses */
+    Uint32 viewport_changes;    /**< Viewport commands */
+    Uint32 cliprect_changes;    /**< Clip rectangle commands */
+    Uint32 color_changes;       /**< Draw color commands */
+    Uint32 clear_commands;      /**< Clear commands */
+    Uint32 point_commands;      /**< Point drawing commands */
+    Uint32 line_commands;       /**< Line drawing commands */
+    Uint32 fill_rect_commands;  /**< Rectangle filling commands */
+    Uint32 copy_commands;       /**< Texture copy commands */
+    Uint32 copy_ex_commands;    /**< Rotated or flipped texture copy commands */
+    Uint32 geometry_commands;   /**< Geometry commands */
+    Uint32 copies;              /**< Texture copies queued, counting each one merged into a copy command */
+    Uint32 draw_calls;          /**< Drawing commands of any kind */
+    Uint32 vertex_bytes_peak;   /**< Largest vertex buffer handed to the backend at once */
+    Uint32 texture_updates;     /**< Texture updates, including unlocked streaming textures */
+    Uint64 texture_update_bytes; /**< Bytes of pixel data uploaded by those updates */
+    Uint64 execution_time;      /**< Time the backend spent running commands, in performance counter ticks */
+} SDL_RenderStats;
+
 
 /* Function prototypes */
 
@@ -1059,6 +1098,28 @@ extern DECLSPEC int SDLCALL SDL_RenderCopyExF(SDL_Renderer * renderer,
                                             const SDL_FPoint *center,
                                             const SDL_RendererFlip flip);
 
+/**
+ *  \brief Render a list of triangles, optionally using a texture and indices into the vertex array.
+ *
+ *  The vertex colors are modulated by the texture color and alpha modulation,
+ *  and the triangles are blended with the texture blend mode, or with the
+ *  renderer blend mode if no texture is used.
+ *
+ *  \param renderer     The rendering context.
+ *  \param texture      The SDL texture to use, or NULL to draw untextured triangles.
+ *  \param vertices     The vertices.
+ *  \param num_vertices The number of vertices.
+ *  \param indices      An array of vertex indices, or NULL to draw the vertices
+ *                      in order as a list of triangles.
+ *  \param num_indices  The number of indices.
+ *
+ *  \return 0 on success, or -1 if the operation is not supported
+ */
+extern DECLSPEC int SDLCALL SDL_RenderGeometry(SDL_Renderer * renderer,
+                                               SDL_Texture * texture,
+                                               const SDL_Vertex * vertices, int num_vertices,
+                                               const int * indices, int num_indices);
+
 /**
  *  \brief Read pixels from the current rendering target.
  *
@@ -1125,6 +1186,26 @@ extern DECLSPEC void SDLCALL SDL_DestroyRenderer(SDL_Renderer * renderer);
  */
 extern DECLSPEC int SDLCALL SDL_RenderFlush(SDL_Renderer * renderer);
 
+/**
+ *  \brief Get statistics about the most recently presented frame.
+ *
+ *  The counters cover everything the renderer did between the two most
+ *  recent calls to SDL_RenderPresent(), and are all zero until the first
+ *  frame has been presented. Divide execution_time by
+ *  SDL_GetPerformanceFrequency() to get seconds.
+ *
+ *  Set the priority of SDL_LOG_CATEGORY_RENDER to SDL_LOG_PRIORITY_VERBOSE
+ *  to also log every command as it is sent to the backend.
+ *
+ *  \param renderer The renderer to query
+ *  \param stats    A pointer filled in with the statistics
+ *
+ *  \return 0 on success, or -1 on error
+ *
+ *  \sa SDL_RenderPresent()
+ */
+extern DECLSPEC int SDLCALL SDL_RenderGetStats(SDL_Renderer * renderer, SDL_RenderStats * stats);
+
 
 /**
  *  \brief Bind the texture to the current OpenGL/ES/ES2 context for use with
@@ -45,6 +45,8 @@ extern "C" {
 #define SDL_RWOPS_JNIFILE   3U  /**< Android asset */
 #define SDL_RWOPS_MEMORY    4U  /**< Memory stream */
 #define SDL_RWOPS_MEMORY_RO 5U  /**< Read-Only memory stream */
+#define SDL_RWOPS_MAPPED    6U  /**< Read-Only memory-mapped file */
+#define SDL_RWOPS_BUFFERED  7U  /**< Buffer around another stream */
 
 /**
  * This is the read/write operation structure -- very basic.
@@ -142,6 +144,12 @@ typedef struct SDL_RWops
  */
 /* @{ */
 
+/**
+ *  Open a file with a mode string like fopen().
+ *
+ *  On platforms with mmap(), adding 'm' to a read-only mode ("rm" or "rbm")
+ *  maps the file into memory. See SDL_HINT_RWOPS_MMAP.
+ */
 extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromFile(const char *file,
                                                   const char *mode);
 
@@ -163,6 +171,29 @@ extern DECLSPEC SDL_RWops *SDLCALL SDL_RWFromConstMem(const void *mem,
 extern DECLSPEC SDL_RWops *SDLCALL SDL_AllocRW(void);
 extern DECLSPEC void SDLCALL SDL_FreeRW(SDL_RWops * area);
 
+/**
+ *  Wrap a stream in a read-ahead and write-behind buffer.
+ *
+ *  Many small reads and writes, like those of SDL_ReadLE32() and friends,
+ *  turn into a few large ones on \c src. Seeks within the read-ahead data
+ *  don't touch \c src at all.
+ *
+ *  \param src the stream to buffer.
+ *  \param buffersize the size of the buffer in bytes, or 0 for a default.
+ *  \param freesrc non-zero to close \c src when the new stream is closed,
+ *                 or if this function fails.
+ *
+ *  Write errors may only show up when the buffer is flushed, which happens
+ *  when it is full, on seeks, on reads and on SDL_RWclose(). If \c freesrc
+ *  is zero, closing the new stream leaves \c src at the position the new
+ *  stream was at.
+ *
+ *  \return the new stream, or NULL on error.
+ */
+extern DECLSPEC SDL_RWops *SDLCALL SDL_CreateBufferedRW(SDL_RWops * src,
+                                                        size_t buffersize,
+                                                        int freesrc);
+
 #define RW_SEEK_SET 0       /**< Seek from the beginning of data */
 #define RW_SEEK_CUR 1       /**< Seek relative to current read point */
 #define RW_SEEK_END 2       /**< Seek relative to the end of data */
@@ -211,6 +242,22 @@ extern DECLSPEC size_t SDLCALL SDL_RWwrite(SDL_RWops *context,
  */
 extern DECLSPEC int SDLCALL SDL_RWclose(SDL_RWops *context);
 
+/**
+ *  Get direct access to the data of a stream that is backed by memory.
+ *
+ *  This works for streams created with SDL_RWFromMem(), SDL_RWFromConstMem()
+ *  and memory-mapped files from SDL_RWFromFile(). The data stays valid until
+ *  the stream is closed, and must not be written to unless the stream came
+ *  from SDL_RWFromMem().
+ *
+ *  If \c size is not NULL, it is filled with the size of the data.
+ *
+ *  \return a pointer to the start of the data, or NULL if the stream isn't
+ *          backed by memory.
+ */
+extern DECLSPEC const void *SDLCALL SDL_RWGetMemory(SDL_RWops *context,
+                                                    size_t *size);
+
 /**
  *  Load all the data from an SDL data stream.
  *
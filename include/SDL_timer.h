@@ -70,6 +70,20 @@ extern DECLSPEC Uint64 SDLCALL SDL_GetPerformanceFrequency(void);
  */
 extern DECLSPEC void SDLCALL SDL_Delay(Uint32 ms);
 
+/**
+ *  Conversion factors for the nanosecond timer functions.
+ */
+#define SDL_NS_PER_SECOND   ((Uint64)1000000000)
+#define SDL_NS_PER_MS       ((Uint64)1000000)
+
+/**
+ * \brief Wait a specified number of nanoseconds before returning.
+ *
+ * This is much more precise than SDL_Delay(), but depending on the platform
+ * it may spin for the part of the wait that is shorter than a millisecond.
+ */
+extern DECLSPEC void SDLCALL SDL_DelayNS(Uint64 ns);
+
 /**
  *  Function prototype for the timer callback function.
  *
@@ -80,6 +94,13 @@ extern DECLSPEC void SDLCALL SDL_Delay(Uint32 ms);
  */
 typedef Uint32 (SDLCALL * SDL_TimerCallback) (Uint32 interval, void *param);
 
+/**
+ *  Function prototype for the nanosecond timer callback function.
+ *
+ *  This works like ::SDL_TimerCallback, but the interval is in nanoseconds.
+ */
+typedef Uint64 (SDLCALL * SDL_TimerCallbackNS) (Uint64 interval, void *param);
+
 /**
  * Definition of the timer ID type.
  */
@@ -94,6 +115,20 @@ extern DECLSPEC SDL_TimerID SDLCALL SDL_AddTimer(Uint32 interval,
                                                  SDL_TimerCallback callback,
                                                  void *param);
 
+/**
+ * \brief Add a new timer with a nanosecond interval to the pool of timers
+ *        already running.
+ *
+ * Timers are scheduled from SDL_GetPerformanceCounter() and the timer
+ * thread finishes waiting for them with SDL_DelayNS(), so they can fire at
+ * sub-millisecond intervals. Remove them with SDL_RemoveTimer().
+ *
+ * \return A timer ID, or 0 when an error occurs.
+ */
+extern DECLSPEC SDL_TimerID SDLCALL SDL_AddTimerNS(Uint64 interval,
+                                                   SDL_TimerCallbackNS callback,
+                                                   void *param);
+
 /**
  * \brief Remove a timer knowing its ID.
  *
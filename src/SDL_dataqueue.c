@@ -23,31 +23,48 @@
 #include "SDL.h"
 #include "./SDL_dataqueue.h"
 
-typedef struct SDL_DataQueuePacket
-{
-    size_t datalen;  /* bytes currently in use in this packet. */
-    size_t startpos;  /* bytes currently consumed in this packet. */
-    struct SDL_DataQueuePacket *next;  /* next item in linked list. */
-    Uint8 data[SDL_VARIABLE_LENGTH_ARRAY];  /* packet data */
-} SDL_DataQueuePacket;
-
+/* The queue is a single contiguous ring buffer. Data is read from (head) and
+   written at (head + queued_bytes), wrapping at the end of the buffer, so
+   reads and writes are at most two memcpy() calls and there's no per-packet
+   allocation. The buffer grows (in multiples of packet_size) when a write
+   doesn't fit, which also unwraps the data to the start of the new buffer. */
 struct SDL_DataQueue
 {
-    SDL_DataQueuePacket *head; /* device fed from here. */
-    SDL_DataQueuePacket *tail; /* queue fills to here. */
-    SDL_DataQueuePacket *pool; /* these are unused packets. */
-    size_t packet_size;   /* size of new packets */
+    Uint8 *buffer;        /* ring buffer storage. */
+    size_t capacity;      /* size of buffer, in bytes. */
+    size_t head;          /* device fed from here. */
+    size_t packet_size;   /* buffer grows in chunks of this many bytes */
     size_t queued_bytes;  /* number of bytes of data in the queue. */
 };
 
-static void
-SDL_FreeDataQueueList(SDL_DataQueuePacket *packet)
+static size_t
+RoundUpToPacketSize(const SDL_DataQueue *queue, const size_t len)
+{
+    return ((len + (queue->packet_size - 1)) / queue->packet_size) * queue->packet_size;
+}
+
+/* Move the queued data into a new buffer of at least (capacity) bytes, starting at offset 0 */
+static int
+ResizeDataQueue(SDL_DataQueue *queue, const size_t _capacity)
 {
-    while (packet) {
-        SDL_DataQueuePacket *next = packet->next;
-        SDL_free(packet);
-        packet = next;
+    const size_t capacity = RoundUpToPacketSize(queue, _capacity);
+    Uint8 *buffer = NULL;
+
+    SDL_assert(capacity >= queue->queued_bytes);
+
+    if (capacity > 0) {
+        buffer = (Uint8 *) SDL_malloc(capacity);
+        if (!buffer) {
+            return SDL_OutOfMemory();
+        }
+        SDL_PeekIntoDataQueue(queue, buffer, queue->queued_bytes);
     }
+
+    SDL_free(queue->buffer);
+    queue->buffer = buffer;
+    queue->capacity = capacity;
+    queue->head = 0;
+    return 0;
 }
 
 
@@ -63,21 +80,12 @@ SDL_NewDataQueue(const size_t _packetlen, const size_t initialslack)
         return NULL;
     } else {
         const size_t packetlen = _packetlen ? _packetlen : 1024;
-        const size_t wantpackets = (initialslack + (packetlen - 1)) / packetlen;
-        size_t i;
 
         SDL_zerop(queue);
         queue->packet_size = packetlen;
 
-        for (i = 0; i < wantpackets; i++) {
-            SDL_DataQueuePacket *packet = (SDL_DataQueuePacket *) SDL_malloc(sizeof (SDL_DataQueuePacket) + packetlen);
-            if (packet) { /* don't care if this fails, we'll deal later. */
-                packet->datalen = 0;
-                packet->startpos = 0;
-                packet->next = queue->pool;
-                queue->pool = packet;
-            }
-        }
+        /* don't care if this fails, we'll deal later. */
+        ResizeDataQueue(queue, initialslack);
     }
 
     return queue;
@@ -87,8 +95,7 @@ void
 SDL_FreeDataQueue(SDL_DataQueue *queue)
 {
     if (queue) {
-        SDL_FreeDataQueueList(queue->head);
-        SDL_FreeDataQueueList(queue->pool);
+        SDL_free(queue->buffer);
         SDL_free(queue);
     }
 }
@@ -96,130 +103,54 @@ SDL_FreeDataQueue(SDL_DataQueue *queue)
 void
 SDL_ClearDataQueue(SDL_DataQueue *queue, const size_t slack)
 {
-    const size_t packet_size = queue ? queue->packet_size : 1;
-    const size_t slackpackets = (slack + (packet_size-1)) / packet_size;
-    SDL_DataQueuePacket *packet;
-    SDL_DataQueuePacket *prev = NULL;
-    size_t i;
-
     if (!queue) {
         return;
     }
 
-    packet = queue->head;
-
-    /* merge the available pool and the current queue into one list. */
-    if (packet) {
-        queue->tail->next = queue->pool;
-    } else {
-        packet = queue->pool;
-    }
-
-    /* Remove the queued packets from the device. */
-    queue->tail = NULL;
-    queue->head = NULL;
+    queue->head = 0;
     queue->queued_bytes = 0;
-    queue->pool = packet;
-
-    /* Optionally keep some slack in the pool to reduce malloc pressure. */
-    for (i = 0; packet && (i < slackpackets); i++) {
-        prev = packet;
-        packet = packet->next;
-    }
 
-    if (prev) {
-        prev->next = NULL;
-    } else {
-        queue->pool = NULL;
-    }
-
-    SDL_FreeDataQueueList(packet);  /* free extra packets */
-}
-
-static SDL_DataQueuePacket *
-AllocateDataQueuePacket(SDL_DataQueue *queue)
-{
-    SDL_DataQueuePacket *packet;
-
-    SDL_assert(queue != NULL);
-
-    packet = queue->pool;
-    if (packet != NULL) {
-        /* we have one available in the pool. */
-        queue->pool = packet->next;
-    } else {
-        /* Have to allocate a new one! */
-        packet = (SDL_DataQueuePacket *) SDL_malloc(sizeof (SDL_DataQueuePacket) + queue->packet_size);
-        if (packet == NULL) {
-            return NULL;
-        }
-    }
-
-    packet->datalen = 0;
-    packet->startpos = 0;
-    packet->next = NULL;
-                
-    SDL_assert((queue->head != NULL) == (queue->queued_bytes != 0));
-    if (queue->tail == NULL) {
-        queue->head = packet;
-    } else {
-        queue->tail->next = packet;
+    /* Optionally keep some slack in the buffer to reduce malloc pressure. */
+    if (queue->capacity > RoundUpToPacketSize(queue, slack)) {
+        ResizeDataQueue(queue, slack);
     }
-    queue->tail = packet;
-    return packet;
 }
 
-
 int
 SDL_WriteToDataQueue(SDL_DataQueue *queue, const void *_data, const size_t _len)
 {
-    size_t len = _len;
     const Uint8 *data = (const Uint8 *) _data;
-    const size_t packet_size = queue ? queue->packet_size : 0;
-    SDL_DataQueuePacket *orighead;
-    SDL_DataQueuePacket *origtail;
-    size_t origlen;
-    size_t datalen;
+    size_t len = _len;
+    size_t tail;
 
     if (!queue) {
         return SDL_InvalidParamError("queue");
+    } else if (len == 0) {
+        return 0;
     }
 
-    orighead = queue->head;
-    origtail = queue->tail;
-    origlen = origtail ? origtail->datalen : 0;
-
-    while (len > 0) {
-        SDL_DataQueuePacket *packet = queue->tail;
-        SDL_assert(!packet || (packet->datalen <= packet_size));
-        if (!packet || (packet->datalen >= packet_size)) {
-            /* tail packet missing or completely full; we need a new packet. */
-            packet = AllocateDataQueuePacket(queue);
-            if (!packet) {
-                /* uhoh, reset so we've queued nothing new, free what we can. */
-                if (!origtail) {
-                    packet = queue->head;  /* whole queue. */
-                } else {
-                    packet = origtail->next;  /* what we added to existing queue. */
-                    origtail->next = NULL;
-                    origtail->datalen = origlen;
-                }
-                queue->head = orighead;
-                queue->tail = origtail;
-                queue->pool = NULL;
-
-                SDL_FreeDataQueueList(packet);  /* give back what we can. */
-                return SDL_OutOfMemory();
-            }
+    if (len > (queue->capacity - queue->queued_bytes)) {
+        /* Grow geometrically so a stream of small writes doesn't realloc every time. */
+        const size_t wanted = SDL_max(queue->queued_bytes + len, queue->capacity * 2);
+        if (ResizeDataQueue(queue, wanted) < 0) {
+            return -1;  /* nothing was queued. */
         }
+    }
 
-        datalen = SDL_min(len, packet_size - packet->datalen);
-        SDL_memcpy(packet->data + packet->datalen, data, datalen);
-        data += datalen;
-        len -= datalen;
-        packet->datalen += datalen;
-        queue->queued_bytes += datalen;
+    tail = queue->head + queue->queued_bytes;
+    if (tail >= queue->capacity) {
+        tail -= queue->capacity;
     }
+    queue->queued_bytes += len;
+
+    if (len > (queue->capacity - tail)) {
+        const size_t cpy = queue->capacity - tail;
+        SDL_memcpy(queue->buffer + tail, data, cpy);
+        data += cpy;
+        len -= cpy;
+        tail = 0;
+    }
+    SDL_memcpy(queue->buffer + tail, data, len);
 
     return 0;
 }
@@ -227,66 +158,64 @@ SDL_WriteToDataQueue(SDL_DataQueue *queue, const void *_data, const size_t _len)
 size_t
 SDL_PeekIntoDataQueue(SDL_DataQueue *queue, void *_buf, const size_t _len)
 {
-    size_t len = _len;
     Uint8 *buf = (Uint8 *) _buf;
-    Uint8 *ptr = buf;
-    SDL_DataQueuePacket *packet;
+    size_t len;
 
     if (!queue) {
         return 0;
     }
 
-    for (packet = queue->head; len && packet; packet = packet->next) {
-        const size_t avail = packet->datalen - packet->startpos;
-        const size_t cpy = SDL_min(len, avail);
-        SDL_assert(queue->queued_bytes >= avail);
-
-        SDL_memcpy(ptr, packet->data + packet->startpos, cpy);
-        ptr += cpy;
-        len -= cpy;
+    len = SDL_min(_len, queue->queued_bytes);
+    if (len > (queue->capacity - queue->head)) {
+        const size_t cpy = queue->capacity - queue->head;
+        SDL_memcpy(buf, queue->buffer + queue->head, cpy);
+        SDL_memcpy(buf + cpy, queue->buffer, len - cpy);
+    } else {
+        SDL_memcpy(buf, queue->buffer + queue->head, len);
     }
 
-    return (size_t) (ptr - buf);
+    return len;
 }
 
 size_t
-SDL_ReadFromDataQueue(SDL_DataQueue *queue, void *_buf, const size_t _len)
+SDL_ReadFromDataQueue(SDL_DataQueue *queue, void *buf, const size_t len)
 {
-    size_t len = _len;
-    Uint8 *buf = (Uint8 *) _buf;
-    Uint8 *ptr = buf;
-    SDL_DataQueuePacket *packet;
+    const size_t retval = SDL_PeekIntoDataQueue(queue, buf, len);
+    SDL_CommitDataQueueRead(queue, retval);
+    return retval;
+}
 
-    if (!queue) {
-        return 0;
+const void *
+SDL_PeekDataQueueSpan(SDL_DataQueue *queue, size_t *len)
+{
+    if (!queue || !queue->queued_bytes) {
+        *len = 0;
+        return NULL;
     }
 
-    while ((len > 0) && ((packet = queue->head) != NULL)) {
-        const size_t avail = packet->datalen - packet->startpos;
-        const size_t cpy = SDL_min(len, avail);
-        SDL_assert(queue->queued_bytes >= avail);
+    *len = SDL_min(queue->queued_bytes, queue->capacity - queue->head);
+    return queue->buffer + queue->head;
+}
 
-        SDL_memcpy(ptr, packet->data + packet->startpos, cpy);
-        packet->startpos += cpy;
-        ptr += cpy;
-        queue->queued_bytes -= cpy;
-        len -= cpy;
+void
+SDL_CommitDataQueueRead(SDL_DataQueue *queue, const size_t _len)
+{
+    size_t len;
 
-        if (packet->startpos == packet->datalen) {  /* packet is done, put it in the pool. */
-            queue->head = packet->next;
-            SDL_assert((packet->next != NULL) || (packet == queue->tail));
-            packet->next = queue->pool;
-            queue->pool = packet;
-        }
+    if (!queue) {
+        return;
     }
 
-    SDL_assert((queue->head != NULL) == (queue->queued_bytes != 0));
-
-    if (queue->head == NULL) {
-        queue->tail = NULL;  /* in case we drained the queue entirely. */
+    len = SDL_min(_len, queue->queued_bytes);
+    queue->queued_bytes -= len;
+    if (queue->queued_bytes == 0) {
+        queue->head = 0;  /* drained entirely, start over so spans stay long. */
+    } else {
+        queue->head += len;
+        if (queue->head >= queue->capacity) {
+            queue->head -= queue->capacity;
+        }
     }
-
-    return (size_t) (ptr - buf);
 }
 
 size_t
@@ -298,7 +227,7 @@ SDL_CountDataQueue(SDL_DataQueue *queue)
 void *
 SDL_ReserveSpaceInDataQueue(SDL_DataQueue *queue, const size_t len)
 {
-    SDL_DataQueuePacket *packet;
+    size_t tail;
 
     if (!queue) {
         SDL_InvalidParamError("queue");
@@ -306,33 +235,25 @@ SDL_ReserveSpaceInDataQueue(SDL_DataQueue *queue, const size_t len)
     } else if (len == 0) {
         SDL_InvalidParamError("len");
         return NULL;
-    } else if (len > queue->packet_size) {
-        SDL_SetError("len is larger than packet size");
-        return NULL;
     }
 
-    packet = queue->head;
-    if (packet) {
-        const size_t avail = queue->packet_size - packet->datalen;
-        if (len <= avail) {  /* we can use the space at end of this packet. */
-            void *retval = packet->data + packet->datalen;
-            packet->datalen += len;
-            queue->queued_bytes += len;
-            return retval;
-        }
+    tail = queue->head + queue->queued_bytes;
+    if (tail >= queue->capacity) {
+        tail -= queue->capacity;
     }
 
-    /* Need a fresh packet. */
-    packet = AllocateDataQueuePacket(queue);
-    if (!packet) {
-        SDL_OutOfMemory();
-        return NULL;
+    /* The space has to be contiguous, and can't overlap data that's queued. */
+    if ((len > (queue->capacity - queue->queued_bytes)) ||
+        ((tail >= queue->head) && (len > (queue->capacity - tail)))) {
+        const size_t wanted = SDL_max(queue->queued_bytes + len, queue->capacity * 2);
+        if (ResizeDataQueue(queue, wanted) < 0) {
+            return NULL;
+        }
+        tail = queue->queued_bytes;
     }
 
-    packet->datalen = len;
     queue->queued_bytes += len;
-    return packet->data;
+    return queue->buffer + tail;
 }
 
 /* vi: set ts=4 sw=4 expandtab: */
-
@@ -34,14 +34,25 @@ size_t SDL_ReadFromDataQueue(SDL_DataQueue *queue, void *buf, const size_t len);
 size_t SDL_PeekIntoDataQueue(SDL_DataQueue *queue, void *buf, const size_t len);
 size_t SDL_CountDataQueue(SDL_DataQueue *queue);
 
+/* this returns a pointer to the longest run of queued data that is contiguous
+   in memory, and sets (*len) to its size, without consuming anything. Call
+   SDL_CommitDataQueueRead() once you're done with some or all of it. The
+   pointer is only valid until the next write or clear. Returns NULL and sets
+   (*len) to 0 if the queue is empty. */
+const void *SDL_PeekDataQueueSpan(SDL_DataQueue *queue, size_t *len);
+
+/* this consumes (len) bytes from the front of the queue without copying them
+   anywhere, usually after looking at them with SDL_PeekDataQueueSpan(). */
+void SDL_CommitDataQueueRead(SDL_DataQueue *queue, const size_t len);
+
 /* this sets a section of the data queue aside (possibly allocating memory for it)
    as if it's been written to, but returns a pointer to that space. You may write
    to this space until a read would consume it. Writes (and other calls to this
-   function) will safely append their data after this reserved space and can
-   be in flight at the same time. There is no thread safety.
-   If there isn't an existing block of memory that can contain the reserved
-   space, one will be allocated for it. You can not (currently) allocate
-   a space larger than the packetlen requested in SDL_NewDataQueue.
+   function) will safely append their data after this reserved space, but if
+   they need to grow the queue its memory moves, so finish writing to the
+   reserved space first. There is no thread safety.
+   If there isn't enough contiguous free space at the end of the queue for
+   the reserved space, the queue grows to make room for it.
    Returned buffer is uninitialized.
    This lets you avoid an extra copy in some cases, but it's safer to use
    SDL_WriteToDataQueue() unless you know what you're doing.
@@ -558,12 +558,301 @@ SDL_RemoveAudioDevice(const int iscapture, void *handle)
 
 
 
+/* device statistics support... */
+
+/* These are only called from the device thread (or whatever thread calls
+   the callback, for backends that provide their own). */
+static void
+SDL_CountAudioCallback(SDL_AudioDevice *device, const Uint64 ticks)
+{
+    SDL_AudioDeviceCounters *counters = &device->counters;
+    if ((counters->callbacks == 0) || (ticks < counters->callback_min)) {
+        counters->callback_min = ticks;
+    }
+    counters->callback_max = SDL_max(counters->callback_max, ticks);
+    counters->callback_total += ticks;
+    counters->callbacks++;
+}
+
+static void
+SDL_CountAudioConversion(SDL_AudioDevice *device, const Uint64 ticks)
+{
+    SDL_AudioDeviceCounters *counters = &device->counters;
+    counters->conversion_max = SDL_max(counters->conversion_max, ticks);
+    counters->conversion_total += ticks;
+    counters->conversions++;
+}
+
+/* (ran_dry) is false for more silence in an underrun that's already counted. */
+static void
+SDL_CountAudioUnderrun(SDL_AudioDevice *device, const int silence_bytes, const SDL_AudioSpec *spec, const SDL_bool ran_dry)
+{
+    if (ran_dry) {
+        SDL_AtomicIncRef(&device->underruns);
+    }
+    device->counters.silence_frames += silence_bytes / ((SDL_AUDIO_BITSIZE(spec->format) / 8) * spec->channels);
+}
+
+static void
+SDL_CountAudioOverrun(SDL_AudioDevice *device)
+{
+    SDL_AtomicIncRef(&device->overruns);
+}
+
+static void
+SDL_CountQueuedAudio(SDL_AudioDevice *device, const Uint32 queued)
+{
+    device->counters.queued_bytes = queued;
+    device->counters.queued_bytes_max = SDL_max(device->counters.queued_bytes_max, queued);
+}
+
+/* Called once per buffer, by the device thread or the audio queue callbacks. */
+static void
+SDL_PublishAudioCounters(SDL_AudioDevice *device)
+{
+    if (SDL_AtomicSet(&device->counters_reset, 0)) {
+        const Uint32 queued_bytes = device->counters.queued_bytes;
+        SDL_zero(device->counters);
+        device->counters.queued_bytes = queued_bytes;  /* still true, though. */
+        device->counters.queued_bytes_max = queued_bytes;
+        device->counters.underruns_base = (Uint32) SDL_AtomicGet(&device->underruns);
+        device->counters.overruns_base = (Uint32) SDL_AtomicGet(&device->overruns);
+    }
+
+    device->counters.underruns = (Uint32) SDL_AtomicGet(&device->underruns) - device->counters.underruns_base;
+    device->counters.overruns = (Uint32) SDL_AtomicGet(&device->overruns) - device->counters.overruns_base;
+
+    if (device->stream) {
+        const Uint32 available = (Uint32) SDL_AudioStreamAvailable(device->stream);
+        device->counters.stream_bytes = available;
+        device->counters.stream_bytes_max = SDL_max(device->counters.stream_bytes_max, available);
+    }
+
+    SDL_AtomicIncRef(&device->counters_sequence);
+    SDL_MemoryBarrierRelease();
+    device->published_counters = device->counters;
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicIncRef(&device->counters_sequence);
+}
+
+static Uint64
+SDL_AudioTicksToNS(const Uint64 ticks)
+{
+    const Uint64 freq = SDL_GetPerformanceFrequency();
+    return ((ticks / freq) * SDL_NS_PER_SECOND) + (((ticks % freq) * SDL_NS_PER_SECOND) / freq);
+}
+
+int
+SDL_GetAudioDeviceStats(SDL_AudioDeviceID devid, SDL_AudioDeviceStats *stats)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+    SDL_AudioDeviceCounters counters;
+    int sequence;
+
+    if (!device) {
+        return -1;  /* get_audio_device() will have set the error state */
+    } else if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+
+    /* the device thread doesn't wait for us; try again if it was mid-copy. */
+    do {
+        sequence = SDL_AtomicGet(&device->counters_sequence);
+        SDL_MemoryBarrierAcquire();
+        counters = device->published_counters;
+        SDL_MemoryBarrierAcquire();
+    } while ((sequence & 1) || (sequence != SDL_AtomicGet(&device->counters_sequence)));
+
+    SDL_zerop(stats);
+    stats->callbacks = counters.callbacks;
+    if (counters.callbacks > 0) {
+        stats->callback_ns_min = SDL_AudioTicksToNS(counters.callback_min);
+        stats->callback_ns_avg = SDL_AudioTicksToNS(counters.callback_total / counters.callbacks);
+        stats->callback_ns_max = SDL_AudioTicksToNS(counters.callback_max);
+    }
+    if (counters.conversions > 0) {
+        stats->conversion_ns_avg = SDL_AudioTicksToNS(counters.conversion_total / counters.conversions);
+        stats->conversion_ns_max = SDL_AudioTicksToNS(counters.conversion_max);
+    }
+    stats->underruns = counters.underruns;
+    stats->overruns = counters.overruns;
+    stats->silence_frames = counters.silence_frames;
+    stats->stream_bytes = counters.stream_bytes;
+    stats->stream_bytes_max = counters.stream_bytes_max;
+    stats->queued_bytes = counters.queued_bytes;
+    stats->queued_bytes_max = counters.queued_bytes_max;
+    return 0;
+}
+
+void
+SDL_ResetAudioDeviceStats(SDL_AudioDeviceID devid)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+
+    if (device) {
+        SDL_AtomicSet(&device->counters_reset, 1);
+    }
+}
+
 /* buffer queueing support... */
 
+/* With SDL_HINT_AUDIO_QUEUE_LOCKFREE, queued audio goes through this ring
+   instead of the buffer_queue, and neither side takes the mixer lock. There
+   is exactly one producer (the app for playback, the device thread for
+   capture) and one consumer (the other one). Positions count bytes and are
+   allowed to wrap around; the buffer size is a power of two so they index
+   it directly. Only the producer moves write_pos and only the consumer moves
+   read_pos. A clear from the app is a request for the consumer to skip
+   ahead to clear_pos, since for playback the app isn't the consumer. The
+   buffer is twice the queue's capacity, so the app can queue a full ring
+   again right after a clear, before the consumer gets around to it. */
+struct SDL_AudioRing
+{
+    Uint8 *buffer;
+    Uint32 mask;
+    Uint32 capacity;
+
+    char cache_pad1[SDL_CACHELINE_SIZE-sizeof(Uint8*)-sizeof(Uint32)*2];
+
+    SDL_atomic_t write_pos;
+
+    char cache_pad2[SDL_CACHELINE_SIZE-sizeof(SDL_atomic_t)];
+
+    SDL_atomic_t read_pos;
+    SDL_atomic_t clear_pos;
+    SDL_atomic_t clear_pending;
+};
+
+/* How big the ring is when SDL_HINT_AUDIO_QUEUE_LOCKFREE is "1", in seconds of audio */
+#define SDL_DEFAULT_AUDIO_RING_SECONDS 1
+
+static Uint32
+SDL_GetAudioRingSize(const char *hint, const SDL_AudioSpec *spec)
+{
+    Uint32 size, wanted;
+    int value;
+
+    if (!hint || !*hint) {
+        return 0;
+    }
+    value = SDL_atoi(hint);
+    if (value <= 0) {
+        return 0;
+    } else if (value == 1) {
+        wanted = SDL_DEFAULT_AUDIO_RING_SECONDS * spec->freq * spec->channels * (SDL_AUDIO_BITSIZE(spec->format) / 8);
+    } else {
+        wanted = (Uint32) value;
+    }
+
+    /* At least two callbacks' worth, like the buffer queue, and a power of 2
+       small enough that twice that still fits in a Uint32. */
+    wanted = SDL_max(wanted, spec->size * 2);
+    for (size = 4096; (size < wanted) && (size < 0x40000000); size *= 2) {
+    }
+    return size;
+}
+
+static SDL_AudioRing *
+SDL_NewAudioRing(const Uint32 size)
+{
+    /* not calloc: touch every page now, so the device thread doesn't fault them in later. */
+    SDL_AudioRing *ring = (SDL_AudioRing *) SDL_malloc(sizeof (SDL_AudioRing) + (size * 2));
+    if (!ring) {
+        return NULL;
+    }
+    SDL_memset(ring, '\0', sizeof (SDL_AudioRing) + (size * 2));
+    ring->buffer = (Uint8 *) (ring + 1);
+    ring->mask = (size * 2) - 1;
+    ring->capacity = size;
+    return ring;
+}
+
+/* Either side may call this. */
+static Uint32
+SDL_CountAudioRing(SDL_AudioRing *ring)
+{
+    const Uint32 write_pos = (Uint32) SDL_AtomicGet(&ring->write_pos);
+    if (SDL_AtomicGet(&ring->clear_pending)) {
+        return write_pos - (Uint32) SDL_AtomicGet(&ring->clear_pos);
+    }
+    return write_pos - (Uint32) SDL_AtomicGet(&ring->read_pos);
+}
+
+/* Called by the producer. Space held by a pending clear doesn't count
+   against the capacity, but isn't free memory until the consumer catches up. */
+static Uint32
+SDL_AudioRingSpace(SDL_AudioRing *ring)
+{
+    const Uint32 unread = (Uint32) SDL_AtomicGet(&ring->write_pos) - (Uint32) SDL_AtomicGet(&ring->read_pos);
+    return SDL_min(ring->capacity - SDL_CountAudioRing(ring), (ring->mask + 1) - unread);
+}
+
+/* Called by the producer. Returns how many bytes fit, which may be less than
+   (len), or 0 if (all_or_nothing) and they don't all fit. */
+static Uint32
+SDL_WriteToAudioRing(SDL_AudioRing *ring, const void *data, const Uint32 len, const SDL_bool all_or_nothing)
+{
+    const Uint32 write_pos = (Uint32) SDL_AtomicGet(&ring->write_pos);
+    const Uint32 space = SDL_AudioRingSpace(ring);
+    const Uint32 offset = write_pos & ring->mask;
+    const Uint32 total = (all_or_nothing && (len > space)) ? 0 : SDL_min(len, space);
+    const Uint32 first = SDL_min(total, (ring->mask + 1) - offset);
+
+    SDL_memcpy(ring->buffer + offset, data, first);
+    SDL_memcpy(ring->buffer, ((const Uint8 *) data) + first, total - first);
+
+    /* the data has to be visible before the consumer sees the new position. */
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&ring->write_pos, (int) (write_pos + total));
+    return total;
+}
+
+/* Called by the consumer. Returns how many bytes were read. */
+static Uint32
+SDL_ReadFromAudioRing(SDL_AudioRing *ring, void *buf, const Uint32 len)
+{
+    Uint32 read_pos = (Uint32) SDL_AtomicGet(&ring->read_pos);
+    Uint32 write_pos, offset, total, first;
+
+    if (SDL_AtomicSet(&ring->clear_pending, 0)) {
+        /* don't go backwards if we already read past a clear we see late. */
+        const Uint32 clear_pos = (Uint32) SDL_AtomicGet(&ring->clear_pos);
+        if ((Sint32) (clear_pos - read_pos) > 0) {
+            read_pos = clear_pos;
+        }
+    }
+
+    /* only load this after the clear, which can point past an older write_pos. */
+    write_pos = (Uint32) SDL_AtomicGet(&ring->write_pos);
+
+    SDL_MemoryBarrierAcquire();
+    offset = read_pos & ring->mask;
+    total = SDL_min(len, write_pos - read_pos);
+    first = SDL_min(total, (ring->mask + 1) - offset);
+
+    if (buf) {
+        SDL_memcpy(buf, ring->buffer + offset, first);
+        SDL_memcpy(((Uint8 *) buf) + first, ring->buffer, total - first);
+    }
+
+    /* we're done with the data before the producer can reuse the space. */
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&ring->read_pos, (int) (read_pos + total));
+    return total;
+}
+
+/* Either side may call this; the consumer drops the data on its next read. */
+static void
+SDL_ClearAudioRing(SDL_AudioRing *ring)
+{
+    SDL_AtomicSet(&ring->clear_pos, SDL_AtomicGet(&ring->write_pos));
+    SDL_AtomicSet(&ring->clear_pending, 1);
+}
+
 static void SDLCALL
 SDL_BufferQueueDrainCallback(void *userdata, Uint8 *stream, int len)
 {
-    /* this function always holds the mixer lock before being called. */
+    /* this function always holds the mixer lock before being called, unless we're using the ring. */
     SDL_AudioDevice *device = (SDL_AudioDevice *) userdata;
     size_t dequeued;
 
@@ -571,13 +860,60 @@ SDL_BufferQueueDrainCallback(void *userdata, Uint8 *stream, int len)
     SDL_assert(!device->iscapture);  /* this shouldn't ever happen, right?! */
     SDL_assert(len >= 0);  /* this shouldn't ever happen, right?! */
 
-    dequeued = SDL_ReadFromDataQueue(device->buffer_queue, stream, len);
+    if (device->ring) {
+        dequeued = SDL_ReadFromAudioRing(device->ring, stream, (Uint32) len);
+    } else {
+        dequeued = SDL_ReadFromDataQueue(device->buffer_queue, stream, len);
+    }
     stream += dequeued;
     len -= (int) dequeued;
 
     if (len > 0) {  /* fill any remaining space in the stream with silence. */
-        SDL_assert(SDL_CountDataQueue(device->buffer_queue) == 0);
+        SDL_assert(device->ring || (SDL_CountDataQueue(device->buffer_queue) == 0));
         SDL_memset(stream, device->callbackspec.silence, len);
+
+        /* every buffer we pad is silence, but it's one underrun until the queue refills. */
+        SDL_CountAudioUnderrun(device, len, &device->callbackspec, (dequeued > 0) || !device->queue_starved);
+        device->queue_starved = SDL_TRUE;
+        SDL_CountQueuedAudio(device, 0);
+    } else {
+        device->queue_starved = SDL_FALSE;
+        SDL_CountQueuedAudio(device, device->ring ? SDL_CountAudioRing(device->ring) : (Uint32) SDL_CountDataQueue(device->buffer_queue));
+    }
+
+    if (current_audio.impl.ProvidesOwnCallbackThread) {
+        SDL_PublishAudioCounters(device);  /* no device thread to do it for us. */
+    }
+}
+
+/* Queued playback that needs converting hands the queued audio to the stream
+   where it sits, instead of copying it out to work_buffer first. This holds
+   the mixer lock, since a write to the queue can move its data. */
+static void
+SDL_BufferQueueDrainToStream(SDL_AudioDevice *device, int len)
+{
+    const int framesize = (SDL_AUDIO_BITSIZE(device->callbackspec.format) / 8) * device->callbackspec.channels;
+
+    while (len > 0) {
+        size_t avail;
+        const void *span = SDL_PeekDataQueueSpan(device->buffer_queue, &avail);
+        int amount = (int) SDL_min(avail, (size_t) len);
+        amount -= amount % framesize;
+        if (amount == 0) {
+            break;  /* out of data, or the next frame wraps around the end of the queue. */
+        }
+        /* if this fails...oh well, like any other stream put. */
+        SDL_AudioStreamPut(device->stream, span, amount);
+        SDL_CommitDataQueueRead(device->buffer_queue, amount);
+        device->queue_starved = SDL_FALSE;
+        len -= amount;
+    }
+
+    if (len > 0) {  /* copy out the rest, padded with silence, the usual way. */
+        SDL_BufferQueueDrainCallback(device, device->work_buffer, len);
+        SDL_AudioStreamPut(device->stream, device->work_buffer, len);
+    } else {
+        SDL_CountQueuedAudio(device, (Uint32) SDL_CountDataQueue(device->buffer_queue));
     }
 }
 
@@ -592,9 +928,54 @@ SDL_BufferQueueFillCallback(void *userdata, Uint8 *stream, int len)
     SDL_assert(len >= 0);  /* this shouldn't ever happen, right?! */
 
     /* note that if this needs to allocate more space and run out of memory,
-       we have no choice but to quietly drop the data and hope it works out
-       later, but you probably have bigger problems in this case anyhow. */
-    SDL_WriteToDataQueue(device->buffer_queue, stream, len);
+       or the ring is full, we have no choice but to quietly drop the data
+       and hope it works out later, but we count it. */
+    if (device->ring) {
+        const Uint32 written = SDL_WriteToAudioRing(device->ring, stream, (Uint32) len, SDL_FALSE);
+        if (written < (Uint32) len) {
+            SDL_CountAudioOverrun(device);
+        }
+        SDL_CountQueuedAudio(device, SDL_CountAudioRing(device->ring));
+    } else {
+        if (SDL_WriteToDataQueue(device->buffer_queue, stream, len) < 0) {
+            SDL_CountAudioOverrun(device);
+        }
+        SDL_CountQueuedAudio(device, (Uint32) SDL_CountDataQueue(device->buffer_queue));
+    }
+
+    if (current_audio.impl.ProvidesOwnCallbackThread) {
+        SDL_PublishAudioCounters(device);  /* no device thread to do it for us. */
+    }
+}
+
+/* More than the whole ring can hold goes in a piece at a time, waiting for
+   the device to play some between pieces. That only works while the device
+   is playing, so this refuses up front if it isn't, and gives up if it
+   stops partway, with whatever fit still queued. */
+static int
+SDL_QueueAudioToRingInPieces(SDL_AudioDevice *device, const Uint8 *data, Uint32 len)
+{
+    const Uint32 framesize = (SDL_AUDIO_BITSIZE(device->callbackspec.format) / 8) * device->callbackspec.channels;
+    const Uint32 wait_ms = SDL_max(1, (device->callbackspec.samples * 1000) / (device->callbackspec.freq * 2));
+
+    if (SDL_AtomicGet(&device->paused) || !SDL_AtomicGet(&device->enabled)) {
+        return SDL_SetError("Audio queue is smaller than the data and the device isn't playing");
+    }
+
+    while (len > 0) {
+        Uint32 amount = SDL_min(len, SDL_AudioRingSpace(device->ring));
+        amount -= amount % framesize;
+        if (amount > 0) {
+            SDL_WriteToAudioRing(device->ring, data, amount, SDL_TRUE);
+            data += amount;
+            len -= amount;
+        } else if (SDL_AtomicGet(&device->paused) || !SDL_AtomicGet(&device->enabled) || SDL_AtomicGet(&device->shutdown)) {
+            return SDL_SetError("Audio queue is full and the device isn't playing");
+        } else {
+            SDL_Delay(wait_ms);
+        }
+    }
+    return 0;
 }
 
 int
@@ -611,7 +992,16 @@ SDL_QueueAudio(SDL_AudioDeviceID devid, const void *data, Uint32 len)
         return SDL_SetError("Audio device has a callback, queueing not allowed");
     }
 
-    if (len > 0) {
+    if (len == 0) {
+        return 0;
+    } else if (device->ring && (len > device->ring->capacity)) {
+        rc = SDL_QueueAudioToRingInPieces(device, (const Uint8 *) data, len);
+    } else if (device->ring) {
+        /* all or nothing, so the app can try again later without splitting a frame. */
+        if (SDL_WriteToAudioRing(device->ring, data, len, SDL_TRUE) == 0) {
+            return SDL_SetError("Audio queue is full");
+        }
+    } else {
         current_audio.impl.LockDevice(device);
         rc = SDL_WriteToDataQueue(device->buffer_queue, data, len);
         current_audio.impl.UnlockDevice(device);
@@ -633,6 +1023,10 @@ SDL_DequeueAudio(SDL_AudioDeviceID devid, void *data, Uint32 len)
         return 0;  /* just report zero bytes dequeued. */
     }
 
+    if (device->ring) {
+        return SDL_ReadFromAudioRing(device->ring, data, len);
+    }
+
     current_audio.impl.LockDevice(device);
     rc = (Uint32) SDL_ReadFromDataQueue(device->buffer_queue, data, len);
     current_audio.impl.UnlockDevice(device);
@@ -650,7 +1044,9 @@ SDL_GetQueuedAudioSize(SDL_AudioDeviceID devid)
     }
 
     /* Nothing to do unless we're set up for queueing. */
-    if (device->callbackspec.callback == SDL_BufferQueueDrainCallback ||
+    if (device->ring) {
+        retval = SDL_CountAudioRing(device->ring);
+    } else if (device->callbackspec.callback == SDL_BufferQueueDrainCallback ||
         device->callbackspec.callback == SDL_BufferQueueFillCallback)
     {
         current_audio.impl.LockDevice(device);
@@ -670,6 +1066,15 @@ SDL_ClearQueuedAudio(SDL_AudioDeviceID devid)
         return;  /* nothing to do. */
     }
 
+    if (device->ring) {
+        if (device->iscapture) {
+            SDL_ReadFromAudioRing(device->ring, NULL, SDL_MAX_UINT32);  /* we're the consumer, just drop it all. */
+        } else {
+            SDL_ClearAudioRing(device->ring);
+        }
+        return;
+    }
+
     /* Blank out the device and release the mutex. Free it afterwards. */
     current_audio.impl.LockDevice(device);
 
@@ -680,6 +1085,21 @@ SDL_ClearQueuedAudio(SDL_AudioDeviceID devid)
 }
 
 
+Uint32
+SDL_GetQueuedAudioXruns(SDL_AudioDeviceID devid)
+{
+    SDL_AudioDevice *device = get_audio_device(devid);
+
+    if (!device) {
+        return 0;
+    } else if (device->callbackspec.callback == SDL_BufferQueueDrainCallback) {
+        return (Uint32) SDL_AtomicGet(&device->underruns);
+    } else if (device->callbackspec.callback == SDL_BufferQueueFillCallback) {
+        return (Uint32) SDL_AtomicGet(&device->overruns);
+    }
+    return 0;
+}
+
 /* The general mixing thread function */
 static int SDLCALL
 SDL_RunAudio(void *devicep)
@@ -688,6 +1108,7 @@ SDL_RunAudio(void *devicep)
     void *udata = device->callbackspec.userdata;
     SDL_AudioCallback callback = device->callbackspec.callback;
     int data_len = 0;
+    SDL_bool streamed;
     Uint8 *data;
 
     SDL_assert(!device->iscapture);
@@ -710,6 +1131,8 @@ SDL_RunAudio(void *devicep)
     /* Loop, filling the audio buffers */
     while (!SDL_AtomicGet(&device->shutdown)) {
         current_audio.impl.BeginLoopIteration(device);
+        SDL_PublishAudioCounters(device);  /* what happened last time through. */
+        streamed = SDL_FALSE;
         data_len = device->callbackspec.size;
 
         /* Fill the current buffer with sound */
@@ -731,23 +1154,45 @@ SDL_RunAudio(void *devicep)
         }
 
         /* !!! FIXME: this should be LockDevice. */
-        SDL_LockMutex(device->mixer_lock);
+        /* the ring never waits on the app, so there's nothing to lock. */
+        if (!device->ring) {
+            SDL_LockMutex(device->mixer_lock);
+        }
         if (SDL_AtomicGet(&device->paused)) {
             SDL_memset(data, device->callbackspec.silence, data_len);
+            if (device->ring) {
+                SDL_ReadFromAudioRing(device->ring, NULL, 0);  /* still catch up with SDL_ClearQueuedAudio() while paused. */
+            }
+        } else if (device->stream && !device->ring && (callback == SDL_BufferQueueDrainCallback)) {
+            const Uint64 start = SDL_GetPerformanceCounter();
+            SDL_BufferQueueDrainToStream(device, data_len);
+            SDL_CountAudioCallback(device, SDL_GetPerformanceCounter() - start);
+            streamed = SDL_TRUE;
         } else {
+            const Uint64 start = SDL_GetPerformanceCounter();
             callback(udata, data, data_len);
+            SDL_CountAudioCallback(device, SDL_GetPerformanceCounter() - start);
+        }
+        if (!device->ring) {
+            SDL_UnlockMutex(device->mixer_lock);
         }
-        SDL_UnlockMutex(device->mixer_lock);
 
         if (device->stream) {
             /* Stream available audio to device, converting/resampling. */
             /* if this fails...oh well. We'll play silence here. */
-            SDL_AudioStreamPut(device->stream, data, data_len);
+            Uint64 start = SDL_GetPerformanceCounter();
+            Uint64 converting;
+            if (!streamed) {
+                SDL_AudioStreamPut(device->stream, data, data_len);
+            }
+            converting = SDL_GetPerformanceCounter() - start;
 
             while (SDL_AudioStreamAvailable(device->stream) >= ((int) device->spec.size)) {
                 int got;
                 data = SDL_AtomicGet(&device->enabled) ? current_audio.impl.GetDeviceBuf(device) : NULL;
+                start = SDL_GetPerformanceCounter();
                 got = SDL_AudioStreamGet(device->stream, data ? data : device->work_buffer, device->spec.size);
+                converting += SDL_GetPerformanceCounter() - start;
                 SDL_assert((got < 0) || (got == device->spec.size));
 
                 if (data == NULL) {  /* device is having issues... */
@@ -756,11 +1201,16 @@ SDL_RunAudio(void *devicep)
                 } else {
                     if (got != device->spec.size) {
                         SDL_memset(data, device->spec.silence, device->spec.size);
+                        /* don't count it twice if the queue already ran dry for this buffer. */
+                        if (!device->queue_starved) {
+                            SDL_CountAudioUnderrun(device, device->spec.size, &device->spec, SDL_TRUE);
+                        }
                     }
                     current_audio.impl.PlayDevice(device);
                     current_audio.impl.WaitDevice(device);
                 }
             }
+            SDL_CountAudioConversion(device, converting);
         } else if (data == device->work_buffer) {
             /* nothing to do; pause like we queued a buffer to play. */
             const Uint32 delay = ((device->spec.samples * 1000) / device->spec.freq);
@@ -816,8 +1266,10 @@ SDL_CaptureAudio(void *devicep)
     while (!SDL_AtomicGet(&device->shutdown)) {
         int still_need;
         Uint8 *ptr;
+        Uint64 start, converting;
 
         current_audio.impl.BeginLoopIteration(device);
+        SDL_PublishAudioCounters(device);  /* what happened last time through. */
 
         if (SDL_AtomicGet(&device->paused)) {
             SDL_Delay(delay);  /* just so we don't cook the CPU. */
@@ -860,33 +1312,52 @@ SDL_CaptureAudio(void *devicep)
         if (still_need > 0) {
             /* Keep any data we already read, silence the rest. */
             SDL_memset(ptr, silence, still_need);
+            SDL_CountAudioUnderrun(device, still_need, &device->spec, SDL_TRUE);
         }
 
         if (device->stream) {
             /* if this fails...oh well. */
+            start = SDL_GetPerformanceCounter();
             SDL_AudioStreamPut(device->stream, data, data_len);
+            converting = SDL_GetPerformanceCounter() - start;
 
             while (SDL_AudioStreamAvailable(device->stream) >= ((int) device->callbackspec.size)) {
-                const int got = SDL_AudioStreamGet(device->stream, device->work_buffer, device->callbackspec.size);
+                int got;
+                start = SDL_GetPerformanceCounter();
+                got = SDL_AudioStreamGet(device->stream, device->work_buffer, device->callbackspec.size);
+                converting += SDL_GetPerformanceCounter() - start;
                 SDL_assert((got < 0) || (got == device->callbackspec.size));
                 if (got != device->callbackspec.size) {
                     SDL_memset(device->work_buffer, device->spec.silence, device->callbackspec.size);
                 }
 
                 /* !!! FIXME: this should be LockDevice. */
-                SDL_LockMutex(device->mixer_lock);
+                if (!device->ring) {
+                    SDL_LockMutex(device->mixer_lock);
+                }
                 if (!SDL_AtomicGet(&device->paused)) {
+                    start = SDL_GetPerformanceCounter();
                     callback(udata, device->work_buffer, device->callbackspec.size);
+                    SDL_CountAudioCallback(device, SDL_GetPerformanceCounter() - start);
+                }
+                if (!device->ring) {
+                    SDL_UnlockMutex(device->mixer_lock);
                 }
-                SDL_UnlockMutex(device->mixer_lock);
             }
+            SDL_CountAudioConversion(device, converting);
         } else {  /* feeding user callback directly without streaming. */
             /* !!! FIXME: this should be LockDevice. */
-            SDL_LockMutex(device->mixer_lock);
+            if (!device->ring) {
+                SDL_LockMutex(device->mixer_lock);
+            }
             if (!SDL_AtomicGet(&device->paused)) {
+                start = SDL_GetPerformanceCounter();
                 callback(udata, data, device->callbackspec.size);
+                SDL_CountAudioCallback(device, SDL_GetPerformanceCounter() - start);
+            }
+            if (!device->ring) {
+                SDL_UnlockMutex(device->mixer_lock);
             }
-            SDL_UnlockMutex(device->mixer_lock);
         }
     }
 
@@ -1147,6 +1618,7 @@ close_audio_device(SDL_AudioDevice * device)
     }
 
     SDL_FreeDataQueue(device->buffer_queue);
+    SDL_free(device->ring);
 
     SDL_free(device);
 }
@@ -1411,13 +1883,24 @@ open_audio_device(const char *devname, int iscapture,
     }
 
     if (device->spec.callback == NULL) {  /* use buffer queueing? */
-        /* pool a few packets to start. Enough for two callbacks. */
-        device->buffer_queue = SDL_NewDataQueue(SDL_AUDIOBUFFERQUEUE_PACKETLEN, obtained->size * 2);
-        if (!device->buffer_queue) {
-            close_audio_device(device);
-            SDL_SetError("Couldn't create audio buffer queue");
-            return 0;
+        const Uint32 ringsize = SDL_GetAudioRingSize(SDL_GetHint(SDL_HINT_AUDIO_QUEUE_LOCKFREE), obtained);
+        if (ringsize > 0) {
+            device->ring = SDL_NewAudioRing(ringsize);
+            if (!device->ring) {
+                close_audio_device(device);
+                SDL_OutOfMemory();
+                return 0;
+            }
+        } else {
+            /* pool a few packets to start. Enough for two callbacks. */
+            device->buffer_queue = SDL_NewDataQueue(SDL_AUDIOBUFFERQUEUE_PACKETLEN, obtained->size * 2);
+            if (!device->buffer_queue) {
+                close_audio_device(device);
+                SDL_SetError("Couldn't create audio buffer queue");
+                return 0;
+            }
         }
+        device->queue_starved = SDL_TRUE;  /* nothing queued yet, that's not an underrun. */
         device->callbackspec.callback = iscapture ? SDL_BufferQueueFillCallback : SDL_BufferQueueDrainCallback;
         device->callbackspec.userdata = device;
     }
@@ -34,6 +34,25 @@
 #define LOG_DEBUG_CONVERT(from, to)
 #endif
 
+#ifdef __SSE2__
+#define HAVE_SSE2_INTRINSICS 1
+#endif
+
+#ifdef __ARM_NEON
+#define HAVE_NEON_INTRINSICS 1
+#endif
+
+/* AVX, AVX2 and AVX-512 code is compiled per-function, so it's available even
+   if the rest of SDL isn't built for it. It's only used if SDL_HasAVX() (etc)
+   says the CPU can run it. */
+#if defined(HAVE_IMMINTRIN_H) && !defined(SDL_DISABLE_IMMINTRIN_H) && \
+    (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_AVX_INTRINSICS 1
+#define HAVE_AVX2_INTRINSICS 1
+#define HAVE_AVX512F_INTRINSICS 1
+#define SDL_TARGETING(x) __attribute__((target(x)))
+#endif
+
 /* Functions and variables exported from SDL_audio.c for SDL_sysaudio.c */
 
 #ifdef HAVE_LIBSAMPLERATE_H
@@ -58,6 +77,12 @@ extern void SDL_CalculateAudioSpec(SDL_AudioSpec * spec);
 /* Choose the audio filter functions below */
 extern void SDL_ChooseAudioConverters(void);
 
+/* Not public: forces one tier of converters ("scalar", "sse2", "neon", "avx2"
+   or "avx512f") so the tests can check each against the scalar ones. Only
+   audio converters built after it changes use the new tier. */
+#define SDL_HINT_AUDIO_CONVERTERS "SDL_AUDIO_CONVERTERS"
+
+
 /* These pointers get set during SDL_ChooseAudioConverters() to various SIMD implementations. */
 extern SDL_AudioFilter SDL_Convert_S8_to_F32;
 extern SDL_AudioFilter SDL_Convert_U8_to_F32;
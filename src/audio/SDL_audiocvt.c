@@ -31,10 +31,15 @@
 
 #include "SDL_loadso.h"
 #include "../SDL_dataqueue.h"
+#include "../thread/SDL_systhread.h"
 #include "SDL_cpuinfo.h"
 
 #define DEBUG_AUDIOSTREAM 0
 
+#ifdef __SSE__
+#define HAVE_SSE_INTRINSICS 1
+#endif
+
 #ifdef __SSE3__
 #define HAVE_SSE3_INTRINSICS 1
 #endif
@@ -322,113 +327,944 @@ SDL_ConvertStereoToQuad(SDL_AudioCVT * cvt, SDL_AudioFormat format)
         dst[3] = rf;  /* BR */
     }
 
-    cvt->len_cvt *= 2;
-    if (cvt->filters[++cvt->filter_index]) {
-        cvt->filters[cvt->filter_index] (cvt, format);
+    cvt->len_cvt *= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, format);
+    }
+}
+
+
+/* Upmix 5.1 to 7.1 */
+static void SDLCALL
+SDL_Convert51To71(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    float lf, rf, lb, rb, ls, rs;
+    int i;
+    const float *src = (const float *) (cvt->buf + cvt->len_cvt);
+    float *dst = (float *) (cvt->buf + cvt->len_cvt * 4 / 3);
+
+    LOG_DEBUG_CONVERT("5.1", "7.1");
+    SDL_assert(format == AUDIO_F32SYS);
+    SDL_assert(cvt->len_cvt % (sizeof(float) * 6) == 0);
+
+    for (i = cvt->len_cvt / (sizeof(float) * 6); i; --i) {
+        dst -= 8;
+        src -= 6;
+        lf = src[0];
+        rf = src[1];
+        lb = src[4];
+        rb = src[5];
+        ls = (lf + lb) * 0.5f;
+        rs = (rf + rb) * 0.5f;
+        /* !!! FIXME: these four may clip */
+        lf += lf - ls;
+        rf += rf - rs;
+        lb += lb - ls;
+        rb += rb - rs;
+        dst[3] = src[3];  /* LFE */
+        dst[2] = src[2];  /* FC */
+        dst[7] = rs; /* SR */
+        dst[6] = ls; /* SL */
+        dst[5] = rb;  /* BR */
+        dst[4] = lb;  /* BL */
+        dst[1] = rf;  /* FR */
+        dst[0] = lf;  /* FL */
+    }
+
+    cvt->len_cvt = cvt->len_cvt * 4 / 3;
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, format);
+    }
+}
+
+#if HAVE_SSE_INTRINSICS
+/* SSE versions of the channel converters above. Each does exactly the same
+   arithmetic per sample as the scalar version, just on several samples at
+   once, so the output is identical. Frames are shuffled straight from the
+   interleaved buffer; channels that the scalar code doesn't add anything to
+   get -0.0f added, which leaves every value (even -0.0f) unchanged. */
+
+/* Convert from 5.1 to stereo. Average left and right, distribute center, discard LFE. */
+static void SDLCALL
+SDL_Convert51ToStereo_SSE(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    float *dst = (float *) cvt->buf;
+    const float *src = dst;
+    int i = cvt->len_cvt / (sizeof (float) * 6);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 divisor = _mm_set1_ps(2.5f);
+
+    LOG_DEBUG_CONVERT("5.1", "stereo (using SSE)");
+    SDL_assert(format == AUDIO_F32SYS);
+
+    /* Two frames at a time: FL FR FC LFE | BL BR FL FR | FC LFE BL BR */
+    while (i >= 2) {
+        const __m128 a = _mm_loadu_ps(src);
+        const __m128 b = _mm_loadu_ps(src + 4);
+        const __m128 c = _mm_loadu_ps(src + 8);
+        const __m128 front = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 2, 1, 0));
+        const __m128 center = _mm_mul_ps(_mm_shuffle_ps(a, c, _MM_SHUFFLE(0, 0, 2, 2)), half);
+        const __m128 back = _mm_shuffle_ps(b, c, _MM_SHUFFLE(3, 2, 1, 0));
+        _mm_storeu_ps(dst, _mm_div_ps(_mm_add_ps(_mm_add_ps(front, center), back), divisor));
+        i -= 2; src += 12; dst += 4;
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    if (i) {
+        const float front_center_distributed = src[2] * 0.5f;
+        dst[0] = (src[0] + front_center_distributed + src[4]) / 2.5f;  /* left */
+        dst[1] = (src[1] + front_center_distributed + src[5]) / 2.5f;  /* right */
+    }
+
+    cvt->len_cvt /= 3;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, format);
+    }
+}
+
+/* Convert from quad to stereo. Average left and right. */
+static void SDLCALL
+SDL_ConvertQuadToStereo_SSE(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    float *dst = (float *) cvt->buf;
+    const float *src = dst;
+    int i = cvt->len_cvt / (sizeof (float) * 4);
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    LOG_DEBUG_CONVERT("quad", "stereo (using SSE)");
+    SDL_assert(format == AUDIO_F32SYS);
+
+    while (i >= 2) {
+        const __m128 a = _mm_loadu_ps(src);
+        const __m128 b = _mm_loadu_ps(src + 4);
+        const __m128 front = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m128 back = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 2, 3, 2));
+        _mm_storeu_ps(dst, _mm_mul_ps(_mm_add_ps(front, back), half));
+        i -= 2; src += 8; dst += 4;
+    }
+
+    if (i) {
+        dst[0] = (src[0] + src[2]) * 0.5f; /* left */
+        dst[1] = (src[1] + src[3]) * 0.5f; /* right */
+    }
+
+    cvt->len_cvt /= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, format);
+    }
+}
+
+/* Convert from 7.1 to 5.1. Distribute sides across front and back. */
+static void SDLCALL
+SDL_Convert71To51_SSE(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    float *dst = (float *) cvt->buf;
+    const float *src = dst;
+    int i = cvt->len_cvt / (sizeof (float) * 8);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 divisor = _mm_set1_ps(1.5f);
+    const __m128 negzero = _mm_set1_ps(-0.0f);
+
+    LOG_DEBUG_CONVERT("7.1", "5.1 (using SSE)");
+    SDL_assert(format == AUDIO_F32SYS);
+
+    /* Each frame is FL FR FC LFE | BL BR SL SR; two frames make three
+       vectors of output. */
+    while (i >= 2) {
+        const __m128 front0 = _mm_loadu_ps(src);
+        const __m128 back0 = _mm_loadu_ps(src + 4);
+        const __m128 front1 = _mm_loadu_ps(src + 8);
+        const __m128 back1 = _mm_loadu_ps(src + 12);
+        const __m128 sides0 = _mm_mul_ps(_mm_movehl_ps(back0, back0), half);
+        const __m128 sides1 = _mm_mul_ps(_mm_movehl_ps(back1, back1), half);
+        const __m128 out_front0 = _mm_div_ps(_mm_add_ps(front0, _mm_movelh_ps(sides0, negzero)), divisor);
+        const __m128 out_back0 = _mm_div_ps(_mm_add_ps(back0, sides0), divisor);
+        const __m128 out_front1 = _mm_div_ps(_mm_add_ps(front1, _mm_movelh_ps(sides1, negzero)), divisor);
+        const __m128 out_back1 = _mm_div_ps(_mm_add_ps(back1, sides1), divisor);
+        _mm_storeu_ps(dst, out_front0);
+        _mm_storeu_ps(dst + 4, _mm_movelh_ps(out_back0, out_front1));
+        _mm_storeu_ps(dst + 8, _mm_shuffle_ps(out_front1, out_back1, _MM_SHUFFLE(1, 0, 3, 2)));
+        i -= 2; src += 16; dst += 12;
+    }
+
+    if (i) {
+        const float surround_left_distributed = src[6] * 0.5f;
+        const float surround_right_distributed = src[7] * 0.5f;
+        dst[0] = (src[0] + surround_left_distributed) / 1.5f;  /* FL */
+        dst[1] = (src[1] + surround_right_distributed) / 1.5f;  /* FR */
+        dst[2] = src[2] / 1.5f; /* CC */
+        dst[3] = src[3] / 1.5f; /* LFE */
+        dst[4] = (src[4] + surround_left_distributed) / 1.5f;  /* BL */
+        dst[5] = (src[5] + surround_right_distributed) / 1.5f;  /* BR */
+    }
+
+    cvt->len_cvt /= 8;
+    cvt->len_cvt *= 6;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, format);
+    }
+}
+
+/* Convert from 5.1 to quad. Distribute center across front, discard LFE. */
+static void SDLCALL
+SDL_Convert51ToQuad_SSE(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    float *dst = (float *) cvt->buf;
+    const float *src = dst;
+    int i = cvt->len_cvt / (sizeof (float) * 6);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 divisor = _mm_set1_ps(1.5f);
+    const __m128 negzero = _mm_set1_ps(-0.0f);
+
+    LOG_DEBUG_CONVERT("5.1", "quad (using SSE)");
+    SDL_assert(format == AUDIO_F32SYS);
+
+    /* Two frames at a time: FL FR FC LFE | BL BR FL FR | FC LFE BL BR */
+    while (i >= 2) {
+        const __m128 a = _mm_loadu_ps(src);
+        const __m128 b = _mm_loadu_ps(src + 4);
+        const __m128 c = _mm_loadu_ps(src + 8);
+        const __m128 quad0 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m128 quad1 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m128 centers = _mm_mul_ps(_mm_shuffle_ps(a, c, _MM_SHUFFLE(0, 0, 2, 2)), half);
+        const __m128 center0 = _mm_shuffle_ps(centers, negzero, _MM_SHUFFLE(0, 0, 0, 0));
+        const __m128 center1 = _mm_shuffle_ps(centers, negzero, _MM_SHUFFLE(0, 0, 2, 2));
+        _mm_storeu_ps(dst, _mm_div_ps(_mm_add_ps(quad0, center0), divisor));
+        _mm_storeu_ps(dst + 4, _mm_div_ps(_mm_add_ps(quad1, center1), divisor));
+        i -= 2; src += 12; dst += 8;
+    }
+
+    if (i) {
+        const float front_center_distributed = src[2] * 0.5f;
+        dst[0] = (src[0] + front_center_distributed) / 1.5f;  /* FL */
+        dst[1] = (src[1] + front_center_distributed) / 1.5f;  /* FR */
+        dst[2] = src[4] / 1.5f;  /* BL */
+        dst[3] = src[5] / 1.5f;  /* BR */
+    }
+
+    cvt->len_cvt /= 6;
+    cvt->len_cvt *= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, format);
+    }
+}
+
+/* Upmix mono to stereo (by duplication) */
+static void SDLCALL
+SDL_ConvertMonoToStereo_SSE(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) (cvt->buf + cvt->len_cvt);
+    float *dst = (float *) (cvt->buf + cvt->len_cvt * 2);
+    int i = cvt->len_cvt / sizeof (float);
+
+    LOG_DEBUG_CONVERT("mono", "stereo (using SSE)");
+    SDL_assert(format == AUDIO_F32SYS);
+
+    /* The upmixers work back to front, so they don't overwrite frames they haven't read yet. */
+    while (i >= 4) {
+        __m128 v;
+        src -= 4;
+        dst -= 8;
+        v = _mm_loadu_ps(src);
+        _mm_storeu_ps(dst, _mm_unpacklo_ps(v, v));
+        _mm_storeu_ps(dst + 4, _mm_unpackhi_ps(v, v));
+        i -= 4;
+    }
+
+    while (i) {
+        src--;
+        dst -= 2;
+        dst[0] = dst[1] = *src;
+        i--;
+    }
+
+    cvt->len_cvt *= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, format);
+    }
+}
+
+/* Upmix stereo to a pseudo-5.1 stream */
+static void SDLCALL
+SDL_ConvertStereoTo51_SSE(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) (cvt->buf + cvt->len_cvt);
+    float *dst = (float *) (cvt->buf + cvt->len_cvt * 3);
+    int i = cvt->len_cvt / (sizeof(float) * 2);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 zero = _mm_setzero_ps();
+
+    LOG_DEBUG_CONVERT("stereo", "5.1 (using SSE)");
+    SDL_assert(format == AUDIO_F32SYS);
+
+    while (i >= 2) {
+        __m128 v, ce, front, ce_lfe0, ce_lfe1;
+        src -= 4;
+        dst -= 12;
+        v = _mm_loadu_ps(src);  /* L0 R0 L1 R1 */
+        ce = _mm_mul_ps(_mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1))), half);
+        front = _mm_add_ps(v, _mm_sub_ps(v, ce));
+        ce_lfe0 = _mm_unpacklo_ps(ce, zero);  /* FC0 0 FC0 0 */
+        ce_lfe1 = _mm_unpackhi_ps(ce, zero);  /* FC1 0 FC1 0 */
+        _mm_storeu_ps(dst, _mm_movelh_ps(front, ce_lfe0));
+        _mm_storeu_ps(dst + 4, _mm_shuffle_ps(v, front, _MM_SHUFFLE(3, 2, 1, 0)));
+        _mm_storeu_ps(dst + 8, _mm_shuffle_ps(ce_lfe1, v, _MM_SHUFFLE(3, 2, 1, 0)));
+        i -= 2;
+    }
+
+    if (i) {
+        const float lf = src[-2];
+        const float rf = src[-1];
+        const float ce = (lf + rf) * 0.5f;
+        dst -= 6;
+        dst[0] = lf + (lf - ce);  /* FL */
+        dst[1] = rf + (rf - ce);  /* FR */
+        dst[2] = ce;  /* FC */
+        dst[3] = 0;   /* LFE (only meant for special LFE effects) */
+        dst[4] = lf;  /* BL */
+        dst[5] = rf;  /* BR */
+    }
+
+    cvt->len_cvt *= 3;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, format);
+    }
+}
+
+/* Upmix quad to a pseudo-5.1 stream */
+static void SDLCALL
+SDL_ConvertQuadTo51_SSE(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) (cvt->buf + cvt->len_cvt);
+    float *dst = (float *) (cvt->buf + cvt->len_cvt * 3 / 2);
+    int i = cvt->len_cvt / (sizeof(float) * 4);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 zero = _mm_setzero_ps();
+
+    LOG_DEBUG_CONVERT("quad", "5.1 (using SSE)");
+    SDL_assert(format == AUDIO_F32SYS);
+    SDL_assert(cvt->len_cvt % (sizeof(float) * 4) == 0);
+
+    while (i >= 2) {
+        __m128 a, b, v, ce, front, ce_lfe0, ce_lfe1;
+        src -= 8;
+        dst -= 12;
+        a = _mm_loadu_ps(src);  /* FL0 FR0 BL0 BR0 */
+        b = _mm_loadu_ps(src + 4);  /* FL1 FR1 BL1 BR1 */
+        v = _mm_movelh_ps(a, b);
+        ce = _mm_mul_ps(_mm_add_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1))), half);
+        front = _mm_add_ps(v, _mm_sub_ps(v, ce));
+        ce_lfe0 = _mm_unpacklo_ps(ce, zero);
+        ce_lfe1 = _mm_unpackhi_ps(ce, zero);
+        _mm_storeu_ps(dst, _mm_movelh_ps(front, ce_lfe0));
+        _mm_storeu_ps(dst + 4, _mm_shuffle_ps(a, front, _MM_SHUFFLE(3, 2, 3, 2)));
+        _mm_storeu_ps(dst + 8, _mm_shuffle_ps(ce_lfe1, b, _MM_SHUFFLE(3, 2, 1, 0)));
+        i -= 2;
+    }
+
+    if (i) {
+        const float lf = src[-4];
+        const float rf = src[-3];
+        const float lb = src[-2];
+        const float rb = src[-1];
+        const float ce = (lf + rf) * 0.5f;
+        dst -= 6;
+        dst[0] = lf + (lf - ce);  /* FL */
+        dst[1] = rf + (rf - ce);  /* FR */
+        dst[2] = ce;  /* FC */
+        dst[3] = 0;   /* LFE (only meant for special LFE effects) */
+        dst[4] = lb;  /* BL */
+        dst[5] = rb;  /* BR */
+    }
+
+    cvt->len_cvt = cvt->len_cvt * 3 / 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, format);
+    }
+}
+
+/* Upmix stereo to a pseudo-4.0 stream (by duplication) */
+static void SDLCALL
+SDL_ConvertStereoToQuad_SSE(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) (cvt->buf + cvt->len_cvt);
+    float *dst = (float *) (cvt->buf + cvt->len_cvt * 2);
+    int i = cvt->len_cvt / (sizeof(float) * 2);
+
+    LOG_DEBUG_CONVERT("stereo", "quad (using SSE)");
+    SDL_assert(format == AUDIO_F32SYS);
+
+    while (i >= 2) {
+        __m128 v;
+        src -= 4;
+        dst -= 8;
+        v = _mm_loadu_ps(src);
+        _mm_storeu_ps(dst, _mm_movelh_ps(v, v));
+        _mm_storeu_ps(dst + 4, _mm_movehl_ps(v, v));
+        i -= 2;
+    }
+
+    if (i) {
+        const float lf = src[-2];
+        const float rf = src[-1];
+        dst -= 4;
+        dst[0] = lf;  /* FL */
+        dst[1] = rf;  /* FR */
+        dst[2] = lf;  /* BL */
+        dst[3] = rf;  /* BR */
+    }
+
+    cvt->len_cvt *= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, format);
+    }
+}
+
+/* Upmix 5.1 to 7.1 */
+static void SDLCALL
+SDL_Convert51To71_SSE(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) (cvt->buf + cvt->len_cvt);
+    float *dst = (float *) (cvt->buf + cvt->len_cvt * 4 / 3);
+    int i = cvt->len_cvt / (sizeof(float) * 6);
+    const __m128 half = _mm_set1_ps(0.5f);
+
+    LOG_DEBUG_CONVERT("5.1", "7.1 (using SSE)");
+    SDL_assert(format == AUDIO_F32SYS);
+    SDL_assert(cvt->len_cvt % (sizeof(float) * 6) == 0);
+
+    /* Two frames at a time: FL FR FC LFE | BL BR FL FR | FC LFE BL BR.
+       The corners of each frame are gathered into one FL FR BL BR vector. */
+    while (i >= 2) {
+        __m128 a, b, c, corners0, corners1, sides0, sides1;
+        src -= 12;
+        dst -= 16;
+        a = _mm_loadu_ps(src);
+        b = _mm_loadu_ps(src + 4);
+        c = _mm_loadu_ps(src + 8);
+        corners0 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 1, 0));
+        corners1 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(3, 2, 3, 2));
+        sides0 = _mm_mul_ps(_mm_add_ps(corners0, _mm_shuffle_ps(corners0, corners0, _MM_SHUFFLE(1, 0, 3, 2))), half);
+        sides1 = _mm_mul_ps(_mm_add_ps(corners1, _mm_shuffle_ps(corners1, corners1, _MM_SHUFFLE(1, 0, 3, 2))), half);
+        corners0 = _mm_add_ps(corners0, _mm_sub_ps(corners0, sides0));
+        corners1 = _mm_add_ps(corners1, _mm_sub_ps(corners1, sides1));
+        _mm_storeu_ps(dst, _mm_shuffle_ps(corners0, a, _MM_SHUFFLE(3, 2, 1, 0)));
+        _mm_storeu_ps(dst + 4, _mm_shuffle_ps(corners0, sides0, _MM_SHUFFLE(1, 0, 3, 2)));
+        _mm_storeu_ps(dst + 8, _mm_shuffle_ps(corners1, c, _MM_SHUFFLE(1, 0, 1, 0)));
+        _mm_storeu_ps(dst + 12, _mm_shuffle_ps(corners1, sides1, _MM_SHUFFLE(1, 0, 3, 2)));
+        i -= 2;
+    }
+
+    if (i) {
+        float lf, rf, lb, rb, ls, rs;
+        dst -= 8;
+        src -= 6;
+        lf = src[0];
+        rf = src[1];
+        lb = src[4];
+        rb = src[5];
+        ls = (lf + lb) * 0.5f;
+        rs = (rf + rb) * 0.5f;
+        lf += lf - ls;
+        rf += rf - rs;
+        lb += lb - ls;
+        rb += rb - rs;
+        dst[3] = src[3];  /* LFE */
+        dst[2] = src[2];  /* FC */
+        dst[7] = rs; /* SR */
+        dst[6] = ls; /* SL */
+        dst[5] = rb;  /* BR */
+        dst[4] = lb;  /* BL */
+        dst[1] = rf;  /* FR */
+        dst[0] = lf;  /* FL */
+    }
+
+    cvt->len_cvt = cvt->len_cvt * 4 / 3;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, format);
+    }
+}
+#endif
+
+/* SDL's resampler uses a "bandlimited interpolation" algorithm:
+     https://ccrma.stanford.edu/~jos/resample/ */
+
+#define RESAMPLER_ZERO_CROSSINGS 5
+#define RESAMPLER_BITS_PER_SAMPLE 16
+#define RESAMPLER_SAMPLES_PER_ZERO_CROSSING  (1 << ((RESAMPLER_BITS_PER_SAMPLE / 2) + 1))
+#define RESAMPLER_FILTER_SIZE ((RESAMPLER_SAMPLES_PER_ZERO_CROSSING * RESAMPLER_ZERO_CROSSINGS) + 1)
+
+/* SDL_RESAMPLER_QUALITY_SHORT_SINC uses a cheaper filter with fewer zero crossings. */
+#define RESAMPLER_SHORT_ZERO_CROSSINGS 2
+#define RESAMPLER_SHORT_FILTER_SIZE ((RESAMPLER_SAMPLES_PER_ZERO_CROSSING * RESAMPLER_SHORT_ZERO_CROSSINGS) + 1)
+#define RESAMPLER_SHORT_TAPS (2 * (RESAMPLER_SHORT_ZERO_CROSSINGS + 1))
+
+/* This is a "modified" bessel function, so you can't use POSIX j0() */
+static double
+bessel(const double x)
+{
+    const double xdiv2 = x / 2.0;
+    double i0 = 1.0f;
+    double f = 1.0f;
+    int i = 1;
+
+    while (SDL_TRUE) {
+        const double diff = SDL_pow(xdiv2, i * 2) / SDL_pow(f, 2);
+        if (diff < 1.0e-21f) {
+            break;
+        }
+        i0 += diff;
+        i++;
+        f *= (double) i;
+    }
+
+    return i0;
+}
+
+/* build kaiser table with cardinal sine applied to it, and array of differences between elements. */
+static void
+kaiser_and_sinc(float *table, float *diffs, const int tablelen, const double beta)
+{
+    const int lenm1 = tablelen - 1;
+    const int lenm1div2 = lenm1 / 2;
+    int i;
+
+    table[0] = 1.0f;
+    for (i = 1; i < tablelen; i++) {
+        const double kaiser = bessel(beta * SDL_sqrt(1.0 - SDL_pow(((i - lenm1) / 2.0) / lenm1div2, 2.0))) / bessel(beta);
+        table[tablelen - i] = (float) kaiser;
+    }
+
+    for (i = 1; i < tablelen; i++) {
+        const float x = (((float) i) / ((float) RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) * ((float) M_PI);
+        table[i] *= SDL_sinf(x) / x;
+        diffs[i - 1] = table[i] - table[i - 1];
+    }
+    diffs[lenm1] = 0.0f;
+}
+
+
+/* The filter reaches this many input frames to either side of an output
+   frame, so every output frame is a dot product over a fixed window of
+   RESAMPLER_TAPS input frames. Taps the current phase doesn't use get a
+   zero coefficient. */
+#define RESAMPLER_TAPS (2 * (RESAMPLER_ZERO_CROSSINGS + 1))
+
+/* SIMD kernels resample one output frame from a window of RESAMPLER_TAPS
+   interleaved input frames and RESAMPLER_TAPS coefficients.
+   They compute the coefficients in single precision and sum in a different
+   order than the scalar code, so results differ from it by a few ULPs: for
+   input in the [-1, 1] range, by less than 1.0e-6. */
+typedef void (*SDL_ResampleFrameFunc)(const float *window, const float *coefs, float *dst);
+
+#define RESAMPLER_MAX_SIMD_CHANNELS 8
+static SDL_ResampleFrameFunc ResampleFrameFuncs[RESAMPLER_MAX_SIMD_CHANNELS + 1];
+
+#if HAVE_SSE_INTRINSICS
+static void
+SDL_ResampleFrame_c1_SSE(const float *window, const float *coefs, float *dst)
+{
+    __m128 acc = _mm_mul_ps(_mm_loadu_ps(window), _mm_loadu_ps(coefs));
+    acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(window + 4), _mm_loadu_ps(coefs + 4)));
+    acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(window + 8), _mm_loadu_ps(coefs + 8)));
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1, 1, 1, 1)));
+    _mm_store_ss(dst, acc);
+}
+
+static void
+SDL_ResampleFrame_c2_SSE(const float *window, const float *coefs, float *dst)
+{
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    int i;
+
+    for (i = 0; i < RESAMPLER_TAPS; i += 4, window += 8) {
+        const __m128 c = _mm_loadu_ps(coefs + i);
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(window), _mm_unpacklo_ps(c, c)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(window + 4), _mm_unpackhi_ps(c, c)));
+    }
+    acc0 = _mm_add_ps(acc0, acc1);
+    acc0 = _mm_add_ps(acc0, _mm_movehl_ps(acc0, acc0));
+    _mm_storel_pi((__m64 *) dst, acc0);
+}
+
+static void
+SDL_ResampleFrame_c4_SSE(const float *window, const float *coefs, float *dst)
+{
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    int i;
+
+    for (i = 0; i < RESAMPLER_TAPS; i += 2, window += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(window), _mm_set1_ps(coefs[i])));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(window + 4), _mm_set1_ps(coefs[i + 1])));
+    }
+    _mm_storeu_ps(dst, _mm_add_ps(acc0, acc1));
+}
+
+static void
+SDL_ResampleFrame_c6_SSE(const float *window, const float *coefs, float *dst)
+{
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    int i;
+
+    for (i = 0; i < RESAMPLER_TAPS; i++, window += 6) {
+        const __m128 c = _mm_set1_ps(coefs[i]);
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(window), c));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *) (window + 4)), c));
+    }
+    _mm_storeu_ps(dst, acc0);
+    _mm_storel_pi((__m64 *) (dst + 4), acc1);
+}
+
+static void
+SDL_ResampleFrame_c8_SSE(const float *window, const float *coefs, float *dst)
+{
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    int i;
+
+    for (i = 0; i < RESAMPLER_TAPS; i++, window += 8) {
+        const __m128 c = _mm_set1_ps(coefs[i]);
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(window), c));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(window + 4), c));
+    }
+    _mm_storeu_ps(dst, acc0);
+    _mm_storeu_ps(dst + 4, acc1);
+}
+#endif
+
+#if HAVE_AVX_INTRINSICS
+SDL_TARGETING("avx") static void
+SDL_ResampleFrame_c2_AVX(const float *window, const float *coefs, float *dst)
+{
+    __m256 acc = _mm256_setzero_ps();
+    __m128 sum;
+    int i;
+
+    for (i = 0; i < RESAMPLER_TAPS; i += 4, window += 8) {
+        const __m128 c = _mm_loadu_ps(coefs + i);
+        const __m256 cc = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_unpacklo_ps(c, c)), _mm_unpackhi_ps(c, c), 1);
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(window), cc));
+    }
+    sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    _mm_storel_pi((__m64 *) dst, sum);
+}
+
+SDL_TARGETING("avx") static void
+SDL_ResampleFrame_c4_AVX(const float *window, const float *coefs, float *dst)
+{
+    __m256 acc = _mm256_setzero_ps();
+    int i;
+
+    for (i = 0; i < RESAMPLER_TAPS; i += 2, window += 8) {
+        const __m256 cc = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_set1_ps(coefs[i])), _mm_set1_ps(coefs[i + 1]), 1);
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(window), cc));
+    }
+    _mm_storeu_ps(dst, _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1)));
+}
+
+SDL_TARGETING("avx") static void
+SDL_ResampleFrame_c8_AVX(const float *window, const float *coefs, float *dst)
+{
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    int i;
+
+    for (i = 0; i < RESAMPLER_TAPS; i += 2, window += 16) {
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(_mm256_loadu_ps(window), _mm256_set1_ps(coefs[i])));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(_mm256_loadu_ps(window + 8), _mm256_set1_ps(coefs[i + 1])));
+    }
+    _mm256_storeu_ps(dst, _mm256_add_ps(acc0, acc1));
+}
+#endif
+
+#if HAVE_NEON_INTRINSICS
+static void
+SDL_ResampleFrame_c1_NEON(const float *window, const float *coefs, float *dst)
+{
+    float32x4_t acc = vmulq_f32(vld1q_f32(window), vld1q_f32(coefs));
+    float32x2_t sum;
+    acc = vmlaq_f32(acc, vld1q_f32(window + 4), vld1q_f32(coefs + 4));
+    acc = vmlaq_f32(acc, vld1q_f32(window + 8), vld1q_f32(coefs + 8));
+    sum = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    sum = vpadd_f32(sum, sum);
+    vst1_lane_f32(dst, sum, 0);
+}
+
+static void
+SDL_ResampleFrame_c2_NEON(const float *window, const float *coefs, float *dst)
+{
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    int i;
+
+    for (i = 0; i < RESAMPLER_TAPS; i += 4, window += 8) {
+        const float32x4_t c = vld1q_f32(coefs + i);
+        const float32x4x2_t cc = vzipq_f32(c, c);
+        acc0 = vmlaq_f32(acc0, vld1q_f32(window), cc.val[0]);
+        acc1 = vmlaq_f32(acc1, vld1q_f32(window + 4), cc.val[1]);
+    }
+    acc0 = vaddq_f32(acc0, acc1);
+    vst1_f32(dst, vadd_f32(vget_low_f32(acc0), vget_high_f32(acc0)));
+}
+
+static void
+SDL_ResampleFrame_c4_NEON(const float *window, const float *coefs, float *dst)
+{
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    int i;
+
+    for (i = 0; i < RESAMPLER_TAPS; i += 2, window += 8) {
+        acc0 = vmlaq_n_f32(acc0, vld1q_f32(window), coefs[i]);
+        acc1 = vmlaq_n_f32(acc1, vld1q_f32(window + 4), coefs[i + 1]);
+    }
+    vst1q_f32(dst, vaddq_f32(acc0, acc1));
+}
+
+static void
+SDL_ResampleFrame_c6_NEON(const float *window, const float *coefs, float *dst)
+{
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x2_t acc1 = vdup_n_f32(0.0f);
+    int i;
+
+    for (i = 0; i < RESAMPLER_TAPS; i++, window += 6) {
+        acc0 = vmlaq_n_f32(acc0, vld1q_f32(window), coefs[i]);
+        acc1 = vmla_n_f32(acc1, vld1_f32(window + 4), coefs[i]);
+    }
+    vst1q_f32(dst, acc0);
+    vst1_f32(dst + 4, acc1);
+}
+
+static void
+SDL_ResampleFrame_c8_NEON(const float *window, const float *coefs, float *dst)
+{
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    int i;
+
+    for (i = 0; i < RESAMPLER_TAPS; i++, window += 8) {
+        acc0 = vmlaq_n_f32(acc0, vld1q_f32(window), coefs[i]);
+        acc1 = vmlaq_n_f32(acc1, vld1q_f32(window + 4), coefs[i]);
+    }
+    vst1q_f32(dst, acc0);
+    vst1q_f32(dst + 4, acc1);
+}
+#endif
+
+static void
+SDL_ChooseResampleFrameFuncs(void)
+{
+    SDL_zeroa(ResampleFrameFuncs);
+
+#if HAVE_SSE_INTRINSICS
+    if (SDL_HasSSE()) {
+        ResampleFrameFuncs[1] = SDL_ResampleFrame_c1_SSE;
+        ResampleFrameFuncs[2] = SDL_ResampleFrame_c2_SSE;
+        ResampleFrameFuncs[4] = SDL_ResampleFrame_c4_SSE;
+        ResampleFrameFuncs[6] = SDL_ResampleFrame_c6_SSE;
+        ResampleFrameFuncs[8] = SDL_ResampleFrame_c8_SSE;
+    }
+#endif
+
+#if HAVE_AVX_INTRINSICS
+    if (SDL_HasAVX()) {
+        ResampleFrameFuncs[2] = SDL_ResampleFrame_c2_AVX;
+        ResampleFrameFuncs[4] = SDL_ResampleFrame_c4_AVX;
+        ResampleFrameFuncs[8] = SDL_ResampleFrame_c8_AVX;
+    }
+#endif
+
+#if HAVE_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        ResampleFrameFuncs[1] = SDL_ResampleFrame_c1_NEON;
+        ResampleFrameFuncs[2] = SDL_ResampleFrame_c2_NEON;
+        ResampleFrameFuncs[4] = SDL_ResampleFrame_c4_NEON;
+        ResampleFrameFuncs[6] = SDL_ResampleFrame_c6_NEON;
+        ResampleFrameFuncs[8] = SDL_ResampleFrame_c8_NEON;
     }
+#endif
 }
 
+/* Rate pairs that reduce to a small ratio cycle through a fixed set of
+   filter phases: (outrate / gcd(inrate, outrate)) of them. For these we
+   precompute every phase's coefficients once, so each output frame is a
+   single dot product with no per-frame phase math. Banks only depend on
+   the phase count and the filter, and are shared by everyone using them. */
+#define RESAMPLER_MAX_PHASES 1024
 
-/* Upmix 5.1 to 7.1 */
-static void SDLCALL
-SDL_Convert51To71(SDL_AudioCVT * cvt, SDL_AudioFormat format)
+typedef struct SDL_ResampleBank
 {
-    float lf, rf, lb, rb, ls, rs;
-    int i;
-    const float *src = (const float *) (cvt->buf + cvt->len_cvt);
-    float *dst = (float *) (cvt->buf + cvt->len_cvt * 4 / 3);
+    int phases;
+    int taps;  /* RESAMPLER_TAPS or RESAMPLER_SHORT_TAPS, which also says which filter this is. */
+    float *coefs;  /* phases * taps of them. */
+    struct SDL_ResampleBank *next;
+} SDL_ResampleBank;
 
-    LOG_DEBUG_CONVERT("5.1", "7.1");
-    SDL_assert(format == AUDIO_F32SYS);
-    SDL_assert(cvt->len_cvt % (sizeof(float) * 6) == 0);
+static SDL_SpinLock ResampleFilterSpinlock = 0;
+static float *ResamplerFilter = NULL;
+static float *ResamplerFilterDifference = NULL;
+static SDL_ResampleBank *ResampleBanks = NULL;
+static float *ShortResamplerFilter = NULL;
+static float *ShortResamplerFilterDifference = NULL;
 
-    for (i = cvt->len_cvt / (sizeof(float) * 6); i; --i) {
-        dst -= 8;
-        src -= 6;
-        lf = src[0];
-        rf = src[1];
-        lb = src[4];
-        rb = src[5];
-        ls = (lf + lb) * 0.5f;
-        rs = (rf + rb) * 0.5f;
-        /* !!! FIXME: these four may clip */
-        lf += lf - ls;
-        rf += rf - ls;
-        lb += lb - ls;
-        rb += rb - ls;
-        dst[3] = src[3];  /* LFE */
-        dst[2] = src[2];  /* FC */
-        dst[7] = rs; /* SR */
-        dst[6] = ls; /* SL */
-        dst[5] = rb;  /* BR */
-        dst[4] = lb;  /* BL */
-        dst[1] = rf;  /* FR */
-        dst[0] = lf;  /* FL */
+/* Fill in (taps) coefficients from a filter table for an output frame that
+   lies (interpolation1) of the way from one input frame to the next. */
+static void
+ResamplerCoefficients(const float *filter, const float *difference, const int filtersize,
+                      const int taps, const double interpolation1, float *coefs)
+{
+    const int filterindex1 = (int) (interpolation1 * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+    const double interpolation2 = 1.0 - interpolation1;
+    const int filterindex2 = (int) (interpolation2 * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+    int j;
+
+    for (j = 0; j < (taps / 2); j++) {
+        const int left = filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+        const int right = filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
+        coefs[((taps / 2) - 1) - j] = (left < filtersize) ? (float) (filter[left] + (interpolation1 * difference[left])) : 0.0f;
+        coefs[(taps / 2) + j] = (right < filtersize) ? (float) (filter[right] + (interpolation2 * difference[right])) : 0.0f;
     }
+}
 
-    cvt->len_cvt = cvt->len_cvt * 4 / 3;
+/* Returns (taps) input frames starting at (firstframe). If they hang off
+   either end of the input, they're gathered into (window) from the padding
+   instead. */
+static const float *
+ResamplerWindow(const int chans, const int taps, const int firstframe, const int paddinglen,
+                const float *lpadding, const float *rpadding,
+                const float *inbuf, const int inframes, float *window)
+{
+    const int framelen = chans * (int)sizeof (float);
+    int j;
 
-    if (cvt->filters[++cvt->filter_index]) {
-        cvt->filters[cvt->filter_index] (cvt, format);
+    if ((firstframe >= 0) && ((firstframe + taps) <= inframes)) {
+        return inbuf + (firstframe * chans);
+    }
+
+    for (j = 0; j < taps; j++) {
+        const int srcframe = firstframe + j;
+        const float *frame;
+        if (srcframe < 0) {
+            frame = lpadding + ((paddinglen + srcframe) * chans);
+        } else if (srcframe >= inframes) {
+            frame = rpadding + ((srcframe - inframes) * chans);
+        } else {
+            frame = inbuf + (srcframe * chans);
+        }
+        SDL_memcpy(window + (j * chans), frame, framelen);
     }
+    return window;
 }
 
-/* SDL's resampler uses a "bandlimited interpolation" algorithm:
-     https://ccrma.stanford.edu/~jos/resample/ */
+/* Splits a resampler position into an input frame and a phase. The frame is
+   negative when the last call filled its output before it used up its
+   input; those frames are at the end of this call's left padding. */
+static void
+ResamplerSplitPosition(const int position, const int phases, int *srcindex, int *phase)
+{
+    *srcindex = position / phases;
+    *phase = position % phases;
+    if (*phase < 0) {
+        *phase += phases;
+        *srcindex -= 1;
+    }
+}
 
-#define RESAMPLER_ZERO_CROSSINGS 5
-#define RESAMPLER_BITS_PER_SAMPLE 16
-#define RESAMPLER_SAMPLES_PER_ZERO_CROSSING  (1 << ((RESAMPLER_BITS_PER_SAMPLE / 2) + 1))
-#define RESAMPLER_FILTER_SIZE ((RESAMPLER_SAMPLES_PER_ZERO_CROSSING * RESAMPLER_ZERO_CROSSINGS) + 1)
+/* The position for the next call, given the frame and phase the next output
+   frame would have come from in this one. If the output filled up first,
+   the next call starts over the frames this one didn't get to, as far back
+   as its left padding reaches when the first of (before) frames ahead of the
+   output frame has to be in it. */
+static int
+ResamplerNextPosition(const int srcindex, const int phase, const int phases,
+                      const int inframes, const int before, const int paddinglen)
+{
+    const int next = SDL_max(srcindex - inframes, before - paddinglen);
+    return (next * phases) + phase;
+}
 
-/* This is a "modified" bessel function, so you can't use POSIX j0() */
-static double
-bessel(const double x)
+static void
+SDL_ResampleFrame_Scalar(const float *window, const float *coefs, const int taps, const int chans, float *dst)
 {
-    const double xdiv2 = x / 2.0;
-    double i0 = 1.0f;
-    double f = 1.0f;
-    int i = 1;
+    int i, chan;
 
-    while (SDL_TRUE) {
-        const double diff = SDL_pow(xdiv2, i * 2) / SDL_pow(f, 2);
-        if (diff < 1.0e-21f) {
-            break;
+    for (chan = 0; chan < chans; chan++) {
+        float outsample = 0.0f;
+        for (i = 0; i < taps; i++) {
+            outsample += window[(i * chans) + chan] * coefs[i];
         }
-        i0 += diff;
-        i++;
-        f *= (double) i;
+        dst[chan] = outsample;
     }
+}
 
-    return i0;
+static int
+GreatestCommonDivisor(int a, int b)
+{
+    while (b != 0) {
+        const int tmp = a % b;
+        a = b;
+        b = tmp;
+    }
+    return a;
 }
 
-/* build kaiser table with cardinal sine applied to it, and array of differences between elements. */
-static void
-kaiser_and_sinc(float *table, float *diffs, const int tablelen, const double beta)
+/* Returns the shared filter bank for this rate pair and filter, or NULL if
+   it doesn't reduce to a small enough ratio. SDL_PrepareResampleFilter()
+   must have succeeded first. */
+static const SDL_ResampleBank *
+SDL_GetResampleBank(const int inrate, const int outrate, const int taps)
 {
-    const int lenm1 = tablelen - 1;
-    const int lenm1div2 = lenm1 / 2;
+    const int phases = (inrate > 0 && outrate > 0) ? (outrate / GreatestCommonDivisor(inrate, outrate)) : 0;
+    SDL_ResampleBank *bank;
     int i;
 
-    table[0] = 1.0f;
-    for (i = 1; i < tablelen; i++) {
-        const double kaiser = bessel(beta * SDL_sqrt(1.0 - SDL_pow(((i - lenm1) / 2.0) / lenm1div2, 2.0))) / bessel(beta);
-        table[tablelen - i] = (float) kaiser;
+    if ((inrate == outrate) || (phases <= 0) || (phases > RESAMPLER_MAX_PHASES)) {
+        return NULL;
     }
 
-    for (i = 1; i < tablelen; i++) {
-        const float x = (((float) i) / ((float) RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) * ((float) M_PI);
-        table[i] *= SDL_sinf(x) / x;
-        diffs[i - 1] = table[i] - table[i - 1];
+    SDL_AtomicLock(&ResampleFilterSpinlock);
+    for (bank = ResampleBanks; bank; bank = bank->next) {
+        if ((bank->phases == phases) && (bank->taps == taps)) {
+            break;
+        }
     }
-    diffs[lenm1] = 0.0f;
-}
 
+    if (!bank) {
+        bank = (SDL_ResampleBank *) SDL_malloc(sizeof (*bank));
+        if (bank) {
+            bank->coefs = (float *) SDL_malloc(phases * taps * sizeof (float));
+            if (!bank->coefs) {
+                SDL_free(bank);
+                bank = NULL;
+            }
+        }
+
+        /* Not fatal, the caller just falls back to the general resampler. */
+        if (bank) {
+            const SDL_bool isshort = (taps == RESAMPLER_SHORT_TAPS);
+            bank->phases = phases;
+            bank->taps = taps;
+            for (i = 0; i < phases; i++) {
+                ResamplerCoefficients(isshort ? ShortResamplerFilter : ResamplerFilter,
+                                      isshort ? ShortResamplerFilterDifference : ResamplerFilterDifference,
+                                      isshort ? RESAMPLER_SHORT_FILTER_SIZE : RESAMPLER_FILTER_SIZE,
+                                      taps, ((double) i) / ((double) phases), bank->coefs + (i * taps));
+            }
+            bank->next = ResampleBanks;
+            ResampleBanks = bank;
+        }
+    }
+    SDL_AtomicUnlock(&ResampleFilterSpinlock);
 
-static SDL_SpinLock ResampleFilterSpinlock = 0;
-static float *ResamplerFilter = NULL;
-static float *ResamplerFilterDifference = NULL;
+    return bank;
+}
 
 int
 SDL_PrepareResampleFilter(void)
@@ -438,10 +1274,21 @@ SDL_PrepareResampleFilter(void)
         /* if dB > 50, beta=(0.1102 * (dB - 8.7)), according to Matlab. */
         const double dB = 80.0;
         const double beta = 0.1102 * (dB - 8.7);
+        const double shortbeta = 0.1102 * (60.0 - 8.7);
         const size_t alloclen = RESAMPLER_FILTER_SIZE * sizeof (float);
 
+        /* the short filter and its differences share one allocation. */
+        ShortResamplerFilter = (float *) SDL_malloc(RESAMPLER_SHORT_FILTER_SIZE * 2 * sizeof (float));
+        if (!ShortResamplerFilter) {
+            SDL_AtomicUnlock(&ResampleFilterSpinlock);
+            return SDL_OutOfMemory();
+        }
+        ShortResamplerFilterDifference = ShortResamplerFilter + RESAMPLER_SHORT_FILTER_SIZE;
+
         ResamplerFilter = (float *) SDL_malloc(alloclen);
         if (!ResamplerFilter) {
+            SDL_free(ShortResamplerFilter);
+            ShortResamplerFilter = NULL;
             SDL_AtomicUnlock(&ResampleFilterSpinlock);
             return SDL_OutOfMemory();
         }
@@ -450,10 +1297,14 @@ SDL_PrepareResampleFilter(void)
         if (!ResamplerFilterDifference) {
             SDL_free(ResamplerFilter);
             ResamplerFilter = NULL;
+            SDL_free(ShortResamplerFilter);
+            ShortResamplerFilter = NULL;
             SDL_AtomicUnlock(&ResampleFilterSpinlock);
             return SDL_OutOfMemory();
         }
         kaiser_and_sinc(ResamplerFilter, ResamplerFilterDifference, RESAMPLER_FILTER_SIZE, beta);
+        kaiser_and_sinc(ShortResamplerFilter, ShortResamplerFilterDifference, RESAMPLER_SHORT_FILTER_SIZE, shortbeta);
+        SDL_ChooseResampleFrameFuncs();
     }
     SDL_AtomicUnlock(&ResampleFilterSpinlock);
     return 0;
@@ -462,10 +1313,19 @@ SDL_PrepareResampleFilter(void)
 void
 SDL_FreeResampleFilter(void)
 {
+    while (ResampleBanks) {
+        SDL_ResampleBank *next = ResampleBanks->next;
+        SDL_free(ResampleBanks->coefs);
+        SDL_free(ResampleBanks);
+        ResampleBanks = next;
+    }
     SDL_free(ResamplerFilter);
     SDL_free(ResamplerFilterDifference);
+    SDL_free(ShortResamplerFilter);
     ResamplerFilter = NULL;
     ResamplerFilterDifference = NULL;
+    ShortResamplerFilter = NULL;
+    ShortResamplerFilterDifference = NULL;
 }
 
 static int
@@ -495,6 +1355,9 @@ SDL_ResampleAudio(const int chans, const int inrate, const int outrate,
     const int wantedoutframes = (int) ((inbuflen / framelen) * ratio);  /* outbuflen isn't total to write, it's total available. */
     const int maxoutframes = outbuflen / framelen;
     const int outframes = SDL_min(wantedoutframes, maxoutframes);
+    const SDL_ResampleFrameFunc resample_frame = (chans <= RESAMPLER_MAX_SIMD_CHANNELS) ? ResampleFrameFuncs[chans] : NULL;
+    float coefs[RESAMPLER_TAPS];
+    float window[RESAMPLER_TAPS * RESAMPLER_MAX_SIMD_CHANNELS];
     float *dst = outbuf;
     double outtime = 0.0;
     int i, j, chan;
@@ -508,25 +1371,36 @@ SDL_ResampleAudio(const int chans, const int inrate, const int outrate,
         const double interpolation2 = 1.0 - interpolation1;
         const int filterindex2 = (int) (interpolation2 * RESAMPLER_SAMPLES_PER_ZERO_CROSSING);
 
-        for (chan = 0; chan < chans; chan++) {
-            float outsample = 0.0f;
-
-            /* do this twice to calculate the sample, once for the "left wing" and then same for the right. */
-            /* !!! FIXME: do both wings in one loop */
-            for (j = 0; (filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) < RESAMPLER_FILTER_SIZE; j++) {
-                const int srcframe = srcindex - j;
-                /* !!! FIXME: we can bubble this conditional out of here by doing a pre loop. */
-                const float insample = (srcframe < 0) ? lpadding[((paddinglen + srcframe) * chans) + chan] : inbuf[(srcframe * chans) + chan];
-                outsample += (float)(insample * (ResamplerFilter[filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)] + (interpolation1 * ResamplerFilterDifference[filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)])));
-            }
-
-            for (j = 0; (filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) < RESAMPLER_FILTER_SIZE; j++) {
-                const int srcframe = srcindex + 1 + j;
-                /* !!! FIXME: we can bubble this conditional out of here by doing a post loop. */
-                const float insample = (srcframe >= inframes) ? rpadding[((srcframe - inframes) * chans) + chan] : inbuf[(srcframe * chans) + chan];
-                outsample += (float)(insample * (ResamplerFilter[filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)] + (interpolation2 * ResamplerFilterDifference[filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)])));
+        if (resample_frame) {
+            /* Work out this phase's coefficients once for all channels, then
+               hand a contiguous window of input frames to the SIMD kernel. */
+            ResamplerCoefficients(ResamplerFilter, ResamplerFilterDifference, RESAMPLER_FILTER_SIZE, RESAMPLER_TAPS,
+                                  interpolation1, coefs);
+            resample_frame(ResamplerWindow(chans, RESAMPLER_TAPS, srcindex - ((RESAMPLER_TAPS / 2) - 1), paddinglen,
+                                           lpadding, rpadding, inbuf, inframes, window),
+                           coefs, dst);
+            dst += chans;
+        } else {
+            for (chan = 0; chan < chans; chan++) {
+                float outsample = 0.0f;
+
+                /* do this twice to calculate the sample, once for the "left wing" and then same for the right. */
+                /* !!! FIXME: do both wings in one loop */
+                for (j = 0; (filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) < RESAMPLER_FILTER_SIZE; j++) {
+                    const int srcframe = srcindex - j;
+                    /* !!! FIXME: we can bubble this conditional out of here by doing a pre loop. */
+                    const float insample = (srcframe < 0) ? lpadding[((paddinglen + srcframe) * chans) + chan] : inbuf[(srcframe * chans) + chan];
+                    outsample += (float)(insample * (ResamplerFilter[filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)] + (interpolation1 * ResamplerFilterDifference[filterindex1 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)])));
+                }
+
+                for (j = 0; (filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)) < RESAMPLER_FILTER_SIZE; j++) {
+                    const int srcframe = srcindex + 1 + j;
+                    /* !!! FIXME: we can bubble this conditional out of here by doing a post loop. */
+                    const float insample = (srcframe >= inframes) ? rpadding[((srcframe - inframes) * chans) + chan] : inbuf[(srcframe * chans) + chan];
+                    outsample += (float)(insample * (ResamplerFilter[filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)] + (interpolation2 * ResamplerFilterDifference[filterindex2 + (j * RESAMPLER_SAMPLES_PER_ZERO_CROSSING)])));
+                }
+                *(dst++) = outsample;
             }
-            *(dst++) = outsample;
         }
 
         outtime += outtimeincr;
@@ -535,6 +1409,168 @@ SDL_ResampleAudio(const int chans, const int inrate, const int outrate,
     return outframes * chans * sizeof (float);
 }
 
+/* Resample with a precomputed filter bank. (position) is where the first
+   output frame lies, in 1/phases of an input frame from the start of
+   (inbuf); it's updated to where the next call's first output frame lies,
+   relative to the input that follows this one. */
+static int
+SDL_ResampleAudioFixedRatio(const int chans, const int inrate, const int outrate,
+                            const SDL_ResampleBank *bank, int *position,
+                            const float *lpadding, const float *rpadding,
+                            const float *inbuf, const int inbuflen,
+                            float *outbuf, const int outbuflen)
+{
+    const int phases = bank->phases;
+    const int taps = bank->taps;
+    const int step = inrate / (outrate / phases);
+    const int paddinglen = ResamplerPadding(inrate, outrate);
+    const int framelen = chans * (int)sizeof (float);
+    const int inframes = inbuflen / framelen;
+    const int maxoutframes = outbuflen / framelen;
+    const SDL_ResampleFrameFunc resample_frame = (taps == RESAMPLER_TAPS) ? ResampleFrameFuncs[chans] : NULL;
+    float window[RESAMPLER_TAPS * RESAMPLER_MAX_SIMD_CHANNELS];
+    int srcindex, phase;
+    int outframes = 0;
+    float *dst = outbuf;
+
+    SDL_assert(chans <= RESAMPLER_MAX_SIMD_CHANNELS);
+
+    ResamplerSplitPosition(*position, phases, &srcindex, &phase);
+
+    while ((srcindex < inframes) && (outframes < maxoutframes)) {
+        const float *coefs = bank->coefs + (phase * taps);
+        const float *src = ResamplerWindow(chans, taps, srcindex - ((taps / 2) - 1), paddinglen,
+                                           lpadding, rpadding, inbuf, inframes, window);
+        if (resample_frame) {
+            resample_frame(src, coefs, dst);
+        } else {
+            SDL_ResampleFrame_Scalar(src, coefs, taps, chans, dst);
+        }
+        dst += chans;
+        outframes++;
+
+        phase += step;
+        srcindex += phase / phases;
+        phase %= phases;
+    }
+
+    *position = ResamplerNextPosition(srcindex, phase, phases, inframes, (taps / 2) - 1, paddinglen);
+
+    return outframes * framelen;
+}
+
+/* SDL_AudioStream's resampler when there's no filter bank for its quality
+   and rates. (position) works like it does for SDL_ResampleAudioFixedRatio(),
+   in units of 1/(outrate / gcd) input frames, which is exact for any pair of
+   rates, so there's no drift between calls. */
+static int
+SDL_ResampleAudioAtQuality(const int chans, const int inrate, const int outrate,
+                              const SDL_AudioResamplerQuality quality, int *position,
+                              const float *lpadding, const float *rpadding,
+                              const float *inbuf, const int inbuflen,
+                              float *outbuf, const int outbuflen)
+{
+    const int gcd = GreatestCommonDivisor(inrate, outrate);
+    const int phases = outrate / gcd;
+    const int step = inrate / gcd;
+    const double phasescale = 1.0 / ((double) phases);
+    const int paddinglen = ResamplerPadding(inrate, outrate);
+    const int framelen = chans * (int)sizeof (float);
+    const int inframes = inbuflen / framelen;
+    const int maxoutframes = outbuflen / framelen;
+    const SDL_ResampleFrameFunc resample_frame = ResampleFrameFuncs[chans];
+    float coefs[RESAMPLER_TAPS];
+    float window[RESAMPLER_TAPS * RESAMPLER_MAX_SIMD_CHANNELS];
+    int srcindex, phase;
+    int outframes = 0;
+    float *dst = outbuf;
+    int taps, before;
+    int chan;
+
+    SDL_assert(chans <= RESAMPLER_MAX_SIMD_CHANNELS);
+
+    ResamplerSplitPosition(*position, phases, &srcindex, &phase);
+
+    /* how many input frames each output frame looks at, and how many of them come before it. */
+    switch (quality) {
+        case SDL_RESAMPLER_QUALITY_NEAREST: taps = 1; before = 0; break;
+        case SDL_RESAMPLER_QUALITY_LINEAR: taps = 2; before = 0; break;
+        case SDL_RESAMPLER_QUALITY_CUBIC: taps = 4; before = 1; break;
+        case SDL_RESAMPLER_QUALITY_SHORT_SINC: taps = RESAMPLER_SHORT_TAPS; before = (RESAMPLER_SHORT_TAPS / 2) - 1; break;
+        default: taps = RESAMPLER_TAPS; before = (RESAMPLER_TAPS / 2) - 1; break;
+    }
+
+    while ((srcindex < inframes) && (outframes < maxoutframes)) {
+        const float t = (float) (phase * phasescale);
+        int firstframe = srcindex - before;
+        const float *src;
+
+        if (quality == SDL_RESAMPLER_QUALITY_NEAREST) {
+            firstframe += (phase >= (phases - phase)) ? 1 : 0;  /* round to the closer frame. */
+        }
+
+        if ((firstframe >= 0) && ((firstframe + taps) <= inframes)) {
+            src = inbuf + (firstframe * chans);
+        } else {
+            src = ResamplerWindow(chans, taps, firstframe, paddinglen, lpadding, rpadding, inbuf, inframes, window);
+        }
+
+        switch (quality) {
+            case SDL_RESAMPLER_QUALITY_NEAREST:
+                for (chan = 0; chan < chans; chan++) {
+                    dst[chan] = src[chan];
+                }
+                break;
+
+            case SDL_RESAMPLER_QUALITY_LINEAR:
+                for (chan = 0; chan < chans; chan++) {
+                    dst[chan] = src[chan] + ((src[chans + chan] - src[chan]) * t);
+                }
+                break;
+
+            case SDL_RESAMPLER_QUALITY_CUBIC:
+                for (chan = 0; chan < chans; chan++) {
+                    const float p0 = src[chan];
+                    const float p1 = src[chans + chan];
+                    const float p2 = src[(chans * 2) + chan];
+                    const float p3 = src[(chans * 3) + chan];
+                    const float a = (-0.5f * p0) + (1.5f * p1) - (1.5f * p2) + (0.5f * p3);
+                    const float b = p0 - (2.5f * p1) + (2.0f * p2) - (0.5f * p3);
+                    const float c = (-0.5f * p0) + (0.5f * p2);
+                    dst[chan] = (((((a * t) + b) * t) + c) * t) + p1;
+                }
+                break;
+
+            case SDL_RESAMPLER_QUALITY_SHORT_SINC:
+                ResamplerCoefficients(ShortResamplerFilter, ShortResamplerFilterDifference, RESAMPLER_SHORT_FILTER_SIZE,
+                                      RESAMPLER_SHORT_TAPS, phase * phasescale, coefs);
+                SDL_ResampleFrame_Scalar(src, coefs, RESAMPLER_SHORT_TAPS, chans, dst);
+                break;
+
+            default:
+                ResamplerCoefficients(ResamplerFilter, ResamplerFilterDifference, RESAMPLER_FILTER_SIZE,
+                                      RESAMPLER_TAPS, phase * phasescale, coefs);
+                if (resample_frame) {
+                    resample_frame(src, coefs, dst);
+                } else {
+                    SDL_ResampleFrame_Scalar(src, coefs, RESAMPLER_TAPS, chans, dst);
+                }
+                break;
+        }
+
+        dst += chans;
+        outframes++;
+
+        phase += step;
+        srcindex += phase / phases;
+        phase %= phases;
+    }
+
+    *position = ResamplerNextPosition(srcindex, phase, phases, inframes, before, paddinglen);
+
+    return outframes * framelen;
+}
+
 int
 SDL_ConvertAudio(SDL_AudioCVT * cvt)
 {
@@ -718,6 +1754,7 @@ SDL_ResampleCVT(SDL_AudioCVT *cvt, const int chans, const SDL_AudioFormat format
     float *dst = (float *) (cvt->buf + srclen);
     const int dstlen = (cvt->len * cvt->len_mult) - srclen;
     const int requestedpadding = ResamplerPadding(inrate, outrate);
+    const SDL_ResampleBank *bank = SDL_GetResampleBank(inrate, outrate, RESAMPLER_TAPS);
     int paddingsamples;
     float *padding;
 
@@ -735,7 +1772,16 @@ SDL_ResampleCVT(SDL_AudioCVT *cvt, const int chans, const SDL_AudioFormat format
         return;
     }
 
-    cvt->len_cvt = SDL_ResampleAudio(chans, inrate, outrate, padding, padding, src, srclen, dst, dstlen);
+    if (bank && (chans <= RESAMPLER_MAX_SIMD_CHANNELS)) {
+        /* produce the same number of frames that SDL_ResampleAudio() would. */
+        const int framelen = chans * (int)sizeof (float);
+        const double ratio = ((float) outrate) / ((float) inrate);
+        const int wantedlen = ((int) ((srclen / framelen) * ratio)) * framelen;
+        int position = 0;
+        cvt->len_cvt = SDL_ResampleAudioFixedRatio(chans, inrate, outrate, bank, &position, padding, padding, src, srclen, dst, SDL_min(dstlen, wantedlen));
+    } else {
+        cvt->len_cvt = SDL_ResampleAudio(chans, inrate, outrate, padding, padding, src, srclen, dst, dstlen);
+    }
 
     SDL_free(padding);
 
@@ -796,6 +1842,9 @@ SDL_BuildAudioResampleCVT(SDL_AudioCVT * cvt, const int dst_channels,
         return -1;
     }
 
+    /* build the shared filter bank now, if this rate pair gets one. */
+    SDL_GetResampleBank(src_rate, dst_rate, RESAMPLER_TAPS);
+
     /* Update (cvt) with filter details... */
     if (SDL_AddAudioCVTFilter(cvt, filter) < 0) {
         return -1;
@@ -842,29 +1891,333 @@ SDL_SupportedAudioFormat(const SDL_AudioFormat fmt)
         case AUDIO_F32MSB:
             return SDL_TRUE;  /* supported. */
 
-        default:
-            break;
+        default:
+            break;
+    }
+
+    return SDL_FALSE;  /* unsupported. */
+}
+
+static SDL_bool
+SDL_SupportedChannelCount(const int channels)
+{
+    switch (channels) {
+        case 1:  /* mono */
+        case 2:  /* stereo */
+        case 4:  /* quad */
+        case 6:  /* 5.1 */
+        case 8:  /* 7.1 */
+          return SDL_TRUE;  /* supported. */
+
+        default:
+            break;
+    }
+
+    return SDL_FALSE;  /* unsupported. */
+}
+
+
+#if HAVE_SSE_INTRINSICS
+#define SSE_CHANNEL_FILTER(fn) fn##_SSE, SDL_HasSSE
+#else
+#define SSE_CHANNEL_FILTER(fn) NULL, NULL
+#endif
+
+/* Every channel converter, and the same conversion written as a matrix. A
+   conversion that would take a chain of converters (say, 7.1 to mono) is
+   instead done in one pass by SDL_RemixAudio(), with the product of the
+   chain's matrices. */
+typedef struct SDL_ChannelConverter
+{
+    int src_channels;
+    int dst_channels;
+    SDL_AudioFilter filter;
+    SDL_AudioFilter simd_filter;  /* NULL if there's no SIMD version */
+    SDL_bool (SDLCALL *has_simd)(void);
+    float matrix[8][8];  /* [dst channel][src channel] */
+} SDL_ChannelConverter;
+
+static const SDL_ChannelConverter StereoToMonoConverter = {
+    2, 1, SDL_ConvertStereoToMono,
+#if HAVE_SSE3_INTRINSICS
+    SDL_ConvertStereoToMono_SSE3, SDL_HasSSE3,
+#else
+    NULL, NULL,
+#endif
+    { { 0.5f, 0.5f } }
+};
+
+static const SDL_ChannelConverter Convert51ToStereoConverter = {
+    6, 2, SDL_Convert51ToStereo, SSE_CHANNEL_FILTER(SDL_Convert51ToStereo),
+    { { 1.0f / 2.5f, 0.0f, 0.5f / 2.5f, 0.0f, 1.0f / 2.5f, 0.0f },
+      { 0.0f, 1.0f / 2.5f, 0.5f / 2.5f, 0.0f, 0.0f, 1.0f / 2.5f } }
+};
+
+static const SDL_ChannelConverter QuadToStereoConverter = {
+    4, 2, SDL_ConvertQuadToStereo, SSE_CHANNEL_FILTER(SDL_ConvertQuadToStereo),
+    { { 0.5f, 0.0f, 0.5f, 0.0f },
+      { 0.0f, 0.5f, 0.0f, 0.5f } }
+};
+
+static const SDL_ChannelConverter Convert71To51Converter = {
+    8, 6, SDL_Convert71To51, SSE_CHANNEL_FILTER(SDL_Convert71To51),
+    { { 1.0f / 1.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.5f / 1.5f, 0.0f },
+      { 0.0f, 1.0f / 1.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.5f / 1.5f },
+      { 0.0f, 0.0f, 1.0f / 1.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f },
+      { 0.0f, 0.0f, 0.0f, 1.0f / 1.5f, 0.0f, 0.0f, 0.0f, 0.0f },
+      { 0.0f, 0.0f, 0.0f, 0.0f, 1.0f / 1.5f, 0.0f, 0.5f / 1.5f, 0.0f },
+      { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f / 1.5f, 0.0f, 0.5f / 1.5f } }
+};
+
+static const SDL_ChannelConverter Convert51ToQuadConverter = {
+    6, 4, SDL_Convert51ToQuad, SSE_CHANNEL_FILTER(SDL_Convert51ToQuad),
+    { { 1.0f / 1.5f, 0.0f, 0.5f / 1.5f, 0.0f, 0.0f, 0.0f },
+      { 0.0f, 1.0f / 1.5f, 0.5f / 1.5f, 0.0f, 0.0f, 0.0f },
+      { 0.0f, 0.0f, 0.0f, 0.0f, 1.0f / 1.5f, 0.0f },
+      { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f / 1.5f } }
+};
+
+static const SDL_ChannelConverter MonoToStereoConverter = {
+    1, 2, SDL_ConvertMonoToStereo, SSE_CHANNEL_FILTER(SDL_ConvertMonoToStereo),
+    { { 1.0f }, { 1.0f } }
+};
+
+/* FL = lf + (lf - ce) where ce = (lf + rf) / 2, and so on. */
+static const SDL_ChannelConverter StereoTo51Converter = {
+    2, 6, SDL_ConvertStereoTo51, SSE_CHANNEL_FILTER(SDL_ConvertStereoTo51),
+    { { 1.5f, -0.5f }, { -0.5f, 1.5f }, { 0.5f, 0.5f }, { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 0.0f, 1.0f } }
+};
+
+static const SDL_ChannelConverter QuadTo51Converter = {
+    4, 6, SDL_ConvertQuadTo51, SSE_CHANNEL_FILTER(SDL_ConvertQuadTo51),
+    { { 1.5f, -0.5f, 0.0f, 0.0f },
+      { -0.5f, 1.5f, 0.0f, 0.0f },
+      { 0.5f, 0.5f, 0.0f, 0.0f },
+      { 0.0f, 0.0f, 0.0f, 0.0f },
+      { 0.0f, 0.0f, 1.0f, 0.0f },
+      { 0.0f, 0.0f, 0.0f, 1.0f } }
+};
+
+static const SDL_ChannelConverter StereoToQuadConverter = {
+    2, 4, SDL_ConvertStereoToQuad, SSE_CHANNEL_FILTER(SDL_ConvertStereoToQuad),
+    { { 1.0f, 0.0f }, { 0.0f, 1.0f }, { 1.0f, 0.0f }, { 0.0f, 1.0f } }
+};
+
+/* FL = lf + (lf - ls) where ls = (lf + lb) / 2, and so on. */
+static const SDL_ChannelConverter Convert51To71Converter = {
+    6, 8, SDL_Convert51To71, SSE_CHANNEL_FILTER(SDL_Convert51To71),
+    { { 1.5f, 0.0f, 0.0f, 0.0f, -0.5f, 0.0f },
+      { 0.0f, 1.5f, 0.0f, 0.0f, 0.0f, -0.5f },
+      { 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f },
+      { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f },
+      { -0.5f, 0.0f, 0.0f, 0.0f, 1.5f, 0.0f },
+      { 0.0f, -0.5f, 0.0f, 0.0f, 0.0f, 1.5f },
+      { 0.5f, 0.0f, 0.0f, 0.0f, 0.5f, 0.0f },
+      { 0.0f, 0.5f, 0.0f, 0.0f, 0.0f, 0.5f } }
+};
+
+#undef SSE_CHANNEL_FILTER
+
+/* Supported channel counts are 1, 2, 4, 6 and 8, so (channels / 2) is a unique index. */
+#define REMIX_INDEX(channels) ((channels) / 2)
+
+/* Remix matrices, stored [src channel][dst channel] so each source sample
+   scales a row of output channels. */
+static float RemixMatrix[5][5][8][8];
+static SDL_bool RemixMatrixReady[5][5];
+static SDL_SpinLock RemixMatrixSpinlock = 0;
+
+static void
+SDL_PrepareRemixMatrix(const SDL_ChannelConverter **chain, const int num_converters)
+{
+    const int src_channels = chain[0]->src_channels;
+    const int dst_channels = chain[num_converters - 1]->dst_channels;
+    float (*matrix)[8] = RemixMatrix[REMIX_INDEX(src_channels)][REMIX_INDEX(dst_channels)];
+    double product[8][8], tmp[8][8];
+    int channels = src_channels;
+    int i, j, k, n;
+
+    SDL_AtomicLock(&RemixMatrixSpinlock);
+    if (!RemixMatrixReady[REMIX_INDEX(src_channels)][REMIX_INDEX(dst_channels)]) {
+        SDL_zero(product);
+        for (i = 0; i < src_channels; i++) {
+            product[i][i] = 1.0;
+        }
+
+        for (n = 0; n < num_converters; n++) {
+            const SDL_ChannelConverter *converter = chain[n];
+            SDL_assert(converter->src_channels == channels);
+            for (i = 0; i < converter->dst_channels; i++) {
+                for (j = 0; j < src_channels; j++) {
+                    double sum = 0.0;
+                    for (k = 0; k < channels; k++) {
+                        sum += converter->matrix[i][k] * product[k][j];
+                    }
+                    tmp[i][j] = sum;
+                }
+            }
+            channels = converter->dst_channels;
+            SDL_memcpy(product, tmp, sizeof (product));
+        }
+
+        SDL_zerop(matrix);
+        for (i = 0; i < dst_channels; i++) {
+            for (j = 0; j < src_channels; j++) {
+                matrix[j][i] = (float) product[i][j];
+            }
+        }
+        RemixMatrixReady[REMIX_INDEX(src_channels)][REMIX_INDEX(dst_channels)] = SDL_TRUE;
+    }
+    SDL_AtomicUnlock(&RemixMatrixSpinlock);
+}
+
+/* Inlined into each REMIX_FILTER below, so the channel counts are constants
+   and the compiler can unroll the per-frame loops. */
+SDL_FORCE_INLINE void
+SDL_RemixAudio(SDL_AudioCVT *cvt, SDL_AudioFormat format, const int src_channels, const int dst_channels)
+{
+    const float (*matrix)[8] = (const float (*)[8]) RemixMatrix[REMIX_INDEX(src_channels)][REMIX_INDEX(dst_channels)];
+    const int frames = cvt->len_cvt / (sizeof (float) * src_channels);
+    const int src_step = (dst_channels > src_channels) ? -src_channels : src_channels;
+    const int dst_step = (dst_channels > src_channels) ? -dst_channels : dst_channels;
+    const float *src = (const float *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    int i, j, k;
+
+    SDL_assert(format == AUDIO_F32SYS);
+    SDL_assert(RemixMatrixReady[REMIX_INDEX(src_channels)][REMIX_INDEX(dst_channels)]);
+
+    /* Upmixing works back to front, so it doesn't overwrite frames it hasn't read yet. */
+    if (dst_channels > src_channels) {
+        src += (frames - 1) * src_channels;
+        dst += (frames - 1) * dst_channels;
+    }
+
+    i = frames;
+
+#if HAVE_SSE_INTRINSICS
+    if (SDL_HasSSE()) {
+        if (dst_channels >= 4) {
+            /* Build a whole output frame in one or two vectors. */
+            for (; i; --i, src += src_step, dst += dst_step) {
+                __m128 lo = _mm_setzero_ps();
+                __m128 hi = _mm_setzero_ps();
+                for (k = 0; k < src_channels; k++) {
+                    const __m128 sample = _mm_set1_ps(src[k]);
+                    lo = _mm_add_ps(lo, _mm_mul_ps(sample, _mm_loadu_ps(&matrix[k][0])));
+                    hi = _mm_add_ps(hi, _mm_mul_ps(sample, _mm_loadu_ps(&matrix[k][4])));
+                }
+                switch (dst_channels) {
+                    case 8: _mm_storeu_ps(dst + 4, hi); _mm_storeu_ps(dst, lo); break;
+                    case 6: _mm_storel_pi((__m64 *) (dst + 4), hi); _mm_storeu_ps(dst, lo); break;
+                    default: _mm_storeu_ps(dst, lo); break;
+                }
+            }
+        } else {
+            /* Mono or stereo output (always a downmix): fill each vector
+               from four or two frames instead, so none of it is wasted. */
+            const int frames_per_vector = 4 / dst_channels;
+            __m128 coefs[8];
+
+            SDL_assert(dst_channels < src_channels);
+            for (k = 0; k < src_channels; k++) {
+                coefs[k] = _mm_setr_ps(matrix[k][0], matrix[k][dst_channels - 1], matrix[k][0], matrix[k][dst_channels - 1]);
+            }
+
+            for (; i >= frames_per_vector; i -= frames_per_vector, src += src_channels * frames_per_vector, dst += 4) {
+                __m128 sum = _mm_setzero_ps();
+                for (k = 0; k < src_channels; k++) {
+                    const __m128 samples = (dst_channels == 1) ?
+                        _mm_setr_ps(src[k], src[src_channels + k], src[src_channels * 2 + k], src[src_channels * 3 + k]) :
+                        _mm_setr_ps(src[k], src[k], src[src_channels + k], src[src_channels + k]);
+                    sum = _mm_add_ps(sum, _mm_mul_ps(coefs[k], samples));
+                }
+                _mm_storeu_ps(dst, sum);
+            }
+        }
+    }
+#endif
+
+    /* Scalar version, and whatever frames the SIMD version left over. */
+    for (; i; --i, src += src_step, dst += dst_step) {
+        float frame[8];
+        for (k = 0; k < src_channels; k++) {
+            frame[k] = src[k];
+        }
+        for (j = 0; j < dst_channels; j++) {
+            float sample = 0.0f;
+            for (k = 0; k < src_channels; k++) {
+                sample += matrix[k][j] * frame[k];
+            }
+            dst[j] = sample;
+        }
     }
 
-    return SDL_FALSE;  /* unsupported. */
+    cvt->len_cvt = frames * dst_channels * sizeof (float);
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index] (cvt, format);
+    }
 }
 
-static SDL_bool
-SDL_SupportedChannelCount(const int channels)
+#define REMIX_FILTER(src, dst) \
+static void SDLCALL SDL_RemixAudio_##src##_to_##dst(SDL_AudioCVT *cvt, SDL_AudioFormat format) { \
+    LOG_DEBUG_CONVERT(#src " channels", #dst " channels (using a remix matrix)"); \
+    SDL_RemixAudio(cvt, format, src, dst); \
+}
+REMIX_FILTER(1, 4)
+REMIX_FILTER(1, 6)
+REMIX_FILTER(1, 8)
+REMIX_FILTER(2, 8)
+REMIX_FILTER(4, 8)
+REMIX_FILTER(4, 1)
+REMIX_FILTER(6, 1)
+REMIX_FILTER(8, 1)
+REMIX_FILTER(8, 2)
+REMIX_FILTER(8, 4)
+#undef REMIX_FILTER
+
+static SDL_AudioFilter
+ChooseRemixFilter(const int src_channels, const int dst_channels)
 {
-    switch (channels) {
-        case 1:  /* mono */
-        case 2:  /* stereo */
-        case 4:  /* quad */
-        case 6:  /* 5.1 */
-        case 8:  /* 7.1 */
-          return SDL_TRUE;  /* supported. */
+    #define REMIX_CASE(src, dst) if ((src_channels == src) && (dst_channels == dst)) { return SDL_RemixAudio_##src##_to_##dst; }
+    REMIX_CASE(1, 4)
+    REMIX_CASE(1, 6)
+    REMIX_CASE(1, 8)
+    REMIX_CASE(2, 8)
+    REMIX_CASE(4, 8)
+    REMIX_CASE(4, 1)
+    REMIX_CASE(6, 1)
+    REMIX_CASE(8, 1)
+    REMIX_CASE(8, 2)
+    REMIX_CASE(8, 4)
+    #undef REMIX_CASE
+    return NULL;
+}
 
-        default:
-            break;
+/* Add a chain of channel converters to (cvt): a single converter is added
+   as-is (or its SIMD version), a longer chain is collapsed into one remix. */
+static int
+SDL_AddChannelConverters(SDL_AudioCVT *cvt, const SDL_ChannelConverter **chain, const int num_converters)
+{
+    SDL_AudioFilter filter = NULL;
+
+    if (num_converters == 0) {
+        return 0;
+    } else if (num_converters == 1) {
+        if (chain[0]->simd_filter && chain[0]->has_simd()) {
+            filter = chain[0]->simd_filter;
+        } else {
+            filter = chain[0]->filter;
+        }
+    } else {
+        filter = ChooseRemixFilter(chain[0]->src_channels, chain[num_converters - 1]->dst_channels);
+        if (!filter) {
+            return SDL_SetError("Invalid channel combination");  /* shouldn't happen, but just in case... */
+        }
+        SDL_PrepareRemixMatrix(chain, num_converters);
     }
 
-    return SDL_FALSE;  /* unsupported. */
+    return SDL_AddAudioCVTFilter(cvt, filter);
 }
 
 
@@ -878,6 +2231,9 @@ SDL_BuildAudioCVT(SDL_AudioCVT * cvt,
                   SDL_AudioFormat src_fmt, Uint8 src_channels, int src_rate,
                   SDL_AudioFormat dst_fmt, Uint8 dst_channels, int dst_rate)
 {
+    const SDL_ChannelConverter *channel_converters[3];
+    int num_channel_converters = 0;
+
     /* Sanity check target pointer */
     if (cvt == NULL) {
         return SDL_InvalidParamError("cvt");
@@ -962,36 +2318,28 @@ SDL_BuildAudioCVT(SDL_AudioCVT * cvt,
         /* Upmixing */
         /* Mono -> Stereo [-> ...] */
         if ((src_channels == 1) && (dst_channels > 1)) {
-            if (SDL_AddAudioCVTFilter(cvt, SDL_ConvertMonoToStereo) < 0) {
-                return -1;
-            }
+            channel_converters[num_channel_converters++] = &MonoToStereoConverter;
             cvt->len_mult *= 2;
             src_channels = 2;
             cvt->len_ratio *= 2;
         }
         /* [Mono ->] Stereo -> 5.1 [-> 7.1] */
         if ((src_channels == 2) && (dst_channels >= 6)) {
-            if (SDL_AddAudioCVTFilter(cvt, SDL_ConvertStereoTo51) < 0) {
-                return -1;
-            }
+            channel_converters[num_channel_converters++] = &StereoTo51Converter;
             src_channels = 6;
             cvt->len_mult *= 3;
             cvt->len_ratio *= 3;
         }
         /* Quad -> 5.1 [-> 7.1] */
         if ((src_channels == 4) && (dst_channels >= 6)) {
-            if (SDL_AddAudioCVTFilter(cvt, SDL_ConvertQuadTo51) < 0) {
-                return -1;
-            }
+            channel_converters[num_channel_converters++] = &QuadTo51Converter;
             src_channels = 6;
             cvt->len_mult = (cvt->len_mult * 3 + 1) / 2;
             cvt->len_ratio *= 1.5;
         }
         /* [[Mono ->] Stereo ->] 5.1 -> 7.1 */
         if ((src_channels == 6) && (dst_channels == 8)) {
-            if (SDL_AddAudioCVTFilter(cvt, SDL_Convert51To71) < 0) {
-                return -1;
-            }
+            channel_converters[num_channel_converters++] = &Convert51To71Converter;
             src_channels = 8;
             cvt->len_mult = (cvt->len_mult * 4 + 2) / 3;
             /* Should be numerically exact with every valid input to this
@@ -1000,9 +2348,7 @@ SDL_BuildAudioCVT(SDL_AudioCVT * cvt,
         }
         /* [Mono ->] Stereo -> Quad */
         if ((src_channels == 2) && (dst_channels == 4)) {
-            if (SDL_AddAudioCVTFilter(cvt, SDL_ConvertStereoToQuad) < 0) {
-                return -1;
-            }
+            channel_converters[num_channel_converters++] = &StereoToQuadConverter;
             src_channels = 4;
             cvt->len_mult *= 2;
             cvt->len_ratio *= 2;
@@ -1012,54 +2358,31 @@ SDL_BuildAudioCVT(SDL_AudioCVT * cvt,
         /* 7.1 -> 5.1 [-> Stereo [-> Mono]] */
         /* 7.1 -> 5.1 [-> Quad] */
         if ((src_channels == 8) && (dst_channels <= 6)) {
-            if (SDL_AddAudioCVTFilter(cvt, SDL_Convert71To51) < 0) {
-                return -1;
-            }
+            channel_converters[num_channel_converters++] = &Convert71To51Converter;
             src_channels = 6;
             cvt->len_ratio *= 0.75;
         }
         /* [7.1 ->] 5.1 -> Stereo [-> Mono] */
         if ((src_channels == 6) && (dst_channels <= 2)) {
-            if (SDL_AddAudioCVTFilter(cvt, SDL_Convert51ToStereo) < 0) {
-                return -1;
-            }
+            channel_converters[num_channel_converters++] = &Convert51ToStereoConverter;
             src_channels = 2;
             cvt->len_ratio /= 3;
         }
         /* 5.1 -> Quad */
         if ((src_channels == 6) && (dst_channels == 4)) {
-            if (SDL_AddAudioCVTFilter(cvt, SDL_Convert51ToQuad) < 0) {
-                return -1;
-            }
+            channel_converters[num_channel_converters++] = &Convert51ToQuadConverter;
             src_channels = 4;
             cvt->len_ratio = cvt->len_ratio * 2 / 3;
         }
         /* Quad -> Stereo [-> Mono] */
         if ((src_channels == 4) && (dst_channels <= 2)) {
-            if (SDL_AddAudioCVTFilter(cvt, SDL_ConvertQuadToStereo) < 0) {
-                return -1;
-            }
+            channel_converters[num_channel_converters++] = &QuadToStereoConverter;
             src_channels = 2;
             cvt->len_ratio /= 2;
         }
         /* [... ->] Stereo -> Mono */
         if ((src_channels == 2) && (dst_channels == 1)) {
-            SDL_AudioFilter filter = NULL;
-
-            #if HAVE_SSE3_INTRINSICS
-            if (SDL_HasSSE3()) {
-                filter = SDL_ConvertStereoToMono_SSE3;
-            }
-            #endif
-
-            if (!filter) {
-                filter = SDL_ConvertStereoToMono;
-            }
-
-            if (SDL_AddAudioCVTFilter(cvt, filter) < 0) {
-                return -1;
-            }
-
+            channel_converters[num_channel_converters++] = &StereoToMonoConverter;
             src_channels = 1;
             cvt->len_ratio /= 2;
         }
@@ -1070,6 +2393,10 @@ SDL_BuildAudioCVT(SDL_AudioCVT * cvt,
            handled by now, but let's be defensive */
       return SDL_SetError("Invalid channel combination");
     }
+
+    if (SDL_AddChannelConverters(cvt, channel_converters, num_channel_converters) < 0) {
+        return -1;
+    }
     
     /* Do rate conversion, if necessary. Updates (cvt). */
     if (SDL_BuildAudioResampleCVT(cvt, dst_channels, src_rate, dst_rate) < 0) {
@@ -1114,9 +2441,13 @@ struct _SDL_AudioStream
     int resampler_padding_samples;
     float *resampler_padding;
     void *resampler_state;
+    const SDL_ResampleBank *resampler_bank;
+    int resampler_position;
+    SDL_AudioResamplerQuality resampler_quality;
     SDL_ResampleAudioStreamFunc resampler_func;
     SDL_ResetAudioStreamResamplerFunc reset_resampler_func;
     SDL_CleanupAudioStreamResamplerFunc cleanup_resampler_func;
+    SDL_bool fused;
 };
 
 static Uint8 *
@@ -1243,7 +2574,13 @@ SDL_ResampleAudioStream(SDL_AudioStream *stream, const void *_inbuf, const int i
 
     SDL_assert(inbuf != ((const float *) outbuf));  /* SDL_AudioStreamPut() shouldn't allow in-place resamples. */
 
-    retval = SDL_ResampleAudio(chans, inrate, outrate, lpadding, rpadding, inbuf, inbuflen, outbuf, outbuflen);
+    if (stream->resampler_bank) {
+        retval = SDL_ResampleAudioFixedRatio(chans, inrate, outrate, stream->resampler_bank, &stream->resampler_position,
+                                             lpadding, rpadding, inbuf, inbuflen, outbuf, outbuflen);
+    } else {
+        retval = SDL_ResampleAudioAtQuality(chans, inrate, outrate, stream->resampler_quality, &stream->resampler_position,
+                                            lpadding, rpadding, inbuf, inbuflen, outbuf, outbuflen);
+    }
 
     /* update our left padding with end of current input, for next run. */
     SDL_memcpy((lpadding + paddingsamples) - (cpy / sizeof (float)), inbufend - cpy, cpy);
@@ -1256,6 +2593,7 @@ SDL_ResetAudioStreamResampler(SDL_AudioStream *stream)
     /* set all the padding to silence. */
     const int len = stream->resampler_padding_samples;
     SDL_memset(stream->resampler_state, '\0', len * sizeof (float));
+    stream->resampler_position = 0;
 }
 
 static void
@@ -1264,6 +2602,97 @@ SDL_CleanupAudioStreamResampler(SDL_AudioStream *stream)
     SDL_free(stream->resampler_state);
 }
 
+/* Only the sinc qualities have filter banks; the others are cheap anyhow. */
+static const SDL_ResampleBank *
+ChooseResampleBank(const int inrate, const int outrate, const SDL_AudioResamplerQuality quality)
+{
+    switch (quality) {
+        case SDL_RESAMPLER_QUALITY_SHORT_SINC: return SDL_GetResampleBank(inrate, outrate, RESAMPLER_SHORT_TAPS);
+        case SDL_RESAMPLER_QUALITY_SINC: return SDL_GetResampleBank(inrate, outrate, RESAMPLER_TAPS);
+        default: break;
+    }
+    return NULL;
+}
+
+static int
+SetupBuiltInResampling(SDL_AudioStream *stream)
+{
+    float *state;
+
+    if (SDL_PrepareResampleFilter() < 0) {
+        return -1;
+    }
+
+    state = (float *) SDL_calloc(stream->resampler_padding_samples, sizeof (float));
+    if (!state) {
+        return SDL_OutOfMemory();
+    }
+
+    /* replace whatever resampler we had before, if any. */
+    if (stream->cleanup_resampler_func) {
+        stream->cleanup_resampler_func(stream);
+    }
+
+    stream->resampler_state = state;
+    stream->resampler_position = 0;
+    stream->resampler_bank = ChooseResampleBank(stream->src_rate, stream->dst_rate, stream->resampler_quality);
+
+    stream->resampler_func = SDL_ResampleAudioStream;
+    stream->reset_resampler_func = SDL_ResetAudioStreamResampler;
+    stream->cleanup_resampler_func = SDL_CleanupAudioStreamResampler;
+    return 0;
+}
+
+/* The most common stream by far takes S16 stereo from a game or a decoder and
+   feeds a float device, so that gets a fused path: instead of running each
+   conversion step over the whole put, it converts, resamples and remixes a
+   block at a time, which keeps the intermediate data in cache and the work
+   buffer small. Blocks are small enough to sit in L1 with the resampler's
+   output next to them. */
+#define FUSED_BLOCK_FRAMES 1024
+
+static SDL_bool
+SDL_CanFuseAudioStream(const SDL_AudioFormat src_format, const Uint8 src_channels,
+                       const SDL_AudioFormat dst_format, const Uint8 dst_channels)
+{
+    return ((src_format == AUDIO_S16SYS) && (src_channels == 2) &&
+            (dst_format == AUDIO_F32SYS) && ((dst_channels == 2) || (dst_channels == 6)));
+}
+
+/* Uses whichever SIMD converter SDL_ChooseAudioConverters() picked. Those
+   work in place, growing the data from the end, so the block gets copied
+   to (dst) first; it's already in cache for the conversion. */
+static void
+SDL_FusedConvertS16ToF32(const Sint16 *src, float *dst, const int samples)
+{
+    SDL_AudioCVT cvt;
+
+    SDL_memcpy(dst, src, samples * sizeof (Sint16));
+    SDL_zero(cvt);
+    cvt.buf = (Uint8 *) dst;
+    cvt.len_cvt = samples * (int) sizeof (Sint16);
+    cvt.filters[0] = SDL_Convert_S16_to_F32;
+    SDL_Convert_S16_to_F32(&cvt, AUDIO_S16SYS);
+}
+
+/* This matches SDL_ConvertStereoTo51() */
+static void
+SDL_FusedStereoTo51(const float *src, float *dst, const int frames)
+{
+    int i;
+    for (i = 0; i < frames; i++, src += 2, dst += 6) {
+        const float lf = src[0];
+        const float rf = src[1];
+        const float ce = (lf + rf) * 0.5f;
+        dst[0] = lf + (lf - ce);  /* FL */
+        dst[1] = rf + (rf - ce);  /* FR */
+        dst[2] = ce;  /* FC */
+        dst[3] = 0;   /* LFE */
+        dst[4] = lf;  /* BL */
+        dst[5] = rf;  /* BR */
+    }
+}
+
 SDL_AudioStream *
 SDL_NewAudioStream(const SDL_AudioFormat src_format,
                    const Uint8 src_channels,
@@ -1298,6 +2727,7 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
     retval->dst_rate = dst_rate;
     retval->pre_resample_channels = pre_resample_channels;
     retval->packetlen = packetlen;
+    retval->resampler_quality = SDL_RESAMPLER_QUALITY_SINC;
     retval->rate_incr = ((double) dst_rate) / ((double) src_rate);
     retval->resampler_padding_samples = ResamplerPadding(retval->src_rate, retval->dst_rate) * pre_resample_channels;
     retval->resampler_padding = (float *) SDL_calloc(retval->resampler_padding_samples ? retval->resampler_padding_samples : 1, sizeof (float));
@@ -1338,23 +2768,10 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
 #endif
 
         if (!retval->resampler_func) {
-            retval->resampler_state = SDL_calloc(retval->resampler_padding_samples, sizeof (float));
-            if (!retval->resampler_state) {
-                SDL_FreeAudioStream(retval);
-                SDL_OutOfMemory();
-                return NULL;
-            }
-
-            if (SDL_PrepareResampleFilter() < 0) {
-                SDL_free(retval->resampler_state);
-                retval->resampler_state = NULL;
+            if (SetupBuiltInResampling(retval) < 0) {
                 SDL_FreeAudioStream(retval);
                 return NULL;
             }
-
-            retval->resampler_func = SDL_ResampleAudioStream;
-            retval->reset_resampler_func = SDL_ResetAudioStreamResampler;
-            retval->cleanup_resampler_func = SDL_CleanupAudioStreamResampler;
         }
 
         /* Convert us to the final format after resampling. */
@@ -1364,6 +2781,8 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
         }
     }
 
+    retval->fused = SDL_CanFuseAudioStream(src_format, src_channels, dst_format, dst_channels);
+
     retval->queue = SDL_NewDataQueue(packetlen, packetlen * 2);
     if (!retval->queue) {
         SDL_FreeAudioStream(retval);
@@ -1373,6 +2792,91 @@ SDL_NewAudioStream(const SDL_AudioFormat src_format,
     return retval;
 }
 
+/* Same results as the unfused path below; the resampler keeps its position
+   and padding across calls, so feeding it a block at a time is the same as
+   feeding it the whole put. */
+static int
+SDL_AudioStreamPutFused(SDL_AudioStream *stream, const void *buf, int len, int *maxputbytes)
+{
+    const Sint16 *src = (const Sint16 *) buf;
+    const SDL_bool resampling = (stream->src_rate != stream->dst_rate);
+    const int dstchans = stream->dst_channels;
+    const int neededpaddingbytes = stream->resampler_padding_samples * sizeof (float);
+    const int blockframes = SDL_max(FUSED_BLOCK_FRAMES, stream->resampler_padding_samples / 2);
+    const int maxoutframes = resampling ? (int) SDL_ceil(blockframes * stream->rate_incr) : blockframes;
+    int frames = len / stream->src_sample_frame_size;
+    float *inblock, *resampled, *outblock;
+    Uint8 *workbuf;
+
+    /* Resampler padding and the converted block, the resampled block, and the remixed block. */
+    workbuf = EnsureStreamBufferSize(stream, neededpaddingbytes + ((blockframes * 2) + (maxoutframes * (2 + dstchans))) * sizeof (float));
+    if (!workbuf) {
+        return -1;  /* probably out of memory. */
+    }
+
+    inblock = (float *) workbuf;
+    resampled = inblock + (stream->resampler_padding_samples + (blockframes * 2));
+    outblock = resampled + (maxoutframes * 2);
+
+    while (frames > 0) {
+        const int blocklen = SDL_min(frames, blockframes);
+        const float *output = outblock;
+        int outframes;
+        int outbytes;
+
+        if (!resampling) {
+            if (dstchans == 6) {
+                SDL_FusedConvertS16ToF32(src, inblock, blocklen * 2);
+                SDL_FusedStereoTo51(inblock, outblock, blocklen);
+            } else {
+                SDL_FusedConvertS16ToF32(src, outblock, blocklen * 2);
+            }
+            outframes = blocklen;
+        } else {
+            /* This is the same padding dance that SDL_AudioStreamPutInternal() does. */
+            const int paddingbytes = stream->first_run ? 0 : neededpaddingbytes;
+            const int buflen = paddingbytes + (blocklen * 2 * sizeof (float));
+            stream->first_run = SDL_FALSE;
+
+            if (paddingbytes) {
+                SDL_memcpy(inblock, stream->resampler_padding, paddingbytes);
+            }
+            SDL_FusedConvertS16ToF32(src, (float *) (((Uint8 *) inblock) + paddingbytes), blocklen * 2);
+            SDL_memcpy(stream->resampler_padding, ((Uint8 *) inblock) + (buflen - neededpaddingbytes), neededpaddingbytes);
+
+            SDL_assert(buflen >= neededpaddingbytes);
+            outbytes = 0;
+            if (buflen > neededpaddingbytes) {
+                outbytes = stream->resampler_func(stream, inblock, buflen - neededpaddingbytes, resampled, maxoutframes * 2 * sizeof (float));
+            }
+            outframes = outbytes / (2 * sizeof (float));
+
+            if (dstchans == 6) {
+                SDL_FusedStereoTo51(resampled, outblock, outframes);
+            } else {
+                output = resampled;
+            }
+        }
+
+        src += blocklen * 2;
+        frames -= blocklen;
+
+        outbytes = outframes * stream->dst_sample_frame_size;
+        if (maxputbytes) {
+            const int maxbytes = *maxputbytes;
+            if (outbytes > maxbytes)
+                outbytes = maxbytes;
+            *maxputbytes -= outbytes;
+        }
+
+        if (outbytes && (SDL_WriteToDataQueue(stream->queue, output, outbytes) < 0)) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
 static int
 SDL_AudioStreamPutInternal(SDL_AudioStream *stream, const void *buf, int len, int *maxputbytes)
 {
@@ -1384,6 +2888,10 @@ SDL_AudioStreamPutInternal(SDL_AudioStream *stream, const void *buf, int len, in
     int neededpaddingbytes;
     int paddingbytes;
 
+    if (stream->fused) {
+        return SDL_AudioStreamPutFused(stream, buf, len, maxputbytes);
+    }
+
     /* !!! FIXME: several converters can take advantage of SIMD, but only
        !!! FIXME:  if the data is aligned to 16 bytes. EnsureStreamBufferSize()
        !!! FIXME:  guarantees the buffer will align, but the
@@ -1662,6 +3170,31 @@ SDL_AudioStreamClear(SDL_AudioStream *stream)
     }
 }
 
+int
+SDL_AudioStreamSetResamplerQuality(SDL_AudioStream *stream, SDL_AudioResamplerQuality quality)
+{
+    if (!stream) {
+        return SDL_InvalidParamError("stream");
+    } else if ((quality < SDL_RESAMPLER_QUALITY_NEAREST) || (quality > SDL_RESAMPLER_QUALITY_SINC)) {
+        return SDL_InvalidParamError("quality");
+    }
+
+#ifdef HAVE_LIBSAMPLERATE_H
+    /* libsamplerate only stands in for our best quality. */
+    if ((quality != SDL_RESAMPLER_QUALITY_SINC) && (stream->resampler_func == SDL_ResampleAudioStream_SRC)) {
+        if (SetupBuiltInResampling(stream) < 0) {
+            return -1;
+        }
+    }
+#endif
+
+    stream->resampler_quality = quality;
+    if (stream->resampler_func == SDL_ResampleAudioStream) {
+        stream->resampler_bank = ChooseResampleBank(stream->src_rate, stream->dst_rate, quality);
+    }
+    return 0;
+}
+
 /* dispose of a stream */
 void
 SDL_FreeAudioStream(SDL_AudioStream *stream)
@@ -1678,5 +3211,282 @@ SDL_FreeAudioStream(SDL_AudioStream *stream)
     }
 }
 
+/* SDL_ConvertAudioSamples() gives each thread a contiguous piece of the
+   input. The built-in resampler places output frames at exact positions
+   (see SDL_ResampleAudioAtQuality()), and each piece gets the same padding
+   frames on either side that a stream would have had, so the pieces put
+   together are the same as one long SDL_AudioStreamPut(). Pieces smaller
+   than this aren't worth a thread. */
+#define CONVERT_MIN_FRAMES_PER_THREAD 16384
+
+typedef struct SDL_ConvertAudioJob
+{
+    const SDL_AudioStream *stream;
+    const Uint8 *src;  /* the whole input */
+    int first_frame;  /* this job converts input frames [first_frame, end_frame) */
+    int end_frame;
+    int position;  /* resampler position of the first output frame, relative to first_frame */
+    Uint8 *dst;  /* where this job's output goes */
+    int dst_frames;
+    int retval;
+} SDL_ConvertAudioJob;
+
+static int SDLCALL
+SDL_RunConvertAudioJob(void *data)
+{
+    SDL_ConvertAudioJob *job = (SDL_ConvertAudioJob *) data;
+    const SDL_AudioStream *stream = job->stream;
+    SDL_AudioCVT cvt_before = stream->cvt_before_resampling;
+    SDL_AudioCVT cvt_after = stream->cvt_after_resampling;
+    const SDL_bool resampling = (stream->src_rate != stream->dst_rate);
+    const int chans = stream->pre_resample_channels;
+    const int framelen = chans * sizeof (float);
+    const int paddingframes = resampling ? ResamplerPadding(stream->src_rate, stream->dst_rate) : 0;
+    const int lo = SDL_max(job->first_frame - paddingframes, 0);
+    const int hi = job->end_frame + paddingframes;  /* the caller leaves enough input after the last job. */
+    const int inlen = (hi - lo) * stream->src_sample_frame_size;
+    const int paddinglen = (paddingframes * framelen + 15) & ~15;
+    const int convertedlen = (inlen * (cvt_before.needed ? cvt_before.len_mult : 1) + 15) & ~15;
+    const int outlen = job->dst_frames * SDL_max(framelen, stream->dst_sample_frame_size) * (cvt_after.needed ? cvt_after.len_mult : 1);
+    Uint8 *workbuf;
+    Uint8 *inbuf;
+    Uint8 *outbuf;
+    int len;
+
+    job->retval = -1;
+
+    /* [left padding][input, converted in place][output] */
+    workbuf = (Uint8 *) SDL_SIMDAlloc(paddinglen + convertedlen + outlen);
+    if (!workbuf) {
+        return -1;
+    }
+    inbuf = workbuf + paddinglen;
+    outbuf = inbuf + convertedlen;
+
+    SDL_memcpy(inbuf, job->src + (lo * stream->src_sample_frame_size), inlen);
+    len = inlen;
+
+    if (!resampling) {
+        /* The stream does the whole conversion in one go when it isn't resampling. */
+        outbuf = inbuf;
+    } else {
+        /* Left padding is whatever input comes before this piece, or silence
+           at the start, just like a fresh stream. */
+        const float *lpadding = (const float *) workbuf;
+        const int lpaddingframes = job->first_frame - lo;
+        const float *resamplein;
+        int position = job->position;
+
+        if (cvt_before.needed) {
+            cvt_before.buf = inbuf;
+            cvt_before.len = len;
+            if (SDL_ConvertAudio(&cvt_before) < 0) {
+                SDL_SIMDFree(workbuf);
+                return -1;
+            }
+            len = cvt_before.len_cvt;
+        }
+        SDL_assert(len == (hi - lo) * framelen);
+
+        SDL_memset(workbuf, '\0', paddinglen);
+        lpadding += (paddinglen / sizeof (float)) - (paddingframes * chans);
+        SDL_memcpy((float *) lpadding + ((paddingframes - lpaddingframes) * chans), inbuf, lpaddingframes * framelen);
+
+        resamplein = ((const float *) inbuf) + (lpaddingframes * chans);
+        len = (job->end_frame - job->first_frame) * framelen;
+        if (stream->resampler_bank) {
+            len = SDL_ResampleAudioFixedRatio(chans, stream->src_rate, stream->dst_rate, stream->resampler_bank, &position,
+                                              lpadding, resamplein + (len / sizeof (float)), resamplein, len,
+                                              (float *) outbuf, job->dst_frames * framelen);
+        } else {
+            len = SDL_ResampleAudioAtQuality(chans, stream->src_rate, stream->dst_rate, stream->resampler_quality, &position,
+                                             lpadding, resamplein + (len / sizeof (float)), resamplein, len,
+                                             (float *) outbuf, job->dst_frames * framelen);
+        }
+        SDL_assert(len == job->dst_frames * framelen);
+    }
+
+    if (cvt_after.needed && (len > 0)) {
+        cvt_after.buf = outbuf;
+        cvt_after.len = len;
+        if (SDL_ConvertAudio(&cvt_after) < 0) {
+            SDL_SIMDFree(workbuf);
+            return -1;
+        }
+        len = cvt_after.len_cvt;
+    }
+
+    SDL_assert(len == job->dst_frames * stream->dst_sample_frame_size);
+    SDL_memcpy(job->dst, outbuf, len);
+    SDL_SIMDFree(workbuf);
+    job->retval = 0;
+    return 0;
+}
+
+static int
+SDL_ConvertAudioSamplesWithStream(SDL_AudioStream *stream, const void *src, int src_len, void **dst, int *dst_len)
+{
+    Uint8 *buf;
+    int len;
+
+    if ((SDL_AudioStreamPut(stream, src, src_len) < 0) || (SDL_AudioStreamFlush(stream) < 0)) {
+        return -1;
+    }
+
+    len = SDL_AudioStreamAvailable(stream);
+    buf = (Uint8 *) SDL_malloc(len ? len : 1);
+    if (!buf) {
+        return SDL_OutOfMemory();
+    }
+
+    if (len && (SDL_AudioStreamGet(stream, buf, len) != len)) {
+        SDL_free(buf);
+        return -1;
+    }
+
+    *dst = buf;
+    *dst_len = len;
+    return 0;
+}
+
+int
+SDL_ConvertAudioSamples(SDL_AudioFormat src_format, Uint8 src_channels, int src_rate,
+                        const void *src, int src_len,
+                        SDL_AudioFormat dst_format, Uint8 dst_channels, int dst_rate,
+                        void **dst, int *dst_len, int num_threads)
+{
+    SDL_AudioStream *stream;
+    SDL_ConvertAudioJob *jobs;
+    SDL_Thread **threads;
+    SDL_bool resampling;
+    Uint8 *buf;
+    Sint64 phases = 1, step = 1;
+    int src_frames, work_frames, total_frames;
+    int retval = 0;
+    int i;
+
+    if (dst) {
+        *dst = NULL;
+    }
+    if (dst_len) {
+        *dst_len = 0;
+    }
+
+    if (!src) {
+        return SDL_InvalidParamError("src");
+    } else if (src_len < 0) {
+        return SDL_InvalidParamError("src_len");
+    } else if (!dst) {
+        return SDL_InvalidParamError("dst");
+    } else if (!dst_len) {
+        return SDL_InvalidParamError("dst_len");
+    }
+
+    stream = SDL_NewAudioStream(src_format, src_channels, src_rate, dst_format, dst_channels, dst_rate);
+    if (!stream) {
+        return -1;
+    }
+
+    if ((src_len % stream->src_sample_frame_size) != 0) {
+        SDL_FreeAudioStream(stream);
+        return SDL_SetError("Can't add partial sample frames");
+    }
+
+    resampling = (src_rate != dst_rate);
+    src_frames = src_len / stream->src_sample_frame_size;
+
+    /* The stream holds back its resampler's padding at the end of the input. */
+    work_frames = src_frames - (resampling ? ResamplerPadding(src_rate, dst_rate) : 0);
+
+    if (num_threads <= 0) {
+        num_threads = SDL_GetCPUCount();
+    }
+    num_threads = SDL_min(num_threads, work_frames / CONVERT_MIN_FRAMES_PER_THREAD);
+
+    /* libsamplerate keeps its own state, so it can only run from start to end. */
+    if ((num_threads <= 1) || (resampling && (stream->resampler_func != SDL_ResampleAudioStream))) {
+        retval = SDL_ConvertAudioSamplesWithStream(stream, src, src_len, dst, dst_len);
+        SDL_FreeAudioStream(stream);
+        return retval;
+    }
+
+    if (resampling) {
+        /* Output frame n lies at input frame (n * step / phases), exactly. */
+        const int gcd = GreatestCommonDivisor(src_rate, dst_rate);
+        phases = dst_rate / gcd;
+        step = src_rate / gcd;
+    }
+
+    jobs = (SDL_ConvertAudioJob *) SDL_calloc(num_threads, sizeof (SDL_ConvertAudioJob));
+    threads = (SDL_Thread **) SDL_calloc(num_threads, sizeof (SDL_Thread *));
+    if (!jobs || !threads) {
+        SDL_free(jobs);
+        SDL_free(threads);
+        SDL_FreeAudioStream(stream);
+        return SDL_OutOfMemory();
+    }
+
+    total_frames = 0;
+    for (i = 0; i < num_threads; i++) {
+        const int first_frame = (int) (((Sint64) work_frames * i) / num_threads);
+        const int end_frame = (int) (((Sint64) work_frames * (i + 1)) / num_threads);
+        const Sint64 first_out = ((first_frame * phases) + step - 1) / step;
+        const Sint64 end_out = ((end_frame * phases) + step - 1) / step;
+        jobs[i].stream = stream;
+        jobs[i].src = (const Uint8 *) src;
+        jobs[i].first_frame = first_frame;
+        jobs[i].end_frame = end_frame;
+        jobs[i].position = (int) ((first_out * step) - (first_frame * phases));
+        jobs[i].dst_frames = (int) (end_out - first_out);
+        total_frames += jobs[i].dst_frames;
+    }
+
+    buf = (Uint8 *) SDL_malloc(total_frames ? (total_frames * stream->dst_sample_frame_size) : 1);
+    if (!buf) {
+        SDL_free(jobs);
+        SDL_free(threads);
+        SDL_FreeAudioStream(stream);
+        return SDL_OutOfMemory();
+    }
+
+    total_frames = 0;
+    for (i = 0; i < num_threads; i++) {
+        jobs[i].dst = buf + (total_frames * stream->dst_sample_frame_size);
+        total_frames += jobs[i].dst_frames;
+    }
+
+    /* This thread takes the first piece; if a thread can't start, we do its piece here too. */
+    for (i = 1; i < num_threads; i++) {
+        threads[i] = SDL_CreateThreadInternal(SDL_RunConvertAudioJob, "SDLAudioConv", 0, &jobs[i]);
+        if (!threads[i]) {
+            SDL_RunConvertAudioJob(&jobs[i]);
+        }
+    }
+    SDL_RunConvertAudioJob(&jobs[0]);
+
+    for (i = 0; i < num_threads; i++) {
+        if (threads[i]) {
+            SDL_WaitThread(threads[i], NULL);
+        }
+        if (jobs[i].retval < 0) {
+            retval = -1;
+        }
+    }
+
+    *dst_len = total_frames * stream->dst_sample_frame_size;
+    SDL_free(jobs);
+    SDL_free(threads);
+    SDL_FreeAudioStream(stream);
+
+    if (retval < 0) {
+        SDL_free(buf);
+        *dst_len = 0;
+        return SDL_OutOfMemory();  /* the jobs only fail when they can't allocate memory. */
+    }
+
+    *dst = buf;
+    return 0;
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
 
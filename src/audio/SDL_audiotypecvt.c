@@ -23,14 +23,7 @@
 #include "SDL_audio.h"
 #include "SDL_audio_c.h"
 #include "SDL_cpuinfo.h"
-
-#ifdef __ARM_NEON
-#define HAVE_NEON_INTRINSICS 1
-#endif
-
-#ifdef __SSE2__
-#define HAVE_SSE2_INTRINSICS 1
-#endif
+#include "SDL_hints.h"
 
 #if defined(__x86_64__) && HAVE_SSE2_INTRINSICS
 #define NEED_SCALAR_CONVERTER_FALLBACKS 0  /* x86_64 guarantees SSE2. */
@@ -42,7 +35,8 @@
 #define NEED_SCALAR_CONVERTER_FALLBACKS 0  /* All Apple ARMv7 chips promise NEON support. */
 #endif
 
-/* Set to zero if platform is guaranteed to use a SIMD codepath here. */
+/* Set to zero if platform is guaranteed to use a SIMD codepath here. The
+   scalar converters still get built, so they can be forced for testing. */
 #ifndef NEED_SCALAR_CONVERTER_FALLBACKS
 #define NEED_SCALAR_CONVERTER_FALLBACKS 1
 #endif
@@ -65,7 +59,6 @@ SDL_AudioFilter SDL_Convert_F32_to_S32 = NULL;
 #define DIVBY8388607 0.00000011920930376163766f
 
 
-#if NEED_SCALAR_CONVERTER_FALLBACKS
 static void SDLCALL
 SDL_Convert_S8_to_F32_Scalar(SDL_AudioCVT *cvt, SDL_AudioFormat format)
 {
@@ -288,7 +281,6 @@ SDL_Convert_F32_to_S32_Scalar(SDL_AudioCVT *cvt, SDL_AudioFormat format)
         cvt->filters[cvt->filter_index](cvt, AUDIO_S32SYS);
     }
 }
-#endif
 
 
 #if HAVE_SSE2_INTRINSICS
@@ -850,50 +842,37 @@ SDL_Convert_F32_to_S32_SSE2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
 #endif
 
 
-#if HAVE_NEON_INTRINSICS
-static void SDLCALL
-SDL_Convert_S8_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+#if HAVE_AVX2_INTRINSICS
+/* The AVX2 and AVX-512 converters do the same math as the SSE2 ones, just
+   wider. Unaligned loads cost next to nothing on CPUs that have AVX2, so
+   only dst gets aligned; stores that split cache lines are still slow.
+   Converters that grow the buffer work from the end back, so they never
+   overwrite samples they haven't read yet. */
+SDL_TARGETING("avx2") static void SDLCALL
+SDL_Convert_S8_to_F32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
 {
-    const Sint8 *src = ((const Sint8 *) (cvt->buf + cvt->len_cvt)) - 1;
-    float *dst = ((float *) (cvt->buf + cvt->len_cvt * 4)) - 1;
+    const Sint8 *src = (const Sint8 *) (cvt->buf + cvt->len_cvt);
+    float *dst = (float *) (cvt->buf + cvt->len_cvt * 4);
+    const __m256 divby128 = _mm256_set1_ps(DIVBY128);
     int i;
 
-    LOG_DEBUG_CONVERT("AUDIO_S8", "AUDIO_F32 (using NEON)");
+    LOG_DEBUG_CONVERT("AUDIO_S8", "AUDIO_F32 (using AVX2)");
 
-    /* Get dst aligned to 16 bytes (since buffer is growing, we don't have to worry about overreading from src) */
-    for (i = cvt->len_cvt; i && (((size_t) (dst-15)) & 15); --i, --src, --dst) {
+    /* Get dst aligned to 32 bytes (since buffer is growing, we don't have to worry about overreading from src) */
+    for (i = cvt->len_cvt; i && (((size_t) dst) & 31); --i) {
+        --src; --dst;
         *dst = ((float) *src) * DIVBY128;
     }
 
-    src -= 15; dst -= 15;  /* adjust to read NEON blocks from the start. */
-    SDL_assert(!i || ((((size_t) dst) & 15) == 0));
-
-    /* Make sure src is aligned too. */
-    if ((((size_t) src) & 15) == 0) {
-        /* Aligned! Do NEON blocks as long as we have 16 bytes available. */
-        const int8_t *mmsrc = (const int8_t *) src;
-        const float32x4_t divby128 = vdupq_n_f32(DIVBY128);
-        while (i >= 16) {   /* 16 * 8-bit */
-            const int8x16_t bytes = vld1q_s8(mmsrc);  /* get 16 sint8 into a NEON register. */
-            const int16x8_t int16hi = vmovl_s8(vget_high_s8(bytes));  /* convert top 8 bytes to 8 int16 */
-            const int16x8_t int16lo = vmovl_s8(vget_low_s8(bytes));   /* convert bottom 8 bytes to 8 int16 */
-            /* split int16 to two int32, then convert to float, then multiply to normalize, store. */
-            vst1q_f32(dst, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(int16lo))), divby128));
-            vst1q_f32(dst+4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(int16lo))), divby128));
-            vst1q_f32(dst+8, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(int16hi))), divby128));
-            vst1q_f32(dst+12, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(int16hi))), divby128));
-            i -= 16; mmsrc -= 16; dst -= 16;
-        }
-
-        src = (const Sint8 *) mmsrc;
+    for (; i >= 8; i -= 8) {
+        src -= 8; dst -= 8;
+        _mm256_storeu_ps(dst, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_loadl_epi64((const __m128i *) src))), divby128));
     }
 
-    src += 15; dst += 15;  /* adjust for any scalar finishing. */
-
     /* Finish off any leftovers with scalar operations. */
-    while (i) {
+    while (i--) {
+        --src; --dst;
         *dst = ((float) *src) * DIVBY128;
-        i--; src--; dst--;
     }
 
     cvt->len_cvt *= 4;
@@ -902,50 +881,33 @@ SDL_Convert_S8_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
     }
 }
 
-static void SDLCALL
-SDL_Convert_U8_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+SDL_TARGETING("avx2") static void SDLCALL
+SDL_Convert_U8_to_F32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
 {
-    const Uint8 *src = ((const Uint8 *) (cvt->buf + cvt->len_cvt)) - 1;
-    float *dst = ((float *) (cvt->buf + cvt->len_cvt * 4)) - 1;
+    const Uint8 *src = (const Uint8 *) (cvt->buf + cvt->len_cvt);
+    float *dst = (float *) (cvt->buf + cvt->len_cvt * 4);
+    const __m256 divby128 = _mm256_set1_ps(DIVBY128);
+    const __m256 minus1 = _mm256_set1_ps(-1.0f);
     int i;
 
-    LOG_DEBUG_CONVERT("AUDIO_U8", "AUDIO_F32 (using NEON)");
+    LOG_DEBUG_CONVERT("AUDIO_U8", "AUDIO_F32 (using AVX2)");
 
-    /* Get dst aligned to 16 bytes (since buffer is growing, we don't have to worry about overreading from src) */
-    for (i = cvt->len_cvt; i && (((size_t) (dst-15)) & 15); --i, --src, --dst) {
+    /* Get dst aligned to 32 bytes (since buffer is growing, we don't have to worry about overreading from src) */
+    for (i = cvt->len_cvt; i && (((size_t) dst) & 31); --i) {
+        --src; --dst;
         *dst = (((float) *src) * DIVBY128) - 1.0f;
     }
 
-    src -= 15; dst -= 15;  /* adjust to read NEON blocks from the start. */
-    SDL_assert(!i || ((((size_t) dst) & 15) == 0));
-
-    /* Make sure src is aligned too. */
-    if ((((size_t) src) & 15) == 0) {
-        /* Aligned! Do NEON blocks as long as we have 16 bytes available. */
-        const uint8_t *mmsrc = (const uint8_t *) src;
-        const float32x4_t divby128 = vdupq_n_f32(DIVBY128);
-        const float32x4_t negone = vdupq_n_f32(-1.0f);
-        while (i >= 16) {   /* 16 * 8-bit */
-            const uint8x16_t bytes = vld1q_u8(mmsrc);  /* get 16 uint8 into a NEON register. */
-            const uint16x8_t uint16hi = vmovl_u8(vget_high_u8(bytes));  /* convert top 8 bytes to 8 uint16 */
-            const uint16x8_t uint16lo = vmovl_u8(vget_low_u8(bytes));   /* convert bottom 8 bytes to 8 uint16 */
-            /* split uint16 to two uint32, then convert to float, then multiply to normalize, subtract to adjust for sign, store. */
-            vst1q_f32(dst, vmlaq_f32(negone, vcvtq_f32_u32(vmovl_u16(vget_low_u16(uint16lo))), divby128));
-            vst1q_f32(dst+4, vmlaq_f32(negone, vcvtq_f32_u32(vmovl_u16(vget_high_u16(uint16lo))), divby128));
-            vst1q_f32(dst+8, vmlaq_f32(negone, vcvtq_f32_u32(vmovl_u16(vget_low_u16(uint16hi))), divby128));
-            vst1q_f32(dst+12, vmlaq_f32(negone, vcvtq_f32_u32(vmovl_u16(vget_high_u16(uint16hi))), divby128));
-            i -= 16; mmsrc -= 16; dst -= 16;
-        }
-
-        src = (const Uint8 *) mmsrc;
+    for (; i >= 8; i -= 8) {
+        src -= 8; dst -= 8;
+        /* Multiply and add separately; a fused multiply-add would round differently than the other paths. */
+        _mm256_storeu_ps(dst, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) src))), divby128), minus1));
     }
 
-    src += 15; dst += 15;  /* adjust for any scalar finishing. */
-
     /* Finish off any leftovers with scalar operations. */
-    while (i) {
+    while (i--) {
+        --src; --dst;
         *dst = (((float) *src) * DIVBY128) - 1.0f;
-        i--; src--; dst--;
     }
 
     cvt->len_cvt *= 4;
@@ -954,42 +916,31 @@ SDL_Convert_U8_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
     }
 }
 
-static void SDLCALL
-SDL_Convert_S16_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+SDL_TARGETING("avx2") static void SDLCALL
+SDL_Convert_S16_to_F32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
 {
-    const Sint16 *src = ((const Sint16 *) (cvt->buf + cvt->len_cvt)) - 1;
-    float *dst = ((float *) (cvt->buf + cvt->len_cvt * 2)) - 1;
+    const Sint16 *src = (const Sint16 *) (cvt->buf + cvt->len_cvt);
+    float *dst = (float *) (cvt->buf + cvt->len_cvt * 2);
+    const __m256 divby32768 = _mm256_set1_ps(DIVBY32768);
     int i;
 
-    LOG_DEBUG_CONVERT("AUDIO_S16", "AUDIO_F32 (using NEON)");
+    LOG_DEBUG_CONVERT("AUDIO_S16", "AUDIO_F32 (using AVX2)");
 
-    /* Get dst aligned to 16 bytes (since buffer is growing, we don't have to worry about overreading from src) */
-    for (i = cvt->len_cvt / sizeof (Sint16); i && (((size_t) (dst-7)) & 15); --i, --src, --dst) {
+    /* Get dst aligned to 32 bytes (since buffer is growing, we don't have to worry about overreading from src) */
+    for (i = cvt->len_cvt / sizeof (Sint16); i && (((size_t) dst) & 31); --i) {
+        --src; --dst;
         *dst = ((float) *src) * DIVBY32768;
     }
 
-    src -= 7; dst -= 7;  /* adjust to read NEON blocks from the start. */
-    SDL_assert(!i || ((((size_t) dst) & 15) == 0));
-
-    /* Make sure src is aligned too. */
-    if ((((size_t) src) & 15) == 0) {
-        /* Aligned! Do NEON blocks as long as we have 16 bytes available. */
-        const float32x4_t divby32768 = vdupq_n_f32(DIVBY32768);
-        while (i >= 8) {   /* 8 * 16-bit */
-            const int16x8_t ints = vld1q_s16((int16_t const *) src);  /* get 8 sint16 into a NEON register. */
-            /* split int16 to two int32, then convert to float, then multiply to normalize, store. */
-            vst1q_f32(dst, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(ints))), divby32768));
-            vst1q_f32(dst+4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(ints))), divby32768));
-            i -= 8; src -= 8; dst -= 8;
-        }
+    for (; i >= 8; i -= 8) {
+        src -= 8; dst -= 8;
+        _mm256_storeu_ps(dst, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *) src))), divby32768));
     }
 
-    src += 7; dst += 7;  /* adjust for any scalar finishing. */
-
     /* Finish off any leftovers with scalar operations. */
-    while (i) {
+    while (i--) {
+        --src; --dst;
         *dst = ((float) *src) * DIVBY32768;
-        i--; src--; dst--;
     }
 
     cvt->len_cvt *= 2;
@@ -998,43 +949,32 @@ SDL_Convert_S16_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
     }
 }
 
-static void SDLCALL
-SDL_Convert_U16_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+SDL_TARGETING("avx2") static void SDLCALL
+SDL_Convert_U16_to_F32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
 {
-    const Uint16 *src = ((const Uint16 *) (cvt->buf + cvt->len_cvt)) - 1;
-    float *dst = ((float *) (cvt->buf + cvt->len_cvt * 2)) - 1;
+    const Uint16 *src = (const Uint16 *) (cvt->buf + cvt->len_cvt);
+    float *dst = (float *) (cvt->buf + cvt->len_cvt * 2);
+    const __m256 divby32768 = _mm256_set1_ps(DIVBY32768);
+    const __m256 minus1 = _mm256_set1_ps(-1.0f);
     int i;
 
-    LOG_DEBUG_CONVERT("AUDIO_U16", "AUDIO_F32 (using NEON)");
+    LOG_DEBUG_CONVERT("AUDIO_U16", "AUDIO_F32 (using AVX2)");
 
-    /* Get dst aligned to 16 bytes (since buffer is growing, we don't have to worry about overreading from src) */
-    for (i = cvt->len_cvt / sizeof (Sint16); i && (((size_t) (dst-7)) & 15); --i, --src, --dst) {
+    /* Get dst aligned to 32 bytes (since buffer is growing, we don't have to worry about overreading from src) */
+    for (i = cvt->len_cvt / sizeof (Uint16); i && (((size_t) dst) & 31); --i) {
+        --src; --dst;
         *dst = (((float) *src) * DIVBY32768) - 1.0f;
     }
 
-    src -= 7; dst -= 7;  /* adjust to read NEON blocks from the start. */
-    SDL_assert(!i || ((((size_t) dst) & 15) == 0));
-
-    /* Make sure src is aligned too. */
-    if ((((size_t) src) & 15) == 0) {
-        /* Aligned! Do NEON blocks as long as we have 16 bytes available. */
-        const float32x4_t divby32768 = vdupq_n_f32(DIVBY32768);
-        const float32x4_t negone = vdupq_n_f32(-1.0f);
-        while (i >= 8) {   /* 8 * 16-bit */
-            const uint16x8_t uints = vld1q_u16((uint16_t const *) src);  /* get 8 uint16 into a NEON register. */
-            /* split uint16 to two int32, then convert to float, then multiply to normalize, subtract for sign, store. */
-            vst1q_f32(dst, vmlaq_f32(negone, vcvtq_f32_u32(vmovl_u16(vget_low_u16(uints))), divby32768));
-            vst1q_f32(dst+4, vmlaq_f32(negone, vcvtq_f32_u32(vmovl_u16(vget_high_u16(uints))), divby32768));
-            i -= 8; src -= 8; dst -= 8;
-        }
+    for (; i >= 8; i -= 8) {
+        src -= 8; dst -= 8;
+        _mm256_storeu_ps(dst, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) src))), divby32768), minus1));
     }
 
-    src += 7; dst += 7;  /* adjust for any scalar finishing. */
-
     /* Finish off any leftovers with scalar operations. */
-    while (i) {
+    while (i--) {
+        --src; --dst;
         *dst = (((float) *src) * DIVBY32768) - 1.0f;
-        i--; src--; dst--;
     }
 
     cvt->len_cvt *= 2;
@@ -1043,39 +983,30 @@ SDL_Convert_U16_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
     }
 }
 
-static void SDLCALL
-SDL_Convert_S32_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+SDL_TARGETING("avx2") static void SDLCALL
+SDL_Convert_S32_to_F32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
 {
     const Sint32 *src = (const Sint32 *) cvt->buf;
     float *dst = (float *) cvt->buf;
+    const __m256 divby8388607 = _mm256_set1_ps(DIVBY8388607);
     int i;
 
-    LOG_DEBUG_CONVERT("AUDIO_S32", "AUDIO_F32 (using NEON)");
+    LOG_DEBUG_CONVERT("AUDIO_S32", "AUDIO_F32 (using AVX2)");
 
-    /* Get dst aligned to 16 bytes */
-    for (i = cvt->len_cvt / sizeof (Sint32); i && (((size_t) dst) & 15); --i, ++src, ++dst) {
+    /* Get dst aligned to 32 bytes */
+    for (i = cvt->len_cvt / sizeof (Sint32); i && (((size_t) dst) & 31); --i, ++src, ++dst) {
         *dst = ((float) (*src>>8)) * DIVBY8388607;
     }
 
-    SDL_assert(!i || ((((size_t) dst) & 15) == 0));
-
-    /* Make sure src is aligned too. */
-    if ((((size_t) src) & 15) == 0) {
-        /* Aligned! Do NEON blocks as long as we have 16 bytes available. */
-        const float32x4_t divby8388607 = vdupq_n_f32(DIVBY8388607);
-        const int32_t *mmsrc = (const int32_t *) src;
-        while (i >= 4) {   /* 4 * sint32 */
-            /* shift out lowest bits so int fits in a float32. Small precision loss, but much faster. */
-            vst1q_f32(dst, vmulq_f32(vcvtq_f32_s32(vshrq_n_s32(vld1q_s32(mmsrc), 8)), divby8388607));
-            i -= 4; mmsrc += 4; dst += 4;
-        }
-        src = (const Sint32 *) mmsrc;
+    for (; i >= 8; i -= 8, src += 8, dst += 8) {
+        /* shift out lowest bits so int fits in a float32. Small precision loss, but much faster. */
+        _mm256_storeu_ps(dst, _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_loadu_si256((const __m256i *) src), 8)), divby8388607));
     }
 
     /* Finish off any leftovers with scalar operations. */
-    while (i) {
+    while (i--) {
         *dst = ((float) (*src>>8)) * DIVBY8388607;
-        i--; src++; dst++;
+        src++; dst++;
     }
 
     if (cvt->filters[++cvt->filter_index]) {
@@ -1083,14 +1014,17 @@ SDL_Convert_S32_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
     }
 }
 
-static void SDLCALL
-SDL_Convert_F32_to_S8_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+SDL_TARGETING("avx2") static void SDLCALL
+SDL_Convert_F32_to_S8_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
 {
     const float *src = (const float *) cvt->buf;
     Sint8 *dst = (Sint8 *) cvt->buf;
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 negone = _mm256_set1_ps(-1.0f);
+    const __m256 mulby127 = _mm256_set1_ps(127.0f);
     int i;
 
-    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S8 (using NEON)");
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S8 (using AVX2)");
 
     /* Get dst aligned to 16 bytes */
     for (i = cvt->len_cvt / sizeof (float); i && (((size_t) dst) & 15); --i, ++src, ++dst) {
@@ -1104,30 +1038,17 @@ SDL_Convert_F32_to_S8_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
         }
     }
 
-    SDL_assert(!i || ((((size_t) dst) & 15) == 0));
-
-    /* Make sure src is aligned too. */
-    if ((((size_t) src) & 15) == 0) {
-        /* Aligned! Do NEON blocks as long as we have 16 bytes available. */
-        const float32x4_t one = vdupq_n_f32(1.0f);
-        const float32x4_t negone = vdupq_n_f32(-1.0f);
-        const float32x4_t mulby127 = vdupq_n_f32(127.0f);
-        int8_t *mmdst = (int8_t *) dst;
-        while (i >= 16) {   /* 16 * float32 */
-            const int32x4_t ints1 = vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src)), one), mulby127));  /* load 4 floats, clamp, convert to sint32 */
-            const int32x4_t ints2 = vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src+4)), one), mulby127));  /* load 4 floats, clamp, convert to sint32 */
-            const int32x4_t ints3 = vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src+8)), one), mulby127));  /* load 4 floats, clamp, convert to sint32 */
-            const int32x4_t ints4 = vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src+12)), one), mulby127));  /* load 4 floats, clamp, convert to sint32 */
-            const int8x8_t i8lo = vmovn_s16(vcombine_s16(vmovn_s32(ints1), vmovn_s32(ints2))); /* narrow to sint16, combine, narrow to sint8 */
-            const int8x8_t i8hi = vmovn_s16(vcombine_s16(vmovn_s32(ints3), vmovn_s32(ints4))); /* narrow to sint16, combine, narrow to sint8 */
-            vst1q_s8(mmdst, vcombine_s8(i8lo, i8hi));  /* combine to int8x16_t, store out */
-            i -= 16; src += 16; mmdst += 16;
-        }
-        dst = (Sint8 *) mmdst;
+    for (; i >= 16; i -= 16, src += 16, dst += 16) {
+        const __m256i ints1 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(negone, _mm256_loadu_ps(src)), one), mulby127));  /* load 8 floats, clamp, convert to sint32 */
+        const __m256i ints2 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(negone, _mm256_loadu_ps(src+8)), one), mulby127));  /* load 8 floats, clamp, convert to sint32 */
+        /* 256-bit packs work within 128-bit lanes, so pack the halves instead to keep the order. */
+        const __m128i shorts1 = _mm_packs_epi32(_mm256_castsi256_si128(ints1), _mm256_extracti128_si256(ints1, 1));
+        const __m128i shorts2 = _mm_packs_epi32(_mm256_castsi256_si128(ints2), _mm256_extracti128_si256(ints2, 1));
+        _mm_storeu_si128((__m128i *) dst, _mm_packs_epi16(shorts1, shorts2));  /* pack down, store out. */
     }
 
     /* Finish off any leftovers with scalar operations. */
-    while (i) {
+    while (i--) {
         const float sample = *src;
         if (sample >= 1.0f) {
             *dst = 127;
@@ -1136,7 +1057,7 @@ SDL_Convert_F32_to_S8_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
         } else {
             *dst = (Sint8)(sample * 127.0f);
         }
-        i--; src++; dst++;
+        src++; dst++;
     }
 
     cvt->len_cvt /= 4;
@@ -1145,14 +1066,17 @@ SDL_Convert_F32_to_S8_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
     }
 }
 
-static void SDLCALL
-SDL_Convert_F32_to_U8_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+SDL_TARGETING("avx2") static void SDLCALL
+SDL_Convert_F32_to_U8_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
 {
     const float *src = (const float *) cvt->buf;
-    Uint8 *dst = (Uint8 *) cvt->buf;
+    Uint8 *dst = cvt->buf;
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 negone = _mm256_set1_ps(-1.0f);
+    const __m256 mulby127 = _mm256_set1_ps(127.0f);
     int i;
 
-    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_U8 (using NEON)");
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_U8 (using AVX2)");
 
     /* Get dst aligned to 16 bytes */
     for (i = cvt->len_cvt / sizeof (float); i && (((size_t) dst) & 15); --i, ++src, ++dst) {
@@ -1166,31 +1090,16 @@ SDL_Convert_F32_to_U8_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
         }
     }
 
-    SDL_assert(!i || ((((size_t) dst) & 15) == 0));
-
-    /* Make sure src is aligned too. */
-    if ((((size_t) src) & 15) == 0) {
-        /* Aligned! Do NEON blocks as long as we have 16 bytes available. */
-        const float32x4_t one = vdupq_n_f32(1.0f);
-        const float32x4_t negone = vdupq_n_f32(-1.0f);
-        const float32x4_t mulby127 = vdupq_n_f32(127.0f);
-        uint8_t *mmdst = (uint8_t *) dst;
-        while (i >= 16) {   /* 16 * float32 */
-            const uint32x4_t uints1 = vcvtq_u32_f32(vmulq_f32(vaddq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src)), one), one), mulby127));  /* load 4 floats, clamp, convert to uint32 */
-            const uint32x4_t uints2 = vcvtq_u32_f32(vmulq_f32(vaddq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src+4)), one), one), mulby127));  /* load 4 floats, clamp, convert to uint32 */
-            const uint32x4_t uints3 = vcvtq_u32_f32(vmulq_f32(vaddq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src+8)), one), one), mulby127));  /* load 4 floats, clamp, convert to uint32 */
-            const uint32x4_t uints4 = vcvtq_u32_f32(vmulq_f32(vaddq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src+12)), one), one), mulby127));  /* load 4 floats, clamp, convert to uint32 */
-            const uint8x8_t ui8lo = vmovn_u16(vcombine_u16(vmovn_u32(uints1), vmovn_u32(uints2))); /* narrow to uint16, combine, narrow to uint8 */
-            const uint8x8_t ui8hi = vmovn_u16(vcombine_u16(vmovn_u32(uints3), vmovn_u32(uints4))); /* narrow to uint16, combine, narrow to uint8 */
-            vst1q_u8(mmdst, vcombine_u8(ui8lo, ui8hi));  /* combine to uint8x16_t, store out */
-            i -= 16; src += 16; mmdst += 16;
-        }
-
-        dst = (Uint8 *) mmdst;
+    for (; i >= 16; i -= 16, src += 16, dst += 16) {
+        const __m256i ints1 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_add_ps(_mm256_min_ps(_mm256_max_ps(negone, _mm256_loadu_ps(src)), one), one), mulby127));  /* load 8 floats, clamp, convert to sint32 */
+        const __m256i ints2 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_add_ps(_mm256_min_ps(_mm256_max_ps(negone, _mm256_loadu_ps(src+8)), one), one), mulby127));  /* load 8 floats, clamp, convert to sint32 */
+        const __m128i shorts1 = _mm_packs_epi32(_mm256_castsi256_si128(ints1), _mm256_extracti128_si256(ints1, 1));
+        const __m128i shorts2 = _mm_packs_epi32(_mm256_castsi256_si128(ints2), _mm256_extracti128_si256(ints2, 1));
+        _mm_storeu_si128((__m128i *) dst, _mm_packus_epi16(shorts1, shorts2));  /* pack down, store out. */
     }
 
     /* Finish off any leftovers with scalar operations. */
-    while (i) {
+    while (i--) {
         const float sample = *src;
         if (sample >= 1.0f) {
             *dst = 255;
@@ -1199,7 +1108,7 @@ SDL_Convert_F32_to_U8_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
         } else {
             *dst = (Uint8)((sample + 1.0f) * 127.0f);
         }
-        i--; src++; dst++;
+        src++; dst++;
     }
 
     cvt->len_cvt /= 4;
@@ -1208,14 +1117,17 @@ SDL_Convert_F32_to_U8_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
     }
 }
 
-static void SDLCALL
-SDL_Convert_F32_to_S16_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+SDL_TARGETING("avx2") static void SDLCALL
+SDL_Convert_F32_to_S16_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
 {
     const float *src = (const float *) cvt->buf;
     Sint16 *dst = (Sint16 *) cvt->buf;
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 negone = _mm256_set1_ps(-1.0f);
+    const __m256 mulby32767 = _mm256_set1_ps(32767.0f);
     int i;
 
-    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S16 (using NEON)");
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S16 (using AVX2)");
 
     /* Get dst aligned to 16 bytes */
     for (i = cvt->len_cvt / sizeof (float); i && (((size_t) dst) & 15); --i, ++src, ++dst) {
@@ -1229,26 +1141,13 @@ SDL_Convert_F32_to_S16_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
         }
     }
 
-    SDL_assert(!i || ((((size_t) dst) & 15) == 0));
-
-    /* Make sure src is aligned too. */
-    if ((((size_t) src) & 15) == 0) {
-        /* Aligned! Do NEON blocks as long as we have 16 bytes available. */
-        const float32x4_t one = vdupq_n_f32(1.0f);
-        const float32x4_t negone = vdupq_n_f32(-1.0f);
-        const float32x4_t mulby32767 = vdupq_n_f32(32767.0f);
-        int16_t *mmdst = (int16_t *) dst;
-        while (i >= 8) {   /* 8 * float32 */
-            const int32x4_t ints1 = vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src)), one), mulby32767));  /* load 4 floats, clamp, convert to sint32 */
-            const int32x4_t ints2 = vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src+4)), one), mulby32767));  /* load 4 floats, clamp, convert to sint32 */
-            vst1q_s16(mmdst, vcombine_s16(vmovn_s32(ints1), vmovn_s32(ints2)));  /* narrow to sint16, combine, store out. */
-            i -= 8; src += 8; mmdst += 8;
-        }
-        dst = (Sint16 *) mmdst;
+    for (; i >= 8; i -= 8, src += 8, dst += 8) {
+        const __m256i ints = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(negone, _mm256_loadu_ps(src)), one), mulby32767));  /* load 8 floats, clamp, convert to sint32 */
+        _mm_storeu_si128((__m128i *) dst, _mm_packs_epi32(_mm256_castsi256_si128(ints), _mm256_extracti128_si256(ints, 1)));  /* pack to sint16, store out. */
     }
 
     /* Finish off any leftovers with scalar operations. */
-    while (i) {
+    while (i--) {
         const float sample = *src;
         if (sample >= 1.0f) {
             *dst = 32767;
@@ -1257,7 +1156,7 @@ SDL_Convert_F32_to_S16_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
         } else {
             *dst = (Sint16)(sample * 32767.0f);
         }
-        i--; src++; dst++;
+        src++; dst++;
     }
 
     cvt->len_cvt /= 2;
@@ -1266,14 +1165,18 @@ SDL_Convert_F32_to_S16_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
     }
 }
 
-static void SDLCALL
-SDL_Convert_F32_to_U16_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+SDL_TARGETING("avx2") static void SDLCALL
+SDL_Convert_F32_to_U16_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
 {
     const float *src = (const float *) cvt->buf;
     Uint16 *dst = (Uint16 *) cvt->buf;
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 negone = _mm256_set1_ps(-1.0f);
+    const __m256 mulby32767 = _mm256_set1_ps(32767.0f);
+    const __m128i topbit = _mm_set1_epi16(-32768);
     int i;
 
-    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_U16 (using NEON)");
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_U16 (using AVX2)");
 
     /* Get dst aligned to 16 bytes */
     for (i = cvt->len_cvt / sizeof (float); i && (((size_t) dst) & 15); --i, ++src, ++dst) {
@@ -1287,26 +1190,14 @@ SDL_Convert_F32_to_U16_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
         }
     }
 
-    SDL_assert(!i || ((((size_t) dst) & 15) == 0));
-
-    /* Make sure src is aligned too. */
-    if ((((size_t) src) & 15) == 0) {
-        /* Aligned! Do NEON blocks as long as we have 16 bytes available. */
-        const float32x4_t one = vdupq_n_f32(1.0f);
-        const float32x4_t negone = vdupq_n_f32(-1.0f);
-        const float32x4_t mulby32767 = vdupq_n_f32(32767.0f);
-        uint16_t *mmdst = (uint16_t *) dst;
-        while (i >= 8) {   /* 8 * float32 */
-            const uint32x4_t uints1 = vcvtq_u32_f32(vmulq_f32(vaddq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src)), one), one), mulby32767));  /* load 4 floats, clamp, convert to uint32 */
-            const uint32x4_t uints2 = vcvtq_u32_f32(vmulq_f32(vaddq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src+4)), one), one), mulby32767));  /* load 4 floats, clamp, convert to uint32 */
-            vst1q_u16(mmdst, vcombine_u16(vmovn_u32(uints1), vmovn_u32(uints2)));  /* narrow to uint16, combine, store out. */
-            i -= 8; src += 8; mmdst += 8;
-        }
-        dst = (Uint16 *) mmdst;
+    for (; i >= 8; i -= 8, src += 8, dst += 8) {
+        /* Same trick as the SSE2 version: pack to sint16 with signed saturation, then flip the top bit. */
+        const __m256i ints = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(negone, _mm256_loadu_ps(src)), one), mulby32767));  /* load 8 floats, clamp, convert to sint32 */
+        _mm_storeu_si128((__m128i *) dst, _mm_xor_si128(_mm_packs_epi32(_mm256_castsi256_si128(ints), _mm256_extracti128_si256(ints, 1)), topbit));
     }
 
     /* Finish off any leftovers with scalar operations. */
-    while (i) {
+    while (i--) {
         const float sample = *src;
         if (sample >= 1.0f) {
             *dst = 65535;
@@ -1315,7 +1206,7 @@ SDL_Convert_F32_to_U16_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
         } else {
             *dst = (Uint16)((sample + 1.0f) * 32767.0f);
         }
-        i--; src++; dst++;
+        src++; dst++;
     }
 
     cvt->len_cvt /= 2;
@@ -1324,39 +1215,970 @@ SDL_Convert_F32_to_U16_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
     }
 }
 
-static void SDLCALL
-SDL_Convert_F32_to_S32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+SDL_TARGETING("avx2") static void SDLCALL
+SDL_Convert_F32_to_S32_AVX2(SDL_AudioCVT *cvt, SDL_AudioFormat format)
 {
     const float *src = (const float *) cvt->buf;
     Sint32 *dst = (Sint32 *) cvt->buf;
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 negone = _mm256_set1_ps(-1.0f);
+    const __m256 mulby8388607 = _mm256_set1_ps(8388607.0f);
     int i;
 
-    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S32 (using NEON)");
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S32 (using AVX2)");
 
-    /* Get dst aligned to 16 bytes */
-    for (i = cvt->len_cvt / sizeof (float); i && (((size_t) dst) & 15); --i, ++src, ++dst) {
+    /* Get dst aligned to 32 bytes */
+    for (i = cvt->len_cvt / sizeof (float); i && (((size_t) dst) & 31); --i, ++src, ++dst) {
         const float sample = *src;
         if (sample >= 1.0f) {
             *dst = 2147483647;
         } else if (sample <= -1.0f) {
-            *dst = (-2147483647) - 1;
+            *dst = (Sint32) -2147483648LL;
         } else {
             *dst = ((Sint32)(sample * 8388607.0f)) << 8;
         }
     }
 
-    SDL_assert(!i || ((((size_t) dst) & 15) == 0));
-    SDL_assert(!i || ((((size_t) src) & 15) == 0));
+    for (; i >= 8; i -= 8, src += 8, dst += 8) {
+        _mm256_storeu_si256((__m256i *) dst, _mm256_slli_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(_mm256_min_ps(_mm256_max_ps(negone, _mm256_loadu_ps(src)), one), mulby8388607)), 8));  /* load 8 floats, clamp, convert to sint32 */
+    }
 
-    {
-        /* Aligned! Do NEON blocks as long as we have 16 bytes available. */
-        const float32x4_t one = vdupq_n_f32(1.0f);
-        const float32x4_t negone = vdupq_n_f32(-1.0f);
-        const float32x4_t mulby8388607 = vdupq_n_f32(8388607.0f);
-        int32_t *mmdst = (int32_t *) dst;
-        while (i >= 4) {   /* 4 * float32 */
-            vst1q_s32(mmdst, vshlq_n_s32(vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src)), one), mulby8388607)), 8));
-            i -= 4; src += 4; mmdst += 4;
+    /* Finish off any leftovers with scalar operations. */
+    while (i--) {
+        const float sample = *src;
+        if (sample >= 1.0f) {
+            *dst = 2147483647;
+        } else if (sample <= -1.0f) {
+            *dst = (Sint32) -2147483648LL;
+        } else {
+            *dst = ((Sint32)(sample * 8388607.0f)) << 8;
+        }
+        src++; dst++;
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_S32SYS);
+    }
+}
+#endif
+
+#if HAVE_AVX512F_INTRINSICS
+/* AVX-512F has no byte or word shuffles, but its widening loads and
+   saturating narrowing stores (vpmovsx, vpmovs) do all the packing we need. */
+SDL_TARGETING("avx512f") static void SDLCALL
+SDL_Convert_S8_to_F32_AVX512F(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Sint8 *src = (const Sint8 *) (cvt->buf + cvt->len_cvt);
+    float *dst = (float *) (cvt->buf + cvt->len_cvt * 4);
+    const __m512 divby128 = _mm512_set1_ps(DIVBY128);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_S8", "AUDIO_F32 (using AVX-512F)");
+
+    /* Get dst aligned to 64 bytes (since buffer is growing, we don't have to worry about overreading from src) */
+    for (i = cvt->len_cvt; i && (((size_t) dst) & 63); --i) {
+        --src; --dst;
+        *dst = ((float) *src) * DIVBY128;
+    }
+
+    for (; i >= 16; i -= 16) {
+        src -= 16; dst -= 16;
+        _mm512_storeu_ps(dst, _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepi8_epi32(_mm_loadu_si128((const __m128i *) src))), divby128));
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i--) {
+        --src; --dst;
+        *dst = ((float) *src) * DIVBY128;
+    }
+
+    cvt->len_cvt *= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+SDL_TARGETING("avx512f") static void SDLCALL
+SDL_Convert_U8_to_F32_AVX512F(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Uint8 *src = (const Uint8 *) (cvt->buf + cvt->len_cvt);
+    float *dst = (float *) (cvt->buf + cvt->len_cvt * 4);
+    const __m512 divby128 = _mm512_set1_ps(DIVBY128);
+    const __m512 minus1 = _mm512_set1_ps(-1.0f);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_U8", "AUDIO_F32 (using AVX-512F)");
+
+    /* Get dst aligned to 64 bytes (since buffer is growing, we don't have to worry about overreading from src) */
+    for (i = cvt->len_cvt; i && (((size_t) dst) & 63); --i) {
+        --src; --dst;
+        *dst = (((float) *src) * DIVBY128) - 1.0f;
+    }
+
+    for (; i >= 16; i -= 16) {
+        src -= 16; dst -= 16;
+        _mm512_storeu_ps(dst, _mm512_add_ps(_mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i *) src))), divby128), minus1));
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i--) {
+        --src; --dst;
+        *dst = (((float) *src) * DIVBY128) - 1.0f;
+    }
+
+    cvt->len_cvt *= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+SDL_TARGETING("avx512f") static void SDLCALL
+SDL_Convert_S16_to_F32_AVX512F(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Sint16 *src = (const Sint16 *) (cvt->buf + cvt->len_cvt);
+    float *dst = (float *) (cvt->buf + cvt->len_cvt * 2);
+    const __m512 divby32768 = _mm512_set1_ps(DIVBY32768);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_S16", "AUDIO_F32 (using AVX-512F)");
+
+    /* Get dst aligned to 64 bytes (since buffer is growing, we don't have to worry about overreading from src) */
+    for (i = cvt->len_cvt / sizeof (Sint16); i && (((size_t) dst) & 63); --i) {
+        --src; --dst;
+        *dst = ((float) *src) * DIVBY32768;
+    }
+
+    for (; i >= 16; i -= 16) {
+        src -= 16; dst -= 16;
+        _mm512_storeu_ps(dst, _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepi16_epi32(_mm256_loadu_si256((const __m256i *) src))), divby32768));
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i--) {
+        --src; --dst;
+        *dst = ((float) *src) * DIVBY32768;
+    }
+
+    cvt->len_cvt *= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+SDL_TARGETING("avx512f") static void SDLCALL
+SDL_Convert_U16_to_F32_AVX512F(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Uint16 *src = (const Uint16 *) (cvt->buf + cvt->len_cvt);
+    float *dst = (float *) (cvt->buf + cvt->len_cvt * 2);
+    const __m512 divby32768 = _mm512_set1_ps(DIVBY32768);
+    const __m512 minus1 = _mm512_set1_ps(-1.0f);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_U16", "AUDIO_F32 (using AVX-512F)");
+
+    /* Get dst aligned to 64 bytes (since buffer is growing, we don't have to worry about overreading from src) */
+    for (i = cvt->len_cvt / sizeof (Uint16); i && (((size_t) dst) & 63); --i) {
+        --src; --dst;
+        *dst = (((float) *src) * DIVBY32768) - 1.0f;
+    }
+
+    for (; i >= 16; i -= 16) {
+        src -= 16; dst -= 16;
+        _mm512_storeu_ps(dst, _mm512_add_ps(_mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i *) src))), divby32768), minus1));
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i--) {
+        --src; --dst;
+        *dst = (((float) *src) * DIVBY32768) - 1.0f;
+    }
+
+    cvt->len_cvt *= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+SDL_TARGETING("avx512f") static void SDLCALL
+SDL_Convert_S32_to_F32_AVX512F(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Sint32 *src = (const Sint32 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    const __m512 divby8388607 = _mm512_set1_ps(DIVBY8388607);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_S32", "AUDIO_F32 (using AVX-512F)");
+
+    /* Get dst aligned to 64 bytes */
+    for (i = cvt->len_cvt / sizeof (Sint32); i && (((size_t) dst) & 63); --i, ++src, ++dst) {
+        *dst = ((float) (*src>>8)) * DIVBY8388607;
+    }
+
+    for (; i >= 16; i -= 16, src += 16, dst += 16) {
+        /* shift out lowest bits so int fits in a float32. Small precision loss, but much faster. */
+        _mm512_storeu_ps(dst, _mm512_mul_ps(_mm512_cvtepi32_ps(_mm512_srai_epi32(_mm512_loadu_si512((const void *) src), 8)), divby8388607));
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i--) {
+        *dst = ((float) (*src>>8)) * DIVBY8388607;
+        src++; dst++;
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+SDL_TARGETING("avx512f") static void SDLCALL
+SDL_Convert_F32_to_S8_AVX512F(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint8 *dst = (Sint8 *) cvt->buf;
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 negone = _mm512_set1_ps(-1.0f);
+    const __m512 mulby127 = _mm512_set1_ps(127.0f);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S8 (using AVX-512F)");
+
+    /* Get dst aligned to 16 bytes */
+    for (i = cvt->len_cvt / sizeof (float); i && (((size_t) dst) & 15); --i, ++src, ++dst) {
+        const float sample = *src;
+        if (sample >= 1.0f) {
+            *dst = 127;
+        } else if (sample <= -1.0f) {
+            *dst = -128;
+        } else {
+            *dst = (Sint8)(sample * 127.0f);
+        }
+    }
+
+    for (; i >= 16; i -= 16, src += 16, dst += 16) {
+        const __m512i ints = _mm512_cvtps_epi32(_mm512_mul_ps(_mm512_min_ps(_mm512_max_ps(negone, _mm512_loadu_ps(src)), one), mulby127));  /* load 16 floats, clamp, convert to sint32 */
+        _mm_storeu_si128((__m128i *) dst, _mm512_cvtsepi32_epi8(ints));  /* pack down with signed saturation, store out. */
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i--) {
+        const float sample = *src;
+        if (sample >= 1.0f) {
+            *dst = 127;
+        } else if (sample <= -1.0f) {
+            *dst = -128;
+        } else {
+            *dst = (Sint8)(sample * 127.0f);
+        }
+        src++; dst++;
+    }
+
+    cvt->len_cvt /= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_S8);
+    }
+}
+
+SDL_TARGETING("avx512f") static void SDLCALL
+SDL_Convert_F32_to_U8_AVX512F(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Uint8 *dst = cvt->buf;
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 negone = _mm512_set1_ps(-1.0f);
+    const __m512 mulby127 = _mm512_set1_ps(127.0f);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_U8 (using AVX-512F)");
+
+    /* Get dst aligned to 16 bytes */
+    for (i = cvt->len_cvt / sizeof (float); i && (((size_t) dst) & 15); --i, ++src, ++dst) {
+        const float sample = *src;
+        if (sample >= 1.0f) {
+            *dst = 255;
+        } else if (sample <= -1.0f) {
+            *dst = 0;
+        } else {
+            *dst = (Uint8)((sample + 1.0f) * 127.0f);
+        }
+    }
+
+    for (; i >= 16; i -= 16, src += 16, dst += 16) {
+        /* After clamping these are 0-254, so unsigned saturation never kicks in. */
+        const __m512i ints = _mm512_cvtps_epi32(_mm512_mul_ps(_mm512_add_ps(_mm512_min_ps(_mm512_max_ps(negone, _mm512_loadu_ps(src)), one), one), mulby127));  /* load 16 floats, clamp, convert to sint32 */
+        _mm_storeu_si128((__m128i *) dst, _mm512_cvtusepi32_epi8(ints));  /* pack down, store out. */
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i--) {
+        const float sample = *src;
+        if (sample >= 1.0f) {
+            *dst = 255;
+        } else if (sample <= -1.0f) {
+            *dst = 0;
+        } else {
+            *dst = (Uint8)((sample + 1.0f) * 127.0f);
+        }
+        src++; dst++;
+    }
+
+    cvt->len_cvt /= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_U8);
+    }
+}
+
+SDL_TARGETING("avx512f") static void SDLCALL
+SDL_Convert_F32_to_S16_AVX512F(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint16 *dst = (Sint16 *) cvt->buf;
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 negone = _mm512_set1_ps(-1.0f);
+    const __m512 mulby32767 = _mm512_set1_ps(32767.0f);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S16 (using AVX-512F)");
+
+    /* Get dst aligned to 32 bytes */
+    for (i = cvt->len_cvt / sizeof (float); i && (((size_t) dst) & 31); --i, ++src, ++dst) {
+        const float sample = *src;
+        if (sample >= 1.0f) {
+            *dst = 32767;
+        } else if (sample <= -1.0f) {
+            *dst = -32768;
+        } else {
+            *dst = (Sint16)(sample * 32767.0f);
+        }
+    }
+
+    for (; i >= 16; i -= 16, src += 16, dst += 16) {
+        const __m512i ints = _mm512_cvtps_epi32(_mm512_mul_ps(_mm512_min_ps(_mm512_max_ps(negone, _mm512_loadu_ps(src)), one), mulby32767));  /* load 16 floats, clamp, convert to sint32 */
+        _mm256_storeu_si256((__m256i *) dst, _mm512_cvtsepi32_epi16(ints));  /* pack to sint16, store out. */
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i--) {
+        const float sample = *src;
+        if (sample >= 1.0f) {
+            *dst = 32767;
+        } else if (sample <= -1.0f) {
+            *dst = -32768;
+        } else {
+            *dst = (Sint16)(sample * 32767.0f);
+        }
+        src++; dst++;
+    }
+
+    cvt->len_cvt /= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_S16SYS);
+    }
+}
+
+SDL_TARGETING("avx512f") static void SDLCALL
+SDL_Convert_F32_to_U16_AVX512F(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Uint16 *dst = (Uint16 *) cvt->buf;
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 negone = _mm512_set1_ps(-1.0f);
+    const __m512 mulby32767 = _mm512_set1_ps(32767.0f);
+    const __m256i topbit = _mm256_set1_epi16(-32768);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_U16 (using AVX-512F)");
+
+    /* Get dst aligned to 32 bytes */
+    for (i = cvt->len_cvt / sizeof (float); i && (((size_t) dst) & 31); --i, ++src, ++dst) {
+        const float sample = *src;
+        if (sample >= 1.0f) {
+            *dst = 65535;
+        } else if (sample <= -1.0f) {
+            *dst = 0;
+        } else {
+            *dst = (Uint16)((sample + 1.0f) * 32767.0f);
+        }
+    }
+
+    for (; i >= 16; i -= 16, src += 16, dst += 16) {
+        /* Same trick as the SSE2 version: pack to sint16 with signed saturation, then flip the top bit. */
+        const __m512i ints = _mm512_cvtps_epi32(_mm512_mul_ps(_mm512_min_ps(_mm512_max_ps(negone, _mm512_loadu_ps(src)), one), mulby32767));  /* load 16 floats, clamp, convert to sint32 */
+        _mm256_storeu_si256((__m256i *) dst, _mm256_xor_si256(_mm512_cvtsepi32_epi16(ints), topbit));
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i--) {
+        const float sample = *src;
+        if (sample >= 1.0f) {
+            *dst = 65535;
+        } else if (sample <= -1.0f) {
+            *dst = 0;
+        } else {
+            *dst = (Uint16)((sample + 1.0f) * 32767.0f);
+        }
+        src++; dst++;
+    }
+
+    cvt->len_cvt /= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_U16SYS);
+    }
+}
+
+SDL_TARGETING("avx512f") static void SDLCALL
+SDL_Convert_F32_to_S32_AVX512F(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint32 *dst = (Sint32 *) cvt->buf;
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 negone = _mm512_set1_ps(-1.0f);
+    const __m512 mulby8388607 = _mm512_set1_ps(8388607.0f);
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S32 (using AVX-512F)");
+
+    /* Get dst aligned to 64 bytes */
+    for (i = cvt->len_cvt / sizeof (float); i && (((size_t) dst) & 63); --i, ++src, ++dst) {
+        const float sample = *src;
+        if (sample >= 1.0f) {
+            *dst = 2147483647;
+        } else if (sample <= -1.0f) {
+            *dst = (Sint32) -2147483648LL;
+        } else {
+            *dst = ((Sint32)(sample * 8388607.0f)) << 8;
+        }
+    }
+
+    for (; i >= 16; i -= 16, src += 16, dst += 16) {
+        _mm512_storeu_si512((void *) dst, _mm512_slli_epi32(_mm512_cvtps_epi32(_mm512_mul_ps(_mm512_min_ps(_mm512_max_ps(negone, _mm512_loadu_ps(src)), one), mulby8388607)), 8));  /* load 16 floats, clamp, convert to sint32 */
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i--) {
+        const float sample = *src;
+        if (sample >= 1.0f) {
+            *dst = 2147483647;
+        } else if (sample <= -1.0f) {
+            *dst = (Sint32) -2147483648LL;
+        } else {
+            *dst = ((Sint32)(sample * 8388607.0f)) << 8;
+        }
+        src++; dst++;
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_S32SYS);
+    }
+}
+#endif
+
+#if HAVE_NEON_INTRINSICS
+static void SDLCALL
+SDL_Convert_S8_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Sint8 *src = ((const Sint8 *) (cvt->buf + cvt->len_cvt)) - 1;
+    float *dst = ((float *) (cvt->buf + cvt->len_cvt * 4)) - 1;
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_S8", "AUDIO_F32 (using NEON)");
+
+    /* Get dst aligned to 16 bytes (since buffer is growing, we don't have to worry about overreading from src) */
+    for (i = cvt->len_cvt; i && (((size_t) (dst-15)) & 15); --i, --src, --dst) {
+        *dst = ((float) *src) * DIVBY128;
+    }
+
+    src -= 15; dst -= 15;  /* adjust to read NEON blocks from the start. */
+    SDL_assert(!i || ((((size_t) dst) & 15) == 0));
+
+    /* Make sure src is aligned too. */
+    if ((((size_t) src) & 15) == 0) {
+        /* Aligned! Do NEON blocks as long as we have 16 bytes available. */
+        const int8_t *mmsrc = (const int8_t *) src;
+        const float32x4_t divby128 = vdupq_n_f32(DIVBY128);
+        while (i >= 16) {   /* 16 * 8-bit */
+            const int8x16_t bytes = vld1q_s8(mmsrc);  /* get 16 sint8 into a NEON register. */
+            const int16x8_t int16hi = vmovl_s8(vget_high_s8(bytes));  /* convert top 8 bytes to 8 int16 */
+            const int16x8_t int16lo = vmovl_s8(vget_low_s8(bytes));   /* convert bottom 8 bytes to 8 int16 */
+            /* split int16 to two int32, then convert to float, then multiply to normalize, store. */
+            vst1q_f32(dst, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(int16lo))), divby128));
+            vst1q_f32(dst+4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(int16lo))), divby128));
+            vst1q_f32(dst+8, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(int16hi))), divby128));
+            vst1q_f32(dst+12, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(int16hi))), divby128));
+            i -= 16; mmsrc -= 16; dst -= 16;
+        }
+
+        src = (const Sint8 *) mmsrc;
+    }
+
+    src += 15; dst += 15;  /* adjust for any scalar finishing. */
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i) {
+        *dst = ((float) *src) * DIVBY128;
+        i--; src--; dst--;
+    }
+
+    cvt->len_cvt *= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_U8_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Uint8 *src = ((const Uint8 *) (cvt->buf + cvt->len_cvt)) - 1;
+    float *dst = ((float *) (cvt->buf + cvt->len_cvt * 4)) - 1;
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_U8", "AUDIO_F32 (using NEON)");
+
+    /* Get dst aligned to 16 bytes (since buffer is growing, we don't have to worry about overreading from src) */
+    for (i = cvt->len_cvt; i && (((size_t) (dst-15)) & 15); --i, --src, --dst) {
+        *dst = (((float) *src) * DIVBY128) - 1.0f;
+    }
+
+    src -= 15; dst -= 15;  /* adjust to read NEON blocks from the start. */
+    SDL_assert(!i || ((((size_t) dst) & 15) == 0));
+
+    /* Make sure src is aligned too. */
+    if ((((size_t) src) & 15) == 0) {
+        /* Aligned! Do NEON blocks as long as we have 16 bytes available. */
+        const uint8_t *mmsrc = (const uint8_t *) src;
+        const float32x4_t divby128 = vdupq_n_f32(DIVBY128);
+        const float32x4_t negone = vdupq_n_f32(-1.0f);
+        while (i >= 16) {   /* 16 * 8-bit */
+            const uint8x16_t bytes = vld1q_u8(mmsrc);  /* get 16 uint8 into a NEON register. */
+            const uint16x8_t uint16hi = vmovl_u8(vget_high_u8(bytes));  /* convert top 8 bytes to 8 uint16 */
+            const uint16x8_t uint16lo = vmovl_u8(vget_low_u8(bytes));   /* convert bottom 8 bytes to 8 uint16 */
+            /* split uint16 to two uint32, then convert to float, then multiply to normalize, subtract to adjust for sign, store. */
+            vst1q_f32(dst, vmlaq_f32(negone, vcvtq_f32_u32(vmovl_u16(vget_low_u16(uint16lo))), divby128));
+            vst1q_f32(dst+4, vmlaq_f32(negone, vcvtq_f32_u32(vmovl_u16(vget_high_u16(uint16lo))), divby128));
+            vst1q_f32(dst+8, vmlaq_f32(negone, vcvtq_f32_u32(vmovl_u16(vget_low_u16(uint16hi))), divby128));
+            vst1q_f32(dst+12, vmlaq_f32(negone, vcvtq_f32_u32(vmovl_u16(vget_high_u16(uint16hi))), divby128));
+            i -= 16; mmsrc -= 16; dst -= 16;
+        }
+
+        src = (const Uint8 *) mmsrc;
+    }
+
+    src += 15; dst += 15;  /* adjust for any scalar finishing. */
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i) {
+        *dst = (((float) *src) * DIVBY128) - 1.0f;
+        i--; src--; dst--;
+    }
+
+    cvt->len_cvt *= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_S16_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Sint16 *src = ((const Sint16 *) (cvt->buf + cvt->len_cvt)) - 1;
+    float *dst = ((float *) (cvt->buf + cvt->len_cvt * 2)) - 1;
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_S16", "AUDIO_F32 (using NEON)");
+
+    /* Get dst aligned to 16 bytes (since buffer is growing, we don't have to worry about overreading from src) */
+    for (i = cvt->len_cvt / sizeof (Sint16); i && (((size_t) (dst-7)) & 15); --i, --src, --dst) {
+        *dst = ((float) *src) * DIVBY32768;
+    }
+
+    src -= 7; dst -= 7;  /* adjust to read NEON blocks from the start. */
+    SDL_assert(!i || ((((size_t) dst) & 15) == 0));
+
+    /* Make sure src is aligned too. */
+    if ((((size_t) src) & 15) == 0) {
+        /* Aligned! Do NEON blocks as long as we have 16 bytes available. */
+        const float32x4_t divby32768 = vdupq_n_f32(DIVBY32768);
+        while (i >= 8) {   /* 8 * 16-bit */
+            const int16x8_t ints = vld1q_s16((int16_t const *) src);  /* get 8 sint16 into a NEON register. */
+            /* split int16 to two int32, then convert to float, then multiply to normalize, store. */
+            vst1q_f32(dst, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(ints))), divby32768));
+            vst1q_f32(dst+4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(ints))), divby32768));
+            i -= 8; src -= 8; dst -= 8;
+        }
+    }
+
+    src += 7; dst += 7;  /* adjust for any scalar finishing. */
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i) {
+        *dst = ((float) *src) * DIVBY32768;
+        i--; src--; dst--;
+    }
+
+    cvt->len_cvt *= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_U16_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Uint16 *src = ((const Uint16 *) (cvt->buf + cvt->len_cvt)) - 1;
+    float *dst = ((float *) (cvt->buf + cvt->len_cvt * 2)) - 1;
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_U16", "AUDIO_F32 (using NEON)");
+
+    /* Get dst aligned to 16 bytes (since buffer is growing, we don't have to worry about overreading from src) */
+    for (i = cvt->len_cvt / sizeof (Sint16); i && (((size_t) (dst-7)) & 15); --i, --src, --dst) {
+        *dst = (((float) *src) * DIVBY32768) - 1.0f;
+    }
+
+    src -= 7; dst -= 7;  /* adjust to read NEON blocks from the start. */
+    SDL_assert(!i || ((((size_t) dst) & 15) == 0));
+
+    /* Make sure src is aligned too. */
+    if ((((size_t) src) & 15) == 0) {
+        /* Aligned! Do NEON blocks as long as we have 16 bytes available. */
+        const float32x4_t divby32768 = vdupq_n_f32(DIVBY32768);
+        const float32x4_t negone = vdupq_n_f32(-1.0f);
+        while (i >= 8) {   /* 8 * 16-bit */
+            const uint16x8_t uints = vld1q_u16((uint16_t const *) src);  /* get 8 uint16 into a NEON register. */
+            /* split uint16 to two int32, then convert to float, then multiply to normalize, subtract for sign, store. */
+            vst1q_f32(dst, vmlaq_f32(negone, vcvtq_f32_u32(vmovl_u16(vget_low_u16(uints))), divby32768));
+            vst1q_f32(dst+4, vmlaq_f32(negone, vcvtq_f32_u32(vmovl_u16(vget_high_u16(uints))), divby32768));
+            i -= 8; src -= 8; dst -= 8;
+        }
+    }
+
+    src += 7; dst += 7;  /* adjust for any scalar finishing. */
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i) {
+        *dst = (((float) *src) * DIVBY32768) - 1.0f;
+        i--; src--; dst--;
+    }
+
+    cvt->len_cvt *= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_S32_to_F32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const Sint32 *src = (const Sint32 *) cvt->buf;
+    float *dst = (float *) cvt->buf;
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_S32", "AUDIO_F32 (using NEON)");
+
+    /* Get dst aligned to 16 bytes */
+    for (i = cvt->len_cvt / sizeof (Sint32); i && (((size_t) dst) & 15); --i, ++src, ++dst) {
+        *dst = ((float) (*src>>8)) * DIVBY8388607;
+    }
+
+    SDL_assert(!i || ((((size_t) dst) & 15) == 0));
+
+    /* Make sure src is aligned too. */
+    if ((((size_t) src) & 15) == 0) {
+        /* Aligned! Do NEON blocks as long as we have 16 bytes available. */
+        const float32x4_t divby8388607 = vdupq_n_f32(DIVBY8388607);
+        const int32_t *mmsrc = (const int32_t *) src;
+        while (i >= 4) {   /* 4 * sint32 */
+            /* shift out lowest bits so int fits in a float32. Small precision loss, but much faster. */
+            vst1q_f32(dst, vmulq_f32(vcvtq_f32_s32(vshrq_n_s32(vld1q_s32(mmsrc), 8)), divby8388607));
+            i -= 4; mmsrc += 4; dst += 4;
+        }
+        src = (const Sint32 *) mmsrc;
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i) {
+        *dst = ((float) (*src>>8)) * DIVBY8388607;
+        i--; src++; dst++;
+    }
+
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_F32SYS);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32_to_S8_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint8 *dst = (Sint8 *) cvt->buf;
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S8 (using NEON)");
+
+    /* Get dst aligned to 16 bytes */
+    for (i = cvt->len_cvt / sizeof (float); i && (((size_t) dst) & 15); --i, ++src, ++dst) {
+        const float sample = *src;
+        if (sample >= 1.0f) {
+            *dst = 127;
+        } else if (sample <= -1.0f) {
+            *dst = -128;
+        } else {
+            *dst = (Sint8)(sample * 127.0f);
+        }
+    }
+
+    SDL_assert(!i || ((((size_t) dst) & 15) == 0));
+
+    /* Make sure src is aligned too. */
+    if ((((size_t) src) & 15) == 0) {
+        /* Aligned! Do NEON blocks as long as we have 16 bytes available. */
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t negone = vdupq_n_f32(-1.0f);
+        const float32x4_t mulby127 = vdupq_n_f32(127.0f);
+        int8_t *mmdst = (int8_t *) dst;
+        while (i >= 16) {   /* 16 * float32 */
+            const int32x4_t ints1 = vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src)), one), mulby127));  /* load 4 floats, clamp, convert to sint32 */
+            const int32x4_t ints2 = vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src+4)), one), mulby127));  /* load 4 floats, clamp, convert to sint32 */
+            const int32x4_t ints3 = vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src+8)), one), mulby127));  /* load 4 floats, clamp, convert to sint32 */
+            const int32x4_t ints4 = vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src+12)), one), mulby127));  /* load 4 floats, clamp, convert to sint32 */
+            const int8x8_t i8lo = vmovn_s16(vcombine_s16(vmovn_s32(ints1), vmovn_s32(ints2))); /* narrow to sint16, combine, narrow to sint8 */
+            const int8x8_t i8hi = vmovn_s16(vcombine_s16(vmovn_s32(ints3), vmovn_s32(ints4))); /* narrow to sint16, combine, narrow to sint8 */
+            vst1q_s8(mmdst, vcombine_s8(i8lo, i8hi));  /* combine to int8x16_t, store out */
+            i -= 16; src += 16; mmdst += 16;
+        }
+        dst = (Sint8 *) mmdst;
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i) {
+        const float sample = *src;
+        if (sample >= 1.0f) {
+            *dst = 127;
+        } else if (sample <= -1.0f) {
+            *dst = -128;
+        } else {
+            *dst = (Sint8)(sample * 127.0f);
+        }
+        i--; src++; dst++;
+    }
+
+    cvt->len_cvt /= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_S8);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32_to_U8_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Uint8 *dst = (Uint8 *) cvt->buf;
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_U8 (using NEON)");
+
+    /* Get dst aligned to 16 bytes */
+    for (i = cvt->len_cvt / sizeof (float); i && (((size_t) dst) & 15); --i, ++src, ++dst) {
+        const float sample = *src;
+        if (sample >= 1.0f) {
+            *dst = 255;
+        } else if (sample <= -1.0f) {
+            *dst = 0;
+        } else {
+            *dst = (Uint8)((sample + 1.0f) * 127.0f);
+        }
+    }
+
+    SDL_assert(!i || ((((size_t) dst) & 15) == 0));
+
+    /* Make sure src is aligned too. */
+    if ((((size_t) src) & 15) == 0) {
+        /* Aligned! Do NEON blocks as long as we have 16 bytes available. */
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t negone = vdupq_n_f32(-1.0f);
+        const float32x4_t mulby127 = vdupq_n_f32(127.0f);
+        uint8_t *mmdst = (uint8_t *) dst;
+        while (i >= 16) {   /* 16 * float32 */
+            const uint32x4_t uints1 = vcvtq_u32_f32(vmulq_f32(vaddq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src)), one), one), mulby127));  /* load 4 floats, clamp, convert to uint32 */
+            const uint32x4_t uints2 = vcvtq_u32_f32(vmulq_f32(vaddq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src+4)), one), one), mulby127));  /* load 4 floats, clamp, convert to uint32 */
+            const uint32x4_t uints3 = vcvtq_u32_f32(vmulq_f32(vaddq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src+8)), one), one), mulby127));  /* load 4 floats, clamp, convert to uint32 */
+            const uint32x4_t uints4 = vcvtq_u32_f32(vmulq_f32(vaddq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src+12)), one), one), mulby127));  /* load 4 floats, clamp, convert to uint32 */
+            const uint8x8_t ui8lo = vmovn_u16(vcombine_u16(vmovn_u32(uints1), vmovn_u32(uints2))); /* narrow to uint16, combine, narrow to uint8 */
+            const uint8x8_t ui8hi = vmovn_u16(vcombine_u16(vmovn_u32(uints3), vmovn_u32(uints4))); /* narrow to uint16, combine, narrow to uint8 */
+            vst1q_u8(mmdst, vcombine_u8(ui8lo, ui8hi));  /* combine to uint8x16_t, store out */
+            i -= 16; src += 16; mmdst += 16;
+        }
+
+        dst = (Uint8 *) mmdst;
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i) {
+        const float sample = *src;
+        if (sample >= 1.0f) {
+            *dst = 255;
+        } else if (sample <= -1.0f) {
+            *dst = 0;
+        } else {
+            *dst = (Uint8)((sample + 1.0f) * 127.0f);
+        }
+        i--; src++; dst++;
+    }
+
+    cvt->len_cvt /= 4;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_U8);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32_to_S16_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint16 *dst = (Sint16 *) cvt->buf;
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S16 (using NEON)");
+
+    /* Get dst aligned to 16 bytes */
+    for (i = cvt->len_cvt / sizeof (float); i && (((size_t) dst) & 15); --i, ++src, ++dst) {
+        const float sample = *src;
+        if (sample >= 1.0f) {
+            *dst = 32767;
+        } else if (sample <= -1.0f) {
+            *dst = -32768;
+        } else {
+            *dst = (Sint16)(sample * 32767.0f);
+        }
+    }
+
+    SDL_assert(!i || ((((size_t) dst) & 15) == 0));
+
+    /* Make sure src is aligned too. */
+    if ((((size_t) src) & 15) == 0) {
+        /* Aligned! Do NEON blocks as long as we have 16 bytes available. */
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t negone = vdupq_n_f32(-1.0f);
+        const float32x4_t mulby32767 = vdupq_n_f32(32767.0f);
+        int16_t *mmdst = (int16_t *) dst;
+        while (i >= 8) {   /* 8 * float32 */
+            const int32x4_t ints1 = vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src)), one), mulby32767));  /* load 4 floats, clamp, convert to sint32 */
+            const int32x4_t ints2 = vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src+4)), one), mulby32767));  /* load 4 floats, clamp, convert to sint32 */
+            vst1q_s16(mmdst, vcombine_s16(vmovn_s32(ints1), vmovn_s32(ints2)));  /* narrow to sint16, combine, store out. */
+            i -= 8; src += 8; mmdst += 8;
+        }
+        dst = (Sint16 *) mmdst;
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i) {
+        const float sample = *src;
+        if (sample >= 1.0f) {
+            *dst = 32767;
+        } else if (sample <= -1.0f) {
+            *dst = -32768;
+        } else {
+            *dst = (Sint16)(sample * 32767.0f);
+        }
+        i--; src++; dst++;
+    }
+
+    cvt->len_cvt /= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_S16SYS);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32_to_U16_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Uint16 *dst = (Uint16 *) cvt->buf;
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_U16 (using NEON)");
+
+    /* Get dst aligned to 16 bytes */
+    for (i = cvt->len_cvt / sizeof (float); i && (((size_t) dst) & 15); --i, ++src, ++dst) {
+        const float sample = *src;
+        if (sample >= 1.0f) {
+            *dst = 65535;
+        } else if (sample <= -1.0f) {
+            *dst = 0;
+        } else {
+            *dst = (Uint16)((sample + 1.0f) * 32767.0f);
+        }
+    }
+
+    SDL_assert(!i || ((((size_t) dst) & 15) == 0));
+
+    /* Make sure src is aligned too. */
+    if ((((size_t) src) & 15) == 0) {
+        /* Aligned! Do NEON blocks as long as we have 16 bytes available. */
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t negone = vdupq_n_f32(-1.0f);
+        const float32x4_t mulby32767 = vdupq_n_f32(32767.0f);
+        uint16_t *mmdst = (uint16_t *) dst;
+        while (i >= 8) {   /* 8 * float32 */
+            const uint32x4_t uints1 = vcvtq_u32_f32(vmulq_f32(vaddq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src)), one), one), mulby32767));  /* load 4 floats, clamp, convert to uint32 */
+            const uint32x4_t uints2 = vcvtq_u32_f32(vmulq_f32(vaddq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src+4)), one), one), mulby32767));  /* load 4 floats, clamp, convert to uint32 */
+            vst1q_u16(mmdst, vcombine_u16(vmovn_u32(uints1), vmovn_u32(uints2)));  /* narrow to uint16, combine, store out. */
+            i -= 8; src += 8; mmdst += 8;
+        }
+        dst = (Uint16 *) mmdst;
+    }
+
+    /* Finish off any leftovers with scalar operations. */
+    while (i) {
+        const float sample = *src;
+        if (sample >= 1.0f) {
+            *dst = 65535;
+        } else if (sample <= -1.0f) {
+            *dst = 0;
+        } else {
+            *dst = (Uint16)((sample + 1.0f) * 32767.0f);
+        }
+        i--; src++; dst++;
+    }
+
+    cvt->len_cvt /= 2;
+    if (cvt->filters[++cvt->filter_index]) {
+        cvt->filters[cvt->filter_index](cvt, AUDIO_U16SYS);
+    }
+}
+
+static void SDLCALL
+SDL_Convert_F32_to_S32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
+{
+    const float *src = (const float *) cvt->buf;
+    Sint32 *dst = (Sint32 *) cvt->buf;
+    int i;
+
+    LOG_DEBUG_CONVERT("AUDIO_F32", "AUDIO_S32 (using NEON)");
+
+    /* Get dst aligned to 16 bytes */
+    for (i = cvt->len_cvt / sizeof (float); i && (((size_t) dst) & 15); --i, ++src, ++dst) {
+        const float sample = *src;
+        if (sample >= 1.0f) {
+            *dst = 2147483647;
+        } else if (sample <= -1.0f) {
+            *dst = (-2147483647) - 1;
+        } else {
+            *dst = ((Sint32)(sample * 8388607.0f)) << 8;
+        }
+    }
+
+    SDL_assert(!i || ((((size_t) dst) & 15) == 0));
+    SDL_assert(!i || ((((size_t) src) & 15) == 0));
+
+    {
+        /* Aligned! Do NEON blocks as long as we have 16 bytes available. */
+        const float32x4_t one = vdupq_n_f32(1.0f);
+        const float32x4_t negone = vdupq_n_f32(-1.0f);
+        const float32x4_t mulby8388607 = vdupq_n_f32(8388607.0f);
+        int32_t *mmdst = (int32_t *) dst;
+        while (i >= 4) {   /* 4 * float32 */
+            vst1q_s32(mmdst, vshlq_n_s32(vcvtq_s32_f32(vmulq_f32(vminq_f32(vmaxq_f32(negone, vld1q_f32(src)), one), mulby8388607)), 8));
+            i -= 4; src += 4; mmdst += 4;
         }
         dst = (Sint32 *) mmdst;
     }
@@ -1382,14 +2204,12 @@ SDL_Convert_F32_to_S32_NEON(SDL_AudioCVT *cvt, SDL_AudioFormat format)
 
 
 
-void SDL_ChooseAudioConverters(void)
+/* Sets the converters to one tier, if it's built in and this CPU supports
+   it. A NULL tier picks the best one available. */
+static SDL_bool
+SDL_SetAudioConverters(const char *tier)
 {
-    static SDL_bool converters_chosen = SDL_FALSE;
-
-    if (converters_chosen) {
-        return;
-    }
-
+#define WANT_CONVERTERS(name) (!tier || (SDL_strcasecmp(tier, name) == 0))
 #define SET_CONVERTER_FUNCS(fntype) \
         SDL_Convert_S8_to_F32 = SDL_Convert_S8_to_F32_##fntype; \
         SDL_Convert_U8_to_F32 = SDL_Convert_U8_to_F32_##fntype; \
@@ -1401,27 +2221,59 @@ void SDL_ChooseAudioConverters(void)
         SDL_Convert_F32_to_S16 = SDL_Convert_F32_to_S16_##fntype; \
         SDL_Convert_F32_to_U16 = SDL_Convert_F32_to_U16_##fntype; \
         SDL_Convert_F32_to_S32 = SDL_Convert_F32_to_S32_##fntype; \
-        converters_chosen = SDL_TRUE
+        return SDL_TRUE
+
+#if HAVE_AVX512F_INTRINSICS
+    if (WANT_CONVERTERS("avx512f") && SDL_HasAVX512F()) {
+        SET_CONVERTER_FUNCS(AVX512F);
+    }
+#endif
+
+#if HAVE_AVX2_INTRINSICS
+    if (WANT_CONVERTERS("avx2") && SDL_HasAVX2()) {
+        SET_CONVERTER_FUNCS(AVX2);
+    }
+#endif
 
 #if HAVE_SSE2_INTRINSICS
-    if (SDL_HasSSE2()) {
+    if (WANT_CONVERTERS("sse2") && SDL_HasSSE2()) {
         SET_CONVERTER_FUNCS(SSE2);
-        return;
     }
 #endif
 
 #if HAVE_NEON_INTRINSICS
-    if (SDL_HasNEON()) {
+    if (WANT_CONVERTERS("neon") && SDL_HasNEON()) {
         SET_CONVERTER_FUNCS(NEON);
-        return;
     }
 #endif
 
-#if NEED_SCALAR_CONVERTER_FALLBACKS
-    SET_CONVERTER_FUNCS(Scalar);
-#endif
+    if (tier ? (SDL_strcasecmp(tier, "scalar") == 0) : NEED_SCALAR_CONVERTER_FALLBACKS) {
+        SET_CONVERTER_FUNCS(Scalar);
+    }
 
 #undef SET_CONVERTER_FUNCS
+#undef WANT_CONVERTERS
+
+    return SDL_FALSE;
+}
+
+void SDL_ChooseAudioConverters(void)
+{
+    static SDL_bool converters_chosen = SDL_FALSE;
+    static char chosen_tier[16];
+    const char *tier = SDL_GetHint(SDL_HINT_AUDIO_CONVERTERS);
+
+    /* Choose again only if the tier the tests force has changed. */
+    if (!tier) {
+        tier = "";
+    }
+    if (converters_chosen && (SDL_strcmp(tier, chosen_tier) == 0)) {
+        return;
+    }
+    SDL_strlcpy(chosen_tier, tier, sizeof (chosen_tier));
+
+    /* A tier that isn't available falls back to the best one that is. */
+    converters_chosen = (*tier && SDL_SetAudioConverters(tier)) || SDL_SetAudioConverters(NULL);
 
     SDL_assert(converters_chosen == SDL_TRUE);
 }
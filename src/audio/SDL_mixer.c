@@ -26,6 +26,7 @@
 #include "SDL_timer.h"
 #include "SDL_audio.h"
 #include "SDL_sysaudio.h"
+#include "SDL_audio_c.h"
 
 /* This table is used to add two sound values together and pin
  * the value to avoid overflow.  (used with permission from ARDI)
@@ -85,6 +86,269 @@ static const Uint8 mix8[] = {
 #define ADJUST_VOLUME(s, v) (s = (s*v)/SDL_MIX_MAXVOLUME)
 #define ADJUST_VOLUME_U8(s, v)  (s = (((s-128)*v)/SDL_MIX_MAXVOLUME)+128)
 
+/* The SIMD mixers below produce exactly what the scalar code in
+   SDL_MixAudioFormat() does, so they can take any part of the buffer.
+   Integer volume scaling divides by SDL_MIX_MAXVOLUME with a shift, rounding
+   toward zero like C division does, so it has to be a power of two. Volumes
+   outside of 0 - 128 are left to the scalar code, which wraps like it always
+   has. Float mixing adds in single precision: the scalar code adds in double
+   and rounds the sum back to float, which gives the same result for a
+   single addition. Each one returns the number of samples it mixed. */
+SDL_COMPILE_TIME_ASSERT(mix_maxvolume, SDL_MIX_MAXVOLUME == 128);
+#define MIX_VOLUME_SHIFT 7
+
+#if HAVE_SSE2_INTRINSICS
+static Uint32
+SDL_MixAudio_S16_SSE2(Sint16 *dst, const Sint16 *src, const Uint32 num_samples, const int volume)
+{
+    const __m128i vol = _mm_set1_epi16((Sint16) volume);
+    const __m128i bias = _mm_set1_epi32(SDL_MIX_MAXVOLUME - 1);
+    Uint32 i;
+
+    for (i = 0; (i + 8) <= num_samples; i += 8) {
+        const __m128i s = _mm_loadu_si128((const __m128i *) &src[i]);
+        const __m128i d = _mm_loadu_si128((const __m128i *) &dst[i]);
+        const __m128i lo = _mm_mullo_epi16(s, vol);
+        const __m128i hi = _mm_mulhi_epi16(s, vol);
+        __m128i p0 = _mm_unpacklo_epi16(lo, hi);
+        __m128i p1 = _mm_unpackhi_epi16(lo, hi);
+        p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_and_si128(_mm_srai_epi32(p0, 31), bias)), MIX_VOLUME_SHIFT);
+        p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_and_si128(_mm_srai_epi32(p1, 31), bias)), MIX_VOLUME_SHIFT);
+        _mm_storeu_si128((__m128i *) &dst[i], _mm_adds_epi16(d, _mm_packs_epi32(p0, p1)));
+    }
+    return i;
+}
+
+static Uint32
+SDL_MixAudio_S32_SSE2(Sint32 *dst, const Sint32 *src, const Uint32 num_samples, const int volume)
+{
+    const __m128i vol = _mm_set1_epi32(volume);
+    const __m128i lowmask = _mm_set_epi32(0, -1, 0, -1);
+    const __m128i maxval = _mm_set1_epi32(0x7FFFFFFF);
+    Uint32 i;
+
+    for (i = 0; (i + 4) <= num_samples; i += 4) {
+        const __m128i s = _mm_loadu_si128((const __m128i *) &src[i]);
+        const __m128i d = _mm_loadu_si128((const __m128i *) &dst[i]);
+        /* Scale the magnitude with 32x32->64 bit multiplies, then put the sign back. */
+        const __m128i sign = _mm_srai_epi32(s, 31);
+        const __m128i mag = _mm_sub_epi32(_mm_xor_si128(s, sign), sign);
+        const __m128i even = _mm_srli_epi64(_mm_mul_epu32(mag, vol), MIX_VOLUME_SHIFT);
+        const __m128i odd = _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(mag, 32), vol), MIX_VOLUME_SHIFT);
+        const __m128i scaled = _mm_or_si128(_mm_and_si128(even, lowmask), _mm_slli_epi64(odd, 32));
+        const __m128i a = _mm_sub_epi32(_mm_xor_si128(scaled, sign), sign);
+        /* Saturating add: it overflowed if the sum's sign differs from both inputs. */
+        const __m128i sum = _mm_add_epi32(a, d);
+        const __m128i overflow = _mm_srai_epi32(_mm_and_si128(_mm_xor_si128(a, sum), _mm_xor_si128(d, sum)), 31);
+        const __m128i clamped = _mm_xor_si128(_mm_srai_epi32(d, 31), maxval);
+        _mm_storeu_si128((__m128i *) &dst[i], _mm_or_si128(_mm_and_si128(overflow, clamped), _mm_andnot_si128(overflow, sum)));
+    }
+    return i;
+}
+
+static Uint32
+SDL_MixAudio_F32_SSE2(float *dst, const float *src, const Uint32 num_samples, const int volume)
+{
+    const __m128 fvolume = _mm_set1_ps((float) volume);
+    const __m128 fmaxvolume = _mm_set1_ps(1.0f / ((float) SDL_MIX_MAXVOLUME));
+    const __m128 maxval = _mm_set1_ps(3.402823466e+38F);
+    const __m128 minval = _mm_set1_ps(-3.402823466e+38F);
+    Uint32 i;
+
+    for (i = 0; (i + 4) <= num_samples; i += 4) {
+        const __m128 s = _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(&src[i]), fvolume), fmaxvolume);
+        const __m128 sum = _mm_add_ps(s, _mm_loadu_ps(&dst[i]));
+        /* Operand order matters here: NaNs pass through, like the scalar code. */
+        _mm_storeu_ps(&dst[i], _mm_max_ps(minval, _mm_min_ps(maxval, sum)));
+    }
+    return i;
+}
+#endif
+
+#if HAVE_AVX2_INTRINSICS
+SDL_TARGETING("avx2") static Uint32
+SDL_MixAudio_S16_AVX2(Sint16 *dst, const Sint16 *src, const Uint32 num_samples, const int volume)
+{
+    const __m256i vol = _mm256_set1_epi16((Sint16) volume);
+    const __m256i bias = _mm256_set1_epi32(SDL_MIX_MAXVOLUME - 1);
+    Uint32 i;
+
+    /* Unpacking and packing both work within 128-bit lanes, so the order comes out right. */
+    for (i = 0; (i + 16) <= num_samples; i += 16) {
+        const __m256i s = _mm256_loadu_si256((const __m256i *) &src[i]);
+        const __m256i d = _mm256_loadu_si256((const __m256i *) &dst[i]);
+        const __m256i lo = _mm256_mullo_epi16(s, vol);
+        const __m256i hi = _mm256_mulhi_epi16(s, vol);
+        __m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+        __m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+        p0 = _mm256_srai_epi32(_mm256_add_epi32(p0, _mm256_and_si256(_mm256_srai_epi32(p0, 31), bias)), MIX_VOLUME_SHIFT);
+        p1 = _mm256_srai_epi32(_mm256_add_epi32(p1, _mm256_and_si256(_mm256_srai_epi32(p1, 31), bias)), MIX_VOLUME_SHIFT);
+        _mm256_storeu_si256((__m256i *) &dst[i], _mm256_adds_epi16(d, _mm256_packs_epi32(p0, p1)));
+    }
+    return i;
+}
+
+SDL_TARGETING("avx2") static Uint32
+SDL_MixAudio_S32_AVX2(Sint32 *dst, const Sint32 *src, const Uint32 num_samples, const int volume)
+{
+    const __m256i vol = _mm256_set1_epi32(volume);
+    const __m256i lowmask = _mm256_set1_epi64x(0xFFFFFFFF);
+    const __m256i maxval = _mm256_set1_epi32(0x7FFFFFFF);
+    Uint32 i;
+
+    for (i = 0; (i + 8) <= num_samples; i += 8) {
+        const __m256i s = _mm256_loadu_si256((const __m256i *) &src[i]);
+        const __m256i d = _mm256_loadu_si256((const __m256i *) &dst[i]);
+        const __m256i sign = _mm256_srai_epi32(s, 31);
+        const __m256i mag = _mm256_sub_epi32(_mm256_xor_si256(s, sign), sign);
+        const __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(mag, vol), MIX_VOLUME_SHIFT);
+        const __m256i odd = _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(mag, 32), vol), MIX_VOLUME_SHIFT);
+        const __m256i scaled = _mm256_or_si256(_mm256_and_si256(even, lowmask), _mm256_slli_epi64(odd, 32));
+        const __m256i a = _mm256_sub_epi32(_mm256_xor_si256(scaled, sign), sign);
+        const __m256i sum = _mm256_add_epi32(a, d);
+        const __m256i overflow = _mm256_srai_epi32(_mm256_and_si256(_mm256_xor_si256(a, sum), _mm256_xor_si256(d, sum)), 31);
+        const __m256i clamped = _mm256_xor_si256(_mm256_srai_epi32(d, 31), maxval);
+        _mm256_storeu_si256((__m256i *) &dst[i], _mm256_blendv_epi8(sum, clamped, overflow));
+    }
+    return i;
+}
+
+SDL_TARGETING("avx2") static Uint32
+SDL_MixAudio_F32_AVX2(float *dst, const float *src, const Uint32 num_samples, const int volume)
+{
+    const __m256 fvolume = _mm256_set1_ps((float) volume);
+    const __m256 fmaxvolume = _mm256_set1_ps(1.0f / ((float) SDL_MIX_MAXVOLUME));
+    const __m256 maxval = _mm256_set1_ps(3.402823466e+38F);
+    const __m256 minval = _mm256_set1_ps(-3.402823466e+38F);
+    Uint32 i;
+
+    for (i = 0; (i + 8) <= num_samples; i += 8) {
+        const __m256 s = _mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(&src[i]), fvolume), fmaxvolume);
+        const __m256 sum = _mm256_add_ps(s, _mm256_loadu_ps(&dst[i]));
+        _mm256_storeu_ps(&dst[i], _mm256_max_ps(minval, _mm256_min_ps(maxval, sum)));
+    }
+    return i;
+}
+#endif
+
+#if HAVE_NEON_INTRINSICS
+static Uint32
+SDL_MixAudio_S16_NEON(Sint16 *dst, const Sint16 *src, const Uint32 num_samples, const int volume)
+{
+    const int32x4_t bias = vdupq_n_s32(SDL_MIX_MAXVOLUME - 1);
+    Uint32 i;
+
+    for (i = 0; (i + 8) <= num_samples; i += 8) {
+        const int16x8_t s = vld1q_s16(&src[i]);
+        const int16x8_t d = vld1q_s16(&dst[i]);
+        int32x4_t p0 = vmull_n_s16(vget_low_s16(s), (Sint16) volume);
+        int32x4_t p1 = vmull_n_s16(vget_high_s16(s), (Sint16) volume);
+        p0 = vshrq_n_s32(vaddq_s32(p0, vandq_s32(vshrq_n_s32(p0, 31), bias)), MIX_VOLUME_SHIFT);
+        p1 = vshrq_n_s32(vaddq_s32(p1, vandq_s32(vshrq_n_s32(p1, 31), bias)), MIX_VOLUME_SHIFT);
+        vst1q_s16(&dst[i], vqaddq_s16(d, vcombine_s16(vmovn_s32(p0), vmovn_s32(p1))));
+    }
+    return i;
+}
+
+static Uint32
+SDL_MixAudio_S32_NEON(Sint32 *dst, const Sint32 *src, const Uint32 num_samples, const int volume)
+{
+    const int64x2_t bias = vdupq_n_s64(SDL_MIX_MAXVOLUME - 1);
+    Uint32 i;
+
+    for (i = 0; (i + 4) <= num_samples; i += 4) {
+        const int32x4_t s = vld1q_s32(&src[i]);
+        const int32x4_t d = vld1q_s32(&dst[i]);
+        int64x2_t p0 = vmull_n_s32(vget_low_s32(s), volume);
+        int64x2_t p1 = vmull_n_s32(vget_high_s32(s), volume);
+        p0 = vshrq_n_s64(vaddq_s64(p0, vandq_s64(vshrq_n_s64(p0, 63), bias)), MIX_VOLUME_SHIFT);
+        p1 = vshrq_n_s64(vaddq_s64(p1, vandq_s64(vshrq_n_s64(p1, 63), bias)), MIX_VOLUME_SHIFT);
+        vst1q_s32(&dst[i], vqaddq_s32(d, vcombine_s32(vmovn_s64(p0), vmovn_s64(p1))));
+    }
+    return i;
+}
+
+static Uint32
+SDL_MixAudio_F32_NEON(float *dst, const float *src, const Uint32 num_samples, const int volume)
+{
+    const float32x4_t maxval = vdupq_n_f32(3.402823466e+38F);
+    const float32x4_t minval = vdupq_n_f32(-3.402823466e+38F);
+    const float fvolume = (float) volume;
+    const float fmaxvolume = 1.0f / ((float) SDL_MIX_MAXVOLUME);
+    Uint32 i;
+
+    for (i = 0; (i + 4) <= num_samples; i += 4) {
+        const float32x4_t s = vmulq_n_f32(vmulq_n_f32(vld1q_f32(&src[i]), fvolume), fmaxvolume);
+        const float32x4_t sum = vaddq_f32(s, vld1q_f32(&dst[i]));
+        vst1q_f32(&dst[i], vmaxq_f32(minval, vminq_f32(maxval, sum)));
+    }
+    return i;
+}
+#endif
+
+/* Mix as much of a native byte order buffer as the CPU can do with SIMD */
+static Uint32
+SDL_MixAudio_SIMD(Uint8 *dst, const Uint8 *src, SDL_AudioFormat format, Uint32 num_samples, int volume)
+{
+    if (format == AUDIO_F32SYS) {
+#if HAVE_AVX2_INTRINSICS
+        if (SDL_HasAVX2()) {
+            return SDL_MixAudio_F32_AVX2((float *) dst, (const float *) src, num_samples, volume);
+        }
+#endif
+#if HAVE_SSE2_INTRINSICS
+        if (SDL_HasSSE2()) {
+            return SDL_MixAudio_F32_SSE2((float *) dst, (const float *) src, num_samples, volume);
+        }
+#endif
+#if HAVE_NEON_INTRINSICS
+        if (SDL_HasNEON()) {
+            return SDL_MixAudio_F32_NEON((float *) dst, (const float *) src, num_samples, volume);
+        }
+#endif
+        return 0;
+    }
+
+    if (volume < 0 || volume > SDL_MIX_MAXVOLUME) {
+        return 0;
+    }
+
+    if (format == AUDIO_S16SYS) {
+#if HAVE_AVX2_INTRINSICS
+        if (SDL_HasAVX2()) {
+            return SDL_MixAudio_S16_AVX2((Sint16 *) dst, (const Sint16 *) src, num_samples, volume);
+        }
+#endif
+#if HAVE_SSE2_INTRINSICS
+        if (SDL_HasSSE2()) {
+            return SDL_MixAudio_S16_SSE2((Sint16 *) dst, (const Sint16 *) src, num_samples, volume);
+        }
+#endif
+#if HAVE_NEON_INTRINSICS
+        if (SDL_HasNEON()) {
+            return SDL_MixAudio_S16_NEON((Sint16 *) dst, (const Sint16 *) src, num_samples, volume);
+        }
+#endif
+    } else if (format == AUDIO_S32SYS) {
+#if HAVE_AVX2_INTRINSICS
+        if (SDL_HasAVX2()) {
+            return SDL_MixAudio_S32_AVX2((Sint32 *) dst, (const Sint32 *) src, num_samples, volume);
+        }
+#endif
+#if HAVE_SSE2_INTRINSICS
+        if (SDL_HasSSE2()) {
+            return SDL_MixAudio_S32_SSE2((Sint32 *) dst, (const Sint32 *) src, num_samples, volume);
+        }
+#endif
+#if HAVE_NEON_INTRINSICS
+        if (SDL_HasNEON()) {
+            return SDL_MixAudio_S32_NEON((Sint32 *) dst, (const Sint32 *) src, num_samples, volume);
+        }
+#endif
+    }
+    return 0;
+}
+
 
 void
 SDL_MixAudioFormat(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
@@ -94,6 +358,15 @@ SDL_MixAudioFormat(Uint8 * dst, const Uint8 * src, SDL_AudioFormat format,
         return;
     }
 
+    /* The scalar code below picks up whatever the SIMD code leaves over */
+    if ((format == AUDIO_S16SYS) || (format == AUDIO_S32SYS) || (format == AUDIO_F32SYS)) {
+        const Uint32 samplesize = SDL_AUDIO_BITSIZE(format) / 8;
+        const Uint32 mixed = SDL_MixAudio_SIMD(dst, src, format, len / samplesize, volume) * samplesize;
+        dst += mixed;
+        src += mixed;
+        len -= mixed;
+    }
+
     switch (format) {
 
     case AUDIO_U8:
@@ -32,8 +32,30 @@
 #define DEFAULT_OUTPUT_DEVNAME "System audio output device"
 #define DEFAULT_INPUT_DEVNAME "System audio capture device"
 
+/* Counters behind SDL_GetAudioDeviceStats(), with times in performance counter ticks. */
+typedef struct SDL_AudioDeviceCounters
+{
+    Uint32 callbacks;
+    Uint64 callback_min;
+    Uint64 callback_max;
+    Uint64 callback_total;
+    Uint32 conversions;
+    Uint64 conversion_max;
+    Uint64 conversion_total;
+    Uint32 underruns;  /* copied from the device's own counts, less (underruns_base) */
+    Uint32 overruns;
+    Uint32 underruns_base;  /* the device's counts when the stats were last reset */
+    Uint32 overruns_base;
+    Uint64 silence_frames;
+    Uint32 stream_bytes;
+    Uint32 stream_bytes_max;
+    Uint32 queued_bytes;
+    Uint32 queued_bytes_max;
+} SDL_AudioDeviceCounters;
+
 /* The SDL audio driver */
 typedef struct SDL_AudioDevice SDL_AudioDevice;
+typedef struct SDL_AudioRing SDL_AudioRing;
 #define _THIS   SDL_AudioDevice *_this
 
 /* Audio targets should call this as devices are added to the system (such as
@@ -165,6 +187,26 @@ struct SDL_AudioDevice
     /* Queued buffers (if app not using callback). */
     SDL_DataQueue *buffer_queue;
 
+    /* Lock-free ring used instead of buffer_queue with SDL_HINT_AUDIO_QUEUE_LOCKFREE. */
+    SDL_AudioRing *ring;
+
+    /* Times the device ran out of audio to play, or dropped captured audio.
+       This is the only count of either: SDL_GetQueuedAudioXruns() reads it,
+       and the stats copy it. A queue that stays empty is one underrun. */
+    SDL_atomic_t underruns;
+    SDL_atomic_t overruns;
+
+    /* true if the last callback ran out of queued audio. Only the device thread touches this. */
+    SDL_bool queue_starved;
+
+    /* Only the device thread touches (counters). Once per buffer it copies
+       them to (published_counters) for SDL_GetAudioDeviceStats(), bumping
+       (counters_sequence) before and after, so it's odd during the copy. */
+    SDL_AudioDeviceCounters counters;
+    SDL_AudioDeviceCounters published_counters;
+    SDL_atomic_t counters_sequence;
+    SDL_atomic_t counters_reset;
+
     /* * * */
     /* Data private to this driver */
     struct SDL_PrivateAudioData *hidden;
@@ -35,6 +35,7 @@
 
 #include "SDL_hints.h"
 #include "SDL_audio.h"
+#include "SDL_cpuinfo.h"
 #include "SDL_wave.h"
 #include "SDL_audio_c.h"
 
@@ -490,40 +491,32 @@ MS_ADPCM_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
-static Sint16
+/* Adapts the delta to each nibble. */
+static const Uint16 MS_ADPCM_Adaptive[16] = {
+    230, 230, 230, 230, 307, 409, 512, 614,
+    768, 614, 512, 409, 307, 230, 230, 230
+};
+
+static SDL_INLINE Sint16
 MS_ADPCM_ProcessNibble(MS_ADPCM_ChannelState *cstate, Sint32 sample1, Sint32 sample2, Uint8 nybble)
 {
     const Sint32 max_audioval = 32767;
     const Sint32 min_audioval = -32768;
-    const Uint16 max_deltaval = 65535;
-    const Uint16 adaptive[] = {
-        230, 230, 230, 230, 307, 409, 512, 614,
-        768, 614, 512, 409, 307, 230, 230, 230
-    };
-    Sint32 new_sample;
-    Sint32 errordelta;
-    Uint32 delta = cstate->delta;
+    const Sint32 max_deltaval = 65535;
+    const Sint32 delta = cstate->delta;
+    Sint32 new_sample, new_delta;
 
     new_sample = (sample1 * cstate->coeff1 + sample2 * cstate->coeff2) / 256;
     /* The nibble is a signed 4-bit error delta. */
-    errordelta = (Sint32)nybble - (nybble >= 0x08 ? 0x10 : 0);
-    new_sample += (Sint32)delta * errordelta;
-    if (new_sample < min_audioval) {
-        new_sample = min_audioval;
-    } else if (new_sample > max_audioval) {
-        new_sample = max_audioval;
-    }
-    delta = (delta * adaptive[nybble]) / 256;
-    if (delta < 16) {
-        delta = 16;
-    } else if (delta > max_deltaval) {
-        /* This issue is not described in the Standards Update and therefore
-         * undefined. It seems sensible to prevent overflows with a limit.
-         */
-        delta = max_deltaval;
-    }
+    new_sample += delta * (((Sint32)nybble ^ 0x08) - 0x08);
+    new_sample = SDL_min(SDL_max(new_sample, min_audioval), max_audioval);
+
+    /* An overflowing delta is not described in the Standards Update and
+     * therefore undefined. It seems sensible to prevent overflows with a limit.
+     */
+    new_delta = (delta * MS_ADPCM_Adaptive[nybble]) / 256;
+    cstate->delta = (Uint16)SDL_min(SDL_max(new_delta, 16), max_deltaval);
 
-    cstate->delta = (Uint16)delta;
     return (Sint16)new_sample;
 }
 
@@ -587,15 +580,18 @@ MS_ADPCM_DecodeBlockHeader(ADPCM_DecoderState *state)
  * short, returning with none or partially decoded data. The partial data
  * will always contain full sample frames (same sample count for each channel).
  * Incomplete sample frames are discarded.
+ *
+ * The last two samples of each channel and the channel state stay in local
+ * variables, and a stereo byte decodes both channels at once, so the two
+ * channels' dependency chains can overlap.
  */
 static int
 MS_ADPCM_DecodeBlockData(ADPCM_DecoderState *state)
 {
-    Uint16 nybble = 0;
-    Sint16 sample1, sample2;
-    const Uint32 channels = state->channels;
-    Uint32 c;
     MS_ADPCM_ChannelState *cstate = (MS_ADPCM_ChannelState *)state->cstate;
+    const Uint8 *data = state->block.data;
+    Sint16 *output = state->output.data;
+    int retval = 0;
 
     size_t blockpos = state->block.pos;
     size_t blocksize = state->block.size;
@@ -606,34 +602,78 @@ MS_ADPCM_DecodeBlockData(ADPCM_DecoderState *state)
     if (blockframesleft > state->framesleft) {
         blockframesleft = state->framesleft;
     }
+    state->framesleft -= blockframesleft;
 
-    while (blockframesleft > 0) {
-        for (c = 0; c < channels; c++) {
-            if (nybble & 0x4000) {
-                nybble <<= 4;
-            } else if (blockpos < blocksize) {
-                nybble = state->block.data[blockpos++] | 0x4000;
-            } else {
-                /* Out of input data. Drop the incomplete frame and return. */
-                state->output.pos = outpos - c;
-                return -1;
+    if (state->channels == 2) {
+        MS_ADPCM_ChannelState left = cstate[0], right = cstate[1];
+        /* Previous samples, which may come from the block header. */
+        Sint16 left1 = output[outpos - 2], left2 = output[outpos - 4];
+        Sint16 right1 = output[outpos - 1], right2 = output[outpos - 3];
+
+        while (blockframesleft > 0) {
+            Uint8 byte;
+            Sint16 l, r;
+
+            if (blockpos >= blocksize) {
+                /* Out of input data. */
+                retval = -1;
+                break;
             }
+            byte = data[blockpos++];
+
+            l = MS_ADPCM_ProcessNibble(&left, left1, left2, byte >> 4);
+            r = MS_ADPCM_ProcessNibble(&right, right1, right2, byte & 0x0f);
+            output[outpos++] = l;
+            output[outpos++] = r;
+            left2 = left1;
+            left1 = l;
+            right2 = right1;
+            right1 = r;
+            blockframesleft--;
+        }
+
+        cstate[0] = left;
+        cstate[1] = right;
+    } else {
+        MS_ADPCM_ChannelState mono = cstate[0];
+        Sint16 sample1 = output[outpos - 1], sample2 = output[outpos - 2];
 
-            /* Load previous samples which may come from the block header. */
-            sample1 = state->output.data[outpos - channels];
-            sample2 = state->output.data[outpos - channels * 2];
+        while (blockframesleft > 0) {
+            Uint8 byte;
+            Sint16 sample;
 
-            sample1 = MS_ADPCM_ProcessNibble(cstate + c, sample1, sample2, (nybble >> 4) & 0x0f);
-            state->output.data[outpos++] = sample1;
+            if (blockpos >= blocksize) {
+                /* Out of input data. */
+                retval = -1;
+                break;
+            }
+            byte = data[blockpos++];
+
+            /* Two sample frames per byte, the high nibble first. */
+            sample = MS_ADPCM_ProcessNibble(&mono, sample1, sample2, byte >> 4);
+            output[outpos++] = sample;
+            sample2 = sample1;
+            sample1 = sample;
+            blockframesleft--;
+
+            if (blockframesleft > 0) {
+                sample = MS_ADPCM_ProcessNibble(&mono, sample1, sample2, byte & 0x0f);
+                output[outpos++] = sample;
+                sample2 = sample1;
+                sample1 = sample;
+                blockframesleft--;
+            }
         }
 
-        state->framesleft--;
-        blockframesleft--;
+        cstate[0] = mono;
     }
 
+    /* Give back the sample frames that didn't get decoded. */
+    state->framesleft += blockframesleft;
+    state->block.pos = blockpos;
     state->output.pos = outpos;
 
-    return 0;
+    return retval;
 }
 
 static int
@@ -856,70 +896,93 @@ IMA_ADPCM_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
-static Sint16
-IMA_ADPCM_ProcessNibble(Sint8 *cindex, Sint16 lastsample, Uint8 nybble)
+/* The change to the sample for each step size and nibble. This calculation
+ * uses shifts and additions because multiplications were much slower back
+ * then. Sadly, this can't just be replaced with an actual multiplication now
+ * as the old algorithm drops some bits. The closest approximation I could
+ * find is something like this:
+ * (nybble & 0x8 ? -1 : 1) * ((nybble & 0x7) * step / 4 + step / 8)
+ */
+#define IMA_DELTA(step, n) \
+    ((((step) >> 3) + (((n) & 4) ? (step) : 0) + (((n) & 2) ? (step) >> 1 : 0) + (((n) & 1) ? (step) >> 2 : 0)) * (((n) & 8) ? -1 : 1))
+#define IMA_DELTAS(step) { \
+    IMA_DELTA(step, 0), IMA_DELTA(step, 1), IMA_DELTA(step, 2), IMA_DELTA(step, 3), \
+    IMA_DELTA(step, 4), IMA_DELTA(step, 5), IMA_DELTA(step, 6), IMA_DELTA(step, 7), \
+    IMA_DELTA(step, 8), IMA_DELTA(step, 9), IMA_DELTA(step, 10), IMA_DELTA(step, 11), \
+    IMA_DELTA(step, 12), IMA_DELTA(step, 13), IMA_DELTA(step, 14), IMA_DELTA(step, 15) }
+
+/* Indexed by step index and nibble, so decoding a sample needs no branches. */
+static const Sint32 IMA_ADPCM_DeltaTable[89][16] = {
+    IMA_DELTAS(7), IMA_DELTAS(8), IMA_DELTAS(9), IMA_DELTAS(10), IMA_DELTAS(11),
+    IMA_DELTAS(12), IMA_DELTAS(13), IMA_DELTAS(14), IMA_DELTAS(16), IMA_DELTAS(17),
+    IMA_DELTAS(19), IMA_DELTAS(21), IMA_DELTAS(23), IMA_DELTAS(25), IMA_DELTAS(28),
+    IMA_DELTAS(31), IMA_DELTAS(34), IMA_DELTAS(37), IMA_DELTAS(41), IMA_DELTAS(45),
+    IMA_DELTAS(50), IMA_DELTAS(55), IMA_DELTAS(60), IMA_DELTAS(66), IMA_DELTAS(73),
+    IMA_DELTAS(80), IMA_DELTAS(88), IMA_DELTAS(97), IMA_DELTAS(107),
+    IMA_DELTAS(118), IMA_DELTAS(130), IMA_DELTAS(143), IMA_DELTAS(157),
+    IMA_DELTAS(173), IMA_DELTAS(190), IMA_DELTAS(209), IMA_DELTAS(230),
+    IMA_DELTAS(253), IMA_DELTAS(279), IMA_DELTAS(307), IMA_DELTAS(337),
+    IMA_DELTAS(371), IMA_DELTAS(408), IMA_DELTAS(449), IMA_DELTAS(494),
+    IMA_DELTAS(544), IMA_DELTAS(598), IMA_DELTAS(658), IMA_DELTAS(724),
+    IMA_DELTAS(796), IMA_DELTAS(876), IMA_DELTAS(963), IMA_DELTAS(1060),
+    IMA_DELTAS(1166), IMA_DELTAS(1282), IMA_DELTAS(1411), IMA_DELTAS(1552),
+    IMA_DELTAS(1707), IMA_DELTAS(1878), IMA_DELTAS(2066), IMA_DELTAS(2272),
+    IMA_DELTAS(2499), IMA_DELTAS(2749), IMA_DELTAS(3024), IMA_DELTAS(3327),
+    IMA_DELTAS(3660), IMA_DELTAS(4026), IMA_DELTAS(4428), IMA_DELTAS(4871),
+    IMA_DELTAS(5358), IMA_DELTAS(5894), IMA_DELTAS(6484), IMA_DELTAS(7132),
+    IMA_DELTAS(7845), IMA_DELTAS(8630), IMA_DELTAS(9493), IMA_DELTAS(10442),
+    IMA_DELTAS(11487), IMA_DELTAS(12635), IMA_DELTAS(13899), IMA_DELTAS(15289),
+    IMA_DELTAS(16818), IMA_DELTAS(18500), IMA_DELTAS(20350), IMA_DELTAS(22385),
+    IMA_DELTAS(24623), IMA_DELTAS(27086), IMA_DELTAS(29794), IMA_DELTAS(32767)
+};
+
+#undef IMA_DELTAS
+#undef IMA_DELTA
+
+/* The next step index for each step index and nibble, already clamped. */
+#define IMA_INDEX(index, adjust) (((index) + (adjust)) < 0 ? 0 : ((index) + (adjust)) > 88 ? 88 : ((index) + (adjust)))
+#define IMA_NEXT(i) { \
+    IMA_INDEX(i, -1), IMA_INDEX(i, -1), IMA_INDEX(i, -1), IMA_INDEX(i, -1), \
+    IMA_INDEX(i, 2), IMA_INDEX(i, 4), IMA_INDEX(i, 6), IMA_INDEX(i, 8), \
+    IMA_INDEX(i, -1), IMA_INDEX(i, -1), IMA_INDEX(i, -1), IMA_INDEX(i, -1), \
+    IMA_INDEX(i, 2), IMA_INDEX(i, 4), IMA_INDEX(i, 6), IMA_INDEX(i, 8) }
+
+static const Uint8 IMA_ADPCM_IndexTable[89][16] = {
+    IMA_NEXT(0), IMA_NEXT(1), IMA_NEXT(2), IMA_NEXT(3), IMA_NEXT(4), IMA_NEXT(5),
+    IMA_NEXT(6), IMA_NEXT(7), IMA_NEXT(8), IMA_NEXT(9), IMA_NEXT(10), IMA_NEXT(11),
+    IMA_NEXT(12), IMA_NEXT(13), IMA_NEXT(14), IMA_NEXT(15), IMA_NEXT(16),
+    IMA_NEXT(17), IMA_NEXT(18), IMA_NEXT(19), IMA_NEXT(20), IMA_NEXT(21),
+    IMA_NEXT(22), IMA_NEXT(23), IMA_NEXT(24), IMA_NEXT(25), IMA_NEXT(26),
+    IMA_NEXT(27), IMA_NEXT(28), IMA_NEXT(29), IMA_NEXT(30), IMA_NEXT(31),
+    IMA_NEXT(32), IMA_NEXT(33), IMA_NEXT(34), IMA_NEXT(35), IMA_NEXT(36),
+    IMA_NEXT(37), IMA_NEXT(38), IMA_NEXT(39), IMA_NEXT(40), IMA_NEXT(41),
+    IMA_NEXT(42), IMA_NEXT(43), IMA_NEXT(44), IMA_NEXT(45), IMA_NEXT(46),
+    IMA_NEXT(47), IMA_NEXT(48), IMA_NEXT(49), IMA_NEXT(50), IMA_NEXT(51),
+    IMA_NEXT(52), IMA_NEXT(53), IMA_NEXT(54), IMA_NEXT(55), IMA_NEXT(56),
+    IMA_NEXT(57), IMA_NEXT(58), IMA_NEXT(59), IMA_NEXT(60), IMA_NEXT(61),
+    IMA_NEXT(62), IMA_NEXT(63), IMA_NEXT(64), IMA_NEXT(65), IMA_NEXT(66),
+    IMA_NEXT(67), IMA_NEXT(68), IMA_NEXT(69), IMA_NEXT(70), IMA_NEXT(71),
+    IMA_NEXT(72), IMA_NEXT(73), IMA_NEXT(74), IMA_NEXT(75), IMA_NEXT(76),
+    IMA_NEXT(77), IMA_NEXT(78), IMA_NEXT(79), IMA_NEXT(80), IMA_NEXT(81),
+    IMA_NEXT(82), IMA_NEXT(83), IMA_NEXT(84), IMA_NEXT(85), IMA_NEXT(86),
+    IMA_NEXT(87), IMA_NEXT(88)
+};
+
+#undef IMA_NEXT
+#undef IMA_INDEX
+
+static SDL_INLINE Sint16
+IMA_ADPCM_ProcessNibble(Uint8 *cindex, Sint32 lastsample, Uint8 nybble)
 {
     const Sint32 max_audioval = 32767;
     const Sint32 min_audioval = -32768;
-    const Sint8 index_table_4b[16] = {
-        -1, -1, -1, -1,
-        2, 4, 6, 8,
-        -1, -1, -1, -1,
-        2, 4, 6, 8
-    };
-    const Uint16 step_table[89] = {
-        7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
-        34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130,
-        143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408,
-        449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282,
-        1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
-        3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
-        9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
-        22385, 24623, 27086, 29794, 32767
-    };
-    Uint32 step;
-    Sint32 sample, delta;
-    Sint8 index = *cindex;
-
-    /* Clamp index into valid range. */
-    if (index > 88) {
-        index = 88;
-    } else if (index < 0) {
-        index = 0;
-    }
-
-    /* explicit cast to avoid gcc warning about using 'char' as array index */
-    step = step_table[(size_t)index];
-
-    /* Update index value */
-    *cindex = index + index_table_4b[nybble];
-
-    /* This calculation uses shifts and additions because multiplications were
-     * much slower back then. Sadly, this can't just be replaced with an actual
-     * multiplication now as the old algorithm drops some bits. The closest
-     * approximation I could find is something like this:
-     * (nybble & 0x8 ? -1 : 1) * ((nybble & 0x7) * step / 4 + step / 8)
-     */
-    delta = step >> 3;
-    if (nybble & 0x04)
-        delta += step;
-    if (nybble & 0x02)
-        delta += step >> 1;
-    if (nybble & 0x01)
-        delta += step >> 2;
-    if (nybble & 0x08)
-        delta = -delta;
-
-    sample = lastsample + delta;
+    const Uint8 index = *cindex;
+    const Sint32 sample = lastsample + IMA_ADPCM_DeltaTable[index][nybble];
 
-    /* Clamp output sample */
-    if (sample > max_audioval) {
-        sample = max_audioval;
-    } else if (sample < min_audioval) {
-        sample = min_audioval;
-    }
+    *cindex = IMA_ADPCM_IndexTable[index][nybble];
 
-    return (Sint16)sample;
+    /* Clamp output sample */
+    return (Sint16)SDL_min(SDL_max(sample, min_audioval), max_audioval);
 }
 
 static int
@@ -927,7 +990,7 @@ IMA_ADPCM_DecodeBlockHeader(ADPCM_DecoderState *state)
 {
     Sint16 step;
     Uint32 c;
-    Uint8 *cstate = (Uint8 *) state->cstate;
+    Uint8 *cstate = (Uint8 *)state->cstate;
 
     for (c = 0; c < state->channels; c++) {
         size_t o = state->block.pos + c * 4;
@@ -939,9 +1002,10 @@ IMA_ADPCM_DecodeBlockHeader(ADPCM_DecoderState *state)
         }
         state->output.data[state->output.pos++] = (Sint16)sample;
 
-        /* Channel step index. */
+        /* Channel step index, clamped into the valid range. */
         step = (Sint16)state->block.data[o + 2];
-        cstate[c] = (Sint8)(step > 0x80 ? step - 0x100 : step);
+        step = step > 0x80 ? step - 0x100 : step;
+        cstate[c] = (Uint8)SDL_min(SDL_max(step, 0), 88);
 
         /* Reserved byte in block header, should be 0. */
         if (state->block.data[o + 3] != 0) {
@@ -971,6 +1035,7 @@ IMA_ADPCM_DecodeBlockData(ADPCM_DecoderState *state)
     const size_t subblockframesize = channels * 4;
     Uint64 bytesrequired;
     Uint32 c;
+    Uint8 *cindex = (Uint8 *)state->cstate;
 
     size_t blockpos = state->block.pos;
     size_t blocksize = state->block.size;
@@ -998,29 +1063,48 @@ IMA_ADPCM_DecodeBlockData(ADPCM_DecoderState *state)
 
     /* Each channel has their nibbles packed into 32-bit blocks. These blocks
      * are interleaved and make up the data part of the ADPCM block. This loop
-     * decodes the samples as they come from the input data and puts them at
-     * the appropriate places in the output data.
+     * decodes a sub-block of every channel at a time and puts the samples at
+     * the appropriate places in the output data. Mono and stereo keep their
+     * state in local variables, and stereo decodes both channels in the same
+     * loop, so the two channels' dependency chains can overlap.
      */
     while (blockframesleft > 0) {
         const size_t subblocksamples = blockframesleft < 8 ? (size_t)blockframesleft : 8;
+        const Uint8 *subblock = state->block.data + blockpos;
+        Sint16 *output = state->output.data + outpos;
 
-        for (c = 0; c < channels; c++) {
-            Uint8 nybble = 0;
-            /* Load previous sample which may come from the block header. */
-            Sint16 sample = state->output.data[outpos + c - channels];
-
+        if (channels == 1) {
+            Uint8 index = cindex[0];
+            Sint16 sample = output[-1];
             for (i = 0; i < subblocksamples; i++) {
-                if (i & 1) {
-                    nybble >>= 4;
-                } else {
-                    nybble = state->block.data[blockpos++];
+                sample = IMA_ADPCM_ProcessNibble(&index, sample, (subblock[i >> 1] >> ((i & 1) * 4)) & 0x0f);
+                output[i] = sample;
+            }
+            cindex[0] = index;
+        } else if (channels == 2) {
+            Uint8 left = cindex[0], right = cindex[1];
+            Sint16 leftsample = output[-2], rightsample = output[-1];
+            for (i = 0; i < subblocksamples; i++) {
+                const int shift = (i & 1) * 4;
+                leftsample = IMA_ADPCM_ProcessNibble(&left, leftsample, (subblock[i >> 1] >> shift) & 0x0f);
+                rightsample = IMA_ADPCM_ProcessNibble(&right, rightsample, (subblock[4 + (i >> 1)] >> shift) & 0x0f);
+                output[i * 2] = leftsample;
+                output[i * 2 + 1] = rightsample;
+            }
+            cindex[0] = left;
+            cindex[1] = right;
+        } else {
+            for (c = 0; c < channels; c++) {
+                /* Load previous sample which may come from the block header. */
+                Sint16 sample = output[(int)c - (int)channels];
+                for (i = 0; i < subblocksamples; i++) {
+                    sample = IMA_ADPCM_ProcessNibble(cindex + c, sample, (subblock[c * 4 + (i >> 1)] >> ((i & 1) * 4)) & 0x0f);
+                    output[c + i * channels] = sample;
                 }
-
-                sample = IMA_ADPCM_ProcessNibble((Sint8 *)state->cstate + c, sample, nybble & 0x0f);
-                state->output.data[outpos + c + i * channels] = sample;
             }
         }
 
+        blockpos += subblockframesize;
         outpos += channels * subblocksamples;
         state->framesleft -= subblocksamples;
         blockframesleft -= subblocksamples;
@@ -1039,7 +1123,7 @@ IMA_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
     size_t bytesleft, outputsize;
     WaveChunk *chunk = &file->chunk;
     ADPCM_DecoderState state;
-    Sint8 *cstate;
+    Uint8 *cstate;
 
     if (chunk->size != chunk->length) {
         /* Could not read everything. Recalculate number of sample frames. */
@@ -1083,7 +1167,7 @@ IMA_ADPCM_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
         return SDL_OutOfMemory();
     }
 
-    cstate = (Sint8 *)SDL_calloc(state.channels, sizeof(Sint8));
+    cstate = (Uint8 *)SDL_calloc(state.channels, sizeof(Uint8));
     if (cstate == NULL) {
         SDL_free(state.output.data);
         return SDL_OutOfMemory();
@@ -1165,51 +1249,175 @@ LAW_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
-static int
-LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
+static const Sint16 LAW_ALawTable[256] = {
+    -5504, -5248, -6016, -5760, -4480, -4224, -4992, -4736, -7552, -7296, -8064, -7808, -6528, -6272, -7040, -6784, -2752,
+    -2624, -3008, -2880, -2240, -2112, -2496, -2368, -3776, -3648, -4032, -3904, -3264, -3136, -3520, -3392, -22016,
+    -20992, -24064, -23040, -17920, -16896, -19968, -18944, -30208, -29184, -32256, -31232, -26112, -25088, -28160, -27136, -11008,
+    -10496, -12032, -11520, -8960, -8448, -9984, -9472, -15104, -14592, -16128, -15616, -13056, -12544, -14080, -13568, -344,
+    -328, -376, -360, -280, -264, -312, -296, -472, -456, -504, -488, -408, -392, -440, -424, -88,
+    -72, -120, -104, -24, -8, -56, -40, -216, -200, -248, -232, -152, -136, -184, -168, -1376,
+    -1312, -1504, -1440, -1120, -1056, -1248, -1184, -1888, -1824, -2016, -1952, -1632, -1568, -1760, -1696, -688,
+    -656, -752, -720, -560, -528, -624, -592, -944, -912, -1008, -976, -816, -784, -880, -848, 5504,
+    5248, 6016, 5760, 4480, 4224, 4992, 4736, 7552, 7296, 8064, 7808, 6528, 6272, 7040, 6784, 2752,
+    2624, 3008, 2880, 2240, 2112, 2496, 2368, 3776, 3648, 4032, 3904, 3264, 3136, 3520, 3392, 22016,
+    20992, 24064, 23040, 17920, 16896, 19968, 18944, 30208, 29184, 32256, 31232, 26112, 25088, 28160, 27136, 11008,
+    10496, 12032, 11520, 8960, 8448, 9984, 9472, 15104, 14592, 16128, 15616, 13056, 12544, 14080, 13568, 344,
+    328, 376, 360, 280, 264, 312, 296, 472, 456, 504, 488, 408, 392, 440, 424, 88,
+    72, 120, 104, 24, 8, 56, 40, 216, 200, 248, 232, 152, 136, 184, 168, 1376,
+    1312, 1504, 1440, 1120, 1056, 1248, 1184, 1888, 1824, 2016, 1952, 1632, 1568, 1760, 1696, 688,
+    656, 752, 720, 560, 528, 624, 592, 944, 912, 1008, 976, 816, 784, 880, 848
+};
+
+static const Sint16 LAW_MuLawTable[256] = {
+    -32124, -31100, -30076, -29052, -28028, -27004, -25980, -24956, -23932, -22908, -21884, -20860, -19836, -18812, -17788, -16764, -15996,
+    -15484, -14972, -14460, -13948, -13436, -12924, -12412, -11900, -11388, -10876, -10364, -9852, -9340, -8828, -8316, -7932,
+    -7676, -7420, -7164, -6908, -6652, -6396, -6140, -5884, -5628, -5372, -5116, -4860, -4604, -4348, -4092, -3900,
+    -3772, -3644, -3516, -3388, -3260, -3132, -3004, -2876, -2748, -2620, -2492, -2364, -2236, -2108, -1980, -1884,
+    -1820, -1756, -1692, -1628, -1564, -1500, -1436, -1372, -1308, -1244, -1180, -1116, -1052, -988, -924, -876,
+    -844, -812, -780, -748, -716, -684, -652, -620, -588, -556, -524, -492, -460, -428, -396, -372,
+    -356, -340, -324, -308, -292, -276, -260, -244, -228, -212, -196, -180, -164, -148, -132, -120,
+    -112, -104, -96, -88, -80, -72, -64, -56, -48, -40, -32, -24, -16, -8, 0, 32124,
+    31100, 30076, 29052, 28028, 27004, 25980, 24956, 23932, 22908, 21884, 20860, 19836, 18812, 17788, 16764, 15996,
+    15484, 14972, 14460, 13948, 13436, 12924, 12412, 11900, 11388, 10876, 10364, 9852, 9340, 8828, 8316, 7932,
+    7676, 7420, 7164, 6908, 6652, 6396, 6140, 5884, 5628, 5372, 5116, 4860, 4604, 4348, 4092, 3900,
+    3772, 3644, 3516, 3388, 3260, 3132, 3004, 2876, 2748, 2620, 2492, 2364, 2236, 2108, 1980, 1884,
+    1820, 1756, 1692, 1628, 1564, 1500, 1436, 1372, 1308, 1244, 1180, 1116, 1052, 988, 924, 876,
+    844, 812, 780, 748, 716, 684, 652, 620, 588, 556, 524, 492, 460, 428, 396, 372,
+    356, 340, 324, 308, 292, 276, 260, 244, 228, 212, 196, 180, 164, 148, 132, 120,
+    112, 104, 96, 88, 80, 72, 64, 56, 48, 40, 32, 24, 16, 8, 0
+};
+
+/* The SIMD versions skip the tables and decode the bytes directly, which
+ * is how the tables were made:
+ *
+ *   mu-law: n = ~byte, ((((n & 0xf) << 3) + 0x84) << ((n >> 4) & 7)) - 0x84
+ *   A-law:  n = byte ^ 0x55, e = (n & 0x7f) >> 4,
+ *           (((n & 0xf) << 4) | 8 | (e ? 0x100 : 0)) << max(e - 1, 0)
+ *
+ * Bit 7 of n gives the sign.
+ */
+#if HAVE_SSE2_INTRINSICS
+/* SSE2 has no per-lane shifts, so shift by each bit of the shift count. */
+static SDL_INLINE __m128i
+LAW_ShiftLeftSSE2(__m128i value, const __m128i count)
 {
-#ifdef SDL_WAVE_LAW_LUT
-    const Sint16 alaw_lut[256] = {
-        -5504, -5248, -6016, -5760, -4480, -4224, -4992, -4736, -7552, -7296, -8064, -7808, -6528, -6272, -7040, -6784, -2752,
-        -2624, -3008, -2880, -2240, -2112, -2496, -2368, -3776, -3648, -4032, -3904, -3264, -3136, -3520, -3392, -22016,
-        -20992, -24064, -23040, -17920, -16896, -19968, -18944, -30208, -29184, -32256, -31232, -26112, -25088, -28160, -27136, -11008,
-        -10496, -12032, -11520, -8960, -8448, -9984, -9472, -15104, -14592, -16128, -15616, -13056, -12544, -14080, -13568, -344,
-        -328, -376, -360, -280, -264, -312, -296, -472, -456, -504, -488, -408, -392, -440, -424, -88,
-        -72, -120, -104, -24, -8, -56, -40, -216, -200, -248, -232, -152, -136, -184, -168, -1376,
-        -1312, -1504, -1440, -1120, -1056, -1248, -1184, -1888, -1824, -2016, -1952, -1632, -1568, -1760, -1696, -688,
-        -656, -752, -720, -560, -528, -624, -592, -944, -912, -1008, -976, -816, -784, -880, -848, 5504,
-        5248, 6016, 5760, 4480, 4224, 4992, 4736, 7552, 7296, 8064, 7808, 6528, 6272, 7040, 6784, 2752,
-        2624, 3008, 2880, 2240, 2112, 2496, 2368, 3776, 3648, 4032, 3904, 3264, 3136, 3520, 3392, 22016,
-        20992, 24064, 23040, 17920, 16896, 19968, 18944, 30208, 29184, 32256, 31232, 26112, 25088, 28160, 27136, 11008,
-        10496, 12032, 11520, 8960, 8448, 9984, 9472, 15104, 14592, 16128, 15616, 13056, 12544, 14080, 13568, 344,
-        328, 376, 360, 280, 264, 312, 296, 472, 456, 504, 488, 408, 392, 440, 424, 88,
-        72, 120, 104, 24, 8, 56, 40, 216, 200, 248, 232, 152, 136, 184, 168, 1376,
-        1312, 1504, 1440, 1120, 1056, 1248, 1184, 1888, 1824, 2016, 1952, 1632, 1568, 1760, 1696, 688,
-        656, 752, 720, 560, 528, 624, 592, 944, 912, 1008, 976, 816, 784, 880, 848
-    };
-    const Sint16 mulaw_lut[256] = {
-        -32124, -31100, -30076, -29052, -28028, -27004, -25980, -24956, -23932, -22908, -21884, -20860, -19836, -18812, -17788, -16764, -15996,
-        -15484, -14972, -14460, -13948, -13436, -12924, -12412, -11900, -11388, -10876, -10364, -9852, -9340, -8828, -8316, -7932,
-        -7676, -7420, -7164, -6908, -6652, -6396, -6140, -5884, -5628, -5372, -5116, -4860, -4604, -4348, -4092, -3900,
-        -3772, -3644, -3516, -3388, -3260, -3132, -3004, -2876, -2748, -2620, -2492, -2364, -2236, -2108, -1980, -1884,
-        -1820, -1756, -1692, -1628, -1564, -1500, -1436, -1372, -1308, -1244, -1180, -1116, -1052, -988, -924, -876,
-        -844, -812, -780, -748, -716, -684, -652, -620, -588, -556, -524, -492, -460, -428, -396, -372,
-        -356, -340, -324, -308, -292, -276, -260, -244, -228, -212, -196, -180, -164, -148, -132, -120,
-        -112, -104, -96, -88, -80, -72, -64, -56, -48, -40, -32, -24, -16, -8, 0, 32124,
-        31100, 30076, 29052, 28028, 27004, 25980, 24956, 23932, 22908, 21884, 20860, 19836, 18812, 17788, 16764, 15996,
-        15484, 14972, 14460, 13948, 13436, 12924, 12412, 11900, 11388, 10876, 10364, 9852, 9340, 8828, 8316, 7932,
-        7676, 7420, 7164, 6908, 6652, 6396, 6140, 5884, 5628, 5372, 5116, 4860, 4604, 4348, 4092, 3900,
-        3772, 3644, 3516, 3388, 3260, 3132, 3004, 2876, 2748, 2620, 2492, 2364, 2236, 2108, 1980, 1884,
-        1820, 1756, 1692, 1628, 1564, 1500, 1436, 1372, 1308, 1244, 1180, 1116, 1052, 988, 924, 876,
-        844, 812, 780, 748, 716, 684, 652, 620, 588, 556, 524, 492, 460, 428, 396, 372,
-        356, 340, 324, 308, 292, 276, 260, 244, 228, 212, 196, 180, 164, 148, 132, 120,
-        112, 104, 96, 88, 80, 72, 64, 56, 48, 40, 32, 24, 16, 8, 0
-    };
+    const __m128i one = _mm_set1_epi16(1), two = _mm_set1_epi16(2), four = _mm_set1_epi16(4);
+    __m128i mask;
+
+    mask = _mm_cmpeq_epi16(_mm_and_si128(count, one), one);
+    value = _mm_or_si128(_mm_and_si128(mask, _mm_slli_epi16(value, 1)), _mm_andnot_si128(mask, value));
+    mask = _mm_cmpeq_epi16(_mm_and_si128(count, two), two);
+    value = _mm_or_si128(_mm_and_si128(mask, _mm_slli_epi16(value, 2)), _mm_andnot_si128(mask, value));
+    mask = _mm_cmpeq_epi16(_mm_and_si128(count, four), four);
+    return _mm_or_si128(_mm_and_si128(mask, _mm_slli_epi16(value, 4)), _mm_andnot_si128(mask, value));
+}
+
+/* Expands eight companded samples, zero-extended to 16 bits. */
+static SDL_INLINE __m128i
+LAW_Expand8SSE2(Uint16 encoding, __m128i bytes)
+{
+    const __m128i sign = _mm_set1_epi16(0x80);
+    __m128i n, value, negative;
+
+    if (encoding == MULAW_CODE) {
+        n = _mm_xor_si128(bytes, _mm_set1_epi16(0xff));
+        value = _mm_add_epi16(_mm_slli_epi16(_mm_and_si128(n, _mm_set1_epi16(0xf)), 3), _mm_set1_epi16(0x84));
+        value = LAW_ShiftLeftSSE2(value, _mm_and_si128(_mm_srli_epi16(n, 4), _mm_set1_epi16(7)));
+        value = _mm_sub_epi16(value, _mm_set1_epi16(0x84));
+        negative = _mm_cmpeq_epi16(_mm_and_si128(n, sign), sign);
+    } else {
+        __m128i exponent;
+        n = _mm_xor_si128(bytes, _mm_set1_epi16(0x55));
+        exponent = _mm_srli_epi16(_mm_and_si128(n, _mm_set1_epi16(0x7f)), 4);
+        value = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(n, _mm_set1_epi16(0xf)), 4), _mm_set1_epi16(8));
+        value = _mm_or_si128(value, _mm_andnot_si128(_mm_cmpeq_epi16(exponent, _mm_setzero_si128()), _mm_set1_epi16(0x100)));
+        value = LAW_ShiftLeftSSE2(value, _mm_subs_epu16(exponent, _mm_set1_epi16(1)));
+        negative = _mm_cmpeq_epi16(_mm_and_si128(n, sign), _mm_setzero_si128());
+    }
+
+    /* Negate where needed: (value ^ -1) - -1 == -value. */
+    return _mm_sub_epi16(_mm_xor_si128(value, negative), negative);
+}
+#endif
+
+#if HAVE_NEON_INTRINSICS
+/* Expands eight companded samples, zero-extended to 16 bits. */
+static SDL_INLINE int16x8_t
+LAW_Expand8NEON(Uint16 encoding, uint16x8_t bytes)
+{
+    int16x8_t value;
+    uint16x8_t n, negative;
+
+    if (encoding == MULAW_CODE) {
+        n = veorq_u16(bytes, vdupq_n_u16(0xff));
+        value = vreinterpretq_s16_u16(vaddq_u16(vshlq_n_u16(vandq_u16(n, vdupq_n_u16(0xf)), 3), vdupq_n_u16(0x84)));
+        value = vshlq_s16(value, vreinterpretq_s16_u16(vandq_u16(vshrq_n_u16(n, 4), vdupq_n_u16(7))));
+        value = vsubq_s16(value, vdupq_n_s16(0x84));
+        negative = vtstq_u16(n, vdupq_n_u16(0x80));
+    } else {
+        uint16x8_t exponent;
+        n = veorq_u16(bytes, vdupq_n_u16(0x55));
+        exponent = vshrq_n_u16(vandq_u16(n, vdupq_n_u16(0x7f)), 4);
+        value = vreinterpretq_s16_u16(vorrq_u16(vshlq_n_u16(vandq_u16(n, vdupq_n_u16(0xf)), 4), vdupq_n_u16(8)));
+        value = vorrq_s16(value, vreinterpretq_s16_u16(vandq_u16(vtstq_u16(exponent, exponent), vdupq_n_u16(0x100))));
+        value = vshlq_s16(value, vreinterpretq_s16_u16(vqsubq_u16(exponent, vdupq_n_u16(1))));
+        negative = vceqq_u16(vandq_u16(n, vdupq_n_u16(0x80)), vdupq_n_u16(0));
+    }
+
+    return vbslq_s16(negative, vnegq_s16(value), value);
+}
+#endif
+
+/* Expands (count) companded samples from (src) to 16-bit samples in (dst).
+ * Works backwards, so (dst) may start at the same address as (src).
+ */
+static void
+LAW_Expand(Uint16 encoding, const Uint8 *src, Sint16 *dst, size_t count)
+{
+    const Sint16 *lut = (encoding == MULAW_CODE) ? LAW_MuLawTable : LAW_ALawTable;
+    size_t i = count;
+
+    SDL_assert(encoding == ALAW_CODE || encoding == MULAW_CODE);
+
+    /* Every 16 bytes are loaded before the 32 bytes they expand to are
+     * stored, and those never reach below the 16 bytes, so this can work
+     * in place too.
+     */
+#if HAVE_SSE2_INTRINSICS
+    if (SDL_HasSSE2()) {
+        const __m128i zero = _mm_setzero_si128();
+        while (i >= 16) {
+            __m128i bytes;
+            i -= 16;
+            bytes = _mm_loadu_si128((const __m128i *)(src + i));
+            _mm_storeu_si128((__m128i *)(dst + i), LAW_Expand8SSE2(encoding, _mm_unpacklo_epi8(bytes, zero)));
+            _mm_storeu_si128((__m128i *)(dst + i + 8), LAW_Expand8SSE2(encoding, _mm_unpackhi_epi8(bytes, zero)));
+        }
+    }
 #endif
+#if HAVE_NEON_INTRINSICS
+    if (SDL_HasNEON()) {
+        while (i >= 16) {
+            uint8x16_t bytes;
+            i -= 16;
+            bytes = vld1q_u8(src + i);
+            vst1q_s16(dst + i, LAW_Expand8NEON(encoding, vmovl_u8(vget_low_u8(bytes))));
+            vst1q_s16(dst + i + 8, LAW_Expand8NEON(encoding, vmovl_u8(vget_high_u8(bytes))));
+        }
+    }
+#endif
+
+    while (i--) {
+        dst[i] = lut[src[i]];
+    }
+}
 
+static int
+LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
+{
     WaveFormat *format = &file->format;
     WaveChunk *chunk = &file->chunk;
-    size_t i, sample_count, expanded_len;
+    size_t sample_count, expanded_len;
     Uint8 *src;
     Sint16 *dst;
 
@@ -1252,55 +1460,7 @@ LAW_Decode(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
     /* Work backwards, since we're expanding in-place. SDL_AudioSpec.format will
      * inform the caller about the byte order.
      */
-    i = sample_count;
-    switch (file->format.encoding) {
-#ifdef SDL_WAVE_LAW_LUT
-    case ALAW_CODE:
-        while (i--) {
-            dst[i] = alaw_lut[src[i]];
-        }
-        break;
-    case MULAW_CODE:
-        while (i--) {
-            dst[i] = mulaw_lut[src[i]];
-        }
-        break;
-#else
-    case ALAW_CODE:
-        while (i--) {
-            Uint8 nibble = src[i];
-            Uint8 exponent = (nibble & 0x7f) ^ 0x55;
-            Sint16 mantissa = exponent & 0xf;
-
-            exponent >>= 4;
-            if (exponent > 0) {
-                mantissa |= 0x10;
-            }
-            mantissa = (mantissa << 4) | 0x8;
-            if (exponent > 1) {
-                mantissa <<= exponent - 1;
-            }
-
-            dst[i] = nibble & 0x80 ? mantissa : -mantissa;
-        }
-        break;
-    case MULAW_CODE:
-        while (i--) {
-            Uint8 nibble = ~src[i];
-            Sint16 mantissa = nibble & 0xf;
-            Uint8 exponent = (nibble >> 4) & 0x7;
-            Sint16 step = 4 << (exponent + 1);
-
-            mantissa = (0x80 << exponent) + step * mantissa + step / 2 - 132;
-
-            dst[i] = nibble & 0x80 ? -mantissa : mantissa;
-        }
-        break;
-#endif
-    default:
-        SDL_free(src);
-        return SDL_SetError("Unknown companded encoding");
-    }
+    LAW_Expand(file->format.encoding, src, dst, sample_count);
 
     *audio_buf = src;
     *audio_len = (Uint32)expanded_len;
@@ -1352,12 +1512,35 @@ PCM_Init(WaveFile *file, size_t datalength)
     return 0;
 }
 
+/* Shifts (count) 24-bit samples at the start of (ptr) to 32 bits. */
+static void
+PCM_ExpandSint24ToSint32(Uint8 *ptr, size_t count)
+{
+    size_t i;
+
+    /* work from end to start, since we're expanding in-place. */
+    for (i = count; i > 0; i--) {
+        const size_t o = i - 1;
+        uint8_t b[4];
+
+        b[0] = 0;
+        b[1] = ptr[o * 3];
+        b[2] = ptr[o * 3 + 1];
+        b[3] = ptr[o * 3 + 2];
+
+        ptr[o * 4 + 0] = b[0];
+        ptr[o * 4 + 1] = b[1];
+        ptr[o * 4 + 2] = b[2];
+        ptr[o * 4 + 3] = b[3];
+    }
+}
+
 static int
 PCM_ConvertSint24ToSint32(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
 {
     WaveFormat *format = &file->format;
     WaveChunk *chunk = &file->chunk;
-    size_t i, expanded_len, sample_count;
+    size_t expanded_len, sample_count;
     Uint8 *ptr;
 
     sample_count = (size_t)file->sampleframes;
@@ -1385,21 +1568,7 @@ PCM_ConvertSint24ToSint32(WaveFile *file, Uint8 **audio_buf, Uint32 *audio_len)
     *audio_buf = ptr;
     *audio_len = (Uint32)expanded_len;
 
-    /* work from end to start, since we're expanding in-place. */
-    for (i = sample_count; i > 0; i--) {
-        const size_t o = i - 1;
-        uint8_t b[4];
-
-        b[0] = 0;
-        b[1] = ptr[o * 3];
-        b[2] = ptr[o * 3 + 1];
-        b[3] = ptr[o * 3 + 2];
-
-        ptr[o * 4 + 0] = b[0];
-        ptr[o * 4 + 1] = b[1];
-        ptr[o * 4 + 2] = b[2];
-        ptr[o * 4 + 3] = b[3];
-    }
+    PCM_ExpandSint24ToSint32(ptr, sample_count);
 
     return 0;
 }
@@ -1783,8 +1952,12 @@ WaveCheckFormat(WaveFile *file, size_t datalength)
     return 0;
 }
 
+/* Finds the fmt and data chunks, checks the format, and initializes the
+ * decoder. On success, file->chunk describes the data chunk with none of its
+ * data read yet, and (endposition) is where the WAVE file ends in (src).
+ */
 static int
-WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32 *audio_len)
+WaveOpen(SDL_RWops *src, WaveFile *file, Sint64 *endposition)
 {
     int result;
     Uint32 chunkcount = 0;
@@ -1792,7 +1965,6 @@ WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf,
     char *envchunkcountlimit;
     Sint64 RIFFstart, RIFFend, lastchunkpos;
     SDL_bool RIFFlengthknown = SDL_FALSE;
-    WaveFormat *format = &file->format;
     WaveChunk *chunk = &file->chunk;
     WaveChunk RIFFchunk;
     WaveChunk fmtchunk;
@@ -2000,6 +2172,74 @@ WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf,
     /* Process data chunk. */
     *chunk = datachunk;
 
+    if (RIFFlengthknown) {
+        *endposition = RIFFend;
+    } else {
+        *endposition = lastchunkpos;
+    }
+
+    return 0;
+}
+
+/* Sets up the SDL_AudioSpec for the decoded data. */
+static int
+WaveGetSpec(WaveFile *file, SDL_AudioSpec *spec)
+{
+    WaveFormat *format = &file->format;
+
+    /* All unsupported formats were filtered out by WaveCheckFormat. */
+    SDL_zerop(spec);
+    spec->freq = format->frequency;
+    spec->channels = (Uint8)format->channels;
+    spec->samples = 4096;       /* Good default buffer size */
+
+    switch (format->encoding) {
+    case MS_ADPCM_CODE:
+    case IMA_ADPCM_CODE:
+    case ALAW_CODE:
+    case MULAW_CODE:
+        /* These can be easily stored in the byte order of the system. */
+        spec->format = AUDIO_S16SYS;
+        break;
+    case IEEE_FLOAT_CODE:
+        spec->format = AUDIO_F32LSB;
+        break;
+    case PCM_CODE:
+        switch (format->bitspersample) {
+        case 8:
+            spec->format = AUDIO_U8;
+            break;
+        case 16:
+            spec->format = AUDIO_S16LSB;
+            break;
+        case 24: /* Gets shifted to 32 bits. */
+        case 32:
+            spec->format = AUDIO_S32LSB;
+            break;
+        default:
+            /* Just in case something unexpected happened in the checks. */
+            return SDL_SetError("Unexpected %u-bit PCM data format", (unsigned int)format->bitspersample);
+        }
+        break;
+    }
+
+    spec->silence = SDL_SilenceValueForFormat(spec->format);
+
+    return 0;
+}
+
+static int
+WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32 *audio_len)
+{
+    int result;
+    Sint64 endposition;
+    WaveFormat *format = &file->format;
+    WaveChunk *chunk = &file->chunk;
+
+    if (WaveOpen(src, file, &endposition) < 0) {
+        return -1;
+    }
+
     if (chunk->length > 0) {
         result = WaveReadChunkData(src, chunk);
         if (result == -1) {
@@ -2043,52 +2283,12 @@ WaveLoad(SDL_RWops *src, WaveFile *file, SDL_AudioSpec *spec, Uint8 **audio_buf,
         break;
     }
 
-    /* Setting up the SDL_AudioSpec. All unsupported formats were filtered out
-     * by checks earlier in this function.
-     */
-    SDL_zerop(spec);
-    spec->freq = format->frequency;
-    spec->channels = (Uint8)format->channels;
-    spec->samples = 4096;       /* Good default buffer size */
-
-    switch (format->encoding) {
-    case MS_ADPCM_CODE:
-    case IMA_ADPCM_CODE:
-    case ALAW_CODE:
-    case MULAW_CODE:
-        /* These can be easily stored in the byte order of the system. */
-        spec->format = AUDIO_S16SYS;
-        break;
-    case IEEE_FLOAT_CODE:
-        spec->format = AUDIO_F32LSB;
-        break;
-    case PCM_CODE:
-        switch (format->bitspersample) {
-        case 8:
-            spec->format = AUDIO_U8;
-            break;
-        case 16:
-            spec->format = AUDIO_S16LSB;
-            break;
-        case 24: /* Has been shifted to 32 bits. */
-        case 32:
-            spec->format = AUDIO_S32LSB;
-            break;
-        default:
-            /* Just in case something unexpected happened in the checks. */
-            return SDL_SetError("Unexpected %u-bit PCM data format", (unsigned int)format->bitspersample);
-        }
-        break;
+    if (WaveGetSpec(file, spec) < 0) {
+        return -1;
     }
 
-    spec->silence = SDL_SilenceValueForFormat(spec->format);
-
     /* Report the end position back to the cleanup code. */
-    if (RIFFlengthknown) {
-        chunk->position = RIFFend;
-    } else {
-        chunk->position = lastchunkpos;
-    }
+    chunk->position = endposition;
 
     return 0;
 }
@@ -2152,4 +2352,436 @@ SDL_FreeWAV(Uint8 *audio_buf)
     SDL_free(audio_buf);
 }
 
+/* WAVE streaming */
+
+/* Sample frames that SDL_AudioStreamPutWAV() decodes at a time for the
+ * formats that don't have blocks.
+ */
+#define WAVE_STREAM_CHUNK_FRAMES 4096
+
+struct SDL_WAVStream
+{
+    SDL_RWops *src;
+    int freesrc;
+    WaveFile file;          /* file.chunk is the data chunk; file.chunk.size is how much of it is in src. */
+    Sint64 srcposition;     /* Where src is, as far as we know, or -1 if we don't. */
+    size_t rawframesize;    /* Size of a sample frame in the data chunk, for formats without blocks. */
+    size_t framesize;       /* Size of a decoded sample frame. */
+    Sint64 framestotal;     /* Number of sample frames in the stream. */
+    Sint64 frame;           /* Next sample frame to return. */
+    const Uint8 *mapped;    /* The data chunk, if src is backed by memory, or NULL. */
+
+    /* For ADPCM, the current block and its decoded sample frames. For
+     * everything else, room for WAVE_STREAM_CHUNK_FRAMES decoded sample frames.
+     */
+    Uint8 *buffer;
+    ADPCM_DecoderState adpcm;
+    Sint64 block;           /* Index of the decoded ADPCM block, or -1. */
+    Sint64 blockframes;     /* Number of sample frames decoded from that block. */
+};
+
+static SDL_bool
+WaveIsADPCM(WaveFile *file)
+{
+    return (file->format.encoding == MS_ADPCM_CODE || file->format.encoding == IMA_ADPCM_CODE) ? SDL_TRUE : SDL_FALSE;
+}
+
+/* Reads up to (len) bytes from (offset) in the data chunk. Returns the number
+ * of bytes read, or -1 if seeking failed.
+ */
+static Sint64
+WaveStreamReadData(SDL_WAVStream *wav, Sint64 offset, void *buf, size_t len)
+{
+    const Sint64 position = wav->file.chunk.position + offset;
+    size_t got;
+
+    if (offset >= (Sint64)wav->file.chunk.size) {
+        return 0;
+    } else if (len > wav->file.chunk.size - (size_t)offset) {
+        len = wav->file.chunk.size - (size_t)offset;
+    }
+
+    if (wav->mapped) {
+        SDL_memcpy(buf, wav->mapped + offset, len);
+        return (Sint64)len;
+    }
+
+    /* Seeking can throw away the RWops' read buffer, so only do it when we have to. */
+    if (wav->srcposition != position) {
+        if (SDL_RWseek(wav->src, position, RW_SEEK_SET) != position) {
+            wav->srcposition = -1;
+            return SDL_SetError("Could not seek data of WAVE data chunk");
+        }
+    }
+
+    got = SDL_RWread(wav->src, buf, 1, len);
+    wav->srcposition = position + got;
+    return (Sint64)got;
+}
+
+/* Decodes the ADPCM block with the given index into wav->adpcm.output. */
+static int
+WaveStreamDecodeBlock(SDL_WAVStream *wav, Sint64 block)
+{
+    ADPCM_DecoderState *state = &wav->adpcm;
+    const Sint64 firstframe = block * (Sint64)state->samplesperblock;
+    Sint64 got;
+    int result;
+
+    wav->block = -1;
+    wav->blockframes = 0;
+
+    if (wav->mapped) {
+        /* Decode straight from memory. The decoders don't write to the block. */
+        const Sint64 offset = block * (Sint64)state->blocksize;
+        const Sint64 left = (Sint64)wav->file.chunk.size - offset;
+        state->block.data = (Uint8 *)wav->mapped + offset;
+        got = left < (Sint64)state->blocksize ? SDL_max(left, 0) : (Sint64)state->blocksize;
+    } else {
+        got = WaveStreamReadData(wav, block * (Sint64)state->blocksize, state->block.data, state->blocksize);
+    }
+    if (got < 0) {
+        return -1;
+    } else if ((size_t)got < state->blockheadersize) {
+        return 0;  /* Out of data. */
+    }
+
+    state->block.size = (size_t)got;
+    state->block.pos = 0;
+    state->output.pos = 0;
+    state->framesleft = wav->framestotal - firstframe;
+    if (state->framesleft > (Sint64)state->samplesperblock) {
+        state->framesleft = state->samplesperblock;
+    }
+
+    if (wav->file.format.encoding == MS_ADPCM_CODE) {
+        result = MS_ADPCM_DecodeBlockHeader(state);
+        if (result == 0) {
+            /* A truncated block still gives us its complete sample frames. */
+            MS_ADPCM_DecodeBlockData(state);
+        }
+    } else {
+        result = IMA_ADPCM_DecodeBlockHeader(state);
+        if (result == 0) {
+            IMA_ADPCM_DecodeBlockData(state);
+        }
+    }
+
+    if (result < 0) {
+        return -1;
+    }
+
+    wav->block = block;
+    wav->blockframes = state->output.pos / state->channels;
+    return 0;
+}
+
+/* Decodes up to (frames) sample frames at the current position and points
+ * (data) at them. ADPCM sample frames come straight from the decoded block;
+ * everything else is read into (buf), which must have room for (frames)
+ * decoded sample frames. Returns the number of sample frames, 0 at the end
+ * of the stream, or -1 on error.
+ */
+static Sint64
+WaveStreamDecode(SDL_WAVStream *wav, Uint8 *buf, Sint64 frames, const Uint8 **data)
+{
+    WaveFormat *format = &wav->file.format;
+    Sint64 got;
+
+    if (frames > wav->framestotal - wav->frame) {
+        frames = wav->framestotal - wav->frame;
+    }
+    if (frames <= 0) {
+        return 0;
+    }
+
+    if (WaveIsADPCM(&wav->file)) {
+        const Sint64 samplesperblock = (Sint64)wav->adpcm.samplesperblock;
+        const Sint64 block = wav->frame / samplesperblock;
+        const Sint64 offset = wav->frame % samplesperblock;
+
+        if (block != wav->block) {
+            if (WaveStreamDecodeBlock(wav, block) < 0) {
+                return -1;
+            }
+        }
+
+        got = wav->blockframes - offset;
+        if (got <= 0) {
+            return 0;  /* Truncated block. */
+        } else if (got > frames) {
+            got = frames;
+        }
+        *data = (const Uint8 *)(wav->adpcm.output.data + offset * wav->adpcm.channels);
+    } else if (wav->mapped && (format->encoding == ALAW_CODE || format->encoding == MULAW_CODE ||
+                               (wav->rawframesize == wav->framesize))) {
+        /* Memory-backed data is used as it is, or expanded straight into (buf). */
+        const Sint64 offset = wav->frame * (Sint64)wav->rawframesize;
+        const Uint8 *raw = wav->mapped + offset;
+        got = ((Sint64)wav->file.chunk.size - offset) / (Sint64)wav->rawframesize;
+        if (got > frames) {
+            got = frames;
+        } else if (got <= 0) {
+            return 0;
+        }
+
+        if (format->encoding == ALAW_CODE || format->encoding == MULAW_CODE) {
+            LAW_Expand(format->encoding, raw, (Sint16 *)buf, (size_t)got * format->channels);
+            *data = buf;
+        } else {
+            *data = raw;
+        }
+    } else {
+        /* A decoded sample frame is never smaller than the one in the file, so
+         * read into the start of (buf) and expand in place.
+         */
+        got = WaveStreamReadData(wav, wav->frame * (Sint64)wav->rawframesize, buf, (size_t)frames * wav->rawframesize);
+        if (got < 0) {
+            return -1;
+        }
+        got /= (Sint64)wav->rawframesize;
+
+        if (format->encoding == ALAW_CODE || format->encoding == MULAW_CODE) {
+            LAW_Expand(format->encoding, buf, (Sint16 *)buf, (size_t)got * format->channels);
+        } else if (format->encoding == PCM_CODE && format->bitspersample == 24) {
+            PCM_ExpandSint24ToSint32(buf, (size_t)got * format->channels);
+        }
+        *data = buf;
+    }
+
+    wav->frame += got;
+    return got;
+}
+
+void
+SDL_CloseWAVStream(SDL_WAVStream *wav)
+{
+    if (wav) {
+        if (wav->freesrc && wav->src) {
+            SDL_RWclose(wav->src);
+        }
+        WaveFreeChunkData(&wav->file.chunk);
+        SDL_free(wav->file.decoderdata);
+        SDL_free(wav->adpcm.cstate);
+        SDL_free(wav->buffer);
+        SDL_free(wav);
+    }
+}
+
+SDL_WAVStream *
+SDL_OpenWAVStream_RW(SDL_RWops *src, int freesrc, SDL_AudioSpec *spec)
+{
+    SDL_WAVStream *wav;
+    WaveFile *file;
+    WaveChunk *chunk;
+    Sint64 endposition, size;
+    const Uint8 *mem;
+    size_t memsize = 0;
+
+    /* Make sure we are passed a valid data source */
+    if (src == NULL) {
+        /* Error may come from RWops. */
+        return NULL;
+    } else if (spec == NULL) {
+        SDL_InvalidParamError("spec");
+        if (freesrc) {
+            SDL_RWclose(src);
+        }
+        return NULL;
+    }
+
+    wav = (SDL_WAVStream *)SDL_calloc(1, sizeof(*wav));
+    if (wav == NULL) {
+        SDL_OutOfMemory();
+        if (freesrc) {
+            SDL_RWclose(src);
+        }
+        return NULL;
+    }
+    wav->src = src;
+    wav->freesrc = freesrc;
+    wav->srcposition = -1;
+    wav->block = -1;
+
+    file = &wav->file;
+    chunk = &file->chunk;
+    file->riffhint = WaveGetRiffSizeHint();
+    file->trunchint = WaveGetTruncationHint();
+    file->facthint = WaveGetFactChunkHint();
+
+    if (WaveOpen(src, file, &endposition) < 0 || WaveGetSpec(file, spec) < 0) {
+        SDL_CloseWAVStream(wav);
+        return NULL;
+    }
+
+    /* Find out how much of the data chunk is actually there, like reading
+     * the whole chunk would, without reading it.
+     */
+    chunk->size = chunk->length;
+    size = SDL_RWsize(src);
+    if (size >= 0 && size - chunk->position < (Sint64)chunk->length) {
+        chunk->size = size > chunk->position ? (size_t)(size - chunk->position) : 0;
+    }
+
+    if (chunk->length != chunk->size) {
+        int result = 0;
+
+        /* I/O issues or corrupt file. */
+        if (file->trunchint == TruncVeryStrict || file->trunchint == TruncStrict) {
+            SDL_SetError("Could not read data of WAVE data chunk");
+            SDL_CloseWAVStream(wav);
+            return NULL;
+        }
+
+        /* Recalculate the number of sample frames like the decoders do. */
+        if (file->format.encoding == MS_ADPCM_CODE) {
+            result = MS_ADPCM_CalculateSampleFrames(file, chunk->size);
+        } else if (file->format.encoding == IMA_ADPCM_CODE) {
+            result = IMA_ADPCM_CalculateSampleFrames(file, chunk->size);
+        } else {
+            file->sampleframes = WaveAdjustToFactValue(file, chunk->size / file->format.blockalign);
+            result = (file->sampleframes < 0) ? -1 : 0;
+        }
+        if (result < 0) {
+            SDL_CloseWAVStream(wav);
+            return NULL;
+        }
+    }
+
+    /* Memory-backed sources, like memory-mapped files, are decoded in place. */
+    mem = (const Uint8 *)SDL_RWGetMemory(src, &memsize);
+    if (mem && chunk->position >= 0 && (Uint64)chunk->position + chunk->size <= memsize) {
+        wav->mapped = mem + chunk->position;
+    }
+
+    wav->framesize = (SDL_AUDIO_BITSIZE(spec->format) / 8) * spec->channels;
+    wav->framestotal = file->sampleframes;
+
+    if (WaveIsADPCM(file)) {
+        ADPCM_DecoderState *state = &wav->adpcm;
+        state->channels = file->format.channels;
+        state->blocksize = file->format.blockalign;
+        state->blockheadersize = (size_t)state->channels * (file->format.encoding == MS_ADPCM_CODE ? 7 : 4);
+        state->samplesperblock = file->format.samplesperblock;
+        state->framesize = wav->framesize;
+        state->framestotal = wav->framestotal;
+        state->ddata = file->decoderdata;
+        state->output.size = state->samplesperblock * state->channels;
+        state->cstate = SDL_calloc(state->channels, sizeof(MS_ADPCM_ChannelState));
+        wav->buffer = (Uint8 *)SDL_malloc(state->output.size * sizeof(Sint16) + state->blocksize);
+        if (state->cstate == NULL || wav->buffer == NULL) {
+            SDL_OutOfMemory();
+            SDL_CloseWAVStream(wav);
+            return NULL;
+        }
+        state->output.data = (Sint16 *)wav->buffer;
+        state->block.data = wav->buffer + state->output.size * sizeof(Sint16);
+    } else {
+        /* Odd block alignments make PCM_Decode count bytes, not sample frames. */
+        wav->rawframesize = ((size_t)file->format.channels * file->format.bitspersample) / 8;
+        wav->framestotal = (file->sampleframes * file->format.blockalign) / (Sint64)wav->rawframesize;
+        wav->buffer = (Uint8 *)SDL_malloc(WAVE_STREAM_CHUNK_FRAMES * wav->framesize);
+        if (wav->buffer == NULL) {
+            SDL_OutOfMemory();
+            SDL_CloseWAVStream(wav);
+            return NULL;
+        }
+    }
+
+    return wav;
+}
+
+int
+SDL_WAVStreamRead(SDL_WAVStream *wav, void *buf, int frames)
+{
+    Uint8 *dst = (Uint8 *)buf;
+    int total = 0;
+
+    if (wav == NULL) {
+        return SDL_InvalidParamError("wav");
+    } else if (buf == NULL) {
+        return SDL_InvalidParamError("buf");
+    } else if (frames < 0) {
+        return SDL_InvalidParamError("frames");
+    }
+
+    while (total < frames) {
+        const Uint8 *data;
+        const Sint64 got = WaveStreamDecode(wav, dst, frames - total, &data);
+        if (got < 0) {
+            return (total > 0) ? total : -1;
+        } else if (got == 0) {
+            break;
+        }
+        if (data != dst) {
+            SDL_memcpy(dst, data, (size_t)got * wav->framesize);
+        }
+        dst += (size_t)got * wav->framesize;
+        total += (int)got;
+    }
+
+    return total;
+}
+
+int
+SDL_AudioStreamPutWAV(SDL_AudioStream *stream, SDL_WAVStream *wav, int frames)
+{
+    int total = 0;
+
+    if (stream == NULL) {
+        return SDL_InvalidParamError("stream");
+    } else if (wav == NULL) {
+        return SDL_InvalidParamError("wav");
+    } else if (frames < 0) {
+        return SDL_InvalidParamError("frames");
+    }
+
+    while (total < frames) {
+        const Uint8 *data;
+        const Sint64 got = WaveStreamDecode(wav, wav->buffer, SDL_min(frames - total, WAVE_STREAM_CHUNK_FRAMES), &data);
+        if (got < 0) {
+            return (total > 0) ? total : -1;
+        } else if (got == 0) {
+            break;
+        } else if (SDL_AudioStreamPut(stream, data, (int)(got * wav->framesize)) < 0) {
+            return -1;
+        }
+        total += (int)got;
+    }
+
+    return total;
+}
+
+int
+SDL_WAVStreamSeek(SDL_WAVStream *wav, Sint64 frame)
+{
+    if (wav == NULL) {
+        return SDL_InvalidParamError("wav");
+    } else if (frame < 0 || frame > wav->framestotal) {
+        return SDL_InvalidParamError("frame");
+    }
+
+    /* ADPCM decodes the block holding this sample frame on the next read. */
+    wav->frame = frame;
+    return 0;
+}
+
+Sint64
+SDL_WAVStreamTell(SDL_WAVStream *wav)
+{
+    if (wav == NULL) {
+        return SDL_InvalidParamError("wav");
+    }
+    return wav->frame;
+}
+
+Sint64
+SDL_WAVStreamLength(SDL_WAVStream *wav)
+{
+    if (wav == NULL) {
+        return SDL_InvalidParamError("wav");
+    }
+    return wav->framestotal;
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
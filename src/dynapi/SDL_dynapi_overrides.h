@@ -799,3 +799,23 @@
 #define SDL_SetWindowMouseGrab SDL_SetWindowMouseGrab_REAL
 #define SDL_GetWindowKeyboardGrab SDL_GetWindowKeyboardGrab_REAL
 #define SDL_GetWindowMouseGrab SDL_GetWindowMouseGrab_REAL
+#define SDL_PollEvents SDL_PollEvents_REAL
+#define SDL_GetCoalescedEventCount SDL_GetCoalescedEventCount_REAL
+#define SDL_DelayNS SDL_DelayNS_REAL
+#define SDL_AddTimerNS SDL_AddTimerNS_REAL
+#define SDL_AudioStreamSetResamplerQuality SDL_AudioStreamSetResamplerQuality_REAL
+#define SDL_ConvertAudioSamples SDL_ConvertAudioSamples_REAL
+#define SDL_GetQueuedAudioXruns SDL_GetQueuedAudioXruns_REAL
+#define SDL_GetAudioDeviceStats SDL_GetAudioDeviceStats_REAL
+#define SDL_ResetAudioDeviceStats SDL_ResetAudioDeviceStats_REAL
+#define SDL_OpenWAVStream_RW SDL_OpenWAVStream_RW_REAL
+#define SDL_WAVStreamRead SDL_WAVStreamRead_REAL
+#define SDL_WAVStreamSeek SDL_WAVStreamSeek_REAL
+#define SDL_WAVStreamTell SDL_WAVStreamTell_REAL
+#define SDL_WAVStreamLength SDL_WAVStreamLength_REAL
+#define SDL_CloseWAVStream SDL_CloseWAVStream_REAL
+#define SDL_AudioStreamPutWAV SDL_AudioStreamPutWAV_REAL
+#define SDL_RWGetMemory SDL_RWGetMemory_REAL
+#define SDL_CreateBufferedRW SDL_CreateBufferedRW_REAL
+#define SDL_RenderGeometry SDL_RenderGeometry_REAL
+#define SDL_RenderGetStats SDL_RenderGetStats_REAL
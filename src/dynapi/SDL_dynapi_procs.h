@@ -862,3 +862,23 @@ SDL_DYNAPI_PROC(void,SDL_SetWindowKeyboardGrab,(SDL_Window *a, SDL_bool b),(a,b)
 SDL_DYNAPI_PROC(void,SDL_SetWindowMouseGrab,(SDL_Window *a, SDL_bool b),(a,b),)
 SDL_DYNAPI_PROC(SDL_bool,SDL_GetWindowKeyboardGrab,(SDL_Window *a),(a),return)
 SDL_DYNAPI_PROC(SDL_bool,SDL_GetWindowMouseGrab,(SDL_Window *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_PollEvents,(SDL_Event *a, int b),(a,b),return)
+SDL_DYNAPI_PROC(Uint32,SDL_GetCoalescedEventCount,(Uint32 a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_DelayNS,(Uint64 a),(a),)
+SDL_DYNAPI_PROC(SDL_TimerID,SDL_AddTimerNS,(Uint64 a, SDL_TimerCallbackNS b, void *c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_AudioStreamSetResamplerQuality,(SDL_AudioStream *a, SDL_AudioResamplerQuality b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_ConvertAudioSamples,(SDL_AudioFormat a, Uint8 b, int c, const void *d, int e, SDL_AudioFormat f, Uint8 g, int h, void **i, int *j, int k),(a,b,c,d,e,f,g,h,i,j,k),return)
+SDL_DYNAPI_PROC(Uint32,SDL_GetQueuedAudioXruns,(SDL_AudioDeviceID a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_GetAudioDeviceStats,(SDL_AudioDeviceID a, SDL_AudioDeviceStats *b),(a,b),return)
+SDL_DYNAPI_PROC(void,SDL_ResetAudioDeviceStats,(SDL_AudioDeviceID a),(a),)
+SDL_DYNAPI_PROC(SDL_WAVStream*,SDL_OpenWAVStream_RW,(SDL_RWops *a, int b, SDL_AudioSpec *c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_WAVStreamRead,(SDL_WAVStream *a, void *b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_WAVStreamSeek,(SDL_WAVStream *a, Sint64 b),(a,b),return)
+SDL_DYNAPI_PROC(Sint64,SDL_WAVStreamTell,(SDL_WAVStream *a),(a),return)
+SDL_DYNAPI_PROC(Sint64,SDL_WAVStreamLength,(SDL_WAVStream *a),(a),return)
+SDL_DYNAPI_PROC(void,SDL_CloseWAVStream,(SDL_WAVStream *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_AudioStreamPutWAV,(SDL_AudioStream *a, SDL_WAVStream *b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(const void*,SDL_RWGetMemory,(SDL_RWops *a, size_t *b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_RWops*,SDL_CreateBufferedRW,(SDL_RWops *a, size_t b, int c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_RenderGeometry,(SDL_Renderer *a, SDL_Texture *b, const SDL_Vertex *c, int d, const int *e, int f),(a,b,c,d,e,f),return)
+SDL_DYNAPI_PROC(int,SDL_RenderGetStats,(SDL_Renderer *a, SDL_RenderStats *b),(a,b),return)
@@ -26,6 +26,7 @@
 #include "SDL_events.h"
 #include "SDL_thread.h"
 #include "SDL_events_c.h"
+#include "../SDL_hints_c.h"
 #include "../timer/SDL_timer_c.h"
 #if !SDL_JOYSTICK_DISABLED
 #include "../joystick/SDL_joystick_c.h"
@@ -43,6 +44,9 @@
 /* An arbitrary limit so we don't have unbounded growth */
 #define SDL_MAX_QUEUED_EVENTS   65535
 
+/* Number of slots in the lock-free ring when SDL_HINT_EVENT_QUEUE_LOCKFREE is "1" */
+#define SDL_DEFAULT_EVENT_RING_SIZE 4096
+
 typedef struct SDL_EventWatcher {
     SDL_EventFilter callback;
     void *userdata;
@@ -91,6 +95,47 @@ static struct
     SDL_SysWMEntry *wmmsg_free;
 } SDL_EventQ = { NULL, { 1 }, { 0 }, 0, NULL, NULL, NULL, NULL, NULL };
 
+/* Number of events merged into the previous one, per coalescable event type */
+enum
+{
+    SDL_COALESCED_MOUSEMOTION,
+    SDL_COALESCED_FINGERMOTION,
+    SDL_COALESCED_SENSORUPDATE,
+    SDL_COALESCED_CONTROLLERSENSORUPDATE,
+    SDL_COALESCED_MAX
+};
+static Uint32 SDL_coalesced_events[SDL_COALESCED_MAX];
+
+/* Optional lock-free ring that producers push into without taking
+   SDL_EventQ.lock. Whoever holds the lock is the single consumer, and moves
+   ring entries onto the tail of SDL_EventQ before looking at the queue, so
+   the existing peek/get/flush/filter code sees events in push order.
+ */
+typedef struct _SDL_EventRingEntry
+{
+    SDL_atomic_t sequence;
+    SDL_Event event;
+    SDL_SysWMmsg msg;
+} SDL_EventRingEntry;
+
+static struct
+{
+    SDL_EventRingEntry *entries;
+    unsigned wrap_mask;
+
+    char cache_pad1[SDL_CACHELINE_SIZE-sizeof(SDL_EventRingEntry*)-sizeof(unsigned)];
+
+    SDL_atomic_t enqueue_pos;
+
+    char cache_pad2[SDL_CACHELINE_SIZE-sizeof(SDL_atomic_t)];
+
+    SDL_atomic_t producers; /* threads that may be touching entries right now */
+
+    char cache_pad3[SDL_CACHELINE_SIZE-sizeof(SDL_atomic_t)];
+
+    unsigned dequeue_pos;   /* only touched with SDL_EventQ.lock held */
+} SDL_EventRing;
+
 
 #if !SDL_JOYSTICK_DISABLED
 
@@ -149,6 +194,15 @@ SDL_EventLoggingChanged(void *userdata, const char *name, const char *oldValue,
     SDL_DoEventLogging = (hint && *hint) ? SDL_max(SDL_min(SDL_atoi(hint), 2), 0) : 0;
 }
 
+/* Merge consecutive high-rate motion and sensor events (SDL_HINT_EVENT_COALESCING) */
+static SDL_bool SDL_CoalesceEvents = SDL_FALSE;
+
+static void SDLCALL
+SDL_EventCoalescingChanged(void *userdata, const char *name, const char *oldValue, const char *hint)
+{
+    SDL_CoalesceEvents = SDL_GetStringBoolean(hint, SDL_FALSE);
+}
+
 static void
 SDL_LogEvent(const SDL_Event *event)
 {
@@ -389,6 +443,28 @@ SDL_LogEvent(const SDL_Event *event)
 
 
 
+static int
+SDL_GetEventRingSize(const char *hint)
+{
+    int size, wanted;
+
+    if (!hint || !*hint) {
+        return 0;
+    }
+    wanted = SDL_atoi(hint);
+    if (wanted <= 0) {
+        return 0;
+    } else if (wanted == 1) {
+        return SDL_DEFAULT_EVENT_RING_SIZE;
+    }
+
+    /* The number of entries must be a power of 2 */
+    wanted = SDL_min(wanted, SDL_MAX_QUEUED_EVENTS);
+    for (size = 2; size < wanted; size *= 2) {
+    }
+    return size;
+}
+
 /* Public functions */
 
 void
@@ -399,15 +475,27 @@ SDL_StopEventLoop(void)
     SDL_EventEntry *entry;
     SDL_SysWMEntry *wmmsg;
 
+    SDL_AtomicSet(&SDL_EventQ.active, 0);
+
+    /* Producers that got past the active check could still be filling ring
+       entries. They may need the lock to drain a full ring, so wait for them
+       before taking it. */
+    while (SDL_AtomicGet(&SDL_EventRing.producers) > 0) {
+        SDL_Delay(0);
+    }
+
     if (SDL_EventQ.lock) {
         SDL_LockMutex(SDL_EventQ.lock);
     }
 
-    SDL_AtomicSet(&SDL_EventQ.active, 0);
-
     if (report && SDL_atoi(report)) {
         SDL_Log("SDL EVENT QUEUE: Maximum events in-flight: %d\n",
                 SDL_EventQ.max_events_seen);
+        SDL_Log("SDL EVENT QUEUE: Coalesced events: %u mouse motion, %u finger motion, %u sensor, %u controller sensor\n",
+                (unsigned int) SDL_coalesced_events[SDL_COALESCED_MOUSEMOTION],
+                (unsigned int) SDL_coalesced_events[SDL_COALESCED_FINGERMOTION],
+                (unsigned int) SDL_coalesced_events[SDL_COALESCED_SENSORUPDATE],
+                (unsigned int) SDL_coalesced_events[SDL_COALESCED_CONTROLLERSENSORUPDATE]);
     }
 
     /* Clean out EventQ */
@@ -432,8 +520,17 @@ SDL_StopEventLoop(void)
         wmmsg = next;
     }
 
+    if (SDL_EventRing.entries) {
+        SDL_free(SDL_EventRing.entries);
+        SDL_EventRing.entries = NULL;
+        SDL_EventRing.wrap_mask = 0;
+        SDL_AtomicSet(&SDL_EventRing.enqueue_pos, 0);
+        SDL_EventRing.dequeue_pos = 0;
+    }
+
     SDL_AtomicSet(&SDL_EventQ.count, 0);
     SDL_EventQ.max_events_seen = 0;
+    SDL_zeroa(SDL_coalesced_events);
     SDL_EventQ.head = NULL;
     SDL_EventQ.tail = NULL;
     SDL_EventQ.free = NULL;
@@ -491,6 +588,24 @@ SDL_StartEventLoop(void)
     }
 #endif /* !SDL_THREADS_DISABLED */
 
+    if (!SDL_EventRing.entries) {
+        const int size = SDL_GetEventRingSize(SDL_GetHint(SDL_HINT_EVENT_QUEUE_LOCKFREE));
+        if (size > 0) {
+            int i;
+
+            SDL_EventRing.entries = (SDL_EventRingEntry *)SDL_malloc(size * sizeof(*SDL_EventRing.entries));
+            if (!SDL_EventRing.entries) {
+                return SDL_OutOfMemory();
+            }
+            for (i = 0; i < size; ++i) {
+                SDL_AtomicSet(&SDL_EventRing.entries[i].sequence, i);
+            }
+            SDL_EventRing.wrap_mask = (unsigned)(size - 1);
+            SDL_AtomicSet(&SDL_EventRing.enqueue_pos, 0);
+            SDL_EventRing.dequeue_pos = 0;
+        }
+    }
+
     /* Process most event types */
     SDL_EventState(SDL_TEXTINPUT, SDL_DISABLE);
     SDL_EventState(SDL_TEXTEDITING, SDL_DISABLE);
@@ -506,18 +621,11 @@ SDL_StartEventLoop(void)
 }
 
 
-/* Add an event to the event queue -- called with the queue locked */
+/* Link an event onto the tail of the event queue -- called with the queue locked */
 static int
-SDL_AddEvent(SDL_Event * event)
+SDL_LinkEvent(const SDL_Event * event)
 {
     SDL_EventEntry *entry;
-    const int initial_count = SDL_AtomicGet(&SDL_EventQ.count);
-    int final_count;
-
-    if (initial_count >= SDL_MAX_QUEUED_EVENTS) {
-        SDL_SetError("Event queue is full (%d events)", initial_count);
-        return 0;
-    }
 
     if (SDL_EventQ.free == NULL) {
         entry = (SDL_EventEntry *)SDL_malloc(sizeof(*entry));
@@ -529,10 +637,6 @@ SDL_AddEvent(SDL_Event * event)
         SDL_EventQ.free = entry->next;
     }
 
-    if (SDL_DoEventLogging) {
-        SDL_LogEvent(event);
-    }
-
     entry->event = *event;
     if (event->type == SDL_SYSWMEVENT) {
         entry->msg = *event->syswm.msg;
@@ -552,11 +656,212 @@ SDL_AddEvent(SDL_Event * event)
         entry->next = NULL;
     }
 
-    final_count = SDL_AtomicAdd(&SDL_EventQ.count, 1) + 1;
-    if (final_count > SDL_EventQ.max_events_seen) {
-        SDL_EventQ.max_events_seen = final_count;
+    return 1;
+}
+
+/* Merge an event into the tail of the event queue if it only updates the
+   same device's motion or sensor state -- called with the queue locked.
+   Only the tail is considered, so ordering relative to button, key and
+   other events is preserved.
+ */
+static SDL_bool
+SDL_CoalesceEvent(const SDL_Event * event)
+{
+    SDL_Event *tail;
+    int index;
+
+    if (!SDL_CoalesceEvents || !SDL_EventQ.tail) {
+        return SDL_FALSE;
     }
 
+    tail = &SDL_EventQ.tail->event;
+    if (tail->type != event->type) {
+        return SDL_FALSE;
+    }
+
+    switch (event->type) {
+    case SDL_MOUSEMOTION:
+        if (tail->motion.windowID != event->motion.windowID ||
+            tail->motion.which != event->motion.which ||
+            tail->motion.state != event->motion.state) {
+            return SDL_FALSE;
+        }
+        tail->motion.x = event->motion.x;
+        tail->motion.y = event->motion.y;
+        tail->motion.xrel += event->motion.xrel;
+        tail->motion.yrel += event->motion.yrel;
+        index = SDL_COALESCED_MOUSEMOTION;
+        break;
+    case SDL_FINGERMOTION:
+        if (tail->tfinger.windowID != event->tfinger.windowID ||
+            tail->tfinger.touchId != event->tfinger.touchId ||
+            tail->tfinger.fingerId != event->tfinger.fingerId) {
+            return SDL_FALSE;
+        }
+        tail->tfinger.x = event->tfinger.x;
+        tail->tfinger.y = event->tfinger.y;
+        tail->tfinger.dx += event->tfinger.dx;
+        tail->tfinger.dy += event->tfinger.dy;
+        tail->tfinger.pressure = event->tfinger.pressure;
+        index = SDL_COALESCED_FINGERMOTION;
+        break;
+    case SDL_SENSORUPDATE:
+        if (tail->sensor.which != event->sensor.which) {
+            return SDL_FALSE;
+        }
+        SDL_memcpy(tail->sensor.data, event->sensor.data, sizeof(tail->sensor.data));
+        index = SDL_COALESCED_SENSORUPDATE;
+        break;
+    case SDL_CONTROLLERSENSORUPDATE:
+        if (tail->csensor.which != event->csensor.which ||
+            tail->csensor.sensor != event->csensor.sensor) {
+            return SDL_FALSE;
+        }
+        SDL_memcpy(tail->csensor.data, event->csensor.data, sizeof(tail->csensor.data));
+        index = SDL_COALESCED_CONTROLLERSENSORUPDATE;
+        break;
+    default:
+        return SDL_FALSE;
+    }
+
+    tail->common.timestamp = event->common.timestamp;
+    ++SDL_coalesced_events[index];
+    return SDL_TRUE;
+}
+
+/* Add an event to the event queue -- called with the queue locked */
+static int
+SDL_AddEvent(SDL_Event * event)
+{
+    const int initial_count = SDL_AtomicGet(&SDL_EventQ.count);
+    int final_count;
+
+    /* Merging into the tail doesn't need a free slot, so try that first. */
+    if (!SDL_CoalesceEvent(event)) {
+        if (initial_count >= SDL_MAX_QUEUED_EVENTS) {
+            SDL_SetError("Event queue is full (%d events)", initial_count);
+            return 0;
+        }
+
+        if (!SDL_LinkEvent(event)) {
+            return 0;
+        }
+
+        final_count = SDL_AtomicAdd(&SDL_EventQ.count, 1) + 1;
+        if (final_count > SDL_EventQ.max_events_seen) {
+            SDL_EventQ.max_events_seen = final_count;
+        }
+    }
+
+    if (SDL_DoEventLogging) {
+        SDL_LogEvent(event);
+    }
+
+    return 1;
+}
+
+/* Add an event to the lock-free ring, returns SDL_FALSE if the ring is full */
+static SDL_bool
+SDL_EnqueueEventLockFree(const SDL_Event * event)
+{
+    SDL_EventRingEntry *entry;
+    unsigned queue_pos;
+    unsigned entry_seq;
+    int delta;
+
+    queue_pos = (unsigned)SDL_AtomicGet(&SDL_EventRing.enqueue_pos);
+    for ( ; ; ) {
+        entry = &SDL_EventRing.entries[queue_pos & SDL_EventRing.wrap_mask];
+        entry_seq = (unsigned)SDL_AtomicGet(&entry->sequence);
+
+        delta = (int)(entry_seq - queue_pos);
+        if (delta == 0) {
+            /* The entry and the queue position match, try to increment the queue position */
+            if (SDL_AtomicCAS(&SDL_EventRing.enqueue_pos, (int)queue_pos, (int)(queue_pos+1))) {
+                break;
+            }
+        } else if (delta < 0) {
+            /* We ran into an entry the consumer hasn't drained yet */
+            return SDL_FALSE;
+        } else {
+            /* Another producer got here first, get the new queue position */
+            queue_pos = (unsigned)SDL_AtomicGet(&SDL_EventRing.enqueue_pos);
+        }
+    }
+
+    /* We own the entry, fill it! */
+    entry->event = *event;
+    if (event->type == SDL_SYSWMEVENT) {
+        entry->msg = *event->syswm.msg;
+        entry->event.syswm.msg = &entry->msg;
+    }
+    SDL_MemoryBarrierRelease();
+    SDL_AtomicSet(&entry->sequence, (int)(queue_pos + 1));
+    return SDL_TRUE;
+}
+
+/* Move everything in the lock-free ring onto the event queue -- called with the queue locked.
+   Returns the number of entries it moved. */
+static int
+SDL_DrainEventRing(void)
+{
+    SDL_EventRingEntry *entry;
+    unsigned queue_pos;
+    unsigned entry_seq;
+    int count, drained;
+
+    if (!SDL_EventRing.entries) {
+        return 0;
+    }
+
+    queue_pos = SDL_EventRing.dequeue_pos;
+    for ( ; ; ) {
+        entry = &SDL_EventRing.entries[queue_pos & SDL_EventRing.wrap_mask];
+        entry_seq = (unsigned)SDL_AtomicGet(&entry->sequence);
+
+        /* Stop at the first entry a producer hasn't finished filling, to keep ordering */
+        if ((int)(entry_seq - (queue_pos + 1)) < 0) {
+            break;
+        }
+        SDL_MemoryBarrierAcquire();
+
+        if (SDL_CoalesceEvent(&entry->event) || !SDL_LinkEvent(&entry->event)) {
+            /* Merged into the tail, or out of memory and the event is lost */
+            SDL_AtomicAdd(&SDL_EventQ.count, -1);
+        }
+        SDL_AtomicSet(&entry->sequence, (int)(queue_pos + SDL_EventRing.wrap_mask + 1));
+        ++queue_pos;
+    }
+    drained = (int)(queue_pos - SDL_EventRing.dequeue_pos);
+    SDL_EventRing.dequeue_pos = queue_pos;
+
+    count = SDL_AtomicGet(&SDL_EventQ.count);
+    if (count > SDL_EventQ.max_events_seen) {
+        SDL_EventQ.max_events_seen = count;
+    }
+    return drained;
+}
+
+/* Add an event without taking the queue lock, returns 0 if the ring is full */
+static int
+SDL_AddEventLockFree(SDL_Event * event)
+{
+    const int initial_count = SDL_AtomicAdd(&SDL_EventQ.count, 1);
+
+    if (initial_count >= SDL_MAX_QUEUED_EVENTS) {
+        SDL_AtomicAdd(&SDL_EventQ.count, -1);
+        SDL_SetError("Event queue is full (%d events)", initial_count);
+        return -1;
+    }
+
+    if (!SDL_EnqueueEventLockFree(event)) {
+        SDL_AtomicAdd(&SDL_EventQ.count, -1);
+        return 0;
+    }
+
+    if (SDL_DoEventLogging) {
+        SDL_LogEvent(event);
+    }
     return 1;
 }
 
@@ -601,11 +906,74 @@ SDL_PeepEvents(SDL_Event * events, int numevents, SDL_eventaction action,
         }
         return (-1);
     }
-    /* Lock the event queue */
     used = 0;
+    i = 0;
+
+    /* Push into the lock-free ring. Events are never linked onto the queue
+       directly while it's in use, since that would put them ahead of ones
+       this thread pushed earlier that are still in the ring. */
+    if (action == SDL_ADDEVENT && SDL_EventRing.entries) {
+        SDL_AtomicAdd(&SDL_EventRing.producers, 1);
+        /* SDL_StopEventLoop() may have freed the ring before we got counted */
+        if (!SDL_AtomicGet(&SDL_EventQ.active) || !SDL_EventRing.entries) {
+            SDL_AtomicAdd(&SDL_EventRing.producers, -1);
+            return (-1);
+        }
+        while (i < numevents) {
+            const int status = SDL_AddEventLockFree(&events[i]);
+            if (status < 0) {
+                /* The queue is full, but the event may still merge into its
+                   tail. That's only in order once the ring is empty. */
+                SDL_bool coalesced = SDL_FALSE;
+                if (SDL_CoalesceEvents && (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0)) {
+                    SDL_DrainEventRing();
+                    if (SDL_EventRing.dequeue_pos == (unsigned)SDL_AtomicGet(&SDL_EventRing.enqueue_pos)) {
+                        coalesced = SDL_CoalesceEvent(&events[i]);
+                    }
+                    if (SDL_EventQ.lock) {
+                        SDL_UnlockMutex(SDL_EventQ.lock);
+                    }
+                }
+                if (!coalesced) {
+                    break;
+                }
+                if (SDL_DoEventLogging) {
+                    SDL_LogEvent(&events[i]);
+                }
+                ++used;
+                ++i;
+                continue;
+            } else if (status > 0) {
+                ++used;
+                ++i;
+                continue;
+            }
+
+            /* The ring is full, move what's in it onto the queue and try again */
+            if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
+                const int drained = SDL_DrainEventRing();
+                if (SDL_EventQ.lock) {
+                    SDL_UnlockMutex(SDL_EventQ.lock);
+                }
+                if (drained == 0) {
+                    /* Another producer is still filling the oldest entry */
+                    SDL_Delay(0);
+                }
+            } else {
+                SDL_SetError("Couldn't lock event queue");
+                break;
+            }
+        }
+        SDL_AtomicAdd(&SDL_EventRing.producers, -1);
+        return (used);
+    }
+
+    /* Lock the event queue */
     if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
+        SDL_DrainEventRing();
+
         if (action == SDL_ADDEVENT) {
-            for (i = 0; i < numevents; ++i) {
+            for ( ; i < numevents; ++i) {
                 used += SDL_AddEvent(&events[i]);
             }
         } else {
@@ -707,6 +1075,7 @@ SDL_FlushEvents(Uint32 minType, Uint32 maxType)
     if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
         SDL_EventEntry *entry, *next;
         Uint32 type;
+        SDL_DrainEventRing();
         for (entry = SDL_EventQ.head; entry; entry = next) {
             next = entry->next;
             type = entry->event.type;
@@ -759,6 +1128,20 @@ SDL_PollEvent(SDL_Event * event)
     return SDL_WaitEventTimeout(event, 0);
 }
 
+int
+SDL_PollEvents(SDL_Event * events, int numevents)
+{
+    if (!events) {
+        return SDL_InvalidParamError("events");
+    }
+    if (numevents <= 0) {
+        return 0;
+    }
+
+    SDL_PumpEvents();
+    return SDL_PeepEvents(events, numevents, SDL_GETEVENT, SDL_FIRSTEVENT, SDL_LASTEVENT);
+}
+
 int
 SDL_WaitEvent(SDL_Event * event)
 {
@@ -945,6 +1328,7 @@ SDL_FilterEvents(SDL_EventFilter filter, void *userdata)
 {
     if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
         SDL_EventEntry *entry, *next;
+        SDL_DrainEventRing();
         for (entry = SDL_EventQ.head; entry; entry = next) {
             next = entry->next;
             if (!filter(userdata, &entry->event)) {
@@ -1017,6 +1401,40 @@ SDL_EventState(Uint32 type, int state)
     return current_state;
 }
 
+Uint32
+SDL_GetCoalescedEventCount(Uint32 type)
+{
+    Uint32 count = 0;
+    int index;
+
+    switch (type) {
+    case SDL_MOUSEMOTION:
+        index = SDL_COALESCED_MOUSEMOTION;
+        break;
+    case SDL_FINGERMOTION:
+        index = SDL_COALESCED_FINGERMOTION;
+        break;
+    case SDL_SENSORUPDATE:
+        index = SDL_COALESCED_SENSORUPDATE;
+        break;
+    case SDL_CONTROLLERSENSORUPDATE:
+        index = SDL_COALESCED_CONTROLLERSENSORUPDATE;
+        break;
+    default:
+        return 0;
+    }
+
+    /* The counters are only updated with the queue locked. */
+    if (!SDL_EventQ.lock || SDL_LockMutex(SDL_EventQ.lock) == 0) {
+        SDL_DrainEventRing();  /* merge anything still waiting in the ring first. */
+        count = SDL_coalesced_events[index];
+        if (SDL_EventQ.lock) {
+            SDL_UnlockMutex(SDL_EventQ.lock);
+        }
+    }
+    return count;
+}
+
 Uint32
 SDL_RegisterEvents(int numevents)
 {
@@ -1084,7 +1502,9 @@ SDL_EventsInit(void)
     SDL_AddHintCallback(SDL_HINT_AUTO_UPDATE_SENSORS, SDL_AutoUpdateSensorsChanged, NULL);
 #endif
     SDL_AddHintCallback(SDL_HINT_EVENT_LOGGING, SDL_EventLoggingChanged, NULL);
+    SDL_AddHintCallback(SDL_HINT_EVENT_COALESCING, SDL_EventCoalescingChanged, NULL);
     if (SDL_StartEventLoop() < 0) {
+        SDL_DelHintCallback(SDL_HINT_EVENT_COALESCING, SDL_EventCoalescingChanged, NULL);
         SDL_DelHintCallback(SDL_HINT_EVENT_LOGGING, SDL_EventLoggingChanged, NULL);
         return -1;
     }
@@ -1099,6 +1519,7 @@ SDL_EventsQuit(void)
 {
     SDL_QuitQuit();
     SDL_StopEventLoop();
+    SDL_DelHintCallback(SDL_HINT_EVENT_COALESCING, SDL_EventCoalescingChanged, NULL);
     SDL_DelHintCallback(SDL_HINT_EVENT_LOGGING, SDL_EventLoggingChanged, NULL);
 #if !SDL_JOYSTICK_DISABLED
     SDL_DelHintCallback(SDL_HINT_AUTO_UPDATE_JOYSTICKS, SDL_AutoUpdateJoysticksChanged, NULL);
@@ -42,11 +42,20 @@
 #include <limits.h>
 #endif
 
+/* Read-only files can be memory-mapped where SDL_RWFromFile() uses stdio. */
+#if defined(HAVE_STDIO_H) && defined(HAVE_MMAP) && !defined(__WIN32__) && !defined(__ANDROID__)
+#define SDL_RWOPS_MMAP_SUPPORTED 1
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#endif
+
 /* This file provides a general interface for SDL to read and write
    data sources.  It can easily be extended to files, memory, etc.
 */
 
 #include "SDL_endian.h"
+#include "SDL_hints.h"
 #include "SDL_rwops.h"
 
 #ifdef __APPLE__
@@ -522,6 +531,281 @@ mem_close(SDL_RWops * context)
     return 0;
 }
 
+#ifdef SDL_RWOPS_MMAP_SUPPORTED
+
+/* Functions to read memory-mapped files, reusing the memory functions */
+
+static int SDLCALL
+mapped_close(SDL_RWops * context)
+{
+    int status = 0;
+    if (context) {
+        const size_t length = (size_t)(context->hidden.mem.stop - context->hidden.mem.base);
+        if (munmap(context->hidden.mem.base, length) != 0) {
+            status = SDL_SetError("Couldn't unmap file");
+        }
+        SDL_FreeRW(context);
+    }
+    return status;
+}
+
+/* Returns a read-only stream over a mapping of the whole file, or NULL if
+   the file can't be mapped. The mapping stays valid after fp is closed. */
+static SDL_RWops *
+mapped_open(FILE *fp)
+{
+    SDL_RWops *rwops;
+    struct stat st;
+    void *base;
+
+    /* Empty files can't be mapped, and pipes and devices have no fixed size. */
+    if (fstat(fileno(fp), &st) < 0 || !S_ISREG(st.st_mode) ||
+        st.st_size <= 0 || (Uint64)st.st_size > SIZE_MAX) {
+        return NULL;
+    }
+
+    base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+#ifdef MADV_SEQUENTIAL
+    /* Assets are usually read front to back, so ask for aggressive read-ahead. */
+    madvise(base, (size_t)st.st_size, MADV_SEQUENTIAL);
+#endif
+
+    rwops = SDL_AllocRW();
+    if (rwops == NULL) {
+        munmap(base, (size_t)st.st_size);
+        return NULL;
+    }
+    rwops->size = mem_size;
+    rwops->seek = mem_seek;
+    rwops->read = mem_read;
+    rwops->write = mem_writeconst;
+    rwops->close = mapped_close;
+    rwops->hidden.mem.base = (Uint8 *) base;
+    rwops->hidden.mem.here = rwops->hidden.mem.base;
+    rwops->hidden.mem.stop = rwops->hidden.mem.base + st.st_size;
+    rwops->type = SDL_RWOPS_MAPPED;
+    return rwops;
+}
+
+#endif /* SDL_RWOPS_MMAP_SUPPORTED */
+
+/* Functions to buffer reads and writes of another SDL_RWops */
+
+#define RWBUFFER_DEFAULT_SIZE   4096
+
+typedef struct
+{
+    SDL_RWops *src;
+    int freesrc;
+    Uint8 *data;
+    size_t size;        /* Capacity of data. */
+    size_t pos;         /* Read position in data. */
+    size_t len;         /* Bytes read ahead into data, or written to it and not flushed yet. */
+    SDL_bool dirty;     /* SDL_TRUE if data holds pending writes instead of read-ahead. */
+    Sint64 offset;      /* Position of data[0] in src, or -1 if src can't tell. */
+} SDL_RWBuffer;
+
+/* Writes out pending data. The buffer is empty afterwards. */
+static int
+buffered_flush(SDL_RWBuffer *buffer)
+{
+    if (buffer->dirty) {
+        const size_t len = buffer->len;
+        const size_t written = len ? SDL_RWwrite(buffer->src, buffer->data, 1, len) : 0;
+        buffer->dirty = SDL_FALSE;
+        buffer->pos = buffer->len = 0;
+        if (written != len) {
+            buffer->offset = -1;
+            return -1;  /* SDL_RWwrite() set the error. */
+        }
+        /* Ask src, because writes to append streams land somewhere else. */
+        buffer->offset = SDL_RWseek(buffer->src, 0, RW_SEEK_CUR);
+    }
+    return 0;
+}
+
+/* Drops the read-ahead data, leaving src where the reader is. */
+static int
+buffered_unread(SDL_RWBuffer *buffer)
+{
+    if (!buffer->dirty && buffer->pos < buffer->len) {
+        const Sint64 unread = (Sint64)(buffer->len - buffer->pos);
+        buffer->pos = buffer->len = 0;
+        buffer->offset = SDL_RWseek(buffer->src, -unread, RW_SEEK_CUR);
+        if (buffer->offset < 0) {
+            return -1;
+        }
+    } else if (!buffer->dirty) {
+        if (buffer->offset >= 0) {
+            buffer->offset += buffer->len;
+        }
+        buffer->pos = buffer->len = 0;
+    }
+    return 0;
+}
+
+static Sint64 SDLCALL
+buffered_size(SDL_RWops * context)
+{
+    SDL_RWBuffer *buffer = (SDL_RWBuffer *) context->hidden.unknown.data1;
+    if (buffered_flush(buffer) < 0) {
+        return -1;
+    }
+    return SDL_RWsize(buffer->src);
+}
+
+static Sint64 SDLCALL
+buffered_seek(SDL_RWops * context, Sint64 offset, int whence)
+{
+    SDL_RWBuffer *buffer = (SDL_RWBuffer *) context->hidden.unknown.data1;
+    Sint64 position;
+
+    if (whence != RW_SEEK_SET && whence != RW_SEEK_CUR && whence != RW_SEEK_END) {
+        return SDL_SetError("Unknown value for 'whence'");
+    }
+
+    if (buffer->dirty) {
+        if (whence == RW_SEEK_CUR && offset == 0 && buffer->offset >= 0) {
+            return buffer->offset + buffer->len;
+        }
+        if (buffered_flush(buffer) < 0) {
+            return -1;
+        }
+    } else if (buffer->offset >= 0 && whence != RW_SEEK_END) {
+        /* Seeks within the read-ahead data don't need to touch src. */
+        const Sint64 target = (whence == RW_SEEK_SET) ? offset : buffer->offset + buffer->pos + offset;
+        if (target >= buffer->offset && target <= buffer->offset + (Sint64)buffer->len) {
+            buffer->pos = (size_t)(target - buffer->offset);
+            return target;
+        }
+    }
+
+    /* src is ahead of the reader by the unread data. */
+    if (whence == RW_SEEK_CUR) {
+        offset -= (Sint64)(buffer->len - buffer->pos);
+    }
+    buffer->pos = buffer->len = 0;
+
+    position = SDL_RWseek(buffer->src, offset, whence);
+    buffer->offset = position;
+    return position;
+}
+
+static size_t SDLCALL
+buffered_read(SDL_RWops * context, void *ptr, size_t size, size_t maxnum)
+{
+    SDL_RWBuffer *buffer = (SDL_RWBuffer *) context->hidden.unknown.data1;
+    Uint8 *dst = (Uint8 *) ptr;
+    size_t total_bytes, left;
+
+    total_bytes = (maxnum * size);
+    if ((maxnum <= 0) || (size <= 0)
+        || ((total_bytes / maxnum) != size)) {
+        return 0;
+    }
+
+    if (buffered_flush(buffer) < 0) {
+        return 0;
+    }
+
+    left = total_bytes;
+    while (left > 0) {
+        size_t got = buffer->len - buffer->pos;
+
+        if (got > 0) {
+            if (got > left) {
+                got = left;
+            }
+            SDL_memcpy(dst, buffer->data + buffer->pos, got);
+            buffer->pos += got;
+        } else {
+            if (buffer->offset >= 0) {
+                buffer->offset += buffer->len;
+            }
+            buffer->pos = buffer->len = 0;
+
+            if (left >= buffer->size) {
+                /* Big reads go straight to the destination. */
+                got = SDL_RWread(buffer->src, dst, 1, left);
+                if (buffer->offset >= 0) {
+                    buffer->offset += got;
+                }
+            } else {
+                buffer->len = SDL_RWread(buffer->src, buffer->data, 1, buffer->size);
+                got = SDL_min(left, buffer->len);
+                SDL_memcpy(dst, buffer->data, got);
+                buffer->pos = got;
+            }
+            if (got == 0) {
+                break;
+            }
+        }
+        dst += got;
+        left -= got;
+    }
+
+    return (total_bytes - left) / size;
+}
+
+static size_t SDLCALL
+buffered_write(SDL_RWops * context, const void *ptr, size_t size, size_t num)
+{
+    SDL_RWBuffer *buffer = (SDL_RWBuffer *) context->hidden.unknown.data1;
+    const size_t total_bytes = size * num;
+
+    if ((num <= 0) || (size <= 0) || ((total_bytes / num) != size)) {
+        return 0;
+    }
+
+    if (!buffer->dirty && buffered_unread(buffer) < 0) {
+        return 0;
+    }
+
+    if (buffer->len + total_bytes > buffer->size) {
+        if (buffered_flush(buffer) < 0) {
+            return 0;
+        }
+        if (total_bytes >= buffer->size) {
+            /* Big writes go straight to src. */
+            const size_t written = SDL_RWwrite(buffer->src, ptr, 1, total_bytes);
+            buffer->offset = SDL_RWseek(buffer->src, 0, RW_SEEK_CUR);
+            return written / size;
+        }
+    }
+
+    SDL_memcpy(buffer->data + buffer->len, ptr, total_bytes);
+    buffer->len += total_bytes;
+    buffer->dirty = SDL_TRUE;
+    return num;
+}
+
+static int SDLCALL
+buffered_close(SDL_RWops * context)
+{
+    int status = 0;
+    if (context) {
+        SDL_RWBuffer *buffer = (SDL_RWBuffer *) context->hidden.unknown.data1;
+        if (buffered_flush(buffer) < 0) {
+            status = -1;
+        }
+        if (buffer->freesrc) {
+            if (SDL_RWclose(buffer->src) < 0) {
+                status = -1;
+            }
+        } else {
+            /* Leave src where the reader stopped. */
+            buffered_unread(buffer);
+        }
+        SDL_free(buffer->data);
+        SDL_free(buffer);
+        SDL_FreeRW(context);
+    }
+    return status;
+}
+
 
 /* Functions to create SDL_RWops structures from various data sources */
 
@@ -592,17 +876,56 @@ SDL_RWFromFile(const char *file, const char *mode)
 
 #elif HAVE_STDIO_H
     {
+        FILE *fp;
+#ifdef SDL_RWOPS_MMAP_SUPPORTED
+        /* 'm' asks for a mapping; take it out of the mode passed to fopen(). */
+        char stdiomode[8];
+        SDL_bool map = SDL_FALSE;
+        size_t i, len = 0;
+
+        if (SDL_strchr(mode, 'm') != NULL) {
+            map = SDL_TRUE;
+            for (i = 0; mode[i]; i++) {
+                if (mode[i] == 'm') {
+                    continue;
+                } else if (len == sizeof (stdiomode) - 1) {
+                    SDL_SetError("Unsupported file mode \"%s\"", mode);
+                    return NULL;
+                }
+                stdiomode[len++] = mode[i];
+            }
+            stdiomode[len] = '\0';
+            mode = stdiomode;
+        }
+
+        if (*mode != 'r' || SDL_strchr(mode, '+') != NULL) {
+            map = SDL_FALSE;  /* Only read-only files are mapped. */
+        } else if (!map) {
+            map = SDL_GetHintBoolean(SDL_HINT_RWOPS_MMAP, SDL_FALSE);
+        }
+#endif /* SDL_RWOPS_MMAP_SUPPORTED */
+
         #ifdef __APPLE__
-        FILE *fp = SDL_OpenFPFromBundleOrFallback(file, mode);
+        fp = SDL_OpenFPFromBundleOrFallback(file, mode);
         #elif __WINRT__
-        FILE *fp = NULL;
+        fp = NULL;
         fopen_s(&fp, file, mode);
         #else
-        FILE *fp = fopen(file, mode);
+        fp = fopen(file, mode);
         #endif
         if (fp == NULL) {
             SDL_SetError("Couldn't open %s", file);
         } else {
+#ifdef SDL_RWOPS_MMAP_SUPPORTED
+            /* Fall back to stdio if the file can't be mapped. */
+            if (map) {
+                rwops = mapped_open(fp);
+            }
+            if (rwops != NULL) {
+                fclose(fp);
+                return rwops;
+            }
+#endif
             rwops = SDL_RWFromFP(fp, SDL_TRUE);
         }
     }
@@ -717,6 +1040,55 @@ SDL_FreeRW(SDL_RWops * area)
     SDL_free(area);
 }
 
+SDL_RWops *
+SDL_CreateBufferedRW(SDL_RWops * src, size_t buffersize, int freesrc)
+{
+    SDL_RWops *rwops = NULL;
+    SDL_RWBuffer *buffer;
+
+    if (!src) {
+        SDL_InvalidParamError("src");
+        return NULL;
+    }
+
+    if (buffersize == 0) {
+        buffersize = RWBUFFER_DEFAULT_SIZE;
+    }
+
+    buffer = (SDL_RWBuffer *) SDL_calloc(1, sizeof (*buffer));
+    if (buffer) {
+        buffer->data = (Uint8 *) SDL_malloc(buffersize);
+        rwops = SDL_AllocRW();
+    }
+    if (!buffer || !buffer->data || !rwops) {
+        if (buffer) {
+            SDL_free(buffer->data);
+            SDL_free(buffer);
+        }
+        SDL_FreeRW(rwops);
+        if (freesrc) {
+            SDL_RWclose(src);
+        }
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    buffer->src = src;
+    buffer->freesrc = freesrc;
+    buffer->size = buffersize;
+    buffer->offset = SDL_RWseek(src, 0, RW_SEEK_CUR);
+
+    rwops->size = buffered_size;
+    rwops->seek = buffered_seek;
+    rwops->read = buffered_read;
+    rwops->write = buffered_write;
+    rwops->close = buffered_close;
+    rwops->hidden.unknown.data1 = buffer;
+    rwops->hidden.unknown.data2 = NULL;
+    rwops->type = SDL_RWOPS_BUFFERED;
+    return rwops;
+}
+
 /* Load all the data from an SDL data stream */
 void *
 SDL_LoadFile_RW(SDL_RWops * src, size_t *datasize, int freesrc)
@@ -731,6 +1103,23 @@ SDL_LoadFile_RW(SDL_RWops * src, size_t *datasize, int freesrc)
         return NULL;
     }
 
+    /* Memory and mapped files: copy the rest of the data in one go. */
+    if (SDL_RWGetMemory(src, NULL) != NULL) {
+        size_total = (size_t)(src->hidden.mem.stop - src->hidden.mem.here);
+        data = SDL_malloc(size_total + 1);
+        if (!data) {
+            SDL_OutOfMemory();
+            goto done;
+        }
+        SDL_memcpy(data, src->hidden.mem.here, size_total);
+        src->hidden.mem.here = src->hidden.mem.stop;
+        if (datasize) {
+            *datasize = size_total;
+        }
+        ((char *)data)[size_total] = '\0';
+        goto done;
+    }
+
     size = SDL_RWsize(src);
     if (size < 0) {
         size = FILE_CHUNK_SIZE;
@@ -812,6 +1201,27 @@ SDL_RWclose(SDL_RWops *context)
     return context->close(context);
 }
 
+const void *
+SDL_RWGetMemory(SDL_RWops *context, size_t *size)
+{
+    if (!context) {
+        SDL_InvalidParamError("context");
+        return NULL;
+    }
+
+    switch (context->type) {
+    case SDL_RWOPS_MEMORY:
+    case SDL_RWOPS_MEMORY_RO:
+    case SDL_RWOPS_MAPPED:
+        if (size) {
+            *size = (size_t)(context->hidden.mem.stop - context->hidden.mem.base);
+        }
+        return context->hidden.mem.base;
+    default:
+        return NULL;
+    }
+}
+
 /* Functions for dynamically reading and writing endian-specific values */
 
 Uint8
@@ -24,6 +24,7 @@
 
 #include "SDL_hints.h"
 #include "SDL_render.h"
+#include "SDL_timer.h"
 #include "SDL_sysrender.h"
 #include "software/SDL_render_sw_c.h"
 #include "../video/SDL_pixels_c.h"
@@ -113,48 +114,53 @@ static const SDL_RenderDriver *render_drivers[] = {
 static char renderer_magic;
 static char texture_magic;
 
-static SDL_INLINE void
+static void
 DebugLogRenderCommands(const SDL_RenderCommand *cmd)
 {
-#if 0
     unsigned int i = 1;
-    SDL_Log("Render commands to flush:");
+
+    /* This is only for debugging, so it's off unless someone asks for it. */
+    if (SDL_LogGetPriority(SDL_LOG_CATEGORY_RENDER) > SDL_LOG_PRIORITY_VERBOSE) {
+        return;
+    }
+
+    SDL_LogVerbose(SDL_LOG_CATEGORY_RENDER, "Render commands to flush:");
     while (cmd) {
         switch (cmd->command) {
             case SDL_RENDERCMD_NO_OP:
-                SDL_Log(" %u. no-op", i++);
+                SDL_LogVerbose(SDL_LOG_CATEGORY_RENDER, " %u. no-op", i++);
                 break;
 
             case SDL_RENDERCMD_SETVIEWPORT:
-                SDL_Log(" %u. set viewport (first=%u, rect={(%d, %d), %dx%d})", i++,
+                SDL_LogVerbose(SDL_LOG_CATEGORY_RENDER, " %u. set viewport (first=%u, rect={(%d, %d), %dx%d})", i++,
                         (unsigned int) cmd->data.viewport.first,
                         cmd->data.viewport.rect.x, cmd->data.viewport.rect.y,
                         cmd->data.viewport.rect.w, cmd->data.viewport.rect.h);
                 break;
 
             case SDL_RENDERCMD_SETCLIPRECT:
-                SDL_Log(" %u. set cliprect (enabled=%s, rect={(%d, %d), %dx%d})", i++,
+                SDL_LogVerbose(SDL_LOG_CATEGORY_RENDER, " %u. set cliprect (enabled=%s, rect={(%d, %d), %dx%d})", i++,
                         cmd->data.cliprect.enabled ? "true" : "false",
                         cmd->data.cliprect.rect.x, cmd->data.cliprect.rect.y,
                         cmd->data.cliprect.rect.w, cmd->data.cliprect.rect.h);
                 break;
 
             case SDL_RENDERCMD_SETDRAWCOLOR:
-                SDL_Log(" %u. set draw color (first=%u, r=%d, g=%d, b=%d, a=%d)", i++,
+                SDL_LogVerbose(SDL_LOG_CATEGORY_RENDER, " %u. set draw color (first=%u, r=%d, g=%d, b=%d, a=%d)", i++,
                         (unsigned int) cmd->data.color.first,
                         (int) cmd->data.color.r, (int) cmd->data.color.g,
                         (int) cmd->data.color.b, (int) cmd->data.color.a);
                 break;
 
             case SDL_RENDERCMD_CLEAR:
-                SDL_Log(" %u. clear (first=%u, r=%d, g=%d, b=%d, a=%d)", i++,
+                SDL_LogVerbose(SDL_LOG_CATEGORY_RENDER, " %u. clear (first=%u, r=%d, g=%d, b=%d, a=%d)", i++,
                         (unsigned int) cmd->data.color.first,
                         (int) cmd->data.color.r, (int) cmd->data.color.g,
                         (int) cmd->data.color.b, (int) cmd->data.color.a);
                 break;
 
             case SDL_RENDERCMD_DRAW_POINTS:
-                SDL_Log(" %u. draw points (first=%u, count=%u, r=%d, g=%d, b=%d, a=%d, blend=%d)", i++,
+                SDL_LogVerbose(SDL_LOG_CATEGORY_RENDER, " %u. draw points (first=%u, count=%u, r=%d, g=%d, b=%d, a=%d, blend=%d)", i++,
                         (unsigned int) cmd->data.draw.first,
                         (unsigned int) cmd->data.draw.count,
                         (int) cmd->data.draw.r, (int) cmd->data.draw.g,
@@ -163,7 +169,7 @@ DebugLogRenderCommands(const SDL_RenderCommand *cmd)
                 break;
 
             case SDL_RENDERCMD_DRAW_LINES:
-                SDL_Log(" %u. draw lines (first=%u, count=%u, r=%d, g=%d, b=%d, a=%d, blend=%d)", i++,
+                SDL_LogVerbose(SDL_LOG_CATEGORY_RENDER, " %u. draw lines (first=%u, count=%u, r=%d, g=%d, b=%d, a=%d, blend=%d)", i++,
                         (unsigned int) cmd->data.draw.first,
                         (unsigned int) cmd->data.draw.count,
                         (int) cmd->data.draw.r, (int) cmd->data.draw.g,
@@ -172,7 +178,7 @@ DebugLogRenderCommands(const SDL_RenderCommand *cmd)
                 break;
 
             case SDL_RENDERCMD_FILL_RECTS:
-                SDL_Log(" %u. fill rects (first=%u, count=%u, r=%d, g=%d, b=%d, a=%d, blend=%d)", i++,
+                SDL_LogVerbose(SDL_LOG_CATEGORY_RENDER, " %u. fill rects (first=%u, count=%u, r=%d, g=%d, b=%d, a=%d, blend=%d)", i++,
                         (unsigned int) cmd->data.draw.first,
                         (unsigned int) cmd->data.draw.count,
                         (int) cmd->data.draw.r, (int) cmd->data.draw.g,
@@ -181,7 +187,7 @@ DebugLogRenderCommands(const SDL_RenderCommand *cmd)
                 break;
 
             case SDL_RENDERCMD_COPY:
-                SDL_Log(" %u. copy (first=%u, count=%u, r=%d, g=%d, b=%d, a=%d, blend=%d, tex=%p)", i++,
+                SDL_LogVerbose(SDL_LOG_CATEGORY_RENDER, " %u. copy (first=%u, count=%u, r=%d, g=%d, b=%d, a=%d, blend=%d, tex=%p)", i++,
                         (unsigned int) cmd->data.draw.first,
                         (unsigned int) cmd->data.draw.count,
                         (int) cmd->data.draw.r, (int) cmd->data.draw.g,
@@ -191,7 +197,16 @@ DebugLogRenderCommands(const SDL_RenderCommand *cmd)
 
 
             case SDL_RENDERCMD_COPY_EX:
-                SDL_Log(" %u. copyex (first=%u, count=%u, r=%d, g=%d, b=%d, a=%d, blend=%d, tex=%p)", i++,
+                SDL_LogVerbose(SDL_LOG_CATEGORY_RENDER, " %u. copyex (first=%u, count=%u, r=%d, g=%d, b=%d, a=%d, blend=%d, tex=%p)", i++,
+                        (unsigned int) cmd->data.draw.first,
+                        (unsigned int) cmd->data.draw.count,
+                        (int) cmd->data.draw.r, (int) cmd->data.draw.g,
+                        (int) cmd->data.draw.b, (int) cmd->data.draw.a,
+                        (int) cmd->data.draw.blend, cmd->data.draw.texture);
+                break;
+
+            case SDL_RENDERCMD_GEOMETRY:
+                SDL_LogVerbose(SDL_LOG_CATEGORY_RENDER, " %u. geometry (first=%u, count=%u, r=%d, g=%d, b=%d, a=%d, blend=%d, tex=%p)", i++,
                         (unsigned int) cmd->data.draw.first,
                         (unsigned int) cmd->data.draw.count,
                         (int) cmd->data.draw.r, (int) cmd->data.draw.g,
@@ -201,12 +216,84 @@ DebugLogRenderCommands(const SDL_RenderCommand *cmd)
         }
         cmd = cmd->next;
     }
-#endif
+}
+
+static void
+CountRenderCommands(SDL_Renderer *renderer, const SDL_RenderCommand *cmd)
+{
+    SDL_RenderStats *stats = &renderer->stats;
+
+    while (cmd) {
+        switch (cmd->command) {
+            case SDL_RENDERCMD_SETVIEWPORT:
+                stats->viewport_changes++;
+                break;
+
+            case SDL_RENDERCMD_SETCLIPRECT:
+                stats->cliprect_changes++;
+                break;
+
+            case SDL_RENDERCMD_SETDRAWCOLOR:
+                stats->color_changes++;
+                break;
+
+            case SDL_RENDERCMD_CLEAR:
+                stats->clear_commands++;
+                stats->draw_calls++;
+                break;
+
+            case SDL_RENDERCMD_DRAW_POINTS:
+                stats->point_commands++;
+                stats->draw_calls++;
+                break;
+
+            case SDL_RENDERCMD_DRAW_LINES:
+                stats->line_commands++;
+                stats->draw_calls++;
+                break;
+
+            case SDL_RENDERCMD_FILL_RECTS:
+                stats->fill_rect_commands++;
+                stats->draw_calls++;
+                break;
+
+            case SDL_RENDERCMD_COPY:
+                stats->copy_commands++;
+                /* only a merged copy's count is copies; PSP, for one, queues a copy's slices there. */
+                stats->copies += renderer->merge_copies ? (Uint32) cmd->data.draw.count : 1;
+                stats->draw_calls++;
+                break;
+
+            case SDL_RENDERCMD_COPY_EX:
+                stats->copy_ex_commands++;
+                stats->copies++;
+                stats->draw_calls++;
+                break;
+
+            case SDL_RENDERCMD_GEOMETRY:
+                stats->geometry_commands++;
+                stats->draw_calls++;
+                break;
+
+            case SDL_RENDERCMD_NO_OP:
+                break;
+        }
+        cmd = cmd->next;
+    }
+}
+
+static void
+CountTextureUpdate(SDL_Texture *texture, const size_t numbytes)
+{
+    SDL_RenderStats *stats = &texture->renderer->stats;
+    stats->texture_updates++;
+    stats->texture_update_bytes += numbytes;
 }
 
 static int
 FlushRenderCommands(SDL_Renderer *renderer)
 {
+    Uint64 start;
     int retval;
 
     SDL_assert((renderer->render_commands == NULL) == (renderer->render_commands_tail == NULL));
@@ -217,8 +304,16 @@ FlushRenderCommands(SDL_Renderer *renderer)
     }
 
     DebugLogRenderCommands(renderer->render_commands);
+    CountRenderCommands(renderer, renderer->render_commands);
 
+    renderer->stats.flushes++;
+    if (renderer->vertex_data_used > renderer->stats.vertex_bytes_peak) {
+        renderer->stats.vertex_bytes_peak = (Uint32) SDL_min(renderer->vertex_data_used, 0xFFFFFFFF);
+    }
+
+    start = SDL_GetPerformanceCounter();
     retval = renderer->RunCommandQueue(renderer, renderer->render_commands, renderer->vertex_data, renderer->vertex_data_used);
+    renderer->stats.execution_time += SDL_GetPerformanceCounter() - start;
 
     /* Move the whole render command queue to the unused pool so we can reuse them next time. */
     if (renderer->render_commands_tail != NULL) {
@@ -241,6 +336,7 @@ FlushRenderCommandsIfTextureNeeded(SDL_Texture *texture)
     SDL_Renderer *renderer = texture->renderer;
     if (texture->last_command_generation == renderer->render_command_generation) {
         /* the current command queue depends on this texture, flush the queue now before it changes */
+        renderer->stats.texture_flushes++;
         return FlushRenderCommands(renderer);
     }
     return 0;
@@ -514,11 +610,55 @@ PrepQueueCmdDrawTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_
     return cmd;
 }
 
+/* Returns the last queued command if a copy of texture can be appended to it. */
+static SDL_RenderCommand *
+GetMergeableCopyCommand(SDL_Renderer *renderer, SDL_Texture * texture)
+{
+    SDL_RenderCommand *cmd = renderer->render_commands_tail;
+    if (!renderer->merge_copies || cmd == NULL || cmd->command != SDL_RENDERCMD_COPY) {
+        return NULL;
+    }
+    /* The scale mode belongs to the texture, so the same texture means the same scale mode. */
+    if (cmd->data.draw.texture != texture ||
+        cmd->data.draw.r != texture->r || cmd->data.draw.g != texture->g ||
+        cmd->data.draw.b != texture->b || cmd->data.draw.a != texture->a ||
+        cmd->data.draw.blend != texture->blendMode) {
+        return NULL;
+    }
+    return cmd;
+}
+
 static int
 QueueCmdCopy(SDL_Renderer *renderer, SDL_Texture * texture, const SDL_Rect * srcrect, const SDL_FRect * dstrect)
 {
-    SDL_RenderCommand *cmd = PrepQueueCmdDrawTexture(renderer, texture, SDL_RENDERCMD_COPY);
+    SDL_RenderCommand *cmd = GetMergeableCopyCommand(renderer, texture);
     int retval = -1;
+
+    if (cmd != NULL) {
+        /* Nothing has been queued since the last copy of this texture, so its
+           vertices end where the vertex buffer does. If the backend puts the
+           new quad straight after them, the two copies become one command. */
+        const size_t used = renderer->vertex_data_used;
+        SDL_RenderCommand merged;
+        SDL_memcpy(&merged, cmd, sizeof (merged));
+        retval = renderer->QueueCopy(renderer, &merged, texture, srcrect, dstrect);
+        if (retval < 0) {
+            return retval;
+        }
+        if (merged.data.draw.first == used) {
+            cmd->data.draw.count += merged.data.draw.count;
+            return 0;
+        }
+        cmd = AllocateRenderCommand(renderer);
+        if (cmd == NULL) {
+            return -1;
+        }
+        cmd->command = SDL_RENDERCMD_COPY;
+        SDL_memcpy(&cmd->data, &merged.data, sizeof (cmd->data));
+        return 0;
+    }
+
+    cmd = PrepQueueCmdDrawTexture(renderer, texture, SDL_RENDERCMD_COPY);
     if (cmd != NULL) {
         retval = renderer->QueueCopy(renderer, cmd, texture, srcrect, dstrect);
         if (retval < 0) {
@@ -545,6 +685,41 @@ QueueCmdCopyEx(SDL_Renderer *renderer, SDL_Texture * texture,
     return retval;
 }
 
+static int
+QueueCmdGeometry(SDL_Renderer *renderer, SDL_Texture * texture,
+                 const SDL_Vertex * vertices, int num_vertices,
+                 const int * indices, int num_indices,
+                 float scale_x, float scale_y)
+{
+    SDL_RenderCommand *cmd = NULL;
+    int retval = -1;
+    SDL_assert(renderer->QueueGeometry != NULL);  /* should have caught at higher level. */
+    if (texture) {
+        cmd = PrepQueueCmdDrawTexture(renderer, texture, SDL_RENDERCMD_GEOMETRY);
+    } else if (PrepQueueCmdDraw(renderer, 0xFF, 0xFF, 0xFF, 0xFF) == 0) {
+        /* untextured geometry is colored by its vertices alone. */
+        cmd = AllocateRenderCommand(renderer);
+        if (cmd != NULL) {
+            cmd->command = SDL_RENDERCMD_GEOMETRY;
+            cmd->data.draw.first = 0;  /* render backend will fill this in. */
+            cmd->data.draw.count = 0;  /* render backend will fill this in. */
+            cmd->data.draw.r = 0xFF;
+            cmd->data.draw.g = 0xFF;
+            cmd->data.draw.b = 0xFF;
+            cmd->data.draw.a = 0xFF;
+            cmd->data.draw.blend = renderer->blendMode;
+            cmd->data.draw.texture = NULL;  /* no texture. */
+        }
+    }
+    if (cmd != NULL) {
+        retval = renderer->QueueGeometry(renderer, cmd, texture, vertices, num_vertices, indices, num_indices, scale_x, scale_y);
+        if (retval < 0) {
+            cmd->command = SDL_RENDERCMD_NO_OP;
+        }
+    }
+    return retval;
+}
+
 
 static int UpdateLogicalSize(SDL_Renderer *renderer);
 
@@ -1574,6 +1749,7 @@ SDL_UpdateTexture(SDL_Texture * texture, const SDL_Rect * rect,
         if (FlushRenderCommandsIfTextureNeeded(texture) < 0) {
             return -1;
         }
+        CountTextureUpdate(texture, (size_t) real_rect.w * real_rect.h * SDL_BYTESPERPIXEL(texture->format));
         return renderer->UpdateTexture(renderer, texture, &real_rect, pixels, pitch);
     }
 }
@@ -1742,6 +1918,8 @@ int SDL_UpdateYUVTexture(SDL_Texture * texture, const SDL_Rect * rect,
             if (FlushRenderCommandsIfTextureNeeded(texture) < 0) {
                 return -1;
             }
+            CountTextureUpdate(texture, (size_t) real_rect.w * real_rect.h +
+                                        (size_t) 2 * ((real_rect.w + 1) / 2) * ((real_rect.h + 1) / 2));
             return renderer->UpdateTextureYUV(renderer, texture, &real_rect, Yplane, Ypitch, Uplane, Upitch, Vplane, Vpitch);
         } else {
             return SDL_Unsupported();
@@ -1802,6 +1980,8 @@ int SDL_UpdateNVTexture(SDL_Texture * texture, const SDL_Rect * rect,
             if (FlushRenderCommandsIfTextureNeeded(texture) < 0) {
                 return -1;
             }
+            CountTextureUpdate(texture, (size_t) real_rect.w * real_rect.h +
+                                        (size_t) 2 * ((real_rect.w + 1) / 2) * ((real_rect.h + 1) / 2));
             return renderer->UpdateTextureNV(renderer, texture, &real_rect, Yplane, Ypitch, UVplane, UVpitch);
         } else {
             return SDL_Unsupported();
@@ -1871,6 +2051,7 @@ SDL_LockTexture(SDL_Texture * texture, const SDL_Rect * rect,
         if (FlushRenderCommandsIfTextureNeeded(texture) < 0) {
             return -1;
         }
+        texture->locked_rect = *rect;  /* for the render stats on unlock. */
         return renderer->LockTexture(renderer, texture, rect, pixels, pitch);
     }
 }
@@ -1972,6 +2153,8 @@ SDL_UnlockTexture(SDL_Texture * texture)
         SDL_UnlockTextureNative(texture);
     } else {
         SDL_Renderer *renderer = texture->renderer;
+        const SDL_Rect *rect = &texture->locked_rect;
+        CountTextureUpdate(texture, (size_t) rect->w * rect->h * SDL_BYTESPERPIXEL(texture->format));
         renderer->UnlockTexture(renderer, texture);
     }
 
@@ -3223,6 +3406,74 @@ SDL_RenderCopyExF(SDL_Renderer * renderer, SDL_Texture * texture,
     return retval < 0 ? retval : FlushRenderCommandsIfNotBatching(renderer);
 }
 
+int
+SDL_RenderGeometry(SDL_Renderer * renderer, SDL_Texture * texture,
+                   const SDL_Vertex * vertices, int num_vertices,
+                   const int * indices, int num_indices)
+{
+    int i;
+    int count;
+    int retval;
+
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    if (texture) {
+        CHECK_TEXTURE_MAGIC(texture, -1);
+
+        if (renderer != texture->renderer) {
+            return SDL_SetError("Texture was not created with this renderer");
+        }
+    }
+
+    if (!vertices) {
+        return SDL_InvalidParamError("vertices");
+    }
+    if (num_vertices < 0) {
+        return SDL_InvalidParamError("num_vertices");
+    }
+    if (indices) {
+        if (num_indices < 0 || (num_indices % 3) != 0) {
+            return SDL_InvalidParamError("num_indices");
+        }
+        for (i = 0; i < num_indices; ++i) {
+            if (indices[i] < 0 || indices[i] >= num_vertices) {
+                return SDL_SetError("The index %d is out of range [0, %d)", indices[i], num_vertices);
+            }
+        }
+        count = num_indices;
+    } else {
+        if ((num_vertices % 3) != 0) {
+            return SDL_InvalidParamError("num_vertices");
+        }
+        count = num_vertices;
+    }
+
+    if (!renderer->QueueGeometry) {
+        return SDL_SetError("Renderer does not support RenderGeometry");
+    }
+
+    /* Don't draw while we're hidden */
+    if (renderer->hidden) {
+        return 0;
+    }
+
+    if (count == 0) {
+        return 0;
+    }
+
+    if (texture) {
+        if (texture->native) {
+            texture = texture->native;
+        }
+        texture->last_command_generation = renderer->render_command_generation;
+    }
+
+    retval = QueueCmdGeometry(renderer, texture, vertices, num_vertices,
+                              indices, indices ? num_indices : 0,
+                              renderer->scale.x, renderer->scale.y);
+    return retval < 0 ? retval : FlushRenderCommandsIfNotBatching(renderer);
+}
+
 int
 SDL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                      Uint32 format, void * pixels, int pitch)
@@ -3269,6 +3520,10 @@ SDL_RenderPresent(SDL_Renderer * renderer)
 
     FlushRenderCommands(renderer);  /* time to send everything to the GPU! */
 
+    /* This frame is done, start counting the next one. */
+    SDL_memcpy(&renderer->last_stats, &renderer->stats, sizeof (SDL_RenderStats));
+    SDL_zero(renderer->stats);
+
     /* Don't present while we're hidden */
     if (renderer->hidden) {
         return;
@@ -3276,6 +3531,18 @@ SDL_RenderPresent(SDL_Renderer * renderer)
     renderer->RenderPresent(renderer);
 }
 
+int
+SDL_RenderGetStats(SDL_Renderer * renderer, SDL_RenderStats * stats)
+{
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+    SDL_memcpy(stats, &renderer->last_stats, sizeof (SDL_RenderStats));
+    return 0;
+}
+
 void
 SDL_DestroyTexture(SDL_Texture * texture)
 {
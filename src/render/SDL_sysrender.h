@@ -74,7 +74,8 @@ typedef enum
     SDL_RENDERCMD_DRAW_LINES,
     SDL_RENDERCMD_FILL_RECTS,
     SDL_RENDERCMD_COPY,
-    SDL_RENDERCMD_COPY_EX
+    SDL_RENDERCMD_COPY_EX,
+    SDL_RENDERCMD_GEOMETRY
 } SDL_RenderCommandType;
 
 typedef struct SDL_RenderCommand
@@ -127,6 +128,9 @@ struct SDL_Renderer
     int (*QueueCopyEx) (SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
                         const SDL_Rect * srcquad, const SDL_FRect * dstrect,
                         const double angle, const SDL_FPoint *center, const SDL_RendererFlip flip);
+    int (*QueueGeometry) (SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                          const SDL_Vertex * vertices, int num_vertices,
+                          const int * indices, int num_indices, float scale_x, float scale_y);
     int (*RunCommandQueue) (SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize);
     int (*UpdateTexture) (SDL_Renderer * renderer, SDL_Texture * texture,
                           const SDL_Rect * rect, const void *pixels,
@@ -212,6 +216,7 @@ struct SDL_Renderer
 
     SDL_bool always_batch;
     SDL_bool batching;
+    SDL_bool merge_copies;  /**< backend draws a SDL_RENDERCMD_COPY of count quads, laid out back to back */
     SDL_RenderCommand *render_commands;
     SDL_RenderCommand *render_commands_tail;
     SDL_RenderCommand *render_commands_pool;
@@ -228,6 +233,9 @@ struct SDL_Renderer
     size_t vertex_data_used;
     size_t vertex_data_allocation;
 
+    SDL_RenderStats stats;              /**< Counters for the frame being rendered */
+    SDL_RenderStats last_stats;         /**< Counters for the last presented frame */
+
     void *driverdata;
 };
 
@@ -1430,6 +1430,8 @@ D3D_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *verti
                 break;
             }
 
+            case SDL_RENDERCMD_GEOMETRY:  /* not supported by this renderer. */
+
             case SDL_RENDERCMD_NO_OP:
                 break;
         }
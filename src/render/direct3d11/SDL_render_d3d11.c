@@ -2345,6 +2345,8 @@ D3D11_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *ver
                 break;
             }
 
+            case SDL_RENDERCMD_GEOMETRY:  /* not supported by this renderer. */
+
             case SDL_RENDERCMD_NO_OP:
                 break;
         }
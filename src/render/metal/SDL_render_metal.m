@@ -1532,6 +1532,8 @@ METAL_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *ver
                 break;
             }
 
+            case SDL_RENDERCMD_GEOMETRY:  /* not supported by this renderer. */
+
             case SDL_RENDERCMD_NO_OP:
                 break;
         }
@@ -1318,24 +1318,28 @@ GL_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
 
             case SDL_RENDERCMD_COPY: {
                 const GLfloat *verts = (GLfloat *) (((Uint8 *) vertices) + cmd->data.draw.first);
-                const GLfloat minx = verts[0];
-                const GLfloat miny = verts[1];
-                const GLfloat maxx = verts[2];
-                const GLfloat maxy = verts[3];
-                const GLfloat minu = verts[4];
-                const GLfloat maxu = verts[5];
-                const GLfloat minv = verts[6];
-                const GLfloat maxv = verts[7];
+                const size_t count = cmd->data.draw.count;
                 SetCopyState(data, cmd);
-                data->glBegin(GL_TRIANGLE_STRIP);
-                data->glTexCoord2f(minu, minv);
-                data->glVertex2f(minx, miny);
-                data->glTexCoord2f(maxu, minv);
-                data->glVertex2f(maxx, miny);
-                data->glTexCoord2f(minu, maxv);
-                data->glVertex2f(minx, maxy);
-                data->glTexCoord2f(maxu, maxv);
-                data->glVertex2f(maxx, maxy);
+                /* copies of the same texture queued back to back are drawn in one pass. */
+                data->glBegin(GL_QUADS);
+                for (i = 0; i < count; i++, verts += 8) {
+                    const GLfloat minx = verts[0];
+                    const GLfloat miny = verts[1];
+                    const GLfloat maxx = verts[2];
+                    const GLfloat maxy = verts[3];
+                    const GLfloat minu = verts[4];
+                    const GLfloat maxu = verts[5];
+                    const GLfloat minv = verts[6];
+                    const GLfloat maxv = verts[7];
+                    data->glTexCoord2f(minu, minv);
+                    data->glVertex2f(minx, miny);
+                    data->glTexCoord2f(maxu, minv);
+                    data->glVertex2f(maxx, miny);
+                    data->glTexCoord2f(maxu, maxv);
+                    data->glVertex2f(maxx, maxy);
+                    data->glTexCoord2f(minu, maxv);
+                    data->glVertex2f(minx, maxy);
+                }
                 data->glEnd();
                 break;
             }
@@ -1373,6 +1377,8 @@ GL_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertic
                 break;
             }
 
+            case SDL_RENDERCMD_GEOMETRY:  /* not supported by this renderer. */
+
             case SDL_RENDERCMD_NO_OP:
                 break;
         }
@@ -1661,6 +1667,7 @@ GL_CreateRenderer(SDL_Window * window, Uint32 flags)
     renderer->DestroyRenderer = GL_DestroyRenderer;
     renderer->GL_BindTexture = GL_BindTexture;
     renderer->GL_UnbindTexture = GL_UnbindTexture;
+    renderer->merge_copies = SDL_TRUE;
     renderer->info = GL_RenderDriver.info;
     renderer->info.flags = SDL_RENDERER_ACCELERATED;
     renderer->driverdata = data;
@@ -988,6 +988,8 @@ GLES_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vert
                 break;
             }
 
+            case SDL_RENDERCMD_GEOMETRY:  /* not supported by this renderer. */
+
             case SDL_RENDERCMD_NO_OP:
                 break;
         }
@@ -93,6 +93,7 @@ typedef enum
     GLES2_ATTRIBUTE_TEXCOORD = 1,
     GLES2_ATTRIBUTE_ANGLE = 2,
     GLES2_ATTRIBUTE_CENTER = 3,
+    GLES2_ATTRIBUTE_COLOR = 4,
 } GLES2_Attribute;
 
 typedef enum
@@ -131,6 +132,7 @@ typedef struct
     SDL_Rect cliprect;
     SDL_bool texturing;
     SDL_bool is_copy_ex;
+    SDL_bool is_geometry;
     Uint32 color;
     Uint32 clear_color;
     int drawablew;
@@ -425,6 +427,7 @@ GLES2_CacheProgram(GLES2_RenderData *data, GLuint vertex, GLuint fragment)
     data->glBindAttribLocation(entry->id, GLES2_ATTRIBUTE_TEXCOORD, "a_texCoord");
     data->glBindAttribLocation(entry->id, GLES2_ATTRIBUTE_ANGLE, "a_angle");
     data->glBindAttribLocation(entry->id, GLES2_ATTRIBUTE_CENTER, "a_center");
+    data->glBindAttribLocation(entry->id, GLES2_ATTRIBUTE_COLOR, "a_color");
     data->glLinkProgram(entry->id);
     data->glGetProgramiv(entry->id, GL_LINK_STATUS, &linkSuccessful);
     if (!linkSuccessful) {
@@ -762,7 +765,7 @@ GLES2_QueueCopy(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * t
 {
     GLfloat minx, miny, maxx, maxy;
     GLfloat minu, maxu, minv, maxv;
-    GLfloat *verts = (GLfloat *) SDL_AllocateRenderVertices(renderer, 16 * sizeof (GLfloat), 0, &cmd->data.draw.first);
+    GLfloat *verts = (GLfloat *) SDL_AllocateRenderVertices(renderer, 24 * sizeof (GLfloat), 0, &cmd->data.draw.first);
 
     if (!verts) {
         return -1;
@@ -780,23 +783,33 @@ GLES2_QueueCopy(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * t
     minv = (GLfloat) srcrect->y / texture->h;
     maxv = (GLfloat) (srcrect->y + srcrect->h) / texture->h;
 
+    /* Two triangles of interleaved position and texture coordinates, so
+       copies queued back to back can be drawn with one call. */
     *(verts++) = minx;
     *(verts++) = miny;
+    *(verts++) = minu;
+    *(verts++) = minv;
     *(verts++) = maxx;
     *(verts++) = miny;
+    *(verts++) = maxu;
+    *(verts++) = minv;
     *(verts++) = minx;
     *(verts++) = maxy;
-    *(verts++) = maxx;
-    *(verts++) = maxy;
-
     *(verts++) = minu;
-    *(verts++) = minv;
+    *(verts++) = maxv;
+
+    *(verts++) = maxx;
+    *(verts++) = miny;
     *(verts++) = maxu;
     *(verts++) = minv;
-    *(verts++) = minu;
-    *(verts++) = maxv;
+    *(verts++) = maxx;
+    *(verts++) = maxy;
     *(verts++) = maxu;
     *(verts++) = maxv;
+    *(verts++) = minx;
+    *(verts++) = maxy;
+    *(verts++) = minu;
+    *(verts++) = maxv;
 
     return 0;
 }
@@ -883,11 +896,58 @@ GLES2_QueueCopyEx(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture *
     return 0;
 }
 
+static int
+GLES2_QueueGeometry(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                    const SDL_Vertex * vertices, int num_vertices,
+                    const int * indices, int num_indices, float scale_x, float scale_y)
+{
+    /* Positions, then texture coordinates if there is a texture, then colors. */
+    const SDL_bool colorswap = (renderer->target && (renderer->target->format == SDL_PIXELFORMAT_ARGB8888 || renderer->target->format == SDL_PIXELFORMAT_RGB888));
+    const int count = indices ? num_indices : num_vertices;
+    const size_t floats = count * (texture ? 4 : 2);
+    GLfloat *verts = (GLfloat *) SDL_AllocateRenderVertices(renderer, floats * sizeof (GLfloat) + count * sizeof (Uint32), 0, &cmd->data.draw.first);
+    GLfloat *texcoords;
+    Uint8 *colors;
+    int i;
+
+    if (!verts) {
+        return -1;
+    }
+
+    cmd->data.draw.count = count;
+
+    texcoords = verts + (count * 2);
+    colors = (Uint8 *) (verts + floats);
+
+    for (i = 0; i < count; i++) {
+        const SDL_Vertex *vertex = &vertices[indices ? indices[i] : i];
+
+        *(verts++) = vertex->position.x * scale_x;
+        *(verts++) = vertex->position.y * scale_y;
+
+        if (texture) {
+            *(texcoords++) = vertex->tex_coord.x;
+            *(texcoords++) = vertex->tex_coord.y;
+        }
+
+        *(colors++) = colorswap ? vertex->color.b : vertex->color.r;
+        *(colors++) = vertex->color.g;
+        *(colors++) = colorswap ? vertex->color.r : vertex->color.b;
+        *(colors++) = vertex->color.a;
+    }
+
+    return 0;
+}
+
 static int
 SetDrawState(GLES2_RenderData *data, const SDL_RenderCommand *cmd, const GLES2_ImageSource imgsrc)
 {
     const SDL_bool was_copy_ex = data->drawstate.is_copy_ex;
     const SDL_bool is_copy_ex = (cmd->command == SDL_RENDERCMD_COPY_EX);
+    const SDL_bool was_geometry = data->drawstate.is_geometry;
+    const SDL_bool is_geometry = (cmd->command == SDL_RENDERCMD_GEOMETRY);
+    const SDL_bool is_copy = (cmd->command == SDL_RENDERCMD_COPY);
+    const GLsizei stride = is_copy ? (GLsizei) (4 * sizeof (GLfloat)) : 0;
     SDL_Texture *texture = cmd->data.draw.texture;
     const SDL_BlendMode blend = cmd->data.draw.blend;
     GLES2_ProgramCacheEntry *program;
@@ -961,7 +1021,10 @@ SetDrawState(GLES2_RenderData *data, const SDL_RenderCommand *cmd, const GLES2_I
     }
 
     if (texture) {
-        data->glVertexAttribPointer(GLES2_ATTRIBUTE_TEXCOORD, 2, GL_FLOAT, GL_FALSE, 0, (const GLvoid *) (cmd->data.draw.first + (sizeof (GLfloat) * 8)));
+        /* copies interleave their texture coordinates, geometry has a position per
+           vertex before them, and rotated copies have four. */
+        const size_t offset = is_copy ? 2 : is_geometry ? (cmd->data.draw.count * 2) : 8;
+        data->glVertexAttribPointer(GLES2_ATTRIBUTE_TEXCOORD, 2, GL_FLOAT, GL_FALSE, stride, (const GLvoid *) (cmd->data.draw.first + (sizeof (GLfloat) * offset)));
     }
 
     if (GLES2_SelectProgram(data, imgsrc, texture ? texture->w : 0, texture ? texture->h : 0) < 0) {
@@ -1004,7 +1067,7 @@ SetDrawState(GLES2_RenderData *data, const SDL_RenderCommand *cmd, const GLES2_I
     }
 
     /* all drawing commands use this */
-    data->glVertexAttribPointer(GLES2_ATTRIBUTE_POSITION, 2, GL_FLOAT, GL_FALSE, 0, (const GLvoid *) cmd->data.draw.first);
+    data->glVertexAttribPointer(GLES2_ATTRIBUTE_POSITION, 2, GL_FLOAT, GL_FALSE, stride, (const GLvoid *) cmd->data.draw.first);
 
     if (is_copy_ex != was_copy_ex) {
         if (is_copy_ex) {
@@ -1022,6 +1085,21 @@ SetDrawState(GLES2_RenderData *data, const SDL_RenderCommand *cmd, const GLES2_I
         data->glVertexAttribPointer(GLES2_ATTRIBUTE_CENTER, 2, GL_FLOAT, GL_FALSE, 0, (const GLvoid *) (cmd->data.draw.first + (sizeof (GLfloat) * 24)));
     }
 
+    /* everything else is drawn with the constant white vertex color set up at creation. */
+    if (is_geometry != was_geometry) {
+        if (is_geometry) {
+            data->glEnableVertexAttribArray((GLenum) GLES2_ATTRIBUTE_COLOR);
+        } else {
+            data->glDisableVertexAttribArray((GLenum) GLES2_ATTRIBUTE_COLOR);
+        }
+        data->drawstate.is_geometry = is_geometry;
+    }
+
+    if (is_geometry) {
+        const size_t offset = cmd->data.draw.count * (texture ? 4 : 2);
+        data->glVertexAttribPointer(GLES2_ATTRIBUTE_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, (const GLvoid *) (cmd->data.draw.first + (sizeof (GLfloat) * offset)));
+    }
+
     return 0;
 }
 
@@ -1257,7 +1335,13 @@ GLES2_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *ver
                 break;
             }
 
-            case SDL_RENDERCMD_COPY:
+            case SDL_RENDERCMD_COPY: {
+                if (SetCopyState(renderer, cmd) == 0) {
+                    data->glDrawArrays(GL_TRIANGLES, 0, (GLsizei) (cmd->data.draw.count * 6));
+                }
+                break;
+            }
+
             case SDL_RENDERCMD_COPY_EX: {
                 if (SetCopyState(renderer, cmd) == 0) {
                     data->glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -1265,6 +1349,14 @@ GLES2_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *ver
                 break;
             }
 
+            case SDL_RENDERCMD_GEOMETRY: {
+                const int ret = cmd->data.draw.texture ? SetCopyState(renderer, cmd) : SetDrawState(data, cmd, GLES2_IMAGESOURCE_SOLID);
+                if (ret == 0) {
+                    data->glDrawArrays(GL_TRIANGLES, 0, (GLsizei) cmd->data.draw.count);
+                }
+                break;
+            }
+
             case SDL_RENDERCMD_NO_OP:
                 break;
         }
@@ -2059,6 +2151,7 @@ GLES2_CreateRenderer(SDL_Window *window, Uint32 flags)
     renderer->QueueFillRects      = GLES2_QueueFillRects;
     renderer->QueueCopy           = GLES2_QueueCopy;
     renderer->QueueCopyEx         = GLES2_QueueCopyEx;
+    renderer->QueueGeometry       = GLES2_QueueGeometry;
     renderer->RunCommandQueue     = GLES2_RunCommandQueue;
     renderer->RenderReadPixels    = GLES2_RenderReadPixels;
     renderer->RenderPresent       = GLES2_RenderPresent;
@@ -2066,6 +2159,7 @@ GLES2_CreateRenderer(SDL_Window *window, Uint32 flags)
     renderer->DestroyRenderer     = GLES2_DestroyRenderer;
     renderer->GL_BindTexture      = GLES2_BindTexture;
     renderer->GL_UnbindTexture    = GLES2_UnbindTexture;
+    renderer->merge_copies        = SDL_TRUE;
 
     renderer->info.texture_formats[renderer->info.num_texture_formats++] = SDL_PIXELFORMAT_YV12;
     renderer->info.texture_formats[renderer->info.num_texture_formats++] = SDL_PIXELFORMAT_IYUV;
@@ -2082,6 +2176,8 @@ GLES2_CreateRenderer(SDL_Window *window, Uint32 flags)
 
     data->glEnableVertexAttribArray(GLES2_ATTRIBUTE_POSITION);
     data->glDisableVertexAttribArray(GLES2_ATTRIBUTE_TEXCOORD);
+    data->glDisableVertexAttribArray(GLES2_ATTRIBUTE_COLOR);
+    data->glVertexAttrib4f(GLES2_ATTRIBUTE_COLOR, 1.0f, 1.0f, 1.0f, 1.0f);
 
     data->glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
 
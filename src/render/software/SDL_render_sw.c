@@ -25,6 +25,7 @@
 #include "../SDL_sysrender.h"
 #include "SDL_render_sw_c.h"
 #include "SDL_hints.h"
+#include "SDL_cpuinfo.h"
 
 #include "SDL_draw.h"
 #include "SDL_blendfillrect.h"
@@ -32,7 +33,8 @@
 #include "SDL_blendpoint.h"
 #include "SDL_drawline.h"
 #include "SDL_drawpoint.h"
-#include "SDL_rotate.h"
+#include "SDL_triangle.h"
+#include "../../thread/SDL_systhread.h"
 
 /* SDL surface based renderer implementation */
 
@@ -43,10 +45,63 @@ typedef struct
     SDL_bool surface_cliprect_dirty;
 } SW_DrawStateCache;
 
+/* With more than one thread (see SDL_HINT_RENDER_SOFTWARE_THREADS), runs of
+   commands that only touch the pixels they cover are binned into square
+   tiles of the target, and the tiles are drawn in parallel. Each command is
+   drawn with its clip rect narrowed to the tile, so every pixel gets the
+   same writes, in the same order, as it would on one thread. */
+#define SW_TILE_SIZE 64
+
+typedef struct SW_TileState SW_TileState;
+
+typedef struct
+{
+    const SDL_RenderCommand *cmd;
+    SDL_Rect clip;  /* the clip rect this command would run with on one thread */
+    SDL_Rect bounds;  /* the pixels this command can touch, inside clip */
+    int texture;  /* index into SW_TileState::textures, or -1 */
+} SW_TileCommand;
+
+typedef struct
+{
+    SW_TileState *tiles;
+    SDL_Surface *surface;  /* this worker's view of the target, kept until the target changes */
+    SDL_Surface **textures;  /* this worker's views of the textures, created as needed, part of SW_TileState::views */
+} SW_TileWorker;
+
+struct SW_TileState
+{
+    int num_workers;  /* worker 0 is the thread running the command queue */
+    SW_TileWorker *workers;
+    SDL_Thread **threads;
+    SDL_sem *work_sem;
+    SDL_sem *done_sem;
+    SDL_atomic_t quit;
+
+    void *vertices;
+    SW_TileCommand *commands;
+    int num_commands;
+    int max_commands;
+    SDL_Texture **textures;  /* every texture drawn so far, until it's destroyed */
+    SDL_Surface **views;  /* max_textures views for each worker, in one allocation */
+    int num_textures;
+    int max_textures;
+    int tiles_x;
+    int tiles_y;
+    int *bin_start;  /* tile t draws commands bins[bin_start[t]] to bins[bin_start[t+1]-1] */
+    int *bin_next;
+    int *bins;
+    int max_tiles;
+    int max_bins;
+    SDL_atomic_t next_tile;
+};
+
 typedef struct
 {
     SDL_Surface *surface;
     SDL_Surface *window;
+    int num_threads;
+    SW_TileState *tiles;
 } SW_RenderData;
 
 
@@ -293,451 +348,832 @@ SW_QueueCopy(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * text
     return 0;
 }
 
-typedef struct CopyExData
-{
-    SDL_Rect srcrect;
-    SDL_Rect dstrect;
-    double angle;
-    SDL_FPoint center;
-    SDL_RendererFlip flip;
-} CopyExData;
-
+/* Rotated and flipped copies are queued as the two triangles that cover the
+   destination rectangle, and get drawn straight into the target like geometry. */
 static int
 SW_QueueCopyEx(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
                const SDL_Rect * srcrect, const SDL_FRect * dstrect,
                const double angle, const SDL_FPoint *center, const SDL_RendererFlip flip)
 {
-    CopyExData *verts = (CopyExData *) SDL_AllocateRenderVertices(renderer, sizeof (CopyExData), 0, &cmd->data.draw.first);
+    static const int corners[6] = { 0, 1, 2, 1, 3, 2 };
+    SDL_TriangleVertex *verts = (SDL_TriangleVertex *) SDL_AllocateRenderVertices(renderer, 6 * sizeof (SDL_TriangleVertex), 0, &cmd->data.draw.first);
+    const double radians = angle * (M_PI / 180.0);
+    const float c = (float) SDL_cos(radians);
+    const float s = (float) SDL_sin(radians);
+    const float x = (float) (int) (renderer->viewport.x + dstrect->x);
+    const float y = (float) (int) (renderer->viewport.y + dstrect->y);
+    const float w = (float) (int) dstrect->w;
+    const float h = (float) (int) dstrect->h;
+    const float cx = x + center->x;
+    const float cy = y + center->y;
+    float u[2], v[2];
+    int i;
 
     if (!verts) {
         return -1;
     }
 
-    cmd->data.draw.count = 1;
+    cmd->data.draw.count = 6;
 
-    SDL_memcpy(&verts->srcrect, srcrect, sizeof (SDL_Rect));
+    u[0] = (float) srcrect->x;
+    u[1] = (float) (srcrect->x + srcrect->w);
+    v[0] = (float) srcrect->y;
+    v[1] = (float) (srcrect->y + srcrect->h);
+    if (flip & SDL_FLIP_HORIZONTAL) {
+        const float tmp = u[0];
+        u[0] = u[1];
+        u[1] = tmp;
+    }
+    if (flip & SDL_FLIP_VERTICAL) {
+        const float tmp = v[0];
+        v[0] = v[1];
+        v[1] = tmp;
+    }
 
-    if (renderer->viewport.x || renderer->viewport.y) {
-        verts->dstrect.x = (int)(renderer->viewport.x + dstrect->x);
-        verts->dstrect.y = (int)(renderer->viewport.y + dstrect->y);
-    } else {
-        verts->dstrect.x = (int)dstrect->x;
-        verts->dstrect.y = (int)dstrect->y;
+    /* Corners are numbered top left, top right, bottom left, bottom right. */
+    for (i = 0; i < 6; i++, verts++) {
+        const int corner = corners[i];
+        const float dx = ((corner & 1) ? (x + w) : x) - cx;
+        const float dy = ((corner & 2) ? (y + h) : y) - cy;
+        verts->x = cx + dx * c - dy * s;
+        verts->y = cy + dx * s + dy * c;
+        verts->u = u[corner & 1];
+        verts->v = v[corner >> 1];
+        verts->color.r = cmd->data.draw.r;
+        verts->color.g = cmd->data.draw.g;
+        verts->color.b = cmd->data.draw.b;
+        verts->color.a = cmd->data.draw.a;
     }
-    verts->dstrect.w = (int)dstrect->w;
-    verts->dstrect.h = (int)dstrect->h;
-    verts->angle = angle;
-    SDL_memcpy(&verts->center, center, sizeof (SDL_FPoint));
-    verts->flip = flip;
 
     return 0;
 }
 
 static int
-SW_RenderCopyEx(SDL_Renderer * renderer, SDL_Surface *surface, SDL_Texture * texture,
-                const SDL_Rect * srcrect, const SDL_Rect * final_rect,
-                const double angle, const SDL_FPoint * center, const SDL_RendererFlip flip)
-{
-    SDL_Surface *src = (SDL_Surface *) texture->driverdata;
-    SDL_Rect tmp_rect;
-    SDL_Surface *src_clone, *src_rotated, *src_scaled;
-    SDL_Surface *mask = NULL, *mask_rotated = NULL;
-    int retval = 0, dstwidth, dstheight, abscenterx, abscentery;
-    double cangle, sangle, px, py, p1x, p1y, p2x, p2y, p3x, p3y, p4x, p4y;
-    SDL_BlendMode blendmode;
-    Uint8 alphaMod, rMod, gMod, bMod;
-    int applyModulation = SDL_FALSE;
-    int blitRequired = SDL_FALSE;
-    int isOpaque = SDL_FALSE;
+SW_QueueGeometry(SDL_Renderer * renderer, SDL_RenderCommand *cmd, SDL_Texture * texture,
+                 const SDL_Vertex * vertices, int num_vertices,
+                 const int * indices, int num_indices, float scale_x, float scale_y)
+{
+    const int count = indices ? num_indices : num_vertices;
+    SDL_TriangleVertex *verts = (SDL_TriangleVertex *) SDL_AllocateRenderVertices(renderer, count * sizeof (SDL_TriangleVertex), 0, &cmd->data.draw.first);
+    const float x = (float) renderer->viewport.x;
+    const float y = (float) renderer->viewport.y;
+    const float w = texture ? (float) texture->w : 0.0f;
+    const float h = texture ? (float) texture->h : 0.0f;
+    const Uint8 r = cmd->data.draw.r;
+    const Uint8 g = cmd->data.draw.g;
+    const Uint8 b = cmd->data.draw.b;
+    const Uint8 a = cmd->data.draw.a;
+    int i;
 
-    if (!surface) {
+    if (!verts) {
         return -1;
     }
 
-    tmp_rect.x = 0;
-    tmp_rect.y = 0;
-    tmp_rect.w = final_rect->w;
-    tmp_rect.h = final_rect->h;
+    cmd->data.draw.count = count;
 
-    /* It is possible to encounter an RLE encoded surface here and locking it is
-     * necessary because this code is going to access the pixel buffer directly.
-     */
-    if (SDL_MUSTLOCK(src)) {
-        SDL_LockSurface(src);
+    /* Apply the texture's color and alpha mod to the vertex colors up front. */
+    for (i = 0; i < count; i++, verts++) {
+        const SDL_Vertex *vertex = &vertices[indices ? indices[i] : i];
+        verts->x = x + vertex->position.x * scale_x;
+        verts->y = y + vertex->position.y * scale_y;
+        verts->u = vertex->tex_coord.x * w;
+        verts->v = vertex->tex_coord.y * h;
+        verts->color.r = (Uint8) DRAW_MUL(vertex->color.r, r);
+        verts->color.g = (Uint8) DRAW_MUL(vertex->color.g, g);
+        verts->color.b = (Uint8) DRAW_MUL(vertex->color.b, b);
+        verts->color.a = (Uint8) DRAW_MUL(vertex->color.a, a);
     }
 
-    /* Clone the source surface but use its pixel buffer directly.
-     * The original source surface must be treated as read-only.
-     */
-    src_clone = SDL_CreateRGBSurfaceFrom(src->pixels, src->w, src->h, src->format->BitsPerPixel, src->pitch,
-                                         src->format->Rmask, src->format->Gmask,
-                                         src->format->Bmask, src->format->Amask);
-    if (src_clone == NULL) {
-        if (SDL_MUSTLOCK(src)) {
-            SDL_UnlockSurface(src);
-        }
-        return -1;
-    }
+    return 0;
+}
 
-    SDL_GetSurfaceBlendMode(src, &blendmode);
-    SDL_GetSurfaceAlphaMod(src, &alphaMod);
-    SDL_GetSurfaceColorMod(src, &rMod, &gMod, &bMod);
+static void
+PrepTextureForCopy(const SDL_RenderCommand *cmd, SDL_Surface *surface)
+{
+    const Uint8 r = cmd->data.draw.r;
+    const Uint8 g = cmd->data.draw.g;
+    const Uint8 b = cmd->data.draw.b;
+    const Uint8 a = cmd->data.draw.a;
+    const SDL_BlendMode blend = cmd->data.draw.blend;
+    const SDL_bool colormod = ((r & g & b) != 0xFF);
+    const SDL_bool alphamod = (a != 0xFF);
+    const SDL_bool blending = ((blend == SDL_BLENDMODE_ADD) || (blend == SDL_BLENDMODE_MOD) || (blend == SDL_BLENDMODE_MUL));
 
-    /* SDLgfx_rotateSurface only accepts 32-bit surfaces with a 8888 layout. Everything else has to be converted. */
-    if (src->format->BitsPerPixel != 32 || SDL_PIXELLAYOUT(src->format->format) != SDL_PACKEDLAYOUT_8888 || !src->format->Amask) {
-        blitRequired = SDL_TRUE;
+    if (colormod || alphamod || blending) {
+        SDL_SetSurfaceRLE(surface, 0);
     }
 
-    /* If scaling and cropping is necessary, it has to be taken care of before the rotation. */
-    if (!(srcrect->w == final_rect->w && srcrect->h == final_rect->h && srcrect->x == 0 && srcrect->y == 0)) {
-        blitRequired = SDL_TRUE;
+    /* !!! FIXME: we can probably avoid some of these calls. */
+    SDL_SetSurfaceColorMod(surface, r, g, b);
+    SDL_SetSurfaceAlphaMod(surface, a);
+    SDL_SetSurfaceBlendMode(surface, blend);
+}
+
+static void
+GetDrawStateClipRect(const SW_DrawStateCache *drawstate, SDL_Rect *rect)
+{
+    const SDL_Rect *viewport = drawstate->viewport;
+    const SDL_Rect *cliprect = drawstate->cliprect;
+    SDL_assert(viewport != NULL);  /* the higher level should have forced a SDL_RENDERCMD_SETVIEWPORT */
+
+    if (cliprect != NULL) {
+        rect->x = cliprect->x + viewport->x;
+        rect->y = cliprect->y + viewport->y;
+        rect->w = cliprect->w;
+        rect->h = cliprect->h;
+        SDL_IntersectRect(viewport, rect, rect);
+    } else {
+        *rect = *viewport;
     }
+}
 
-    /* srcrect is not selecting the whole src surface, so cropping is needed */
-    if (!(srcrect->w == src->w && srcrect->h == src->h && srcrect->x == 0 && srcrect->y == 0)) {
-        blitRequired = SDL_TRUE;
+static void
+SetDrawState(SDL_Surface *surface, SW_DrawStateCache *drawstate)
+{
+    if (drawstate->surface_cliprect_dirty) {
+        SDL_Rect clip_rect;
+        GetDrawStateClipRect(drawstate, &clip_rect);
+        SDL_SetClipRect(surface, &clip_rect);
+        drawstate->surface_cliprect_dirty = SDL_FALSE;
     }
+}
+
+/* Draws cmd into surface, inside the surface's current clip rect. src is the
+   surface to copy the command's texture from. */
+static void
+SW_DrawCommand(SDL_Renderer * renderer, SDL_Surface *surface, SDL_Surface *src, const SDL_RenderCommand *cmd, void *vertices)
+{
+    switch (cmd->command) {
+        case SDL_RENDERCMD_CLEAR: {
+            const Uint8 r = cmd->data.color.r;
+            const Uint8 g = cmd->data.color.g;
+            const Uint8 b = cmd->data.color.b;
+            const Uint8 a = cmd->data.color.a;
+            SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, r, g, b, a));
+            break;
+        }
 
-    /* The color and alpha modulation has to be applied before the rotation when using the NONE, MOD or MUL blend modes. */
-    if ((blendmode == SDL_BLENDMODE_NONE || blendmode == SDL_BLENDMODE_MOD || blendmode == SDL_BLENDMODE_MUL) && (alphaMod & rMod & gMod & bMod) != 255) {
-        applyModulation = SDL_TRUE;
-        SDL_SetSurfaceAlphaMod(src_clone, alphaMod);
-        SDL_SetSurfaceColorMod(src_clone, rMod, gMod, bMod);
+        case SDL_RENDERCMD_DRAW_POINTS: {
+            const Uint8 r = cmd->data.draw.r;
+            const Uint8 g = cmd->data.draw.g;
+            const Uint8 b = cmd->data.draw.b;
+            const Uint8 a = cmd->data.draw.a;
+            const int count = (int) cmd->data.draw.count;
+            const SDL_Point *verts = (SDL_Point *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            const SDL_BlendMode blend = cmd->data.draw.blend;
+            if (blend == SDL_BLENDMODE_NONE) {
+                SDL_DrawPoints(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
+            } else {
+                SDL_BlendPoints(surface, verts, count, blend, r, g, b, a);
+            }
+            break;
+        }
+
+        case SDL_RENDERCMD_DRAW_LINES: {
+            const Uint8 r = cmd->data.draw.r;
+            const Uint8 g = cmd->data.draw.g;
+            const Uint8 b = cmd->data.draw.b;
+            const Uint8 a = cmd->data.draw.a;
+            const int count = (int) cmd->data.draw.count;
+            const SDL_Point *verts = (SDL_Point *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            const SDL_BlendMode blend = cmd->data.draw.blend;
+            if (blend == SDL_BLENDMODE_NONE) {
+                SDL_DrawLines(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
+            } else {
+                SDL_BlendLines(surface, verts, count, blend, r, g, b, a);
+            }
+            break;
+        }
+
+        case SDL_RENDERCMD_FILL_RECTS: {
+            const Uint8 r = cmd->data.draw.r;
+            const Uint8 g = cmd->data.draw.g;
+            const Uint8 b = cmd->data.draw.b;
+            const Uint8 a = cmd->data.draw.a;
+            const int count = (int) cmd->data.draw.count;
+            const SDL_Rect *verts = (SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            const SDL_BlendMode blend = cmd->data.draw.blend;
+            if (blend == SDL_BLENDMODE_NONE) {
+                SDL_FillRects(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
+            } else {
+                SDL_BlendFillRects(surface, verts, count, blend, r, g, b, a);
+            }
+            break;
+        }
+
+        case SDL_RENDERCMD_COPY: {
+            const SDL_Rect *verts = (SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            const int count = (int) cmd->data.draw.count;
+            SDL_Texture *texture = cmd->data.draw.texture;
+            int i;
+
+            PrepTextureForCopy(cmd, src);
+
+            /* copies of the same texture queued back to back share this command. */
+            for (i = 0; i < count; i++, verts += 2) {
+                const SDL_Rect *srcrect = verts;
+                SDL_Rect dstrect = verts[1];  /* the blit clips this, and tiles share the vertices. */
+
+                if ( srcrect->w == dstrect.w && srcrect->h == dstrect.h ) {
+                    SDL_BlitSurface(src, srcrect, surface, &dstrect);
+                } else {
+                    /* If scaling is ever done, permanently disable RLE (which doesn't support scaling)
+                     * to avoid potentially frequent RLE encoding/decoding.
+                     */
+                    SDL_SetSurfaceRLE(surface, 0);
+                    SDL_PrivateUpperBlitScaled(src, srcrect, surface, &dstrect, texture->scaleMode);
+                }
+            }
+            break;
+        }
+
+        case SDL_RENDERCMD_COPY_EX:
+        case SDL_RENDERCMD_GEOMETRY: {
+            const SDL_TriangleVertex *verts = (SDL_TriangleVertex *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            SDL_Texture *texture = cmd->data.draw.texture;
+            /* The texture is only read, so this uses it directly rather than src. */
+            SDL_FillTriangles(surface, texture ? (SDL_Surface *) texture->driverdata : NULL,
+                              verts, (int) cmd->data.draw.count, cmd->data.draw.blend,
+                              texture ? texture->scaleMode : SDL_ScaleModeNearest);
+            break;
+        }
+
+        default:
+            break;
     }
+}
 
-    /* Opaque surfaces are much easier to handle with the NONE blend mode. */
-    if (blendmode == SDL_BLENDMODE_NONE && !src->format->Amask && alphaMod == 255) {
-        isOpaque = SDL_TRUE;
+static void
+SW_RunCommand(SDL_Renderer * renderer, SDL_Surface *surface, const SDL_RenderCommand *cmd, void *vertices, SW_DrawStateCache *drawstate)
+{
+    switch (cmd->command) {
+        case SDL_RENDERCMD_SETDRAWCOLOR: {
+            break;  /* Not used in this backend. */
+        }
+
+        case SDL_RENDERCMD_SETVIEWPORT: {
+            drawstate->viewport = &cmd->data.viewport.rect;
+            drawstate->surface_cliprect_dirty = SDL_TRUE;
+            break;
+        }
+
+        case SDL_RENDERCMD_SETCLIPRECT: {
+            drawstate->cliprect = cmd->data.cliprect.enabled ? &cmd->data.cliprect.rect : NULL;
+            drawstate->surface_cliprect_dirty = SDL_TRUE;
+            break;
+        }
+
+        case SDL_RENDERCMD_CLEAR: {
+            /* By definition the clear ignores the clip rect */
+            SDL_SetClipRect(surface, NULL);
+            SW_DrawCommand(renderer, surface, NULL, cmd, vertices);
+            drawstate->surface_cliprect_dirty = SDL_TRUE;
+            break;
+        }
+
+        case SDL_RENDERCMD_DRAW_POINTS:
+        case SDL_RENDERCMD_DRAW_LINES:
+        case SDL_RENDERCMD_FILL_RECTS:
+        case SDL_RENDERCMD_COPY:
+        case SDL_RENDERCMD_COPY_EX:
+        case SDL_RENDERCMD_GEOMETRY: {
+            SDL_Texture *texture = cmd->data.draw.texture;
+            SetDrawState(surface, drawstate);
+            SW_DrawCommand(renderer, surface, texture ? (SDL_Surface *) texture->driverdata : NULL, cmd, vertices);
+            break;
+        }
+
+        case SDL_RENDERCMD_NO_OP:
+            break;
     }
+}
 
-    /* The NONE blend mode requires a mask for non-opaque surfaces. This mask will be used
-     * to clear the pixels in the destination surface. The other steps are explained below.
-     */
-    if (blendmode == SDL_BLENDMODE_NONE && !isOpaque) {
-        mask = SDL_CreateRGBSurface(0, final_rect->w, final_rect->h, 32,
-                                    0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000);
-        if (mask == NULL) {
-            retval = -1;
-        } else {
-            SDL_SetSurfaceBlendMode(mask, SDL_BLENDMODE_MOD);
+/* Works out the clip rect cmd would be drawn with, and the part of it that
+   cmd can change. Returns 1 if cmd can be drawn tile by tile, 0 if it draws
+   nothing, and -1 if it has to be drawn in one piece. */
+static int
+SW_GetTileBounds(SDL_Surface *surface, const SW_DrawStateCache *drawstate, const SDL_RenderCommand *cmd, void *vertices, SDL_Rect *clip, SDL_Rect *bounds)
+{
+    SDL_Rect full, extent;
+    int i;
+
+    full.x = 0;
+    full.y = 0;
+    full.w = surface->w;
+    full.h = surface->h;
+
+    switch (cmd->command) {
+        case SDL_RENDERCMD_CLEAR: {
+            /* By definition the clear ignores the clip rect */
+            *clip = full;
+            *bounds = full;
+            return 1;
+        }
+
+        case SDL_RENDERCMD_DRAW_POINTS: {
+            const int count = (int) cmd->data.draw.count;
+            const SDL_Point *verts = (SDL_Point *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            int minx, miny, maxx, maxy;
+            if (count <= 0) {
+                return 0;
+            }
+            minx = maxx = verts[0].x;
+            miny = maxy = verts[0].y;
+            for (i = 1; i < count; i++) {
+                minx = SDL_min(minx, verts[i].x);
+                maxx = SDL_max(maxx, verts[i].x);
+                miny = SDL_min(miny, verts[i].y);
+                maxy = SDL_max(maxy, verts[i].y);
+            }
+            extent.x = minx;
+            extent.y = miny;
+            extent.w = maxx - minx + 1;
+            extent.h = maxy - miny + 1;
+            break;
         }
+
+        case SDL_RENDERCMD_FILL_RECTS: {
+            const int count = (int) cmd->data.draw.count;
+            const SDL_Rect *verts = (SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            if (count <= 0) {
+                return 0;
+            }
+            extent = verts[0];
+            for (i = 1; i < count; i++) {
+                SDL_UnionRect(&extent, &verts[i], &extent);
+            }
+            break;
+        }
+
+        case SDL_RENDERCMD_COPY: {
+            const int count = (int) cmd->data.draw.count;
+            const SDL_Rect *verts = (SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            const SDL_Surface *src = (SDL_Surface *) cmd->data.draw.texture->driverdata;
+            if (src == surface || SDL_MUSTLOCK(src) || src->format->palette) {
+                return -1;
+            }
+            if (count <= 0) {
+                return 0;
+            }
+            extent = verts[1];
+            for (i = 0; i < count; i++, verts += 2) {
+                /* Clipping a scaled blit changes how it rounds, so those stay in one piece. */
+                if (verts[0].w != verts[1].w || verts[0].h != verts[1].h) {
+                    return -1;
+                }
+                SDL_UnionRect(&extent, &verts[1], &extent);
+            }
+            break;
+        }
+
+        case SDL_RENDERCMD_COPY_EX:
+        case SDL_RENDERCMD_GEOMETRY: {
+            const SDL_TriangleVertex *verts = (SDL_TriangleVertex *) (((Uint8 *) vertices) + cmd->data.draw.first);
+            const SDL_Texture *texture = cmd->data.draw.texture;
+            /* Every tile reads the texture's pixels directly. */
+            if (texture) {
+                const SDL_Surface *src = (SDL_Surface *) texture->driverdata;
+                if (src == surface || SDL_MUSTLOCK(src)) {
+                    return -1;
+                }
+            }
+            if (!SDL_GetTrianglesBounds(verts, (int) cmd->data.draw.count, &extent)) {
+                return 0;
+            }
+            break;
+        }
+
+        default:
+            /* Clipping a line moves its end points, so lines stay in one piece. */
+            return -1;
     }
 
-    /* Create a new surface should there be a format mismatch or if scaling, cropping,
-     * or modulation is required. It's possible to use the source surface directly otherwise.
-     */
-    if (!retval && (blitRequired || applyModulation)) {
-        SDL_Rect scale_rect = tmp_rect;
-        src_scaled = SDL_CreateRGBSurface(0, final_rect->w, final_rect->h, 32,
-                                          0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000);
-        if (src_scaled == NULL) {
-            retval = -1;
-        } else {
-            SDL_SetSurfaceBlendMode(src_clone, SDL_BLENDMODE_NONE);
-            retval = SDL_PrivateUpperBlitScaled(src_clone, srcrect, src_scaled, &scale_rect, texture->scaleMode);
-            SDL_FreeSurface(src_clone);
-            src_clone = src_scaled;
-            src_scaled = NULL;
-        }
-    }
-
-    /* SDLgfx_rotateSurface is going to make decisions depending on the blend mode. */
-    SDL_SetSurfaceBlendMode(src_clone, blendmode);
-
-    if (!retval) {
-        SDLgfx_rotozoomSurfaceSizeTrig(tmp_rect.w, tmp_rect.h, angle, &dstwidth, &dstheight, &cangle, &sangle);
-        src_rotated = SDLgfx_rotateSurface(src_clone, angle, dstwidth/2, dstheight/2, (texture->scaleMode == SDL_ScaleModeNearest) ? 0 : 1, flip & SDL_FLIP_HORIZONTAL, flip & SDL_FLIP_VERTICAL, dstwidth, dstheight, cangle, sangle);
-        if (src_rotated == NULL) {
-            retval = -1;
-        }
-        if (!retval && mask != NULL) {
-            /* The mask needed for the NONE blend mode gets rotated with the same parameters. */
-            mask_rotated = SDLgfx_rotateSurface(mask, angle, dstwidth/2, dstheight/2, SDL_FALSE, 0, 0, dstwidth, dstheight, cangle, sangle);
-            if (mask_rotated == NULL) {
-                retval = -1;
+    GetDrawStateClipRect(drawstate, clip);
+    if (!SDL_IntersectRect(clip, &full, clip) || !SDL_IntersectRect(&extent, clip, bounds)) {
+        return 0;
+    }
+    return 1;
+}
+
+static int
+SW_AddTileCommand(SW_TileState *tiles, const SDL_RenderCommand *cmd, const SDL_Rect *clip, const SDL_Rect *bounds)
+{
+    SW_TileCommand *tc;
+    int texture = -1;
+    int i;
+
+    if (cmd->command == SDL_RENDERCMD_COPY) {
+        for (texture = 0; texture < tiles->num_textures; texture++) {
+            if (tiles->textures[texture] == cmd->data.draw.texture) {
+                break;
             }
         }
-        if (!retval) {
-            /* Find out where the new origin is by rotating the four final_rect points around the center and then taking the extremes */
-            abscenterx = final_rect->x + (int)center->x;
-            abscentery = final_rect->y + (int)center->y;
-            /* Compensate the angle inversion to match the behaviour of the other backends */
-            sangle = -sangle;
-
-            /* Top Left */
-            px = final_rect->x - abscenterx;
-            py = final_rect->y - abscentery;
-            p1x = px * cangle - py * sangle + abscenterx;
-            p1y = px * sangle + py * cangle + abscentery;
-
-            /* Top Right */
-            px = final_rect->x + final_rect->w - abscenterx;
-            py = final_rect->y - abscentery;
-            p2x = px * cangle - py * sangle + abscenterx;
-            p2y = px * sangle + py * cangle + abscentery;
-
-            /* Bottom Left */
-            px = final_rect->x - abscenterx;
-            py = final_rect->y + final_rect->h - abscentery;
-            p3x = px * cangle - py * sangle + abscenterx;
-            p3y = px * sangle + py * cangle + abscentery;
-
-            /* Bottom Right */
-            px = final_rect->x + final_rect->w - abscenterx;
-            py = final_rect->y + final_rect->h - abscentery;
-            p4x = px * cangle - py * sangle + abscenterx;
-            p4y = px * sangle + py * cangle + abscentery;
-
-            tmp_rect.x = (int)MIN(MIN(p1x, p2x), MIN(p3x, p4x));
-            tmp_rect.y = (int)MIN(MIN(p1y, p2y), MIN(p3y, p4y));
-            tmp_rect.w = dstwidth;
-            tmp_rect.h = dstheight;
-
-            /* The NONE blend mode needs some special care with non-opaque surfaces.
-             * Other blend modes or opaque surfaces can be blitted directly.
-             */
-            if (blendmode != SDL_BLENDMODE_NONE || isOpaque) {
-                if (applyModulation == SDL_FALSE) {
-                    /* If the modulation wasn't already applied, make it happen now. */
-                    SDL_SetSurfaceAlphaMod(src_rotated, alphaMod);
-                    SDL_SetSurfaceColorMod(src_rotated, rMod, gMod, bMod);
+        if (texture == tiles->num_textures) {
+            if (tiles->num_textures == tiles->max_textures) {
+                /* Allocate everything before touching anything, so running out of memory leaves it all as it was. */
+                const int max_textures = tiles->max_textures ? (tiles->max_textures * 2) : 8;
+                SDL_Texture **textures = (SDL_Texture **) SDL_malloc(max_textures * sizeof (SDL_Texture *));
+                SDL_Surface **views = (SDL_Surface **) SDL_calloc(tiles->num_workers * max_textures, sizeof (SDL_Surface *));
+                if (!textures || !views) {
+                    SDL_free(textures);
+                    SDL_free(views);
+                    return SDL_OutOfMemory();
                 }
-                retval = SDL_BlitSurface(src_rotated, NULL, surface, &tmp_rect);
-            } else {
-                /* The NONE blend mode requires three steps to get the pixels onto the destination surface.
-                 * First, the area where the rotated pixels will be blitted to get set to zero.
-                 * This is accomplished by simply blitting a mask with the NONE blend mode.
-                 * The colorkey set by the rotate function will discard the correct pixels.
-                 */
-                SDL_Rect mask_rect = tmp_rect;
-                SDL_SetSurfaceBlendMode(mask_rotated, SDL_BLENDMODE_NONE);
-                retval = SDL_BlitSurface(mask_rotated, NULL, surface, &mask_rect);
-                if (!retval) {
-                    /* The next step copies the alpha value. This is done with the BLEND blend mode and
-                     * by modulating the source colors with 0. Since the destination is all zeros, this
-                     * will effectively set the destination alpha to the source alpha.
-                     */
-                    SDL_SetSurfaceColorMod(src_rotated, 0, 0, 0);
-                    mask_rect = tmp_rect;
-                    retval = SDL_BlitSurface(src_rotated, NULL, surface, &mask_rect);
-                    if (!retval) {
-                        /* The last step gets the color values in place. The ADD blend mode simply adds them to
-                         * the destination (where the color values are all zero). However, because the ADD blend
-                         * mode modulates the colors with the alpha channel, a surface without an alpha mask needs
-                         * to be created. This makes all source pixels opaque and the colors get copied correctly.
-                         */
-                        SDL_Surface *src_rotated_rgb;
-                        src_rotated_rgb = SDL_CreateRGBSurfaceFrom(src_rotated->pixels, src_rotated->w, src_rotated->h,
-                                                                   src_rotated->format->BitsPerPixel, src_rotated->pitch,
-                                                                   src_rotated->format->Rmask, src_rotated->format->Gmask,
-                                                                   src_rotated->format->Bmask, 0);
-                        if (src_rotated_rgb == NULL) {
-                            retval = -1;
-                        } else {
-                            SDL_SetSurfaceBlendMode(src_rotated_rgb, SDL_BLENDMODE_ADD);
-                            retval = SDL_BlitSurface(src_rotated_rgb, NULL, surface, &tmp_rect);
-                            SDL_FreeSurface(src_rotated_rgb);
-                        }
+                if (tiles->num_textures) {
+                    SDL_memcpy(textures, tiles->textures, tiles->num_textures * sizeof (SDL_Texture *));
+                }
+                for (i = 0; i < tiles->num_workers; i++) {
+                    SW_TileWorker *worker = &tiles->workers[i];
+                    if (tiles->num_textures) {
+                        SDL_memcpy(views + (i * max_textures), worker->textures, tiles->num_textures * sizeof (SDL_Surface *));
                     }
+                    worker->textures = views + (i * max_textures);
+                }
+                SDL_free(tiles->textures);
+                SDL_free(tiles->views);
+                tiles->textures = textures;
+                tiles->views = views;
+                tiles->max_textures = max_textures;
+            }
+            tiles->textures[tiles->num_textures++] = cmd->data.draw.texture;
+        }
+    }
+
+    if (tiles->num_commands == tiles->max_commands) {
+        const int max_commands = tiles->max_commands ? (tiles->max_commands * 2) : 128;
+        SW_TileCommand *commands = (SW_TileCommand *) SDL_realloc(tiles->commands, max_commands * sizeof (SW_TileCommand));
+        if (!commands) {
+            return SDL_OutOfMemory();
+        }
+        tiles->commands = commands;
+        tiles->max_commands = max_commands;
+    }
+
+    tc = &tiles->commands[tiles->num_commands++];
+    tc->cmd = cmd;
+    tc->clip = *clip;
+    tc->bounds = *bounds;
+    tc->texture = texture;
+    return 0;
+}
+
+static SDL_Surface *
+SW_GetTileTexture(SW_TileWorker *worker, int texture)
+{
+    /* Each worker copies from its own surface, since a surface's blit
+       mapping and color/alpha mod change while it's being drawn. */
+    if (!worker->textures[texture]) {
+        const SDL_Surface *src = (SDL_Surface *) worker->tiles->textures[texture]->driverdata;
+        worker->textures[texture] = SDL_CreateRGBSurfaceWithFormatFrom(src->pixels, src->w, src->h,
+                                                                       src->format->BitsPerPixel, src->pitch,
+                                                                       src->format->format);
+    }
+    return worker->textures[texture];
+}
+
+static void
+SW_RunTiles(SW_TileWorker *worker)
+{
+    SW_TileState *tiles = worker->tiles;
+    const int num_tiles = tiles->tiles_x * tiles->tiles_y;
+    int t;
+
+    while ((t = SDL_AtomicAdd(&tiles->next_tile, 1)) < num_tiles) {
+        SDL_Rect tile;
+        int i;
+
+        tile.x = (t % tiles->tiles_x) * SW_TILE_SIZE;
+        tile.y = (t / tiles->tiles_x) * SW_TILE_SIZE;
+        tile.w = SW_TILE_SIZE;
+        tile.h = SW_TILE_SIZE;
+
+        for (i = tiles->bin_start[t]; i < tiles->bin_start[t + 1]; i++) {
+            const SW_TileCommand *tc = &tiles->commands[tiles->bins[i]];
+            SDL_Surface *src = NULL;
+            SDL_Rect clip;
+
+            if (tc->texture >= 0) {
+                src = SW_GetTileTexture(worker, tc->texture);
+                if (!src) {
+                    continue;
                 }
-                SDL_FreeSurface(mask_rotated);
             }
-            if (src_rotated != NULL) {
-                SDL_FreeSurface(src_rotated);
+            SDL_IntersectRect(&tc->clip, &tile, &clip);
+            SDL_SetClipRect(worker->surface, &clip);
+            SW_DrawCommand(NULL, worker->surface, src, tc->cmd, tiles->vertices);
+        }
+    }
+}
+
+static int SDLCALL
+SW_TileThread(void *data)
+{
+    SW_TileWorker *worker = (SW_TileWorker *) data;
+    SW_TileState *tiles = worker->tiles;
+
+    for (;;) {
+        SDL_SemWait(tiles->work_sem);
+        if (SDL_AtomicGet(&tiles->quit)) {
+            break;
+        }
+        SW_RunTiles(worker);
+        SDL_SemPost(tiles->done_sem);
+    }
+    return 0;
+}
+
+/* Draws the commands binned so far, tile by tile on all the workers. */
+static void
+SW_FlushTiles(SW_TileState *tiles, SDL_Surface *surface, SW_DrawStateCache *drawstate)
+{
+    const int num_tiles = tiles->tiles_x * tiles->tiles_y;
+    int total = 0;
+    int i, x, y;
+
+    if (tiles->num_commands == 0) {
+        return;
+    }
+
+    /* Count each tile's commands, then fill the bins in command order. */
+    SDL_memset(tiles->bin_start, '\0', (num_tiles + 1) * sizeof (int));
+    for (i = 0; i < tiles->num_commands; i++) {
+        const SDL_Rect *bounds = &tiles->commands[i].bounds;
+        for (y = bounds->y / SW_TILE_SIZE; y <= (bounds->y + bounds->h - 1) / SW_TILE_SIZE; y++) {
+            for (x = bounds->x / SW_TILE_SIZE; x <= (bounds->x + bounds->w - 1) / SW_TILE_SIZE; x++) {
+                tiles->bin_start[(y * tiles->tiles_x) + x + 1]++;
             }
         }
     }
+    for (i = 0; i < num_tiles; i++) {
+        tiles->bin_start[i + 1] += tiles->bin_start[i];
+    }
+    total = tiles->bin_start[num_tiles];
 
-    if (SDL_MUSTLOCK(src)) {
-        SDL_UnlockSurface(src);
+    if (total > tiles->max_bins) {
+        int *bins = (int *) SDL_realloc(tiles->bins, total * sizeof (int));
+        if (bins) {
+            tiles->bins = bins;
+            tiles->max_bins = total;
+        }
     }
-    if (mask != NULL) {
-        SDL_FreeSurface(mask);
+    for (i = 0; i < tiles->num_workers; i++) {
+        SW_TileWorker *worker = &tiles->workers[i];
+        if (worker->surface && ((worker->surface->pixels != surface->pixels) ||
+                                (worker->surface->w != surface->w) || (worker->surface->h != surface->h) ||
+                                (worker->surface->pitch != surface->pitch) ||
+                                (worker->surface->format->format != surface->format->format))) {
+            SDL_FreeSurface(worker->surface);  /* the target changed. */
+            worker->surface = NULL;
+        }
+        if (!worker->surface) {
+            worker->surface = SDL_CreateRGBSurfaceWithFormatFrom(surface->pixels, surface->w, surface->h,
+                                                                 surface->format->BitsPerPixel, surface->pitch,
+                                                                 surface->format->format);
+        }
+        if (!worker->surface) {
+            break;
+        }
+    }
+
+    if ((total > tiles->max_bins) || (i < tiles->num_workers)) {
+        /* Out of memory, so draw everything here, in one piece. */
+        for (i = 0; i < tiles->num_commands; i++) {
+            const SW_TileCommand *tc = &tiles->commands[i];
+            SDL_Surface *src = (tc->texture >= 0) ? (SDL_Surface *) tiles->textures[tc->texture]->driverdata : NULL;
+            SDL_SetClipRect(surface, &tc->clip);
+            SW_DrawCommand(NULL, surface, src, tc->cmd, tiles->vertices);
+        }
+        drawstate->surface_cliprect_dirty = SDL_TRUE;
+        tiles->num_commands = 0;
+        return;
+    }
+
+    SDL_memcpy(tiles->bin_next, tiles->bin_start, num_tiles * sizeof (int));
+    for (i = 0; i < tiles->num_commands; i++) {
+        const SDL_Rect *bounds = &tiles->commands[i].bounds;
+        for (y = bounds->y / SW_TILE_SIZE; y <= (bounds->y + bounds->h - 1) / SW_TILE_SIZE; y++) {
+            for (x = bounds->x / SW_TILE_SIZE; x <= (bounds->x + bounds->w - 1) / SW_TILE_SIZE; x++) {
+                tiles->bins[tiles->bin_next[(y * tiles->tiles_x) + x]++] = i;
+            }
+        }
+    }
+
+    /* This thread draws tiles too, until they're all taken. */
+    SDL_AtomicSet(&tiles->next_tile, 0);
+    for (i = 1; i < tiles->num_workers; i++) {
+        SDL_SemPost(tiles->work_sem);
     }
-    if (src_clone != NULL) {
-        SDL_FreeSurface(src_clone);
+    SW_RunTiles(&tiles->workers[0]);
+    for (i = 1; i < tiles->num_workers; i++) {
+        SDL_SemWait(tiles->done_sem);
     }
-    return retval;
+
+    tiles->num_commands = 0;
 }
 
+/* Drops the workers' views of a texture that's being destroyed. */
 static void
-PrepTextureForCopy(const SDL_RenderCommand *cmd)
+SW_ForgetTileTexture(SW_TileState *tiles, SDL_Texture *texture)
 {
-    const Uint8 r = cmd->data.draw.r;
-    const Uint8 g = cmd->data.draw.g;
-    const Uint8 b = cmd->data.draw.b;
-    const Uint8 a = cmd->data.draw.a;
-    const SDL_BlendMode blend = cmd->data.draw.blend;
-    SDL_Texture *texture = cmd->data.draw.texture;
-    SDL_Surface *surface = (SDL_Surface *) texture->driverdata;
-    const SDL_bool colormod = ((r & g & b) != 0xFF);
-    const SDL_bool alphamod = (a != 0xFF);
-    const SDL_bool blending = ((blend == SDL_BLENDMODE_ADD) || (blend == SDL_BLENDMODE_MOD) || (blend == SDL_BLENDMODE_MUL));
+    const int last = tiles->num_textures - 1;
+    int i, j;
 
-    if (colormod || alphamod || blending) {
-        SDL_SetSurfaceRLE(surface, 0);
+    for (j = 0; j <= last; j++) {
+        if (tiles->textures[j] == texture) {
+            break;
+        }
+    }
+    if (j > last) {
+        return;
     }
 
-    /* !!! FIXME: we can probably avoid some of these calls. */
-    SDL_SetSurfaceColorMod(surface, r, g, b);
-    SDL_SetSurfaceAlphaMod(surface, a);
-    SDL_SetSurfaceBlendMode(surface, blend);
+    /* Nothing is binned between command queues, so the last one can take its place. */
+    tiles->textures[j] = tiles->textures[last];
+    for (i = 0; i < tiles->num_workers; i++) {
+        SW_TileWorker *worker = &tiles->workers[i];
+        SDL_FreeSurface(worker->textures[j]);
+        worker->textures[j] = worker->textures[last];
+        worker->textures[last] = NULL;
+    }
+    tiles->num_textures = last;
 }
 
 static void
-SetDrawState(SDL_Surface *surface, SW_DrawStateCache *drawstate)
+SW_DestroyTileState(SW_TileState *tiles)
 {
-    if (drawstate->surface_cliprect_dirty) {
-        const SDL_Rect *viewport = drawstate->viewport;
-        const SDL_Rect *cliprect = drawstate->cliprect;
-        SDL_assert(viewport != NULL);  /* the higher level should have forced a SDL_RENDERCMD_SETVIEWPORT */
-
-        if (cliprect != NULL) {
-            SDL_Rect clip_rect;
-            clip_rect.x = cliprect->x + viewport->x;
-            clip_rect.y = cliprect->y + viewport->y;
-            clip_rect.w = cliprect->w;
-            clip_rect.h = cliprect->h;
-            SDL_IntersectRect(viewport, &clip_rect, &clip_rect);
-            SDL_SetClipRect(surface, &clip_rect);
-        } else {
-            SDL_SetClipRect(surface, drawstate->viewport);
+    int i;
+
+    if (tiles->threads) {
+        SDL_AtomicSet(&tiles->quit, 1);
+        for (i = 1; i < tiles->num_workers; i++) {
+            SDL_SemPost(tiles->work_sem);
         }
-        drawstate->surface_cliprect_dirty = SDL_FALSE;
+        for (i = 1; i < tiles->num_workers; i++) {
+            SDL_WaitThread(tiles->threads[i], NULL);
+        }
+    }
+    if (tiles->workers) {
+        for (i = 0; i < tiles->num_workers; i++) {
+            SW_TileWorker *worker = &tiles->workers[i];
+            int j;
+            for (j = 0; j < tiles->num_textures; j++) {
+                SDL_FreeSurface(worker->textures[j]);
+            }
+            SDL_FreeSurface(worker->surface);
+        }
+    }
+    if (tiles->work_sem) {
+        SDL_DestroySemaphore(tiles->work_sem);
+    }
+    if (tiles->done_sem) {
+        SDL_DestroySemaphore(tiles->done_sem);
     }
+    SDL_free(tiles->workers);
+    SDL_free(tiles->threads);
+    SDL_free(tiles->commands);
+    SDL_free(tiles->textures);
+    SDL_free(tiles->views);
+    SDL_free(tiles->bin_start);
+    SDL_free(tiles->bin_next);
+    SDL_free(tiles->bins);
+    SDL_free(tiles);
+}
+
+static SW_TileState *
+SW_CreateTileState(int num_threads)
+{
+    SW_TileState *tiles = (SW_TileState *) SDL_calloc(1, sizeof (*tiles));
+    int i;
+
+    if (!tiles) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    tiles->workers = (SW_TileWorker *) SDL_calloc(num_threads, sizeof (SW_TileWorker));
+    tiles->threads = (SDL_Thread **) SDL_calloc(num_threads, sizeof (SDL_Thread *));
+    tiles->work_sem = SDL_CreateSemaphore(0);
+    tiles->done_sem = SDL_CreateSemaphore(0);
+    if (!tiles->workers || !tiles->threads || !tiles->work_sem || !tiles->done_sem) {
+        SW_DestroyTileState(tiles);
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    tiles->num_workers = 1;
+    tiles->workers[0].tiles = tiles;
+    for (i = 1; i < num_threads; i++) {
+        tiles->workers[i].tiles = tiles;
+        tiles->threads[i] = SDL_CreateThreadInternal(SW_TileThread, "SDLRenderTiles", 0, &tiles->workers[i]);
+        if (!tiles->threads[i]) {
+            break;  /* make do with the threads we have. */
+        }
+        tiles->num_workers++;
+    }
+
+    if (tiles->num_workers == 1) {
+        SW_DestroyTileState(tiles);
+        return NULL;
+    }
+    return tiles;
 }
 
 static int
-SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize)
+SW_RunCommandQueueTiled(SDL_Renderer * renderer, SDL_Surface *surface, SDL_RenderCommand *cmd, void *vertices)
 {
-    SDL_Surface *surface = SW_ActivateRenderer(renderer);
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
+    SW_TileState *tiles = data->tiles;
     SW_DrawStateCache drawstate;
-
-    if (!surface) {
-        return -1;
+    const int tiles_x = (surface->w + SW_TILE_SIZE - 1) / SW_TILE_SIZE;
+    const int tiles_y = (surface->h + SW_TILE_SIZE - 1) / SW_TILE_SIZE;
+
+    if ((tiles_x * tiles_y) > tiles->max_tiles) {
+        const int max_tiles = tiles_x * tiles_y;
+        int *bin_start = (int *) SDL_realloc(tiles->bin_start, (max_tiles + 1) * sizeof (int));
+        int *bin_next;
+        if (!bin_start) {
+            return SDL_OutOfMemory();
+        }
+        tiles->bin_start = bin_start;
+        bin_next = (int *) SDL_realloc(tiles->bin_next, max_tiles * sizeof (int));
+        if (!bin_next) {
+            return SDL_OutOfMemory();
+        }
+        tiles->bin_next = bin_next;
+        tiles->max_tiles = max_tiles;
     }
 
+    tiles->tiles_x = tiles_x;
+    tiles->tiles_y = tiles_y;
+    tiles->vertices = vertices;
+
     drawstate.viewport = NULL;
     drawstate.cliprect = NULL;
     drawstate.surface_cliprect_dirty = SDL_TRUE;
 
     while (cmd) {
         switch (cmd->command) {
-            case SDL_RENDERCMD_SETDRAWCOLOR: {
-                break;  /* Not used in this backend. */
-            }
-
-            case SDL_RENDERCMD_SETVIEWPORT: {
-                drawstate.viewport = &cmd->data.viewport.rect;
-                drawstate.surface_cliprect_dirty = SDL_TRUE;
-                break;
-            }
-
-            case SDL_RENDERCMD_SETCLIPRECT: {
-                drawstate.cliprect = cmd->data.cliprect.enabled ? &cmd->data.cliprect.rect : NULL;                
-                drawstate.surface_cliprect_dirty = SDL_TRUE;
-                break;
-            }
-
-            case SDL_RENDERCMD_CLEAR: {
-                const Uint8 r = cmd->data.color.r;
-                const Uint8 g = cmd->data.color.g;
-                const Uint8 b = cmd->data.color.b;
-                const Uint8 a = cmd->data.color.a;
-                /* By definition the clear ignores the clip rect */
-                SDL_SetClipRect(surface, NULL);
-                SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, r, g, b, a));
-                drawstate.surface_cliprect_dirty = SDL_TRUE;
-                break;
-            }
-
-            case SDL_RENDERCMD_DRAW_POINTS: {
-                const Uint8 r = cmd->data.draw.r;
-                const Uint8 g = cmd->data.draw.g;
-                const Uint8 b = cmd->data.draw.b;
-                const Uint8 a = cmd->data.draw.a;
-                const int count = (int) cmd->data.draw.count;
-                const SDL_Point *verts = (SDL_Point *) (((Uint8 *) vertices) + cmd->data.draw.first);
-                const SDL_BlendMode blend = cmd->data.draw.blend;
-                SetDrawState(surface, &drawstate);
-                if (blend == SDL_BLENDMODE_NONE) {
-                    SDL_DrawPoints(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
-                } else {
-                    SDL_BlendPoints(surface, verts, count, blend, r, g, b, a);
+            case SDL_RENDERCMD_CLEAR:
+            case SDL_RENDERCMD_DRAW_POINTS:
+            case SDL_RENDERCMD_DRAW_LINES:
+            case SDL_RENDERCMD_FILL_RECTS:
+            case SDL_RENDERCMD_COPY:
+            case SDL_RENDERCMD_COPY_EX:
+            case SDL_RENDERCMD_GEOMETRY: {
+                SDL_Rect clip, bounds;
+                const int tiled = SW_GetTileBounds(surface, &drawstate, cmd, vertices, &clip, &bounds);
+                if ((tiled < 0) || ((tiled > 0) && (SW_AddTileCommand(tiles, cmd, &clip, &bounds) < 0))) {
+                    /* Everything before it has to be drawn first. */
+                    SW_FlushTiles(tiles, surface, &drawstate);
+                    SW_RunCommand(renderer, surface, cmd, vertices, &drawstate);
                 }
                 break;
             }
 
-            case SDL_RENDERCMD_DRAW_LINES: {
-                const Uint8 r = cmd->data.draw.r;
-                const Uint8 g = cmd->data.draw.g;
-                const Uint8 b = cmd->data.draw.b;
-                const Uint8 a = cmd->data.draw.a;
-                const int count = (int) cmd->data.draw.count;
-                const SDL_Point *verts = (SDL_Point *) (((Uint8 *) vertices) + cmd->data.draw.first);
-                const SDL_BlendMode blend = cmd->data.draw.blend;
-                SetDrawState(surface, &drawstate);
-                if (blend == SDL_BLENDMODE_NONE) {
-                    SDL_DrawLines(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
-                } else {
-                    SDL_BlendLines(surface, verts, count, blend, r, g, b, a);
-                }
+            default:
+                /* State changes only; the binned commands keep their own clip rects. */
+                SW_RunCommand(renderer, surface, cmd, vertices, &drawstate);
                 break;
-            }
-
-            case SDL_RENDERCMD_FILL_RECTS: {
-                const Uint8 r = cmd->data.draw.r;
-                const Uint8 g = cmd->data.draw.g;
-                const Uint8 b = cmd->data.draw.b;
-                const Uint8 a = cmd->data.draw.a;
-                const int count = (int) cmd->data.draw.count;
-                const SDL_Rect *verts = (SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
-                const SDL_BlendMode blend = cmd->data.draw.blend;
-                SetDrawState(surface, &drawstate);
-                if (blend == SDL_BLENDMODE_NONE) {
-                    SDL_FillRects(surface, verts, count, SDL_MapRGBA(surface->format, r, g, b, a));
-                } else {
-                    SDL_BlendFillRects(surface, verts, count, blend, r, g, b, a);
-                }
-                break;
-            }
+        }
 
-            case SDL_RENDERCMD_COPY: {
-                SDL_Rect *verts = (SDL_Rect *) (((Uint8 *) vertices) + cmd->data.draw.first);
-                const SDL_Rect *srcrect = verts;
-                SDL_Rect *dstrect = verts + 1;
-                SDL_Texture *texture = cmd->data.draw.texture;
-                SDL_Surface *src = (SDL_Surface *) texture->driverdata;
+        cmd = cmd->next;
+    }
 
-                SetDrawState(surface, &drawstate);
+    SW_FlushTiles(tiles, surface, &drawstate);
+    return 0;
+}
 
-                PrepTextureForCopy(cmd);
+static int
+SW_RunCommandQueue(SDL_Renderer * renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize)
+{
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
+    SDL_Surface *surface = SW_ActivateRenderer(renderer);
+    SW_DrawStateCache drawstate;
 
-                if ( srcrect->w == dstrect->w && srcrect->h == dstrect->h ) {
-                    SDL_BlitSurface(src, srcrect, surface, dstrect);
-                } else {
-                    /* If scaling is ever done, permanently disable RLE (which doesn't support scaling)
-                     * to avoid potentially frequent RLE encoding/decoding.
-                     */
-                    SDL_SetSurfaceRLE(surface, 0);
-                    SDL_PrivateUpperBlitScaled(src, srcrect, surface, dstrect, texture->scaleMode);
-                }
-                break;
-            }
+    if (!surface) {
+        return -1;
+    }
 
-            case SDL_RENDERCMD_COPY_EX: {
-                const CopyExData *copydata = (CopyExData *) (((Uint8 *) vertices) + cmd->data.draw.first);
-                SetDrawState(surface, &drawstate);
-                PrepTextureForCopy(cmd);
-                SW_RenderCopyEx(renderer, surface, cmd->data.draw.texture, &copydata->srcrect,
-                                &copydata->dstrect, copydata->angle, &copydata->center, copydata->flip);
-                break;
-            }
+    if ((data->num_threads > 1) && !data->tiles) {
+        data->tiles = SW_CreateTileState(data->num_threads);
+        if (!data->tiles) {
+            data->num_threads = 1;  /* don't try again every frame. */
+        }
+    }
 
-            case SDL_RENDERCMD_NO_OP:
-                break;
+    if (data->tiles && !SDL_MUSTLOCK(surface) && !surface->format->palette &&
+        ((surface->w > SW_TILE_SIZE) || (surface->h > SW_TILE_SIZE))) {
+        if (SW_RunCommandQueueTiled(renderer, surface, cmd, vertices) == 0) {
+            return 0;
         }
+    }
 
+    drawstate.viewport = NULL;
+    drawstate.cliprect = NULL;
+    drawstate.surface_cliprect_dirty = SDL_TRUE;
+
+    while (cmd) {
+        SW_RunCommand(renderer, surface, cmd, vertices, &drawstate);
         cmd = cmd->next;
     }
 
@@ -788,8 +1224,12 @@ SW_RenderPresent(SDL_Renderer * renderer)
 static void
 SW_DestroyTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 {
+    SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
     SDL_Surface *surface = (SDL_Surface *) texture->driverdata;
 
+    if (data->tiles) {
+        SW_ForgetTileTexture(data->tiles, texture);
+    }
     SDL_FreeSurface(surface);
 }
 
@@ -798,6 +1238,9 @@ SW_DestroyRenderer(SDL_Renderer * renderer)
 {
     SW_RenderData *data = (SW_RenderData *) renderer->driverdata;
 
+    if (data && data->tiles) {
+        SW_DestroyTileState(data->tiles);
+    }
     SDL_free(data);
     SDL_free(renderer);
 }
@@ -807,6 +1250,7 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
 {
     SDL_Renderer *renderer;
     SW_RenderData *data;
+    const char *hint;
 
     if (!surface) {
         SDL_SetError("Can't create renderer for NULL surface");
@@ -828,6 +1272,12 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
     data->surface = surface;
     data->window = surface;
 
+    hint = SDL_GetHint(SDL_HINT_RENDER_SOFTWARE_THREADS);
+    data->num_threads = hint ? SDL_atoi(hint) : 1;
+    if (data->num_threads <= 0) {
+        data->num_threads = SDL_GetCPUCount();
+    }
+
     renderer->WindowEvent = SW_WindowEvent;
     renderer->GetOutputSize = SW_GetOutputSize;
     renderer->CreateTexture = SW_CreateTexture;
@@ -843,11 +1293,13 @@ SW_CreateRendererForSurface(SDL_Surface * surface)
     renderer->QueueFillRects = SW_QueueFillRects;
     renderer->QueueCopy = SW_QueueCopy;
     renderer->QueueCopyEx = SW_QueueCopyEx;
+    renderer->QueueGeometry = SW_QueueGeometry;
     renderer->RunCommandQueue = SW_RunCommandQueue;
     renderer->RenderReadPixels = SW_RenderReadPixels;
     renderer->RenderPresent = SW_RenderPresent;
     renderer->DestroyTexture = SW_DestroyTexture;
     renderer->DestroyRenderer = SW_DestroyRenderer;
+    renderer->merge_copies = SDL_TRUE;
     renderer->info = SW_RenderDriver.info;
     renderer->driverdata = data;
 
@@ -0,0 +1,918 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../../SDL_internal.h"
+
+#if SDL_VIDEO_RENDER_SW && !SDL_RENDER_DISABLED
+
+#include "SDL_cpuinfo.h"
+#include "SDL_draw.h"
+#include "SDL_triangle.h"
+
+#ifdef __SSE2__
+#define HAVE_SSE2_INTRINSICS 1
+#endif
+
+#ifdef __ARM_NEON
+#define HAVE_NEON_INTRINSICS 1
+#endif
+
+/* Vertices are snapped to 1/16 of a pixel, and a triangle covers the pixels
+   whose centers it contains. A center exactly on an edge belongs to the
+   triangle on the edge's top or left, so triangles sharing an edge draw its
+   pixels once. Every pixel is worked out from its own coordinates, so a
+   triangle drawn in pieces with different clip rects (as the tiled renderer
+   does) ends up with exactly the same pixels as one drawn in one go. */
+#define TRI_SUBPIXEL 16
+#define TRI_HALF_PIXEL (TRI_SUBPIXEL / 2)
+
+/* Keeps the edge functions well inside 64 bits. */
+#define TRI_COORD_LIMIT 4194304.0f
+
+enum
+{
+    TRI_R,
+    TRI_G,
+    TRI_B,
+    TRI_A,
+    TRI_U,
+    TRI_V,
+    TRI_NUM_ATTRIBUTES
+};
+
+typedef struct
+{
+    Sint64 a, b, c;     /* a * x + b * y + c >= 0 inside, with x and y in subpixels */
+} TriangleEdge;
+
+typedef struct
+{
+    SDL_Surface *dst;
+    SDL_Surface *texture;
+    SDL_BlendMode blend;
+    SDL_bool linear;    /* filter the four texels around each sample */
+    SDL_bool modulate;  /* the texels get multiplied by the colors, which aren't all white */
+    int num_attributes;
+    float max_u, max_v;
+
+    /* 32-bit formats with 8-bit channels, for the SIMD versions */
+    int dst_shift[4];
+    SDL_bool dst_alpha;
+    int texture_shift[4];
+    SDL_bool texture_alpha;
+
+    /* The attributes of the triangle being drawn are start + dx * (x - x0) +
+       dy * (y - y0) at the center of pixel (x, y). row is the value at
+       (x0, y) for the row being drawn. */
+    int x0, y0;
+    float start[TRI_NUM_ATTRIBUTES];
+    float dx[TRI_NUM_ATTRIBUTES];
+    float dy[TRI_NUM_ATTRIBUTES];
+    float row[TRI_NUM_ATTRIBUTES];
+} TriangleState;
+
+typedef void (*TriangleSpanFunc)(const TriangleState *t, int y, int x, int n);
+
+#define TRI_TEXEL32(texture, u, v) \
+    (*(const Uint32 *) ((const Uint8 *) (texture)->pixels + (v) * (texture)->pitch + (u) * 4))
+
+/* Weighs a against b by w / 256, for a and b up to 255 and w up to 255. */
+#define TRI_LERP(a, b, w) (((a) * (256 - (w)) + (b) * (w) + 128) >> 8)
+
+static Sint64
+TriangleSnap(float value)
+{
+    if (!(value > -TRI_COORD_LIMIT)) {  /* this catches NaN, too */
+        value = -TRI_COORD_LIMIT;
+    } else if (value > TRI_COORD_LIMIT) {
+        value = TRI_COORD_LIMIT;
+    }
+    return (Sint64) SDL_floor(value * (double) TRI_SUBPIXEL + 0.5);
+}
+
+/* Rounds towards negative infinity; d must be positive. */
+static SDL_INLINE Sint64
+TriangleFloorDiv(Sint64 n, Sint64 d)
+{
+    return (n >= 0) ? (n / d) : -((d - 1 - n) / d);
+}
+
+/* NaN ends up as 0, as it does in the SIMD versions. */
+static SDL_INLINE float
+TriangleClamp(float value, float max)
+{
+    value = (value > 0.0f) ? value : 0.0f;
+    return (value < max) ? value : max;
+}
+
+static float
+TriangleAttribute(const SDL_TriangleVertex *vertex, int attribute)
+{
+    switch (attribute) {
+    case TRI_R:
+        return vertex->color.r;
+    case TRI_G:
+        return vertex->color.g;
+    case TRI_B:
+        return vertex->color.b;
+    case TRI_A:
+        return vertex->color.a;
+    case TRI_U:
+        return vertex->u;
+    default:
+        return vertex->v;
+    }
+}
+
+static SDL_bool
+TriangleIs8888(const SDL_PixelFormat *fmt, int shift[4], SDL_bool *alpha)
+{
+    if (fmt->BytesPerPixel != 4 ||
+        fmt->Rmask != (0xFFu << fmt->Rshift) ||
+        fmt->Gmask != (0xFFu << fmt->Gshift) ||
+        fmt->Bmask != (0xFFu << fmt->Bshift) ||
+        (fmt->Amask && fmt->Amask != (0xFFu << fmt->Ashift))) {
+        return SDL_FALSE;
+    }
+    shift[0] = fmt->Rshift;
+    shift[1] = fmt->Gshift;
+    shift[2] = fmt->Bshift;
+    shift[3] = fmt->Ashift;
+    *alpha = fmt->Amask ? SDL_TRUE : SDL_FALSE;
+    return SDL_TRUE;
+}
+
+static Uint32
+TriangleGetPixel(const Uint8 *p, int bpp)
+{
+    switch (bpp) {
+    case 1:
+        return *p;
+    case 2:
+        return *(const Uint16 *) p;
+    case 3:
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+        return p[0] | (p[1] << 8) | (p[2] << 16);
+#else
+        return (p[0] << 16) | (p[1] << 8) | p[2];
+#endif
+    default:
+        return *(const Uint32 *) p;
+    }
+}
+
+static void
+TriangleSetPixel(Uint8 *p, int bpp, Uint32 pixel)
+{
+    switch (bpp) {
+    case 1:
+        *p = (Uint8) pixel;
+        break;
+    case 2:
+        *(Uint16 *) p = (Uint16) pixel;
+        break;
+    case 3:
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+        p[0] = (Uint8) pixel;
+        p[1] = (Uint8) (pixel >> 8);
+        p[2] = (Uint8) (pixel >> 16);
+#else
+        p[0] = (Uint8) (pixel >> 16);
+        p[1] = (Uint8) (pixel >> 8);
+        p[2] = (Uint8) pixel;
+#endif
+        break;
+    default:
+        *(Uint32 *) p = pixel;
+        break;
+    }
+}
+
+static void
+TriangleGetTexel(const SDL_Surface *texture, int u, int v, unsigned c[4])
+{
+    const int bpp = texture->format->BytesPerPixel;
+    const Uint8 *texel = (const Uint8 *) texture->pixels + v * texture->pitch + u * bpp;
+    Uint8 r, g, b, a;
+
+    SDL_GetRGBA(TriangleGetPixel(texel, bpp), texture->format, &r, &g, &b, &a);
+    c[0] = r;
+    c[1] = g;
+    c[2] = b;
+    c[3] = a;
+}
+
+/* Filters the four texels around (u, v), which is already clamped to the
+   texture, exactly the way the SIMD versions do. */
+static void
+TriangleGetTexelLinear(const SDL_Surface *texture, float u, float v, unsigned c[4])
+{
+    const int u0 = (int) u;
+    const int v0 = (int) v;
+    const int u1 = u0 + ((u0 < texture->w - 1) ? 1 : 0);
+    const int v1 = v0 + ((v0 < texture->h - 1) ? 1 : 0);
+    const unsigned wu = (unsigned) ((u - (float) u0) * 256.0f);
+    const unsigned wv = (unsigned) ((v - (float) v0) * 256.0f);
+    unsigned c00[4], c10[4], c01[4], c11[4];
+    int i;
+
+    TriangleGetTexel(texture, u0, v0, c00);
+    TriangleGetTexel(texture, u1, v0, c10);
+    TriangleGetTexel(texture, u0, v1, c01);
+    TriangleGetTexel(texture, u1, v1, c11);
+    for (i = 0; i < 4; i++) {
+        c[i] = TRI_LERP(TRI_LERP(c00[i], c10[i], wu), TRI_LERP(c01[i], c11[i], wu), wv);
+    }
+}
+
+/* Blends s into d the same way SDL_BlendFillRect() does. */
+static void
+TriangleBlend(SDL_BlendMode blend, const unsigned s[4], unsigned d[4])
+{
+    const unsigned inva = 0xFF - s[3];
+    int i;
+
+    switch (blend) {
+    case SDL_BLENDMODE_BLEND:
+        for (i = 0; i < 3; i++) {
+            d[i] = DRAW_MUL(inva, d[i]) + DRAW_MUL(s[i], s[3]);
+        }
+        d[3] = DRAW_MUL(inva, d[3]) + s[3];
+        break;
+    case SDL_BLENDMODE_ADD:
+        for (i = 0; i < 3; i++) {
+            d[i] = SDL_min(d[i] + DRAW_MUL(s[i], s[3]), 0xFF);
+        }
+        break;
+    case SDL_BLENDMODE_MOD:
+        for (i = 0; i < 3; i++) {
+            d[i] = DRAW_MUL(d[i], s[i]);
+        }
+        break;
+    case SDL_BLENDMODE_MUL:
+        for (i = 0; i < 4; i++) {
+            d[i] = SDL_min(DRAW_MUL(d[i], s[i]) + DRAW_MUL(inva, d[i]), 0xFF);
+        }
+        break;
+    default:
+        for (i = 0; i < 4; i++) {
+            d[i] = s[i];
+        }
+        break;
+    }
+}
+
+/* Any format, a pixel at a time. */
+static void
+TriangleSpan(const TriangleState *t, int y, int x, int n)
+{
+    const SDL_Surface *dst = t->dst;
+    const SDL_Surface *texture = t->texture;
+    const int bpp = dst->format->BytesPerPixel;
+    Uint8 *pixel = (Uint8 *) dst->pixels + y * dst->pitch + x * bpp;
+
+    for (; n > 0; n--, x++, pixel += bpp) {
+        const float fx = (float) (x - t->x0);
+        unsigned s[4], d[4];
+        Uint8 r, g, b, a;
+        int i;
+
+        for (i = TRI_R; i <= TRI_A; i++) {
+            s[i] = (unsigned) TriangleClamp(t->row[i] + t->dx[i] * fx, 255.0f);
+        }
+
+        if (texture) {
+            const float u = TriangleClamp(t->row[TRI_U] + t->dx[TRI_U] * fx, t->max_u);
+            const float v = TriangleClamp(t->row[TRI_V] + t->dx[TRI_V] * fx, t->max_v);
+            unsigned c[4];
+            if (t->linear) {
+                TriangleGetTexelLinear(texture, u, v, c);
+            } else {
+                TriangleGetTexel(texture, (int) u, (int) v, c);
+            }
+            for (i = TRI_R; i <= TRI_A; i++) {
+                s[i] = DRAW_MUL(s[i], c[i]);
+            }
+        }
+
+        SDL_GetRGBA(TriangleGetPixel(pixel, bpp), dst->format, &r, &g, &b, &a);
+        d[0] = r;
+        d[1] = g;
+        d[2] = b;
+        d[3] = a;
+
+        TriangleBlend(t->blend, s, d);
+
+        TriangleSetPixel(pixel, bpp, SDL_MapRGBA(dst->format, (Uint8) d[0], (Uint8) d[1], (Uint8) d[2], (Uint8) d[3]));
+    }
+}
+
+#if HAVE_SSE2_INTRINSICS
+/* The SIMD versions work on four pixels at a time, with their channels in
+   16-bit lanes: one vector holds the four reds then the four greens, the
+   other the four blues then the four alphas. */
+
+/* x / 255, exactly, for x up to 255 * 255 */
+static SDL_INLINE __m128i
+TriangleDiv255SSE2(__m128i x)
+{
+    return _mm_srli_epi16(_mm_add_epi16(x, _mm_add_epi16(_mm_srli_epi16(x, 8), _mm_set1_epi16(1))), 8);
+}
+
+#define TRI_MUL_SSE2(a, b) TriangleDiv255SSE2(_mm_mullo_epi16(a, b))
+
+static SDL_INLINE __m128i
+TriangleChannelSSE2(__m128i pixels, int shift)
+{
+    return _mm_and_si128(_mm_srl_epi32(pixels, _mm_cvtsi32_si128(shift)), _mm_set1_epi32(0xFF));
+}
+
+static SDL_INLINE __m128
+TriangleClampedSSE2(const TriangleState *t, int attribute, __m128 fx, float max)
+{
+    const __m128 value = _mm_add_ps(_mm_set1_ps(t->row[attribute]), _mm_mul_ps(_mm_set1_ps(t->dx[attribute]), fx));
+    return _mm_min_ps(_mm_max_ps(value, _mm_setzero_ps()), _mm_set1_ps(max));
+}
+
+static SDL_INLINE __m128i
+TriangleAttributeSSE2(const TriangleState *t, int attribute, __m128 fx, float max)
+{
+    return _mm_cvttps_epi32(TriangleClampedSSE2(t, attribute, fx, max));
+}
+
+static __m128i
+TriangleTexelsSSE2(const TriangleState *t, __m128 fx)
+{
+    const SDL_Surface *texture = t->texture;
+    int u[4], v[4];
+
+    _mm_storeu_si128((__m128i *) u, TriangleAttributeSSE2(t, TRI_U, fx, t->max_u));
+    _mm_storeu_si128((__m128i *) v, TriangleAttributeSSE2(t, TRI_V, fx, t->max_v));
+    return _mm_set_epi32((int) TRI_TEXEL32(texture, u[3], v[3]), (int) TRI_TEXEL32(texture, u[2], v[2]),
+                         (int) TRI_TEXEL32(texture, u[1], v[1]), (int) TRI_TEXEL32(texture, u[0], v[0]));
+}
+
+static SDL_INLINE __m128i
+TriangleLerpSSE2(__m128i a, __m128i b, __m128i w)
+{
+    const __m128i invw = _mm_sub_epi16(_mm_set1_epi16(256), w);
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(a, invw), _mm_mullo_epi16(b, w)), _mm_set1_epi16(128)), 8);
+}
+
+/* Splits the four 32-bit weights in w into one per channel of the first
+   two texels (lo) and of the last two (hi). */
+static SDL_INLINE void
+TriangleSpreadWeightsSSE2(__m128i w, __m128i *lo, __m128i *hi)
+{
+    w = _mm_packs_epi32(w, w);
+    w = _mm_unpacklo_epi16(w, w);
+    *lo = _mm_unpacklo_epi32(w, w);
+    *hi = _mm_unpackhi_epi32(w, w);
+}
+
+/* Filters the four texels around each sample. Their channels get filtered
+   in place, so the result is laid out like the texture's pixels. */
+static __m128i
+TriangleTexelsLinearSSE2(const TriangleState *t, __m128 fx)
+{
+    const SDL_Surface *texture = t->texture;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128 u = TriangleClampedSSE2(t, TRI_U, fx, t->max_u);
+    const __m128 v = TriangleClampedSSE2(t, TRI_V, fx, t->max_v);
+    const __m128i u0 = _mm_cvttps_epi32(u);
+    const __m128i v0 = _mm_cvttps_epi32(v);
+    const __m128i u1 = _mm_sub_epi32(u0, _mm_cmplt_epi32(u0, _mm_set1_epi32(texture->w - 1)));
+    const __m128i v1 = _mm_sub_epi32(v0, _mm_cmplt_epi32(v0, _mm_set1_epi32(texture->h - 1)));
+    const __m128 scale = _mm_set1_ps(256.0f);
+    __m128i wulo, wuhi, wvlo, wvhi, t00, t10, t01, t11, lo, hi;
+    int x0[4], x1[4], y0[4], y1[4];
+
+    TriangleSpreadWeightsSSE2(_mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(u, _mm_cvtepi32_ps(u0)), scale)), &wulo, &wuhi);
+    TriangleSpreadWeightsSSE2(_mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(v, _mm_cvtepi32_ps(v0)), scale)), &wvlo, &wvhi);
+
+    _mm_storeu_si128((__m128i *) x0, u0);
+    _mm_storeu_si128((__m128i *) x1, u1);
+    _mm_storeu_si128((__m128i *) y0, v0);
+    _mm_storeu_si128((__m128i *) y1, v1);
+    t00 = _mm_set_epi32((int) TRI_TEXEL32(texture, x0[3], y0[3]), (int) TRI_TEXEL32(texture, x0[2], y0[2]),
+                        (int) TRI_TEXEL32(texture, x0[1], y0[1]), (int) TRI_TEXEL32(texture, x0[0], y0[0]));
+    t10 = _mm_set_epi32((int) TRI_TEXEL32(texture, x1[3], y0[3]), (int) TRI_TEXEL32(texture, x1[2], y0[2]),
+                        (int) TRI_TEXEL32(texture, x1[1], y0[1]), (int) TRI_TEXEL32(texture, x1[0], y0[0]));
+    t01 = _mm_set_epi32((int) TRI_TEXEL32(texture, x0[3], y1[3]), (int) TRI_TEXEL32(texture, x0[2], y1[2]),
+                        (int) TRI_TEXEL32(texture, x0[1], y1[1]), (int) TRI_TEXEL32(texture, x0[0], y1[0]));
+    t11 = _mm_set_epi32((int) TRI_TEXEL32(texture, x1[3], y1[3]), (int) TRI_TEXEL32(texture, x1[2], y1[2]),
+                        (int) TRI_TEXEL32(texture, x1[1], y1[1]), (int) TRI_TEXEL32(texture, x1[0], y1[0]));
+
+    lo = TriangleLerpSSE2(TriangleLerpSSE2(_mm_unpacklo_epi8(t00, zero), _mm_unpacklo_epi8(t10, zero), wulo),
+                          TriangleLerpSSE2(_mm_unpacklo_epi8(t01, zero), _mm_unpacklo_epi8(t11, zero), wulo), wvlo);
+    hi = TriangleLerpSSE2(TriangleLerpSSE2(_mm_unpackhi_epi8(t00, zero), _mm_unpackhi_epi8(t10, zero), wuhi),
+                          TriangleLerpSSE2(_mm_unpackhi_epi8(t01, zero), _mm_unpackhi_epi8(t11, zero), wuhi), wvhi);
+    return _mm_packus_epi16(lo, hi);
+}
+
+static __m128i
+TrianglePixelsSSE2(const TriangleState *t, int x, __m128i pixels)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i max = _mm_set1_epi16(0xFF);
+    const __m128 fx = _mm_cvtepi32_ps(_mm_add_epi32(_mm_set1_epi32(x - t->x0), _mm_set_epi32(3, 2, 1, 0)));
+    __m128i rg, ba, drg, dba, sa, inva;
+
+    if (t->modulate) {
+        rg = _mm_packs_epi32(TriangleAttributeSSE2(t, TRI_R, fx, 255.0f), TriangleAttributeSSE2(t, TRI_G, fx, 255.0f));
+        ba = _mm_packs_epi32(TriangleAttributeSSE2(t, TRI_B, fx, 255.0f), TriangleAttributeSSE2(t, TRI_A, fx, 255.0f));
+    } else {
+        rg = max;
+        ba = max;
+    }
+
+    if (t->texture) {
+        const __m128i texels = t->linear ? TriangleTexelsLinearSSE2(t, fx) : TriangleTexelsSSE2(t, fx);
+        const __m128i trg = _mm_packs_epi32(TriangleChannelSSE2(texels, t->texture_shift[0]),
+                                            TriangleChannelSSE2(texels, t->texture_shift[1]));
+        const __m128i tba = _mm_packs_epi32(TriangleChannelSSE2(texels, t->texture_shift[2]),
+                                            t->texture_alpha ? TriangleChannelSSE2(texels, t->texture_shift[3]) : _mm_set1_epi32(0xFF));
+        rg = t->modulate ? TRI_MUL_SSE2(rg, trg) : trg;
+        ba = t->modulate ? TRI_MUL_SSE2(ba, tba) : tba;
+    }
+
+    drg = _mm_packs_epi32(TriangleChannelSSE2(pixels, t->dst_shift[0]), TriangleChannelSSE2(pixels, t->dst_shift[1]));
+    dba = _mm_packs_epi32(TriangleChannelSSE2(pixels, t->dst_shift[2]),
+                          t->dst_alpha ? TriangleChannelSSE2(pixels, t->dst_shift[3]) : _mm_set1_epi32(0xFF));
+    sa = _mm_unpackhi_epi64(ba, ba);
+    inva = _mm_sub_epi16(max, sa);
+
+    switch (t->blend) {
+    case SDL_BLENDMODE_BLEND:
+        rg = _mm_add_epi16(TRI_MUL_SSE2(drg, inva), TRI_MUL_SSE2(rg, sa));
+        ba = _mm_add_epi16(TRI_MUL_SSE2(dba, inva), TRI_MUL_SSE2(ba, _mm_unpacklo_epi64(sa, max)));
+        break;
+    case SDL_BLENDMODE_ADD:
+        rg = _mm_min_epi16(_mm_add_epi16(drg, TRI_MUL_SSE2(rg, sa)), max);
+        ba = _mm_min_epi16(_mm_add_epi16(dba, TRI_MUL_SSE2(ba, sa)), max);
+        ba = _mm_unpacklo_epi64(ba, _mm_unpackhi_epi64(dba, dba));
+        break;
+    case SDL_BLENDMODE_MOD:
+        rg = TRI_MUL_SSE2(drg, rg);
+        ba = _mm_unpacklo_epi64(TRI_MUL_SSE2(dba, ba), _mm_unpackhi_epi64(dba, dba));
+        break;
+    case SDL_BLENDMODE_MUL:
+        rg = _mm_min_epi16(_mm_add_epi16(TRI_MUL_SSE2(drg, rg), TRI_MUL_SSE2(drg, inva)), max);
+        ba = _mm_min_epi16(_mm_add_epi16(TRI_MUL_SSE2(dba, ba), TRI_MUL_SSE2(dba, inva)), max);
+        break;
+    default:
+        break;
+    }
+
+    pixels = _mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(rg, zero), _mm_cvtsi32_si128(t->dst_shift[0])),
+                          _mm_sll_epi32(_mm_unpackhi_epi16(rg, zero), _mm_cvtsi32_si128(t->dst_shift[1])));
+    pixels = _mm_or_si128(pixels, _mm_sll_epi32(_mm_unpacklo_epi16(ba, zero), _mm_cvtsi32_si128(t->dst_shift[2])));
+    if (t->dst_alpha) {
+        pixels = _mm_or_si128(pixels, _mm_sll_epi32(_mm_unpackhi_epi16(ba, zero), _mm_cvtsi32_si128(t->dst_shift[3])));
+    }
+    return pixels;
+}
+
+static void
+TriangleSpanSSE2(const TriangleState *t, int y, int x, int n)
+{
+    Uint32 *pixel = (Uint32 *) ((Uint8 *) t->dst->pixels + y * t->dst->pitch) + x;
+    Uint32 tail[4] = { 0, 0, 0, 0 };
+
+    for (; n >= 4; n -= 4, x += 4, pixel += 4) {
+        _mm_storeu_si128((__m128i *) pixel, TrianglePixelsSSE2(t, x, _mm_loadu_si128((const __m128i *) pixel)));
+    }
+
+    /* The last few pixels go through a copy, so nothing past the span is touched. */
+    if (n > 0) {
+        SDL_memcpy(tail, pixel, n * sizeof (Uint32));
+        _mm_storeu_si128((__m128i *) tail, TrianglePixelsSSE2(t, x, _mm_loadu_si128((const __m128i *) tail)));
+        SDL_memcpy(pixel, tail, n * sizeof (Uint32));
+    }
+}
+#endif /* HAVE_SSE2_INTRINSICS */
+
+#if HAVE_NEON_INTRINSICS
+/* x / 255, exactly, for x up to 255 * 255 */
+static SDL_INLINE uint16x8_t
+TriangleDiv255NEON(uint16x8_t x)
+{
+    return vshrq_n_u16(vaddq_u16(x, vaddq_u16(vshrq_n_u16(x, 8), vdupq_n_u16(1))), 8);
+}
+
+#define TRI_MUL_NEON(a, b) TriangleDiv255NEON(vmulq_u16(a, b))
+#define TRI_PACK_NEON(lo, hi) vcombine_u16(vmovn_u32(lo), vmovn_u32(hi))
+
+static SDL_INLINE uint32x4_t
+TriangleChannelNEON(uint32x4_t pixels, int shift)
+{
+    return vandq_u32(vshlq_u32(pixels, vdupq_n_s32(-shift)), vdupq_n_u32(0xFF));
+}
+
+static SDL_INLINE float32x4_t
+TriangleClampedNEON(const TriangleState *t, int attribute, float32x4_t fx, float max)
+{
+    const float32x4_t value = vaddq_f32(vdupq_n_f32(t->row[attribute]), vmulq_f32(vdupq_n_f32(t->dx[attribute]), fx));
+    return vminq_f32(vmaxq_f32(value, vdupq_n_f32(0.0f)), vdupq_n_f32(max));
+}
+
+static SDL_INLINE uint32x4_t
+TriangleAttributeNEON(const TriangleState *t, int attribute, float32x4_t fx, float max)
+{
+    return vcvtq_u32_f32(TriangleClampedNEON(t, attribute, fx, max));
+}
+
+static uint32x4_t
+TriangleTexelsNEON(const TriangleState *t, float32x4_t fx)
+{
+    const SDL_Surface *texture = t->texture;
+    uint32_t u[4], v[4], texel[4];
+    int i;
+
+    vst1q_u32(u, TriangleAttributeNEON(t, TRI_U, fx, t->max_u));
+    vst1q_u32(v, TriangleAttributeNEON(t, TRI_V, fx, t->max_v));
+    for (i = 0; i < 4; i++) {
+        texel[i] = TRI_TEXEL32(texture, u[i], v[i]);
+    }
+    return vld1q_u32(texel);
+}
+
+static SDL_INLINE uint16x8_t
+TriangleLerpNEON(uint16x8_t a, uint16x8_t b, uint16x8_t w)
+{
+    const uint16x8_t invw = vsubq_u16(vdupq_n_u16(256), w);
+    return vshrq_n_u16(vaddq_u16(vaddq_u16(vmulq_u16(a, invw), vmulq_u16(b, w)), vdupq_n_u16(128)), 8);
+}
+
+/* Splits the four 32-bit weights in w into one per channel of the first
+   two texels (lo) and of the last two (hi). */
+static SDL_INLINE void
+TriangleSpreadWeightsNEON(uint32x4_t w, uint16x8_t *lo, uint16x8_t *hi)
+{
+    const uint16x4_t w4 = vmovn_u32(w);
+    const uint16x4x2_t pairs = vzip_u16(w4, w4);
+    const uint16x4x2_t first = vzip_u16(pairs.val[0], pairs.val[0]);
+    const uint16x4x2_t last = vzip_u16(pairs.val[1], pairs.val[1]);
+    *lo = vcombine_u16(first.val[0], first.val[1]);
+    *hi = vcombine_u16(last.val[0], last.val[1]);
+}
+
+#define TRI_TEXELS_LO_NEON(texels) vmovl_u8(vget_low_u8(vreinterpretq_u8_u32(texels)))
+#define TRI_TEXELS_HI_NEON(texels) vmovl_u8(vget_high_u8(vreinterpretq_u8_u32(texels)))
+
+/* Filters the four texels around each sample. Their channels get filtered
+   in place, so the result is laid out like the texture's pixels. */
+static uint32x4_t
+TriangleTexelsLinearNEON(const TriangleState *t, float32x4_t fx)
+{
+    const SDL_Surface *texture = t->texture;
+    const float32x4_t u = TriangleClampedNEON(t, TRI_U, fx, t->max_u);
+    const float32x4_t v = TriangleClampedNEON(t, TRI_V, fx, t->max_v);
+    const uint32x4_t u0 = vcvtq_u32_f32(u);
+    const uint32x4_t v0 = vcvtq_u32_f32(v);
+    const uint32x4_t u1 = vsubq_u32(u0, vcltq_u32(u0, vdupq_n_u32((uint32_t) (texture->w - 1))));
+    const uint32x4_t v1 = vsubq_u32(v0, vcltq_u32(v0, vdupq_n_u32((uint32_t) (texture->h - 1))));
+    const float32x4_t scale = vdupq_n_f32(256.0f);
+    uint16x8_t wulo, wuhi, wvlo, wvhi, lo, hi;
+    uint32x4_t t00, t10, t01, t11;
+    uint32_t x0[4], x1[4], y0[4], y1[4], texel[4][4];
+    int i;
+
+    TriangleSpreadWeightsNEON(vcvtq_u32_f32(vmulq_f32(vsubq_f32(u, vcvtq_f32_u32(u0)), scale)), &wulo, &wuhi);
+    TriangleSpreadWeightsNEON(vcvtq_u32_f32(vmulq_f32(vsubq_f32(v, vcvtq_f32_u32(v0)), scale)), &wvlo, &wvhi);
+
+    vst1q_u32(x0, u0);
+    vst1q_u32(x1, u1);
+    vst1q_u32(y0, v0);
+    vst1q_u32(y1, v1);
+    for (i = 0; i < 4; i++) {
+        texel[0][i] = TRI_TEXEL32(texture, x0[i], y0[i]);
+        texel[1][i] = TRI_TEXEL32(texture, x1[i], y0[i]);
+        texel[2][i] = TRI_TEXEL32(texture, x0[i], y1[i]);
+        texel[3][i] = TRI_TEXEL32(texture, x1[i], y1[i]);
+    }
+    t00 = vld1q_u32(texel[0]);
+    t10 = vld1q_u32(texel[1]);
+    t01 = vld1q_u32(texel[2]);
+    t11 = vld1q_u32(texel[3]);
+
+    lo = TriangleLerpNEON(TriangleLerpNEON(TRI_TEXELS_LO_NEON(t00), TRI_TEXELS_LO_NEON(t10), wulo),
+                          TriangleLerpNEON(TRI_TEXELS_LO_NEON(t01), TRI_TEXELS_LO_NEON(t11), wulo), wvlo);
+    hi = TriangleLerpNEON(TriangleLerpNEON(TRI_TEXELS_HI_NEON(t00), TRI_TEXELS_HI_NEON(t10), wuhi),
+                          TriangleLerpNEON(TRI_TEXELS_HI_NEON(t01), TRI_TEXELS_HI_NEON(t11), wuhi), wvhi);
+    return vreinterpretq_u32_u8(vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+}
+
+static uint32x4_t
+TrianglePixelsNEON(const TriangleState *t, int x, uint32x4_t pixels)
+{
+    static const int32_t lanes[4] = { 0, 1, 2, 3 };
+    const uint16x8_t max = vdupq_n_u16(0xFF);
+    const float32x4_t fx = vcvtq_f32_s32(vaddq_s32(vdupq_n_s32(x - t->x0), vld1q_s32(lanes)));
+    uint16x8_t rg, ba, drg, dba, sa, inva;
+
+    if (t->modulate) {
+        rg = TRI_PACK_NEON(TriangleAttributeNEON(t, TRI_R, fx, 255.0f), TriangleAttributeNEON(t, TRI_G, fx, 255.0f));
+        ba = TRI_PACK_NEON(TriangleAttributeNEON(t, TRI_B, fx, 255.0f), TriangleAttributeNEON(t, TRI_A, fx, 255.0f));
+    } else {
+        rg = max;
+        ba = max;
+    }
+
+    if (t->texture) {
+        const uint32x4_t texels = t->linear ? TriangleTexelsLinearNEON(t, fx) : TriangleTexelsNEON(t, fx);
+        const uint16x8_t trg = TRI_PACK_NEON(TriangleChannelNEON(texels, t->texture_shift[0]),
+                                             TriangleChannelNEON(texels, t->texture_shift[1]));
+        const uint16x8_t tba = TRI_PACK_NEON(TriangleChannelNEON(texels, t->texture_shift[2]),
+                                             t->texture_alpha ? TriangleChannelNEON(texels, t->texture_shift[3]) : vdupq_n_u32(0xFF));
+        rg = t->modulate ? TRI_MUL_NEON(rg, trg) : trg;
+        ba = t->modulate ? TRI_MUL_NEON(ba, tba) : tba;
+    }
+
+    drg = TRI_PACK_NEON(TriangleChannelNEON(pixels, t->dst_shift[0]), TriangleChannelNEON(pixels, t->dst_shift[1]));
+    dba = TRI_PACK_NEON(TriangleChannelNEON(pixels, t->dst_shift[2]),
+                        t->dst_alpha ? TriangleChannelNEON(pixels, t->dst_shift[3]) : vdupq_n_u32(0xFF));
+    sa = vcombine_u16(vget_high_u16(ba), vget_high_u16(ba));
+    inva = vsubq_u16(max, sa);
+
+    switch (t->blend) {
+    case SDL_BLENDMODE_BLEND:
+        rg = vaddq_u16(TRI_MUL_NEON(drg, inva), TRI_MUL_NEON(rg, sa));
+        ba = vaddq_u16(TRI_MUL_NEON(dba, inva), TRI_MUL_NEON(ba, vcombine_u16(vget_low_u16(sa), vget_low_u16(max))));
+        break;
+    case SDL_BLENDMODE_ADD:
+        rg = vminq_u16(vaddq_u16(drg, TRI_MUL_NEON(rg, sa)), max);
+        ba = vminq_u16(vaddq_u16(dba, TRI_MUL_NEON(ba, sa)), max);
+        ba = vcombine_u16(vget_low_u16(ba), vget_high_u16(dba));
+        break;
+    case SDL_BLENDMODE_MOD:
+        rg = TRI_MUL_NEON(drg, rg);
+        ba = vcombine_u16(vget_low_u16(TRI_MUL_NEON(dba, ba)), vget_high_u16(dba));
+        break;
+    case SDL_BLENDMODE_MUL:
+        rg = vminq_u16(vaddq_u16(TRI_MUL_NEON(drg, rg), TRI_MUL_NEON(drg, inva)), max);
+        ba = vminq_u16(vaddq_u16(TRI_MUL_NEON(dba, ba), TRI_MUL_NEON(dba, inva)), max);
+        break;
+    default:
+        break;
+    }
+
+    pixels = vorrq_u32(vshlq_u32(vmovl_u16(vget_low_u16(rg)), vdupq_n_s32(t->dst_shift[0])),
+                       vshlq_u32(vmovl_u16(vget_high_u16(rg)), vdupq_n_s32(t->dst_shift[1])));
+    pixels = vorrq_u32(pixels, vshlq_u32(vmovl_u16(vget_low_u16(ba)), vdupq_n_s32(t->dst_shift[2])));
+    if (t->dst_alpha) {
+        pixels = vorrq_u32(pixels, vshlq_u32(vmovl_u16(vget_high_u16(ba)), vdupq_n_s32(t->dst_shift[3])));
+    }
+    return pixels;
+}
+
+static void
+TriangleSpanNEON(const TriangleState *t, int y, int x, int n)
+{
+    Uint32 *pixel = (Uint32 *) ((Uint8 *) t->dst->pixels + y * t->dst->pitch) + x;
+    Uint32 tail[4] = { 0, 0, 0, 0 };
+
+    for (; n >= 4; n -= 4, x += 4, pixel += 4) {
+        vst1q_u32(pixel, TrianglePixelsNEON(t, x, vld1q_u32(pixel)));
+    }
+
+    /* The last few pixels go through a copy, so nothing past the span is touched. */
+    if (n > 0) {
+        SDL_memcpy(tail, pixel, n * sizeof (Uint32));
+        vst1q_u32(tail, TrianglePixelsNEON(t, x, vld1q_u32(tail)));
+        SDL_memcpy(pixel, tail, n * sizeof (Uint32));
+    }
+}
+#endif /* HAVE_NEON_INTRINSICS */
+
+static void
+TriangleDraw(TriangleState *t, TriangleSpanFunc span, const SDL_TriangleVertex *vertices)
+{
+    const SDL_Rect *clip = &t->dst->clip_rect;
+    const SDL_TriangleVertex *v[3];
+    Sint64 x[3], y[3];
+    Sint64 area, minx, miny, maxx, maxy;
+    TriangleEdge edges[3];
+    double det, x1, y1, x2, y2, cx, cy;
+    int left, right, top, bottom;
+    int i, row;
+
+    for (i = 0; i < 3; i++) {
+        v[i] = &vertices[i];
+        x[i] = TriangleSnap(vertices[i].x);
+        y[i] = TriangleSnap(vertices[i].y);
+    }
+
+    area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+    if (area == 0) {
+        return;
+    }
+    if (area < 0) {
+        /* Wind the other way, so the inside is always where the edge functions are positive. */
+        const SDL_TriangleVertex *vertex = v[1];
+        Sint64 tmp;
+        v[1] = v[2];
+        v[2] = vertex;
+        tmp = x[1]; x[1] = x[2]; x[2] = tmp;
+        tmp = y[1]; y[1] = y[2]; y[2] = tmp;
+        area = -area;
+    }
+
+    minx = SDL_min(x[0], SDL_min(x[1], x[2]));
+    maxx = SDL_max(x[0], SDL_max(x[1], x[2]));
+    miny = SDL_min(y[0], SDL_min(y[1], y[2]));
+    maxy = SDL_max(y[0], SDL_max(y[1], y[2]));
+    t->x0 = (int) TriangleFloorDiv(minx, TRI_SUBPIXEL);
+    t->y0 = (int) TriangleFloorDiv(miny, TRI_SUBPIXEL);
+    left = SDL_max(t->x0, clip->x);
+    top = SDL_max(t->y0, clip->y);
+    right = (int) SDL_min(TriangleFloorDiv(maxx, TRI_SUBPIXEL), clip->x + clip->w - 1);
+    bottom = (int) SDL_min(TriangleFloorDiv(maxy, TRI_SUBPIXEL), clip->y + clip->h - 1);
+    if (left > right || top > bottom) {
+        return;
+    }
+
+    /* Multiplying by white changes nothing, which is how rotated copies come in. */
+    t->modulate = SDL_TRUE;
+    if (t->texture) {
+        t->modulate = SDL_FALSE;
+        for (i = 0; i < 3; i++) {
+            const SDL_Color *color = &v[i]->color;
+            if ((color->r & color->g & color->b & color->a) != 0xFF) {
+                t->modulate = SDL_TRUE;
+            }
+        }
+    }
+
+    for (i = 0; i < 3; i++) {
+        const int j = (i + 1) % 3;
+        TriangleEdge *edge = &edges[i];
+        edge->a = y[i] - y[j];
+        edge->b = x[j] - x[i];
+        edge->c = -(edge->a * x[i] + edge->b * y[i]);
+        /* Only top and left edges keep the centers right on them. */
+        if (edge->a < 0 || (edge->a == 0 && edge->b <= 0)) {
+            edge->c -= 1;
+        }
+    }
+
+    /* Set up the planes the attributes lie on, relative to the center of pixel (x0, y0). */
+    det = (double) area / (TRI_SUBPIXEL * TRI_SUBPIXEL);
+    x1 = (double) (x[1] - x[0]) / TRI_SUBPIXEL;
+    y1 = (double) (y[1] - y[0]) / TRI_SUBPIXEL;
+    x2 = (double) (x[2] - x[0]) / TRI_SUBPIXEL;
+    y2 = (double) (y[2] - y[0]) / TRI_SUBPIXEL;
+    cx = (t->x0 + 0.5) - (double) x[0] / TRI_SUBPIXEL;
+    cy = (t->y0 + 0.5) - (double) y[0] / TRI_SUBPIXEL;
+    for (i = 0; i < t->num_attributes; i++) {
+        const double a0 = TriangleAttribute(v[0], i);
+        const double a1 = TriangleAttribute(v[1], i) - a0;
+        const double a2 = TriangleAttribute(v[2], i) - a0;
+        const double dx = (a1 * y2 - a2 * y1) / det;
+        const double dy = (a2 * x1 - a1 * x2) / det;
+        /* Colors are rounded to the nearest value. Texels are sampled where the
+           center falls, or filtered between the texel centers around it. */
+        const double bias = (i < TRI_U) ? 0.5 : t->linear ? -0.5 : 0.0;
+        t->start[i] = (float) (a0 + dx * cx + dy * cy + bias);
+        t->dx[i] = (float) dx;
+        t->dy[i] = (float) dy;
+    }
+
+    for (row = top; row <= bottom; row++) {
+        const Sint64 sy = (Sint64) row * TRI_SUBPIXEL + TRI_HALF_PIXEL;
+        Sint64 first = left;
+        Sint64 last = right;
+
+        /* Find the pixels x whose centers sx = x * 16 + 8 have a * sx + k >= 0 for every edge. */
+        for (i = 0; i < 3; i++) {
+            const TriangleEdge *edge = &edges[i];
+            const Sint64 k = edge->b * sy + edge->c;
+            if (edge->a > 0) {
+                first = SDL_max(first, -TriangleFloorDiv(k + edge->a * TRI_HALF_PIXEL, edge->a * TRI_SUBPIXEL));
+            } else if (edge->a < 0) {
+                last = SDL_min(last, TriangleFloorDiv(k + edge->a * TRI_HALF_PIXEL, -edge->a * TRI_SUBPIXEL));
+            } else if (k < 0) {
+                last = first - 1;
+            }
+        }
+
+        if (first <= last) {
+            for (i = 0; i < t->num_attributes; i++) {
+                t->row[i] = t->start[i] + t->dy[i] * (float) (row - t->y0);
+            }
+            span(t, row, (int) first, (int) (last - first + 1));
+        }
+    }
+}
+
+SDL_bool
+SDL_GetTrianglesBounds(const SDL_TriangleVertex * vertices, int count, SDL_Rect * bounds)
+{
+    Sint64 minx, miny, maxx, maxy;
+    int i;
+
+    count -= count % 3;
+    if (count <= 0) {
+        return SDL_FALSE;
+    }
+
+    minx = maxx = TriangleSnap(vertices[0].x);
+    miny = maxy = TriangleSnap(vertices[0].y);
+    for (i = 1; i < count; i++) {
+        const Sint64 x = TriangleSnap(vertices[i].x);
+        const Sint64 y = TriangleSnap(vertices[i].y);
+        minx = SDL_min(minx, x);
+        maxx = SDL_max(maxx, x);
+        miny = SDL_min(miny, y);
+        maxy = SDL_max(maxy, y);
+    }
+
+    bounds->x = (int) TriangleFloorDiv(minx, TRI_SUBPIXEL);
+    bounds->y = (int) TriangleFloorDiv(miny, TRI_SUBPIXEL);
+    bounds->w = (int) TriangleFloorDiv(maxx, TRI_SUBPIXEL) - bounds->x + 1;
+    bounds->h = (int) TriangleFloorDiv(maxy, TRI_SUBPIXEL) - bounds->y + 1;
+    return SDL_TRUE;
+}
+
+int
+SDL_FillTriangles(SDL_Surface * dst, SDL_Surface * texture, const SDL_TriangleVertex * vertices, int count,
+                  SDL_BlendMode blendMode, SDL_ScaleMode scaleMode)
+{
+    TriangleState t;
+    TriangleSpanFunc span = TriangleSpan;
+    int i;
+
+    if (!dst) {
+        return SDL_SetError("Passed NULL destination surface");
+    }
+
+    /* This function doesn't work on surfaces < 8 bpp */
+    if (dst->format->BitsPerPixel < 8 || (texture && texture->format->BitsPerPixel < 8)) {
+        return SDL_SetError("SDL_FillTriangles(): Unsupported surface format");
+    }
+
+    if (texture && (texture->w <= 0 || texture->h <= 0)) {
+        return 0;
+    }
+
+    SDL_zero(t);
+    t.dst = dst;
+    t.texture = texture;
+    t.blend = blendMode;
+    t.linear = (texture && scaleMode != SDL_ScaleModeNearest) ? SDL_TRUE : SDL_FALSE;
+    t.num_attributes = texture ? TRI_NUM_ATTRIBUTES : TRI_U;
+    if (texture) {
+        t.max_u = (float) (texture->w - 1);
+        t.max_v = (float) (texture->h - 1);
+    }
+
+    if (TriangleIs8888(dst->format, t.dst_shift, &t.dst_alpha) &&
+        (!texture || TriangleIs8888(texture->format, t.texture_shift, &t.texture_alpha))) {
+#if HAVE_SSE2_INTRINSICS
+        if (SDL_HasSSE2()) {
+            span = TriangleSpanSSE2;
+        }
+#endif
+#if HAVE_NEON_INTRINSICS
+        if (SDL_HasNEON()) {
+            span = TriangleSpanNEON;
+        }
+#endif
+    }
+
+    if (texture && SDL_MUSTLOCK(texture)) {
+        if (SDL_LockSurface(texture) < 0) {
+            return -1;
+        }
+    }
+
+    for (i = 0; i + 2 < count; i += 3) {
+        TriangleDraw(&t, span, &vertices[i]);
+    }
+
+    if (texture && SDL_MUSTLOCK(texture)) {
+        SDL_UnlockSurface(texture);
+    }
+    return 0;
+}
+
+#endif /* SDL_VIDEO_RENDER_SW && !SDL_RENDER_DISABLED */
+
+/* vi: set ts=4 sw=4 expandtab: */
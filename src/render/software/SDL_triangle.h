@@ -19,14 +19,24 @@
   3. This notice may not be removed or altered from any source distribution.
 */
 
-#ifndef SDL_rotate_h_
-#define SDL_rotate_h_
+#ifndef SDL_triangle_h_
+#define SDL_triangle_h_
 
-#ifndef MIN
-#define MIN(a,b)    (((a) < (b)) ? (a) : (b))
-#endif
+#include "../../SDL_internal.h"
 
-extern SDL_Surface *SDLgfx_rotateSurface(SDL_Surface * src, double angle, int centerx, int centery, int smooth, int flipx, int flipy, int dstwidth, int dstheight, double cangle, double sangle);
-extern void SDLgfx_rotozoomSurfaceSizeTrig(int width, int height, double angle, int *dstwidth, int *dstheight, double *cangle, double *sangle);
+#include "SDL_render.h"
 
-#endif /* SDL_rotate_h_ */
+typedef struct
+{
+    float x, y;         /* position on the destination, in pixels */
+    float u, v;         /* position on the texture, in texels */
+    SDL_Color color;    /* multiplies the texture, or is drawn as is without one */
+} SDL_TriangleVertex;
+
+extern SDL_bool SDL_GetTrianglesBounds(const SDL_TriangleVertex * vertices, int count, SDL_Rect * bounds);
+extern int SDL_FillTriangles(SDL_Surface * dst, SDL_Surface * texture, const SDL_TriangleVertex * vertices, int count,
+                             SDL_BlendMode blendMode, SDL_ScaleMode scaleMode);
+
+#endif /* SDL_triangle_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -34,9 +34,10 @@ typedef struct _SDL_Timer
 {
     int timerID;
     SDL_TimerCallback callback;
+    SDL_TimerCallbackNS callback_ns;
     void *param;
-    Uint32 interval;
-    Uint32 scheduled;
+    Uint64 interval;    /* In nanoseconds */
+    Uint64 scheduled;   /* In nanoseconds, see SDL_GetTimerTicksNS() */
     SDL_atomic_t canceled;
     struct _SDL_Timer *next;
 } SDL_Timer;
@@ -48,12 +49,17 @@ typedef struct _SDL_TimerMap
     struct _SDL_TimerMap *next;
 } SDL_TimerMap;
 
-/* The timers are kept in a sorted list */
+/* The initial number of timer map buckets, must be a power of 2 */
+#define SDL_TIMERMAP_INITIAL_SIZE   64
+
+/* The timers are kept in a binary heap */
 typedef struct {
     /* Data used by the main thread */
     SDL_Thread *thread;
     SDL_atomic_t nextID;
-    SDL_TimerMap *timermap;
+    SDL_TimerMap **timermap;    /* Hash table of timer IDs, chained per bucket */
+    int timermap_size;
+    int timermap_count;
     SDL_mutex *timermap_lock;
 
     /* Padding to separate cache lines between threads */
@@ -66,37 +72,87 @@ typedef struct {
     SDL_Timer *freelist;
     SDL_atomic_t active;
 
-    /* List of timers - this is only touched by the timer thread */
-    SDL_Timer *timers;
+    /* Heap of timers, earliest first - this is only touched by the timer thread */
+    SDL_Timer **timers;
+    int num_timers;
+    int max_timers;
 } SDL_TimerData;
 
 static SDL_TimerData SDL_timer_data;
 
 /* The idea here is that any thread might add a timer, but a single
- * thread manages the active timer queue, sorted by scheduling time.
+ * thread manages the active timer queue, ordered by scheduling time.
  *
  * Timers are removed by simply setting a canceled flag
  */
 
-static void
+#define TIMER_BEFORE(A, B) ((A)->scheduled < (B)->scheduled)
+
+/* Timers that fire less than this far in the future are waited for with
+   SDL_DelayNS() instead of the semaphore, which only has millisecond precision.
+ */
+#define SDL_PRECISE_WAIT_NS     (2 * SDL_NS_PER_MS)
+
+/* Nanoseconds on the performance counter timeline, which doesn't wrap */
+static Uint64
+SDL_GetTimerTicksNS(void)
+{
+    const Uint64 counter = SDL_GetPerformanceCounter();
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+
+    return (counter / frequency) * SDL_NS_PER_SECOND +
+           ((counter % frequency) * SDL_NS_PER_SECOND) / frequency;
+}
+
+static SDL_bool
 SDL_AddTimerInternal(SDL_TimerData *data, SDL_Timer *timer)
 {
-    SDL_Timer *prev, *curr;
+    SDL_Timer **timers = data->timers;
+    int i, parent;
+
+    if (data->num_timers == data->max_timers) {
+        const int max_timers = data->max_timers ? (data->max_timers * 2) : 64;
+        timers = (SDL_Timer **)SDL_realloc(data->timers, max_timers * sizeof(*timers));
+        if (!timers) {
+            return SDL_FALSE;
+        }
+        data->timers = timers;
+        data->max_timers = max_timers;
+    }
 
-    prev = NULL;
-    for (curr = data->timers; curr; prev = curr, curr = curr->next) {
-        if ((Sint32)(timer->scheduled-curr->scheduled) < 0) {
+    /* Sift the new timer up from the bottom of the heap */
+    for (i = data->num_timers++; i > 0; i = parent) {
+        parent = (i - 1) / 2;
+        if (!TIMER_BEFORE(timer, timers[parent])) {
             break;
         }
+        timers[i] = timers[parent];
     }
+    timers[i] = timer;
+    return SDL_TRUE;
+}
 
-    /* Insert the timer here! */
-    if (prev) {
-        prev->next = timer;
-    } else {
-        data->timers = timer;
+static void
+SDL_RemoveFirstTimer(SDL_TimerData *data)
+{
+    SDL_Timer **timers = data->timers;
+    SDL_Timer *last = timers[--data->num_timers];
+    const int count = data->num_timers;
+    int i, child;
+
+    /* Sift the last timer down from the top of the heap */
+    for (i = 0; (child = 2 * i + 1) < count; i = child) {
+        if (child + 1 < count && TIMER_BEFORE(timers[child + 1], timers[child])) {
+            ++child;
+        }
+        if (!TIMER_BEFORE(timers[child], last)) {
+            break;
+        }
+        timers[i] = timers[child];
+    }
+    if (count > 0) {
+        timers[i] = last;
     }
-    timer->next = curr;
 }
 
 static int SDLCALL
@@ -107,7 +163,8 @@ SDL_TimerThread(void *_data)
     SDL_Timer *current;
     SDL_Timer *freelist_head = NULL;
     SDL_Timer *freelist_tail = NULL;
-    Uint32 tick, now, interval, delay;
+    Uint64 tick, interval, delay;
+    SDL_bool precise;
 
     /* Threaded timer loop:
      *  1. Queue timers added by other threads
@@ -130,77 +187,105 @@ SDL_TimerThread(void *_data)
         }
         SDL_AtomicUnlock(&data->lock);
 
-        /* Sort the pending timers into our list */
+        freelist_head = NULL;
+        freelist_tail = NULL;
+
+        /* Sort the pending timers into our heap */
         while (pending) {
             current = pending;
             pending = pending->next;
-            SDL_AddTimerInternal(data, current);
+            if (!SDL_AddTimerInternal(data, current)) {
+                /* Out of memory, drop the timer */
+                current->next = freelist_head;
+                freelist_head = current;
+                if (!freelist_tail) {
+                    freelist_tail = current;
+                }
+                SDL_AtomicSet(&current->canceled, 1);
+            }
         }
-        freelist_head = NULL;
-        freelist_tail = NULL;
 
         /* Check to see if we're still running, after maintenance */
         if (!SDL_AtomicGet(&data->active)) {
             break;
         }
 
-        /* Initial delay if there are no timers */
-        delay = SDL_MUTEX_MAXWAIT;
+        delay = 0;
+        precise = SDL_FALSE;
 
-        tick = SDL_GetTicks();
+        tick = SDL_GetTimerTicksNS();
 
         /* Process all the pending timers for this tick */
-        while (data->timers) {
-            current = data->timers;
+        while (data->num_timers > 0) {
+            current = data->timers[0];
 
-            if ((Sint32)(tick-current->scheduled) < 0) {
+            if (tick < current->scheduled) {
                 /* Scheduled for the future, wait a bit */
                 delay = (current->scheduled - tick);
+                precise = current->callback_ns ? SDL_TRUE : SDL_FALSE;
                 break;
             }
 
             /* We're going to do something with this timer */
-            data->timers = current->next;
+            SDL_RemoveFirstTimer(data);
 
             if (SDL_AtomicGet(&current->canceled)) {
                 interval = 0;
+            } else if (current->callback_ns) {
+                interval = current->callback_ns(current->interval, current->param);
             } else {
-                interval = current->callback(current->interval, current->param);
+                interval = (Uint64)current->callback((Uint32)(current->interval / SDL_NS_PER_MS), current->param) * SDL_NS_PER_MS;
             }
 
             if (interval > 0) {
-                /* Reschedule this timer */
+                /* Reschedule this timer, it just left the heap so there's room for it */
                 current->interval = interval;
-                current->scheduled = tick + interval;
+                if (current->callback_ns && (tick - current->scheduled) < interval) {
+                    /* Keep a steady rate, so wakeup latency doesn't accumulate */
+                    current->scheduled += interval;
+                } else {
+                    current->scheduled = tick + interval;
+                }
                 SDL_AddTimerInternal(data, current);
             } else {
-                if (!freelist_head) {
-                    freelist_head = current;
-                }
-                if (freelist_tail) {
-                    freelist_tail->next = current;
+                current->next = freelist_head;
+                freelist_head = current;
+                if (!freelist_tail) {
+                    freelist_tail = current;
                 }
-                freelist_tail = current;
 
                 SDL_AtomicSet(&current->canceled, 1);
             }
         }
 
+        /* Note that each time a timer is added, this will return
+           immediately, but we process the timers added all at once.
+           That's okay, it just means we run through the loop a few
+           extra times.
+         */
+        if (data->num_timers == 0) {
+            /* No timers, wait until one is added */
+            SDL_SemWait(data->sem);
+            continue;
+        }
+
         /* Adjust the delay based on processing time */
-        now = SDL_GetTicks();
-        interval = (now - tick);
+        interval = SDL_GetTimerTicksNS() - tick;
         if (interval > delay) {
             delay = 0;
         } else {
             delay -= interval;
         }
 
-        /* Note that each time a timer is added, this will return
-           immediately, but we process the timers added all at once.
-           That's okay, it just means we run through the loop a few
-           extra times.
-         */
-        SDL_SemWaitTimeout(data->sem, delay);
+        if (!precise) {
+            /* Millisecond timers fire on the millisecond, like SDL_GetTicks() */
+            SDL_SemWaitTimeout(data->sem, (Uint32)((delay + SDL_NS_PER_MS - 1) / SDL_NS_PER_MS));
+        } else if (delay >= SDL_PRECISE_WAIT_NS) {
+            /* Wake up a bit early and finish the wait precisely */
+            SDL_SemWaitTimeout(data->sem, (Uint32)((delay - SDL_PRECISE_WAIT_NS) / SDL_NS_PER_MS) + 1);
+        } else if (SDL_SemTryWait(data->sem) != 0) {
+            SDL_DelayNS(delay);
+        }
     }
     return 0;
 }
@@ -217,9 +302,21 @@ SDL_TimerInit(void)
             return -1;
         }
 
+        data->timermap = (SDL_TimerMap **)SDL_calloc(SDL_TIMERMAP_INITIAL_SIZE, sizeof(*data->timermap));
+        if (!data->timermap) {
+            SDL_DestroyMutex(data->timermap_lock);
+            data->timermap_lock = NULL;
+            return SDL_OutOfMemory();
+        }
+        data->timermap_size = SDL_TIMERMAP_INITIAL_SIZE;
+        data->timermap_count = 0;
+
         data->sem = SDL_CreateSemaphore(0);
         if (!data->sem) {
+            SDL_free(data->timermap);
+            data->timermap = NULL;
             SDL_DestroyMutex(data->timermap_lock);
+            data->timermap_lock = NULL;
             return -1;
         }
 
@@ -243,6 +340,7 @@ SDL_TimerQuit(void)
     SDL_TimerData *data = &SDL_timer_data;
     SDL_Timer *timer;
     SDL_TimerMap *entry;
+    int i;
 
     if (SDL_AtomicCAS(&data->active, 1, 0)) {  /* active? Move to inactive. */
         /* Shutdown the timer thread */
@@ -256,29 +354,64 @@ SDL_TimerQuit(void)
         data->sem = NULL;
 
         /* Clean up the timer entries */
-        while (data->timers) {
-            timer = data->timers;
-            data->timers = timer->next;
-            SDL_free(timer);
+        for (i = 0; i < data->num_timers; ++i) {
+            SDL_free(data->timers[i]);
         }
+        SDL_free(data->timers);
+        data->timers = NULL;
+        data->num_timers = 0;
+        data->max_timers = 0;
         while (data->freelist) {
             timer = data->freelist;
             data->freelist = timer->next;
             SDL_free(timer);
         }
-        while (data->timermap) {
-            entry = data->timermap;
-            data->timermap = entry->next;
-            SDL_free(entry);
+        for (i = 0; i < data->timermap_size; ++i) {
+            while (data->timermap[i]) {
+                entry = data->timermap[i];
+                data->timermap[i] = entry->next;
+                SDL_free(entry);
+            }
         }
+        SDL_free(data->timermap);
+        data->timermap = NULL;
+        data->timermap_size = 0;
+        data->timermap_count = 0;
 
         SDL_DestroyMutex(data->timermap_lock);
         data->timermap_lock = NULL;
     }
 }
 
-SDL_TimerID
-SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
+/* Double the number of timer map buckets -- called with the timer map locked */
+static void
+SDL_GrowTimerMap(SDL_TimerData *data)
+{
+    const int size = data->timermap_size * 2;
+    SDL_TimerMap **timermap;
+    SDL_TimerMap *entry, *next;
+    int i;
+
+    timermap = (SDL_TimerMap **)SDL_calloc(size, sizeof(*timermap));
+    if (!timermap) {
+        /* Keep using the smaller table, lookups just get slower */
+        return;
+    }
+
+    for (i = 0; i < data->timermap_size; ++i) {
+        for (entry = data->timermap[i]; entry; entry = next) {
+            next = entry->next;
+            entry->next = timermap[entry->timerID & (size - 1)];
+            timermap[entry->timerID & (size - 1)] = entry;
+        }
+    }
+    SDL_free(data->timermap);
+    data->timermap = timermap;
+    data->timermap_size = size;
+}
+
+static SDL_TimerID
+SDL_AddTimerInternalNS(Uint64 interval, SDL_TimerCallback callback, SDL_TimerCallbackNS callback_ns, void *param)
 {
     SDL_TimerData *data = &SDL_timer_data;
     SDL_Timer *timer;
@@ -309,9 +442,10 @@ SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
     }
     timer->timerID = SDL_AtomicIncRef(&data->nextID);
     timer->callback = callback;
+    timer->callback_ns = callback_ns;
     timer->param = param;
     timer->interval = interval;
-    timer->scheduled = SDL_GetTicks() + interval;
+    timer->scheduled = SDL_GetTimerTicksNS() + interval;
     SDL_AtomicSet(&timer->canceled, 0);
 
     entry = (SDL_TimerMap *)SDL_malloc(sizeof(*entry));
@@ -324,8 +458,12 @@ SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
     entry->timerID = timer->timerID;
 
     SDL_LockMutex(data->timermap_lock);
-    entry->next = data->timermap;
-    data->timermap = entry;
+    if (data->timermap_count >= data->timermap_size) {
+        SDL_GrowTimerMap(data);
+    }
+    entry->next = data->timermap[entry->timerID & (data->timermap_size - 1)];
+    data->timermap[entry->timerID & (data->timermap_size - 1)] = entry;
+    ++data->timermap_count;
     SDL_UnlockMutex(data->timermap_lock);
 
     /* Add the timer to the pending list for the timer thread */
@@ -340,24 +478,40 @@ SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
     return entry->timerID;
 }
 
+SDL_TimerID
+SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
+{
+    return SDL_AddTimerInternalNS((Uint64)interval * SDL_NS_PER_MS, callback, NULL, param);
+}
+
+SDL_TimerID
+SDL_AddTimerNS(Uint64 interval, SDL_TimerCallbackNS callback, void *param)
+{
+    return SDL_AddTimerInternalNS(interval, NULL, callback, param);
+}
+
 SDL_bool
 SDL_RemoveTimer(SDL_TimerID id)
 {
     SDL_TimerData *data = &SDL_timer_data;
-    SDL_TimerMap *prev, *entry;
+    SDL_TimerMap *prev, *entry = NULL;
     SDL_bool canceled = SDL_FALSE;
 
     /* Find the timer */
     SDL_LockMutex(data->timermap_lock);
-    prev = NULL;
-    for (entry = data->timermap; entry; prev = entry, entry = entry->next) {
-        if (entry->timerID == id) {
-            if (prev) {
-                prev->next = entry->next;
-            } else {
-                data->timermap = entry->next;
+    if (data->timermap) {
+        SDL_TimerMap **bucket = &data->timermap[id & (data->timermap_size - 1)];
+        prev = NULL;
+        for (entry = *bucket; entry; prev = entry, entry = entry->next) {
+            if (entry->timerID == id) {
+                if (prev) {
+                    prev->next = entry->next;
+                } else {
+                    *bucket = entry->next;
+                }
+                --data->timermap_count;
+                break;
             }
-            break;
         }
     }
     SDL_UnlockMutex(data->timermap_lock);
@@ -380,6 +534,9 @@ typedef struct _SDL_TimerMap
 {
     int timerID;
     int timeoutID;
+    SDL_TimerCallbackNS callback_ns;
+    void *param_ns;
+    Uint64 interval_ns;
     struct _SDL_TimerMap *next;
 } SDL_TimerMap;
 
@@ -406,6 +563,36 @@ SDL_Emscripten_TimerHelper(SDL_TimerMap *entry, Uint32 interval, SDL_TimerCallba
     }
 }
 
+/* Browser timers only have millisecond resolution, so nanosecond timers are
+   rounded up to the next millisecond and run through this callback */
+static Uint32 SDLCALL
+SDL_Emscripten_NSTimerCallback(Uint32 interval, void *param)
+{
+    SDL_TimerMap *entry = (SDL_TimerMap *)param;
+
+    entry->interval_ns = entry->callback_ns(entry->interval_ns, entry->param_ns);
+    return (Uint32)((entry->interval_ns + SDL_NS_PER_MS - 1) / SDL_NS_PER_MS);
+}
+
+static SDL_TimerID
+SDL_Emscripten_AddTimer(SDL_TimerMap *entry, Uint32 interval, SDL_TimerCallback callback, void *param)
+{
+    SDL_TimerData *data = &SDL_timer_data;
+
+    entry->timerID = ++data->nextID;
+
+    entry->timeoutID = EM_ASM_INT({
+        return Browser.safeSetTimeout(function() {
+            dynCall('viiii', $0, [$1, $2, $3, $4]);
+        }, $2);
+    }, &SDL_Emscripten_TimerHelper, entry, interval, callback, param);
+
+    entry->next = data->timermap;
+    data->timermap = entry;
+
+    return entry->timerID;
+}
+
 int
 SDL_TimerInit(void)
 {
@@ -428,26 +615,30 @@ SDL_TimerQuit(void)
 SDL_TimerID
 SDL_AddTimer(Uint32 interval, SDL_TimerCallback callback, void *param)
 {
-    SDL_TimerData *data = &SDL_timer_data;
     SDL_TimerMap *entry;
 
-    entry = (SDL_TimerMap *)SDL_malloc(sizeof(*entry));
+    entry = (SDL_TimerMap *)SDL_calloc(1, sizeof(*entry));
     if (!entry) {
         SDL_OutOfMemory();
         return 0;
     }
-    entry->timerID = ++data->nextID;
-
-    entry->timeoutID = EM_ASM_INT({
-        return Browser.safeSetTimeout(function() {
-            dynCall('viiii', $0, [$1, $2, $3, $4]);
-        }, $2);
-    }, &SDL_Emscripten_TimerHelper, entry, interval, callback, param);
+    return SDL_Emscripten_AddTimer(entry, interval, callback, param);
+}
 
-    entry->next = data->timermap;
-    data->timermap = entry;
+SDL_TimerID
+SDL_AddTimerNS(Uint64 interval, SDL_TimerCallbackNS callback, void *param)
+{
+    SDL_TimerMap *entry;
 
-    return entry->timerID;
+    entry = (SDL_TimerMap *)SDL_calloc(1, sizeof(*entry));
+    if (!entry) {
+        SDL_OutOfMemory();
+        return 0;
+    }
+    entry->callback_ns = callback;
+    entry->param_ns = param;
+    entry->interval_ns = interval;
+    return SDL_Emscripten_AddTimer(entry, (Uint32)((interval + SDL_NS_PER_MS - 1) / SDL_NS_PER_MS), SDL_Emscripten_NSTimerCallback, entry);
 }
 
 SDL_bool
@@ -482,4 +673,23 @@ SDL_RemoveTimer(SDL_TimerID id)
 
 #endif
 
+#ifndef SDL_TIMER_UNIX
+/* Sleep for the whole milliseconds, then spin on the performance counter */
+void
+SDL_DelayNS(Uint64 ns)
+{
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    const Uint64 start = SDL_GetPerformanceCounter();
+    const Uint64 ticks = (ns / SDL_NS_PER_SECOND) * frequency +
+                         ((ns % SDL_NS_PER_SECOND) * frequency) / SDL_NS_PER_SECOND;
+
+    if (ns >= SDL_NS_PER_MS) {
+        SDL_Delay((Uint32)(ns / SDL_NS_PER_MS));
+    }
+    while ((SDL_GetPerformanceCounter() - start) < ticks) {
+        /* spin */
+    }
+}
+#endif /* !SDL_TIMER_UNIX */
+
 /* vi: set ts=4 sw=4 expandtab: */
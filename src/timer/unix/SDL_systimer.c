@@ -237,6 +237,48 @@ SDL_Delay(Uint32 ms)
     } while (was_error && (errno == EINTR));
 }
 
+void
+SDL_DelayNS(Uint64 ns)
+{
+#if HAVE_NANOSLEEP
+    struct timespec elapsed, tv;
+    int was_error;
+#else
+    Uint64 then, now, elapsed;
+#endif
+
+#ifdef __EMSCRIPTEN__
+    if (emscripten_has_asyncify() && SDL_GetHintBoolean(SDL_HINT_EMSCRIPTEN_ASYNCIFY, SDL_TRUE)) {
+        /* pseudo-synchronous pause, only millisecond resolution is available */
+        emscripten_sleep((unsigned int)((ns + SDL_NS_PER_MS - 1) / SDL_NS_PER_MS));
+        return;
+    }
+#endif
+
+#if HAVE_NANOSLEEP
+    /* nanosleep() updates the remaining time if it's interrupted */
+    elapsed.tv_sec = (time_t)(ns / SDL_NS_PER_SECOND);
+    elapsed.tv_nsec = (long)(ns % SDL_NS_PER_SECOND);
+    do {
+        errno = 0;
+        tv.tv_sec = elapsed.tv_sec;
+        tv.tv_nsec = elapsed.tv_nsec;
+        was_error = nanosleep(&tv, &elapsed);
+    } while (was_error && (errno == EINTR));
+#else
+    /* Sleep for the whole milliseconds, then spin on the performance counter */
+    then = SDL_GetPerformanceCounter();
+    if (ns >= SDL_NS_PER_MS) {
+        SDL_Delay((Uint32)(ns / SDL_NS_PER_MS));
+    }
+    elapsed = (ns / SDL_NS_PER_SECOND) * SDL_GetPerformanceFrequency() +
+              ((ns % SDL_NS_PER_SECOND) * SDL_GetPerformanceFrequency()) / SDL_NS_PER_SECOND;
+    do {
+        now = SDL_GetPerformanceCounter();
+    } while ((now - then) < elapsed);
+#endif /* HAVE_NANOSLEEP */
+}
+
 #endif /* SDL_TIMER_UNIX */
 
 /* vi: set ts=4 sw=4 expandtab: */
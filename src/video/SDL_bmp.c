@@ -217,6 +217,17 @@ SDL_LoadBMP_RW(SDL_RWops * src, int freesrc)
         goto done;
     }
 
+    /* The headers, palettes and RLE data are read a few bytes at a time, so
+       buffer streams that aren't in memory already. */
+    if (SDL_RWGetMemory(src, NULL) == NULL) {
+        src = SDL_CreateBufferedRW(src, 0, freesrc);
+        freesrc = SDL_TRUE;
+        if (src == NULL) {
+            was_error = SDL_TRUE;
+            goto done;
+        }
+    }
+
     /* Read in the BMP file header */
     fp_offset = SDL_RWtell(src);
     SDL_ClearError();
@@ -0,0 +1,112 @@
+/*
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Feed a playback device with SDL_QueueAudio(), keeping a few callbacks'
+   worth of audio queued, with and without SDL_HINT_AUDIO_QUEUE_LOCKFREE.
+   Reports how long SDL_QueueAudio() calls take and how many times the
+   device ran out of queued audio. Run with SDL_AUDIODRIVER=dummy to measure
+   without audio hardware. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define TEST_SECONDS    5
+#define CHUNK_FRAMES    256
+#define QUEUED_CALLBACKS 4
+
+static SDL_bool
+RunQueueTest(const char *lockfree)
+{
+    static Sint16 chunk[CHUNK_FRAMES * 2];
+    SDL_AudioSpec desired, obtained;
+    SDL_AudioDeviceID dev;
+    Uint64 start, end, before, elapsed, worst = 0, total = 0;
+    Uint32 calls = 0;
+    int i;
+
+    SDL_SetHint(SDL_HINT_AUDIO_QUEUE_LOCKFREE, lockfree);
+
+    SDL_zero(desired);
+    desired.freq = 48000;
+    desired.format = AUDIO_S16SYS;
+    desired.channels = 2;
+    desired.samples = 512;
+    desired.callback = NULL;
+    dev = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+    if (!dev) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't open audio device: %s\n", SDL_GetError());
+        return SDL_FALSE;
+    }
+
+    for (i = 0; i < CHUNK_FRAMES; i++) {
+        const Sint16 sample = (Sint16) (SDL_sin(i * 2.0 * M_PI / CHUNK_FRAMES) * 8192.0);
+        chunk[i * 2] = sample;
+        chunk[i * 2 + 1] = sample;
+    }
+
+    /* Prime the queue, then keep it topped up while the device plays. */
+    while (SDL_GetQueuedAudioSize(dev) < obtained.size * QUEUED_CALLBACKS) {
+        SDL_QueueAudio(dev, chunk, sizeof (chunk));
+    }
+    SDL_PauseAudioDevice(dev, 0);
+
+    start = SDL_GetPerformanceCounter();
+    end = start + (SDL_GetPerformanceFrequency() * TEST_SECONDS);
+    while (SDL_GetPerformanceCounter() < end) {
+        if (SDL_GetQueuedAudioSize(dev) >= obtained.size * QUEUED_CALLBACKS) {
+            SDL_Delay(1);
+            continue;
+        }
+        before = SDL_GetPerformanceCounter();
+        if (SDL_QueueAudio(dev, chunk, sizeof (chunk)) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_QueueAudio failed: %s\n", SDL_GetError());
+        }
+        elapsed = SDL_GetPerformanceCounter() - before;
+        worst = SDL_max(worst, elapsed);
+        total += elapsed;
+        calls++;
+    }
+
+    SDL_Log("%-9s: %6u queue calls, %7.3f usec average, %8.3f usec worst, %u underruns\n",
+            (*lockfree == '0') ? "locked" : "lock-free", (unsigned) calls,
+            calls ? ((double) total * 1000000.0 / (double) SDL_GetPerformanceFrequency() / calls) : 0.0,
+            (double) worst * 1000000.0 / (double) SDL_GetPerformanceFrequency(),
+            (unsigned) SDL_GetQueuedAudioXruns(dev));
+
+    SDL_CloseAudioDevice(dev);
+    return SDL_TRUE;
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_bool ok = SDL_TRUE;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (SDL_Init(SDL_INIT_AUDIO) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Log("Queueing %d seconds of audio on the '%s' driver\n", TEST_SECONDS, SDL_GetCurrentAudioDriver());
+    ok &= RunQueueTest("0");
+    ok &= RunQueueTest("1");
+
+    SDL_Quit();
+    return ok ? 0 : 1;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
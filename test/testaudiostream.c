@@ -0,0 +1,101 @@
+/*
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Measure SDL_AudioStream conversion throughput for the streams games use
+   most: S16 stereo from a decoder or mixer, going to a float device. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define BENCHMARK_SECONDS   20
+#define MAX_PUT_FRAMES      48000
+
+static SDL_bool
+RunStreamTest(const int inrate, const SDL_AudioFormat dst_format, const int dst_channels,
+              const int outrate, const int put_frames)
+{
+    static Sint16 input[MAX_PUT_FRAMES * 2];
+    static float output[4096 * 8];
+    const int total_frames = inrate * BENCHMARK_SECONDS;
+    const int dst_frame_size = (SDL_AUDIO_BITSIZE(dst_format) / 8) * dst_channels;
+    const int readlen = (sizeof (output) / dst_frame_size) * dst_frame_size;
+    SDL_AudioStream *stream;
+    Uint64 start, elapsed;
+    int frames, got;
+    Sint64 outbytes = 0;
+    int i;
+
+    stream = SDL_NewAudioStream(AUDIO_S16SYS, 2, inrate, dst_format, dst_channels, outrate);
+    if (!stream) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create audio stream: %s\n", SDL_GetError());
+        return SDL_FALSE;
+    }
+
+    for (i = 0; i < put_frames; i++) {
+        const Sint16 sample = (Sint16) (SDL_sin(i * 2.0 * M_PI * 440.0 / inrate) * 16384.0);
+        input[i * 2] = sample;
+        input[i * 2 + 1] = -sample;
+    }
+
+    start = SDL_GetPerformanceCounter();
+    for (frames = 0; frames < total_frames; frames += put_frames) {
+        if (SDL_AudioStreamPut(stream, input, put_frames * 2 * sizeof (Sint16)) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_AudioStreamPut failed: %s\n", SDL_GetError());
+            SDL_FreeAudioStream(stream);
+            return SDL_FALSE;
+        }
+        while ((got = SDL_AudioStreamGet(stream, output, readlen)) > 0) {
+            outbytes += got;
+        }
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+    SDL_FreeAudioStream(stream);
+
+    SDL_Log("S16 stereo %5d Hz -> %s %d channels %5d Hz, %5d frame puts: %7.1fx realtime (%d frames out)\n",
+            inrate, (dst_format == AUDIO_F32SYS) ? "F32" : "S16", dst_channels, outrate, put_frames,
+            (double) BENCHMARK_SECONDS * SDL_GetPerformanceFrequency() / (double) elapsed,
+            (int) (outbytes / dst_frame_size));
+    return SDL_TRUE;
+}
+
+int
+main(int argc, char *argv[])
+{
+    static const int put_sizes[] = { 512, 4096, MAX_PUT_FRAMES };
+    SDL_bool ok = SDL_TRUE;
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Log("Converting %d seconds of audio through SDL_AudioStream\n", BENCHMARK_SECONDS);
+    for (i = 0; i < SDL_arraysize(put_sizes); ++i) {
+        ok &= RunStreamTest(48000, AUDIO_F32SYS, 2, 48000, put_sizes[i]);
+        ok &= RunStreamTest(48000, AUDIO_F32SYS, 6, 48000, put_sizes[i]);
+        ok &= RunStreamTest(44100, AUDIO_F32SYS, 2, 48000, put_sizes[i]);
+        ok &= RunStreamTest(44100, AUDIO_F32SYS, 6, 48000, put_sizes[i]);
+        /* Not fused, for comparison */
+        ok &= RunStreamTest(44100, AUDIO_S16SYS, 2, 48000, put_sizes[i]);
+    }
+
+    SDL_Quit();
+    return ok ? 0 : 1;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
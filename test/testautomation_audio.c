@@ -26,6 +26,14 @@ _audioSetUp(void *arg)
     if (ret != 0) {
            SDLTest_LogError("%s", SDL_GetError());
         }
+
+    /* Tests that call SDL_AudioQuit() directly leave the subsystem marked
+       as initialized without a driver; bring the default one back. */
+    if (SDL_GetCurrentAudioDriver() == NULL) {
+        ret = SDL_AudioInit(NULL);
+        SDLTest_AssertPass("Call to SDL_AudioInit(NULL)");
+        SDLTest_AssertCheck(ret==0, "Check result from SDL_AudioInit(NULL)");
+    }
 }
 
 void
@@ -968,6 +976,1235 @@ int audio_openCloseAudioDeviceConnected()
 }
 
 
+/**
+ * \brief Resamples a constant signal through an audio stream at every resampler quality.
+ *
+ * \sa https://wiki.libsdl.org/SDL_AudioStreamSetResamplerQuality
+ */
+int audio_resamplerQuality()
+{
+   const int inframes = 44000;
+   const int chunkframes = 1000;
+   float input[1000 * 2];
+   float output[2048 * 2];
+   SDL_AudioStream *stream;
+   int quality, result, i;
+
+   for (i = 0; i < SDL_arraysize(input); i++) {
+      input[i] = 0.25f;
+   }
+
+   for (quality = SDL_RESAMPLER_QUALITY_NEAREST; quality <= SDL_RESAMPLER_QUALITY_SINC; quality++) {
+      int total = 0;
+      float worst = 0.0f;
+
+      stream = SDL_NewAudioStream(AUDIO_F32SYS, 2, 44100, AUDIO_F32SYS, 2, 48000);
+      SDLTest_AssertPass("Call to SDL_NewAudioStream(AUDIO_F32SYS, 2, 44100, AUDIO_F32SYS, 2, 48000)");
+      SDLTest_AssertCheck(stream != NULL, "Validate stream is not NULL");
+      if (stream == NULL) return TEST_ABORTED;
+
+      result = SDL_AudioStreamSetResamplerQuality(stream, (SDL_AudioResamplerQuality) quality);
+      SDLTest_AssertPass("Call to SDL_AudioStreamSetResamplerQuality(stream, %i)", quality);
+      SDLTest_AssertCheck(result == 0, "Verify result value; expected: 0; got: %i", result);
+
+      for (i = 0; i < inframes; i += chunkframes) {
+         int got;
+         SDL_AudioStreamPut(stream, input, sizeof (input));
+         while ((got = SDL_AudioStreamGet(stream, output, sizeof (output))) > 0) {
+            int j;
+            /* skip the start, where the resampler still sees the silence before the signal. */
+            for (j = 0; j < got / (int) sizeof (float); j++) {
+               if ((total + (j / 2)) >= 100) {
+                  const float diff = SDL_fabs(output[j] - 0.25f);
+                  worst = SDL_max(worst, diff);
+               }
+            }
+            total += got / (int) (sizeof (float) * 2);
+         }
+      }
+      SDLTest_AssertCheck(total >= 47000 && total <= 48000, "Verify output frame count; expected: 47000-48000, got: %i", total);
+      SDLTest_AssertCheck(worst < 0.01f, "Verify resampled signal; expected: within 0.01 of 0.25, got: %f off", worst);
+
+      SDL_FreeAudioStream(stream);
+      SDLTest_AssertPass("Call to SDL_FreeAudioStream()");
+   }
+
+   /* Invalid parameters */
+   result = SDL_AudioStreamSetResamplerQuality(NULL, SDL_RESAMPLER_QUALITY_LINEAR);
+   SDLTest_AssertPass("Call to SDL_AudioStreamSetResamplerQuality(NULL, SDL_RESAMPLER_QUALITY_LINEAR)");
+   SDLTest_AssertCheck(result == -1, "Verify result value; expected: -1; got: %i", result);
+
+   stream = SDL_NewAudioStream(AUDIO_F32SYS, 2, 44100, AUDIO_F32SYS, 2, 48000);
+   SDLTest_AssertCheck(stream != NULL, "Validate stream is not NULL");
+   if (stream == NULL) return TEST_ABORTED;
+   result = SDL_AudioStreamSetResamplerQuality(stream, (SDL_AudioResamplerQuality) 42);
+   SDLTest_AssertPass("Call to SDL_AudioStreamSetResamplerQuality(stream, 42)");
+   SDLTest_AssertCheck(result == -1, "Verify result value; expected: -1; got: %i", result);
+   SDL_FreeAudioStream(stream);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * \brief Mixes native byte order S16, S32 and F32 audio and compares it against a plain C reference.
+ *
+ * \sa https://wiki.libsdl.org/SDL_MixAudioFormat
+ */
+int audio_mixAudioFormat()
+{
+   /* An odd count and a one-sample offset, so SIMD code has unaligned data and leftovers */
+   #define MIX_SAMPLES 1027
+   static const int volumes[] = { 1, 37, 64, 100, 127, SDL_MIX_MAXVOLUME };
+   Sint16 src16[MIX_SAMPLES + 1], dst16[MIX_SAMPLES + 1], ref16[MIX_SAMPLES + 1];
+   Sint32 src32[MIX_SAMPLES + 1], dst32[MIX_SAMPLES + 1], ref32[MIX_SAMPLES + 1];
+   float srcf[MIX_SAMPLES + 1], dstf[MIX_SAMPLES + 1], reff[MIX_SAMPLES + 1];
+   int v, i, mismatches;
+
+   for (v = 0; v < SDL_arraysize(volumes); v++) {
+      const int volume = volumes[v];
+
+      for (i = 0; i <= MIX_SAMPLES; i++) {
+         /* Make sure the extremes show up, to check clamping */
+         switch (i % 16) {
+         case 0:
+            src16[i] = dst16[i] = SDL_MAX_SINT16;
+            src32[i] = dst32[i] = SDL_MAX_SINT32;
+            srcf[i] = dstf[i] = 3.402823466e+38F;
+            break;
+         case 1:
+            src16[i] = dst16[i] = SDL_MIN_SINT16;
+            src32[i] = dst32[i] = SDL_MIN_SINT32;
+            srcf[i] = dstf[i] = -3.402823466e+38F;
+            break;
+         default:
+            src16[i] = SDLTest_RandomSint16();
+            dst16[i] = SDLTest_RandomSint16();
+            src32[i] = SDLTest_RandomSint32();
+            dst32[i] = SDLTest_RandomSint32();
+            srcf[i] = (SDLTest_RandomUnitFloat() * 2.0f) - 1.0f;
+            dstf[i] = (SDLTest_RandomUnitFloat() * 2.0f) - 1.0f;
+            break;
+         }
+      }
+
+      for (i = 1; i <= MIX_SAMPLES; i++) {
+         const int s16 = (src16[i] * volume) / SDL_MIX_MAXVOLUME + dst16[i];
+         const Sint64 s32 = (((Sint64) src32[i]) * volume) / SDL_MIX_MAXVOLUME + dst32[i];
+         const double sf = ((double) ((srcf[i] * (float) volume) * (1.0f / SDL_MIX_MAXVOLUME))) + ((double) dstf[i]);
+         ref16[i] = (Sint16) SDL_max(SDL_min(s16, SDL_MAX_SINT16), SDL_MIN_SINT16);
+         ref32[i] = (Sint32) SDL_max(SDL_min(s32, SDL_MAX_SINT32), SDL_MIN_SINT32);
+         reff[i] = (float) SDL_max(SDL_min(sf, 3.402823466e+38F), -3.402823466e+38F);
+      }
+
+      SDL_MixAudioFormat((Uint8 *) &dst16[1], (const Uint8 *) &src16[1], AUDIO_S16SYS, MIX_SAMPLES * sizeof (Sint16), volume);
+      SDLTest_AssertPass("Call to SDL_MixAudioFormat(AUDIO_S16SYS, volume=%i)", volume);
+      for (i = 1, mismatches = 0; i <= MIX_SAMPLES; i++) {
+         mismatches += (dst16[i] != ref16[i]);
+      }
+      SDLTest_AssertCheck(mismatches == 0, "Verify S16 samples match the reference; got %i mismatches", mismatches);
+
+      SDL_MixAudioFormat((Uint8 *) &dst32[1], (const Uint8 *) &src32[1], AUDIO_S32SYS, MIX_SAMPLES * sizeof (Sint32), volume);
+      SDLTest_AssertPass("Call to SDL_MixAudioFormat(AUDIO_S32SYS, volume=%i)", volume);
+      for (i = 1, mismatches = 0; i <= MIX_SAMPLES; i++) {
+         mismatches += (dst32[i] != ref32[i]);
+      }
+      SDLTest_AssertCheck(mismatches == 0, "Verify S32 samples match the reference; got %i mismatches", mismatches);
+
+      SDL_MixAudioFormat((Uint8 *) &dstf[1], (const Uint8 *) &srcf[1], AUDIO_F32SYS, MIX_SAMPLES * sizeof (float), volume);
+      SDLTest_AssertPass("Call to SDL_MixAudioFormat(AUDIO_F32SYS, volume=%i)", volume);
+      for (i = 1, mismatches = 0; i <= MIX_SAMPLES; i++) {
+         mismatches += (SDL_memcmp(&dstf[i], &reff[i], sizeof (float)) != 0);
+      }
+      SDLTest_AssertCheck(mismatches == 0, "Verify F32 samples match the reference; got %i mismatches", mismatches);
+   }
+   #undef MIX_SAMPLES
+
+   return TEST_COMPLETED;
+}
+
+/* Runs one type conversion on count samples, starting offset bytes into a fresh buffer. */
+static Uint8 *
+_convertAudioType(SDL_AudioFormat src_format, SDL_AudioFormat dst_format, const void *src, int count, int offset)
+{
+   SDL_AudioCVT cvt;
+   Uint8 *buf;
+   int result;
+
+   result = SDL_BuildAudioCVT(&cvt, src_format, 1, 48000, dst_format, 1, 48000);
+   SDLTest_AssertCheck(result == 1, "Verify SDL_BuildAudioCVT(0x%.4x, 0x%.4x) result; expected: 1; got: %i", src_format, dst_format, result);
+   if (result != 1) {
+      return NULL;
+   }
+
+   cvt.len = count * (SDL_AUDIO_BITSIZE(src_format) / 8);
+   buf = (Uint8 *) SDL_malloc(offset + (cvt.len * cvt.len_mult));
+   SDLTest_AssertCheck(buf != NULL, "Check data buffer to convert is not NULL");
+   if (buf == NULL) {
+      return NULL;
+   }
+   cvt.buf = buf + offset;
+   SDL_memcpy(cvt.buf, src, cvt.len);
+
+   result = SDL_ConvertAudio(&cvt);
+   SDLTest_AssertCheck(result == 0, "Verify SDL_ConvertAudio() result; expected: 0; got: %i", result);
+   SDLTest_AssertCheck(cvt.len_cvt == count * (SDL_AUDIO_BITSIZE(dst_format) / 8), "Verify converted length; expected: %i; got: %i",
+                       count * (SDL_AUDIO_BITSIZE(dst_format) / 8), cvt.len_cvt);
+   return buf;
+}
+
+/**
+ * \brief Checks the int<->float converters against the plain C conversions, for every 8 and 16 bit value and a sweep of floats.
+ *
+ * This tests whichever SIMD converters SDL picks for this CPU; audio_convertAudioTypeTiers
+ * checks the others against the scalar ones. The int to float
+ * conversions are exact; float to int rounds to nearest on SIMD paths and
+ * truncates on scalar ones, so those may be one step off.
+ *
+ * \sa https://wiki.libsdl.org/SDL_ConvertAudio
+ */
+int audio_convertAudioTypes()
+{
+   /* 65536 values, plus a few leftover samples for the scalar tail */
+   const int count = 65536 + 7;
+   const int offsets[] = { 0, 4, 6 };
+   Sint8 *s8 = (Sint8 *) SDL_malloc(count * sizeof (Sint8));
+   Uint8 *u8 = (Uint8 *) SDL_malloc(count * sizeof (Uint8));
+   Sint16 *s16 = (Sint16 *) SDL_malloc(count * sizeof (Sint16));
+   Uint16 *u16 = (Uint16 *) SDL_malloc(count * sizeof (Uint16));
+   Sint32 *s32 = (Sint32 *) SDL_malloc(count * sizeof (Sint32));
+   float *f32 = (float *) SDL_malloc(count * sizeof (float));
+   int o, i, mismatches;
+   Uint8 *buf;
+
+   SDLTest_AssertCheck(s8 && u8 && s16 && u16 && s32 && f32, "Check sample buffers are not NULL");
+   if (!s8 || !u8 || !s16 || !u16 || !s32 || !f32) {
+      return TEST_ABORTED;
+   }
+
+   for (i = 0; i < count; i++) {
+      s8[i] = (Sint8) i;
+      u8[i] = (Uint8) i;
+      s16[i] = (Sint16) i;
+      u16[i] = (Uint16) i;
+      s32[i] = (Sint32) (((Uint32) i << 16) | (i & 0xFFFF));
+      f32[i] = ((((float) i) / 65536.0f) * 2.25f) - 1.125f;
+   }
+   /* Make sure the edges show up in the float data */
+   f32[0] = -1.0f;
+   f32[1] = 1.0f;
+   f32[2] = 0.0f;
+   f32[3] = -0.0f;
+   f32[4] = 1.0f / 32767.0f;
+   f32[5] = 0.5f / 32767.0f;
+   f32[6] = -100.0f;
+   f32[7] = 100.0f;
+
+   for (o = 0; o < SDL_arraysize(offsets); o++) {
+      const int offset = offsets[o];
+
+      buf = _convertAudioType(AUDIO_S8, AUDIO_F32SYS, s8, count, offset);
+      if (buf) {
+         const float *out = (const float *) (buf + offset);
+         for (i = 0, mismatches = 0; i < count; i++) {
+            mismatches += (out[i] != ((float) s8[i]) * 0.0078125f);
+         }
+         SDLTest_AssertCheck(mismatches == 0, "Verify AUDIO_S8 to AUDIO_F32 at offset %i; got %i mismatches", offset, mismatches);
+         SDL_free(buf);
+      }
+
+      buf = _convertAudioType(AUDIO_U8, AUDIO_F32SYS, u8, count, offset);
+      if (buf) {
+         const float *out = (const float *) (buf + offset);
+         for (i = 0, mismatches = 0; i < count; i++) {
+            mismatches += (out[i] != (((float) u8[i]) * 0.0078125f) - 1.0f);
+         }
+         SDLTest_AssertCheck(mismatches == 0, "Verify AUDIO_U8 to AUDIO_F32 at offset %i; got %i mismatches", offset, mismatches);
+         SDL_free(buf);
+      }
+
+      buf = _convertAudioType(AUDIO_S16SYS, AUDIO_F32SYS, s16, count, offset);
+      if (buf) {
+         const float *out = (const float *) (buf + offset);
+         for (i = 0, mismatches = 0; i < count; i++) {
+            mismatches += (out[i] != ((float) s16[i]) * 0.000030517578125f);
+         }
+         SDLTest_AssertCheck(mismatches == 0, "Verify AUDIO_S16 to AUDIO_F32 at offset %i; got %i mismatches", offset, mismatches);
+         SDL_free(buf);
+      }
+
+      buf = _convertAudioType(AUDIO_U16SYS, AUDIO_F32SYS, u16, count, offset);
+      if (buf) {
+         const float *out = (const float *) (buf + offset);
+         for (i = 0, mismatches = 0; i < count; i++) {
+            mismatches += (out[i] != (((float) u16[i]) * 0.000030517578125f) - 1.0f);
+         }
+         SDLTest_AssertCheck(mismatches == 0, "Verify AUDIO_U16 to AUDIO_F32 at offset %i; got %i mismatches", offset, mismatches);
+         SDL_free(buf);
+      }
+
+      buf = _convertAudioType(AUDIO_S32SYS, AUDIO_F32SYS, s32, count, offset);
+      if (buf) {
+         const float *out = (const float *) (buf + offset);
+         for (i = 0, mismatches = 0; i < count; i++) {
+            mismatches += (out[i] != ((float) (s32[i] >> 8)) * 0.00000011920930376163766f);
+         }
+         SDLTest_AssertCheck(mismatches == 0, "Verify AUDIO_S32 to AUDIO_F32 at offset %i; got %i mismatches", offset, mismatches);
+         SDL_free(buf);
+      }
+
+      buf = _convertAudioType(AUDIO_F32SYS, AUDIO_S8, f32, count, offset);
+      if (buf) {
+         const Sint8 *out = (const Sint8 *) (buf + offset);
+         for (i = 0, mismatches = 0; i < count; i++) {
+            const float sample = f32[i];
+            const int expected = (sample >= 1.0f) ? 127 : (sample <= -1.0f) ? -128 : (Sint8) (sample * 127.0f);
+            mismatches += (SDL_abs(out[i] - expected) > 1);
+         }
+         SDLTest_AssertCheck(mismatches == 0, "Verify AUDIO_F32 to AUDIO_S8 at offset %i; got %i mismatches", offset, mismatches);
+         SDL_free(buf);
+      }
+
+      buf = _convertAudioType(AUDIO_F32SYS, AUDIO_U8, f32, count, offset);
+      if (buf) {
+         const Uint8 *out = (const Uint8 *) (buf + offset);
+         for (i = 0, mismatches = 0; i < count; i++) {
+            const float sample = f32[i];
+            const int expected = (sample >= 1.0f) ? 255 : (sample <= -1.0f) ? 0 : (Uint8) ((sample + 1.0f) * 127.0f);
+            mismatches += (SDL_abs(out[i] - expected) > 1);
+         }
+         SDLTest_AssertCheck(mismatches == 0, "Verify AUDIO_F32 to AUDIO_U8 at offset %i; got %i mismatches", offset, mismatches);
+         SDL_free(buf);
+      }
+
+      buf = _convertAudioType(AUDIO_F32SYS, AUDIO_S16SYS, f32, count, offset);
+      if (buf) {
+         const Sint16 *out = (const Sint16 *) (buf + offset);
+         for (i = 0, mismatches = 0; i < count; i++) {
+            const float sample = f32[i];
+            const int expected = (sample >= 1.0f) ? 32767 : (sample <= -1.0f) ? -32768 : (Sint16) (sample * 32767.0f);
+            mismatches += (SDL_abs(out[i] - expected) > 1);
+         }
+         SDLTest_AssertCheck(mismatches == 0, "Verify AUDIO_F32 to AUDIO_S16 at offset %i; got %i mismatches", offset, mismatches);
+         SDL_free(buf);
+      }
+
+      buf = _convertAudioType(AUDIO_F32SYS, AUDIO_U16SYS, f32, count, offset);
+      if (buf) {
+         const Uint16 *out = (const Uint16 *) (buf + offset);
+         for (i = 0, mismatches = 0; i < count; i++) {
+            const float sample = f32[i];
+            const int expected = (sample >= 1.0f) ? 65535 : (sample <= -1.0f) ? 0 : (Uint16) ((sample + 1.0f) * 32767.0f);
+            /* SIMD paths convert to Sint16 and flip the top bit, which adds 32768 instead of 32767 */
+            mismatches += (SDL_abs(out[i] - expected) > 2);
+         }
+         SDLTest_AssertCheck(mismatches == 0, "Verify AUDIO_F32 to AUDIO_U16 at offset %i; got %i mismatches", offset, mismatches);
+         SDL_free(buf);
+      }
+
+      buf = _convertAudioType(AUDIO_F32SYS, AUDIO_S32SYS, f32, count, offset);
+      if (buf) {
+         const Sint32 *out = (const Sint32 *) (buf + offset);
+         for (i = 0, mismatches = 0; i < count; i++) {
+            const float sample = f32[i];
+            const Sint64 expected = (sample >= 1.0f) ? 2147483647 : (sample <= -1.0f) ? -2147483647 - 1 : (((Sint64) (sample * 8388607.0f)) * 256);
+            const Sint64 diff = ((Sint64) out[i]) - expected;
+            mismatches += ((diff < -256) || (diff > 256));
+         }
+         SDLTest_AssertCheck(mismatches == 0, "Verify AUDIO_F32 to AUDIO_S32 at offset %i; got %i mismatches", offset, mismatches);
+         SDL_free(buf);
+      }
+   }
+
+   SDL_free(s8);
+   SDL_free(u8);
+   SDL_free(s16);
+   SDL_free(u16);
+   SDL_free(s32);
+   SDL_free(f32);
+
+   return TEST_COMPLETED;
+}
+
+
+/* Reads sample i of a converter's output, scaled so the SIMD and scalar paths can be compared. */
+static double
+_audioTypeSample(SDL_AudioFormat format, const Uint8 *buf, int i)
+{
+   switch (format) {
+      case AUDIO_S8: return (double) ((const Sint8 *) buf)[i];
+      case AUDIO_U8: return (double) ((const Uint8 *) buf)[i];
+      case AUDIO_S16SYS: return (double) ((const Sint16 *) buf)[i];
+      case AUDIO_U16SYS: return (double) ((const Uint16 *) buf)[i];
+      case AUDIO_S32SYS: return (double) ((const Sint32 *) buf)[i];
+      default: return (double) ((const float *) buf)[i];
+   }
+}
+
+/**
+ * \brief Forces each SIMD tier of the int<->float converters in turn and checks it against the scalar converters.
+ *
+ * Tiers that aren't built in or that this CPU lacks are skipped. The int to float
+ * conversions must match exactly; float to int may be one step off, since SIMD
+ * paths round to nearest and scalar ones truncate.
+ *
+ * \sa https://wiki.libsdl.org/SDL_ConvertAudio
+ */
+int audio_convertAudioTypeTiers()
+{
+   static const struct {
+      const char *name;
+      SDL_bool (SDLCALL *available)(void);
+   } tiers[] = {
+      { "sse2", SDL_HasSSE2 },
+      { "neon", SDL_HasNEON },
+      { "avx2", SDL_HasAVX2 },
+      { "avx512f", SDL_HasAVX512F }
+   };
+   static const struct {
+      SDL_AudioFormat src;
+      SDL_AudioFormat dst;
+      double tolerance;
+   } conversions[] = {
+      { AUDIO_S8, AUDIO_F32SYS, 0.0 },
+      { AUDIO_U8, AUDIO_F32SYS, 0.0 },
+      { AUDIO_S16SYS, AUDIO_F32SYS, 0.0 },
+      { AUDIO_U16SYS, AUDIO_F32SYS, 0.0 },
+      { AUDIO_S32SYS, AUDIO_F32SYS, 0.0 },
+      { AUDIO_F32SYS, AUDIO_S8, 1.0 },
+      { AUDIO_F32SYS, AUDIO_U8, 1.0 },
+      { AUDIO_F32SYS, AUDIO_S16SYS, 1.0 },
+      { AUDIO_F32SYS, AUDIO_U16SYS, 2.0 },  /* SIMD flips the top bit of Sint16, adding 32768 instead of 32767 */
+      { AUDIO_F32SYS, AUDIO_S32SYS, 256.0 }
+   };
+   /* Make sure the edges show up in the float data */
+   static const float edges[] = { -1.0f, 1.0f, 0.0f, -0.0f, 1.0f / 32767.0f, 0.5f / 32767.0f, -100.0f, 100.0f };
+   /* Every 16 bit pattern, plus a few leftover samples for the scalar tail */
+   const int count = 65536 + 7;
+   Uint8 *src = (Uint8 *) SDL_malloc(count * sizeof (float));
+   const char *hint = SDL_GetHint("SDL_AUDIO_CONVERTERS");
+   char *saved_hint = hint ? SDL_strdup(hint) : NULL;
+   int t, c, i, mismatches, tested = 0;
+
+   SDLTest_AssertCheck(src != NULL, "Check sample buffer is not NULL");
+   if (src == NULL) {
+      SDL_free(saved_hint);
+      return TEST_ABORTED;
+   }
+
+   for (t = 0; t < SDL_arraysize(tiers); t++) {
+      if (!tiers[t].available()) {
+         SDLTest_Log("Skipping the %s converters, this CPU doesn't support them", tiers[t].name);
+         continue;
+      }
+      tested++;
+
+      for (c = 0; c < SDL_arraysize(conversions); c++) {
+         const SDL_AudioFormat src_format = conversions[c].src;
+         const SDL_AudioFormat dst_format = conversions[c].dst;
+         Uint8 *expected, *actual;
+
+         for (i = 0; i < count; i++) {
+            if (src_format == AUDIO_F32SYS) {
+               ((float *) src)[i] = (i < SDL_arraysize(edges)) ? edges[i] : ((((float) i) / 65536.0f) * 2.25f) - 1.125f;
+            } else if (src_format == AUDIO_S32SYS) {
+               ((Sint32 *) src)[i] = (Sint32) (((Uint32) i << 16) | (i & 0xFFFF));
+            } else if (SDL_AUDIO_BITSIZE(src_format) == 16) {
+               ((Uint16 *) src)[i] = (Uint16) i;
+            } else {
+               src[i] = (Uint8) i;
+            }
+         }
+
+         SDL_SetHint("SDL_AUDIO_CONVERTERS", "scalar");
+         expected = _convertAudioType(src_format, dst_format, src, count, 0);
+         SDL_SetHint("SDL_AUDIO_CONVERTERS", tiers[t].name);
+         actual = _convertAudioType(src_format, dst_format, src, count, 0);
+         if (expected && actual) {
+            for (i = 0, mismatches = 0; i < count; i++) {
+               mismatches += (SDL_fabs(_audioTypeSample(dst_format, actual, i) - _audioTypeSample(dst_format, expected, i)) > conversions[c].tolerance);
+            }
+            SDLTest_AssertCheck(mismatches == 0, "Verify %s 0x%.4x to 0x%.4x against scalar; got %i mismatches",
+                                tiers[t].name, src_format, dst_format, mismatches);
+         }
+         SDL_free(expected);
+         SDL_free(actual);
+      }
+   }
+
+   SDL_SetHint("SDL_AUDIO_CONVERTERS", saved_hint);
+   SDL_free(saved_hint);
+   SDL_free(src);
+
+   if (tested == 0) {
+      SDLTest_Log("No SIMD converters to check on this CPU");
+      return TEST_SKIPPED;
+   }
+   return TEST_COMPLETED;
+}
+
+/* Mixes one frame the way the channel converters are documented to, one step at a time, in double precision. */
+static void
+_remixFrameReference(const float *in, int src_channels, int dst_channels, double *out)
+{
+   double frame[8], tmp[8];
+   int i;
+
+   for (i = 0; i < src_channels; i++) {
+      frame[i] = in[i];
+   }
+
+   if ((src_channels == 1) && (dst_channels > 1)) {
+      frame[1] = frame[0];
+      src_channels = 2;
+   }
+   if ((src_channels == 2) && (dst_channels >= 6)) {
+      const double ce = (frame[0] + frame[1]) * 0.5;
+      tmp[0] = frame[0] + (frame[0] - ce); tmp[1] = frame[1] + (frame[1] - ce); tmp[2] = ce; tmp[3] = 0.0; tmp[4] = frame[0]; tmp[5] = frame[1];
+      SDL_memcpy(frame, tmp, sizeof (tmp));
+      src_channels = 6;
+   }
+   if ((src_channels == 4) && (dst_channels >= 6)) {
+      const double ce = (frame[0] + frame[1]) * 0.5;
+      tmp[0] = frame[0] + (frame[0] - ce); tmp[1] = frame[1] + (frame[1] - ce); tmp[2] = ce; tmp[3] = 0.0; tmp[4] = frame[2]; tmp[5] = frame[3];
+      SDL_memcpy(frame, tmp, sizeof (tmp));
+      src_channels = 6;
+   }
+   if ((src_channels == 6) && (dst_channels == 8)) {
+      const double ls = (frame[0] + frame[4]) * 0.5;
+      const double rs = (frame[1] + frame[5]) * 0.5;
+      tmp[0] = frame[0] + (frame[0] - ls); tmp[1] = frame[1] + (frame[1] - rs); tmp[2] = frame[2]; tmp[3] = frame[3];
+      tmp[4] = frame[4] + (frame[4] - ls); tmp[5] = frame[5] + (frame[5] - rs); tmp[6] = ls; tmp[7] = rs;
+      SDL_memcpy(frame, tmp, sizeof (tmp));
+      src_channels = 8;
+   }
+   if ((src_channels == 2) && (dst_channels == 4)) {
+      frame[2] = frame[0];
+      frame[3] = frame[1];
+      src_channels = 4;
+   }
+   if ((src_channels == 8) && (dst_channels <= 6)) {
+      for (i = 0; i < 6; i++) {
+         tmp[i] = frame[i];
+      }
+      tmp[0] += frame[6] * 0.5; tmp[1] += frame[7] * 0.5; tmp[4] += frame[6] * 0.5; tmp[5] += frame[7] * 0.5;
+      for (i = 0; i < 6; i++) {
+         frame[i] = tmp[i] / 1.5;
+      }
+      src_channels = 6;
+   }
+   if ((src_channels == 6) && (dst_channels <= 2)) {
+      tmp[0] = (frame[0] + frame[2] * 0.5 + frame[4]) / 2.5;
+      tmp[1] = (frame[1] + frame[2] * 0.5 + frame[5]) / 2.5;
+      frame[0] = tmp[0];
+      frame[1] = tmp[1];
+      src_channels = 2;
+   }
+   if ((src_channels == 6) && (dst_channels == 4)) {
+      tmp[0] = (frame[0] + frame[2] * 0.5) / 1.5; tmp[1] = (frame[1] + frame[2] * 0.5) / 1.5; tmp[2] = frame[4] / 1.5; tmp[3] = frame[5] / 1.5;
+      SDL_memcpy(frame, tmp, 4 * sizeof (double));
+      src_channels = 4;
+   }
+   if ((src_channels == 4) && (dst_channels <= 2)) {
+      frame[0] = (frame[0] + frame[2]) * 0.5;
+      frame[1] = (frame[1] + frame[3]) * 0.5;
+      src_channels = 2;
+   }
+   if ((src_channels == 2) && (dst_channels == 1)) {
+      frame[0] = (frame[0] + frame[1]) * 0.5;
+      src_channels = 1;
+   }
+
+   for (i = 0; i < dst_channels; i++) {
+      out[i] = frame[i];
+   }
+}
+
+/**
+ * \brief Checks every channel conversion against a step-by-step reference mix, with an odd number of frames at an unaligned offset.
+ *
+ * This tests the SIMD channel converters and the single pass remixer
+ * that replaces chains of converters.
+ *
+ * \sa https://wiki.libsdl.org/SDL_ConvertAudio
+ */
+int audio_convertChannels()
+{
+   const int channel_counts[] = { 1, 2, 4, 6, 8 };
+   const int frames = 1001;
+   const int offset = 4;
+   float *input = (float *) SDL_malloc(frames * 8 * sizeof (float));
+   int s, d, i, j, mismatches;
+
+   SDLTest_AssertCheck(input != NULL, "Check sample buffer is not NULL");
+   if (input == NULL) {
+      return TEST_ABORTED;
+   }
+
+   for (i = 0; i < frames * 8; i++) {
+      input[i] = (float) SDL_sin(i * 0.37) * 0.9f;
+   }
+
+   for (s = 0; s < SDL_arraysize(channel_counts); s++) {
+      for (d = 0; d < SDL_arraysize(channel_counts); d++) {
+         const int src_channels = channel_counts[s];
+         const int dst_channels = channel_counts[d];
+         SDL_AudioCVT cvt;
+         Uint8 *buf;
+         int result;
+
+         if (src_channels == dst_channels) {
+            continue;
+         }
+
+         result = SDL_BuildAudioCVT(&cvt, AUDIO_F32SYS, src_channels, 48000, AUDIO_F32SYS, dst_channels, 48000);
+         SDLTest_AssertCheck(result == 1, "Verify SDL_BuildAudioCVT(%i channels, %i channels) result; expected: 1; got: %i", src_channels, dst_channels, result);
+         if (result != 1) {
+            continue;
+         }
+
+         cvt.len = frames * src_channels * sizeof (float);
+         buf = (Uint8 *) SDL_malloc(offset + (cvt.len * cvt.len_mult));
+         SDLTest_AssertCheck(buf != NULL, "Check data buffer to convert is not NULL");
+         if (buf == NULL) {
+            continue;
+         }
+         cvt.buf = buf + offset;
+         SDL_memcpy(cvt.buf, input, cvt.len);
+
+         result = SDL_ConvertAudio(&cvt);
+         SDLTest_AssertCheck(result == 0, "Verify SDL_ConvertAudio() result; expected: 0; got: %i", result);
+         SDLTest_AssertCheck(cvt.len_cvt == frames * dst_channels * (int) sizeof (float), "Verify converted length; expected: %i; got: %i",
+                             frames * dst_channels * (int) sizeof (float), cvt.len_cvt);
+
+         for (i = 0, mismatches = 0; i < frames; i++) {
+            const float *out = ((const float *) cvt.buf) + (i * dst_channels);
+            double expected[8];
+            _remixFrameReference(&input[i * src_channels], src_channels, dst_channels, expected);
+            for (j = 0; j < dst_channels; j++) {
+               mismatches += (SDL_fabs(out[j] - expected[j]) > 1e-5);
+            }
+         }
+         SDLTest_AssertCheck(mismatches == 0, "Verify %i to %i channels matches the reference; got %i mismatches", src_channels, dst_channels, mismatches);
+         SDL_free(buf);
+      }
+   }
+
+   SDL_free(input);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * \brief Checks SDL_ConvertAudioSamples() on several threads against a single SDL_AudioStream.
+ *
+ * \sa https://wiki.libsdl.org/SDL_ConvertAudioSamples
+ */
+int audio_convertAudioSamples()
+{
+   static const struct {
+      SDL_AudioFormat src_format; Uint8 src_channels; int src_rate;
+      SDL_AudioFormat dst_format; Uint8 dst_channels; int dst_rate;
+   } tests[] = {
+      { AUDIO_S16SYS, 2, 44100, AUDIO_F32SYS, 2, 48000 },
+      { AUDIO_F32SYS, 2, 48000, AUDIO_F32SYS, 2, 44100 },
+      { AUDIO_F32SYS, 6, 44100, AUDIO_F32SYS, 2, 22050 },
+      { AUDIO_S16SYS, 2, 48000, AUDIO_F32SYS, 6, 48000 },
+      { AUDIO_S16SYS, 2, 44100, AUDIO_S16SYS, 2, 48000 }
+   };
+   const int frames = 100001;
+   void *dst = NULL;
+   int dst_len, result;
+   int t, i;
+
+   for (t = 0; t < SDL_arraysize(tests); t++) {
+      const int src_samples = frames * tests[t].src_channels;
+      const int src_len = src_samples * (SDL_AUDIO_BITSIZE(tests[t].src_format) / 8);
+      Uint8 *src = (Uint8 *) SDL_malloc(src_len);
+      Uint8 *expected = NULL;
+      int expected_len, mismatches;
+      SDL_AudioStream *stream;
+
+      SDLTest_AssertCheck(src != NULL, "Check source buffer is not NULL");
+      if (src == NULL) {
+         return TEST_ABORTED;
+      }
+
+      for (i = 0; i < src_samples; i++) {
+         const double sample = SDL_sin(i * 0.011) * 0.8;
+         if (tests[t].src_format == AUDIO_F32SYS) {
+            ((float *) src)[i] = (float) sample;
+         } else {
+            ((Sint16 *) src)[i] = (Sint16) (sample * 32767.0);
+         }
+      }
+
+      stream = SDL_NewAudioStream(tests[t].src_format, tests[t].src_channels, tests[t].src_rate,
+                                  tests[t].dst_format, tests[t].dst_channels, tests[t].dst_rate);
+      SDLTest_AssertPass("Call to SDL_NewAudioStream()");
+      SDLTest_AssertCheck(stream != NULL, "Check stream is not NULL");
+      if (stream == NULL) {
+         SDL_free(src);
+         return TEST_ABORTED;
+      }
+      SDL_AudioStreamPut(stream, src, src_len);
+      SDL_AudioStreamFlush(stream);
+      expected_len = SDL_AudioStreamAvailable(stream);
+      expected = (Uint8 *) SDL_malloc(expected_len);
+      SDLTest_AssertCheck(expected != NULL, "Check expected output buffer is not NULL");
+      if (expected != NULL) {
+         SDL_AudioStreamGet(stream, expected, expected_len);
+      }
+      SDL_FreeAudioStream(stream);
+
+      result = SDL_ConvertAudioSamples(tests[t].src_format, tests[t].src_channels, tests[t].src_rate, src, src_len,
+                                       tests[t].dst_format, tests[t].dst_channels, tests[t].dst_rate, &dst, &dst_len, 4);
+      SDLTest_AssertPass("Call to SDL_ConvertAudioSamples(%i channels %i Hz, %i channels %i Hz, 4 threads)",
+                         tests[t].src_channels, tests[t].src_rate, tests[t].dst_channels, tests[t].dst_rate);
+      SDLTest_AssertCheck(result == 0, "Verify result value; expected: 0; got: %i", result);
+      SDLTest_AssertCheck(dst_len == expected_len, "Verify output length; expected: %i; got: %i", expected_len, dst_len);
+
+      if ((result == 0) && (expected != NULL) && (dst_len == expected_len)) {
+         mismatches = 0;
+         if (tests[t].dst_format == AUDIO_F32SYS) {
+            mismatches = (SDL_memcmp(dst, expected, dst_len) != 0);
+         } else {
+            /* float to integer conversion may round differently at the edges of each thread's piece. */
+            for (i = 0; i < dst_len / (int) sizeof (Sint16); i++) {
+               mismatches += (SDL_abs(((Sint16 *) dst)[i] - ((Sint16 *) expected)[i]) > 1);
+            }
+         }
+         SDLTest_AssertCheck(mismatches == 0, "Verify output matches the audio stream; got %i mismatches", mismatches);
+      }
+
+      SDL_free(dst);
+      dst = NULL;
+      SDL_free(expected);
+      SDL_free(src);
+   }
+
+   /* Invalid parameters */
+   result = SDL_ConvertAudioSamples(AUDIO_S16SYS, 2, 44100, NULL, 4, AUDIO_F32SYS, 2, 48000, &dst, &dst_len, 0);
+   SDLTest_AssertCheck(result == -1, "Verify result value with NULL src; expected: -1; got: %i", result);
+   result = SDL_ConvertAudioSamples(AUDIO_S16SYS, 2, 44100, &frames, 3, AUDIO_F32SYS, 2, 48000, &dst, &dst_len, 0);
+   SDLTest_AssertCheck(result == -1, "Verify result value with a partial frame; expected: -1; got: %i", result);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * \brief Queues audio through the lock-free ring and checks sizes, overflow, clearing and underrun counting.
+ *
+ * \sa https://wiki.libsdl.org/SDL_QueueAudio
+ * \sa https://wiki.libsdl.org/SDL_GetQueuedAudioXruns
+ */
+int audio_queueAudioLockFree()
+{
+   const Uint32 ringsize = 65536;
+   SDL_AudioSpec desired, obtained;
+   SDL_AudioDeviceID id;
+   Uint8 *data;
+   Uint32 queued, xruns;
+   int result;
+
+   SDL_SetHint(SDL_HINT_AUDIO_QUEUE_LOCKFREE, "65536");
+   SDLTest_AssertPass("Call to SDL_SetHint(SDL_HINT_AUDIO_QUEUE_LOCKFREE, \"65536\")");
+
+   SDL_zero(desired);
+   desired.freq = 22050;
+   desired.format = AUDIO_S16SYS;
+   desired.channels = 2;
+   desired.samples = 1024;
+   desired.callback = NULL;
+   id = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+   SDL_SetHint(SDL_HINT_AUDIO_QUEUE_LOCKFREE, NULL);
+   SDLTest_AssertPass("Call to SDL_OpenAudioDevice(NULL, 0, ...)");
+   SDLTest_AssertCheck(id > 0, "Validate device ID; expected: >0, got: %i", id);
+   if (id == 0) {
+      return TEST_ABORTED;
+   }
+
+   data = (Uint8 *) SDL_calloc(1, ringsize + 4);
+   SDLTest_AssertCheck(data != NULL, "Check data buffer is not NULL");
+   if (data == NULL) {
+      SDL_CloseAudioDevice(id);
+      return TEST_ABORTED;
+   }
+
+   /* The device starts paused, so nothing drains the queue yet. */
+   result = SDL_QueueAudio(id, data, ringsize / 2);
+   SDLTest_AssertCheck(result == 0, "Verify SDL_QueueAudio() result; expected: 0, got: %i", result);
+   result = SDL_QueueAudio(id, data, ringsize / 2);
+   SDLTest_AssertCheck(result == 0, "Verify SDL_QueueAudio() result; expected: 0, got: %i", result);
+   queued = SDL_GetQueuedAudioSize(id);
+   SDLTest_AssertCheck(queued == ringsize, "Verify queued size; expected: %u, got: %u", (unsigned) ringsize, (unsigned) queued);
+
+   result = SDL_QueueAudio(id, data, 4);
+   SDLTest_AssertCheck(result == -1, "Verify SDL_QueueAudio() fails when the ring is full; expected: -1, got: %i", result);
+   queued = SDL_GetQueuedAudioSize(id);
+   SDLTest_AssertCheck(queued == ringsize, "Verify queued size didn't change; expected: %u, got: %u", (unsigned) ringsize, (unsigned) queued);
+
+   SDL_ClearQueuedAudio(id);
+   queued = SDL_GetQueuedAudioSize(id);
+   SDLTest_AssertCheck(queued == 0, "Verify queued size after clearing; expected: 0, got: %u", (unsigned) queued);
+
+   /* More than the ring holds can only go in while the device plays it. */
+   result = SDL_QueueAudio(id, data, ringsize + 4);
+   SDLTest_AssertCheck(result == -1, "Verify SDL_QueueAudio() of more than the ring fails while paused; expected: -1, got: %i", result);
+   queued = SDL_GetQueuedAudioSize(id);
+   SDLTest_AssertCheck(queued == 0, "Verify nothing was queued; expected: 0, got: %u", (unsigned) queued);
+
+   xruns = SDL_GetQueuedAudioXruns(id);
+   SDLTest_AssertCheck(xruns == 0, "Verify no underruns before playing; expected: 0, got: %u", (unsigned) xruns);
+
+   /* Less than one callback's worth, so the device runs dry once and stays dry. */
+   SDL_PauseAudioDevice(id, 0);
+   result = SDL_QueueAudio(id, data, obtained.size / 2);
+   SDLTest_AssertCheck(result == 0, "Verify SDL_QueueAudio() result after clearing; expected: 0, got: %i", result);
+   SDL_Delay(((obtained.samples * 1000) / obtained.freq) * 6);
+
+   queued = SDL_GetQueuedAudioSize(id);
+   SDLTest_AssertCheck(queued == 0, "Verify the queue drained; expected: 0, got: %u", (unsigned) queued);
+   xruns = SDL_GetQueuedAudioXruns(id);
+   SDLTest_AssertCheck(xruns == 1, "Verify one underrun was counted; expected: 1, got: %u", (unsigned) xruns);
+
+   result = SDL_QueueAudio(id, data, ringsize + 4);
+   SDLTest_AssertCheck(result == 0, "Verify SDL_QueueAudio() of more than the ring succeeds while playing; expected: 0, got: %i", result);
+   queued = SDL_GetQueuedAudioSize(id);
+   SDLTest_AssertCheck(queued <= ringsize, "Verify the ring never held more than it can; expected: <=%u, got: %u", (unsigned) ringsize, (unsigned) queued);
+
+   SDL_CloseAudioDevice(id);
+   SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+   SDL_free(data);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * \brief Plays queued audio and checks the device statistics add up.
+ *
+ * \sa https://wiki.libsdl.org/SDL_GetAudioDeviceStats
+ * \sa https://wiki.libsdl.org/SDL_ResetAudioDeviceStats
+ */
+int audio_getAudioDeviceStats()
+{
+   SDL_AudioSpec desired, obtained;
+   SDL_AudioDeviceStats stats;
+   SDL_AudioDeviceID id;
+   Uint8 *data;
+   Uint32 period_ms;
+   int result;
+
+   SDL_zero(desired);
+   desired.freq = 22050;
+   desired.format = AUDIO_S16SYS;
+   desired.channels = 2;
+   desired.samples = 1024;
+   desired.callback = NULL;
+   id = SDL_OpenAudioDevice(NULL, 0, &desired, &obtained, 0);
+   SDLTest_AssertPass("Call to SDL_OpenAudioDevice(NULL, 0, ...)");
+   SDLTest_AssertCheck(id > 0, "Validate device ID; expected: >0, got: %i", id);
+   if (id == 0) {
+      return TEST_ABORTED;
+   }
+   period_ms = (obtained.samples * 1000) / obtained.freq;
+
+   result = SDL_GetAudioDeviceStats(id, NULL);
+   SDLTest_AssertCheck(result == -1, "Verify result with NULL stats; expected: -1, got: %i", result);
+   result = SDL_GetAudioDeviceStats(0, &stats);
+   SDLTest_AssertCheck(result == -1, "Verify result with an invalid device; expected: -1, got: %i", result);
+
+   /* Two and a half buffers, so the third one comes up short. */
+   data = (Uint8 *) SDL_calloc(1, obtained.size * 3);
+   SDLTest_AssertCheck(data != NULL, "Check data buffer is not NULL");
+   if (data == NULL) {
+      SDL_CloseAudioDevice(id);
+      return TEST_ABORTED;
+   }
+   SDL_QueueAudio(id, data, (obtained.size * 5) / 2);
+   SDL_PauseAudioDevice(id, 0);
+   SDL_Delay(period_ms * 8);
+
+   result = SDL_GetAudioDeviceStats(id, &stats);
+   SDLTest_AssertCheck(result == 0, "Verify SDL_GetAudioDeviceStats() result; expected: 0, got: %i", result);
+   SDLTest_AssertCheck(stats.callbacks >= 3, "Verify callbacks; expected: >=3, got: %u", (unsigned) stats.callbacks);
+   SDLTest_AssertCheck((stats.callback_ns_min <= stats.callback_ns_avg) && (stats.callback_ns_avg <= stats.callback_ns_max),
+                       "Verify callback times are ordered; got min %u, avg %u, max %u ns",
+                       (unsigned) stats.callback_ns_min, (unsigned) stats.callback_ns_avg, (unsigned) stats.callback_ns_max);
+   /* the queue only ran dry once, however many buffers of silence followed. */
+   SDLTest_AssertCheck(stats.underruns == 1, "Verify underruns; expected: 1, got: %u", (unsigned) stats.underruns);
+   SDLTest_AssertCheck(stats.underruns == SDL_GetQueuedAudioXruns(id), "Verify underruns match xruns; expected: %u, got: %u",
+                       (unsigned) SDL_GetQueuedAudioXruns(id), (unsigned) stats.underruns);
+   SDLTest_AssertCheck((stats.silence_frames > obtained.samples) && ((stats.silence_frames % obtained.samples) == (obtained.samples / 2)),
+                       "Verify silence frames are half a buffer plus whole buffers; got: %u", (unsigned) stats.silence_frames);
+   SDLTest_AssertCheck(stats.overruns == 0, "Verify overruns; expected: 0, got: %u", (unsigned) stats.overruns);
+   SDLTest_AssertCheck(stats.queued_bytes == 0, "Verify queued bytes; expected: 0, got: %u", (unsigned) stats.queued_bytes);
+   SDLTest_AssertCheck(stats.queued_bytes_max == (obtained.size * 3) / 2, "Verify most queued bytes; expected: %u, got: %u",
+                       (unsigned) ((obtained.size * 3) / 2), (unsigned) stats.queued_bytes_max);
+
+   /* paused devices don't drain the queue, so nothing new gets counted after the reset. */
+   SDL_PauseAudioDevice(id, 1);
+   SDL_ResetAudioDeviceStats(id);
+   SDLTest_AssertPass("Call to SDL_ResetAudioDeviceStats()");
+   SDL_Delay(period_ms * 4);
+   result = SDL_GetAudioDeviceStats(id, &stats);
+   SDLTest_AssertCheck(result == 0, "Verify SDL_GetAudioDeviceStats() result; expected: 0, got: %i", result);
+   SDLTest_AssertCheck(stats.underruns == 0, "Verify underruns after reset; expected: 0, got: %u", (unsigned) stats.underruns);
+   SDLTest_AssertCheck(SDL_GetQueuedAudioXruns(id) == 1, "Verify the reset left xruns alone; expected: 1, got: %u", (unsigned) SDL_GetQueuedAudioXruns(id));
+   SDLTest_AssertCheck(stats.silence_frames == 0, "Verify silence frames after reset; expected: 0, got: %u", (unsigned) stats.silence_frames);
+
+   SDL_CloseAudioDevice(id);
+   SDLTest_AssertPass("Call to SDL_CloseAudioDevice()");
+   SDL_free(data);
+
+   return TEST_COMPLETED;
+}
+
+/* Builds a WAVE file with a fmt chunk and a data chunk of (datalen) pseudo-random bytes. */
+static Uint8 *
+_audio_makeWAV(Uint16 formattag, Uint16 channels, Uint16 blockalign, Uint16 bits, Uint16 samplesperblock, Uint32 datalen, int *len)
+{
+   const Uint32 fmtlen = (samplesperblock > 0) ? 20 : 16;
+   const Uint32 rifflen = 4 + (8 + fmtlen) + (8 + datalen);
+   Uint8 *wav = (Uint8 *) SDL_malloc(8 + rifflen);
+   SDL_RWops *rw;
+   Uint32 i, seed = 0x12345;
+
+   if (wav == NULL) {
+      return NULL;
+   }
+   rw = SDL_RWFromMem(wav, 8 + rifflen);
+   SDL_RWwrite(rw, "RIFF", 4, 1);
+   SDL_WriteLE32(rw, rifflen);
+   SDL_RWwrite(rw, "WAVEfmt ", 8, 1);
+   SDL_WriteLE32(rw, fmtlen);
+   SDL_WriteLE16(rw, formattag);
+   SDL_WriteLE16(rw, channels);
+   SDL_WriteLE32(rw, 22050);
+   SDL_WriteLE32(rw, 22050 * blockalign);
+   SDL_WriteLE16(rw, blockalign);
+   SDL_WriteLE16(rw, bits);
+   if (samplesperblock > 0) {
+      SDL_WriteLE16(rw, 2);
+      SDL_WriteLE16(rw, samplesperblock);
+   }
+   SDL_RWwrite(rw, "data", 4, 1);
+   SDL_WriteLE32(rw, datalen);
+   for (i = 0; i < datalen; i++) {
+      seed = seed * 1103515245 + 12345;
+      SDL_WriteU8(rw, (Uint8) (seed >> 16));
+   }
+   SDL_RWclose(rw);
+
+   *len = (int) (8 + rifflen);
+   return wav;
+}
+
+/**
+ * \brief Decodes WAVE files with a WAVE stream and compares against SDL_LoadWAV_RW().
+ *
+ * \sa https://wiki.libsdl.org/SDL_OpenWAVStream_RW
+ * \sa https://wiki.libsdl.org/SDL_WAVStreamRead
+ * \sa https://wiki.libsdl.org/SDL_WAVStreamSeek
+ * \sa https://wiki.libsdl.org/SDL_AudioStreamPutWAV
+ */
+int audio_wavStream()
+{
+   static const struct {
+      const char *name;
+      Uint16 formattag, channels, blockalign, bits, samplesperblock;
+      Uint32 datalen;
+   } tests[] = {
+      { "16-bit PCM stereo", 0x0001, 2, 4, 16, 0, 40000 },
+      { "24-bit PCM mono", 0x0001, 1, 3, 24, 0, 30000 },
+      { "A-law mono", 0x0006, 1, 1, 8, 0, 20000 },
+      { "mu-law stereo", 0x0007, 2, 2, 8, 0, 20000 },
+      { "IMA ADPCM stereo", 0x0011, 2, 256, 4, 249, 256 * 40 },
+      { "IMA ADPCM mono, truncated", 0x0011, 1, 512, 4, 1017, 512 * 20 + 300 },
+      { "sample.wav (MS ADPCM mono)", 0, 0, 0, 0, 0, 0 }
+   };
+   const int seeks[] = { 0, 1, 248, 249, 250, 1017, 5000, 12345 };
+   int n, i;
+
+   /* Every file is decoded twice, once in place from memory and once through the RWops. */
+   for (n = 0; n < SDL_arraysize(tests) * 2; n++) {
+      const int t = n / 2;
+      const SDL_bool inplace = (n % 2) ? SDL_TRUE : SDL_FALSE;
+      SDL_RWops *rw;
+      SDL_AudioSpec spec, streamspec;
+      SDL_WAVStream *wav;
+      SDL_AudioStream *stream;
+      Uint8 *file = NULL, *expected = NULL, *got;
+      Uint32 expected_len = 0;
+      int file_len = 0, framesize, frames, result;
+      Sint64 position;
+
+      if (tests[t].formattag != 0) {
+         file = _audio_makeWAV(tests[t].formattag, tests[t].channels, tests[t].blockalign, tests[t].bits,
+                               tests[t].samplesperblock, tests[t].datalen, &file_len);
+         SDLTest_AssertCheck(file != NULL, "Check WAVE file is not NULL");
+         if (file == NULL) {
+            return TEST_ABORTED;
+         }
+      } else {
+         rw = SDL_RWFromFile("sample.wav", "rb");
+         if (rw == NULL) {
+            SDLTest_Log("Skipping %s: %s", tests[t].name, SDL_GetError());
+            continue;
+         }
+         file_len = (int) SDL_RWsize(rw);
+         file = (Uint8 *) SDL_malloc(file_len);
+         SDLTest_AssertCheck(file != NULL, "Check WAVE file is not NULL");
+         if (file == NULL) {
+            SDL_RWclose(rw);
+            return TEST_ABORTED;
+         }
+         SDL_RWread(rw, file, 1, file_len);
+         SDL_RWclose(rw);
+      }
+
+      SDLTest_AssertCheck(SDL_LoadWAV_RW(SDL_RWFromConstMem(file, file_len), 1, &spec, &expected, &expected_len) != NULL,
+                          "Call to SDL_LoadWAV_RW() with %s", tests[t].name);
+      rw = SDL_RWFromConstMem(file, file_len);
+      if (rw != NULL && !inplace) {
+         /* Hide that the data is in memory, so the stream reads through the RWops. */
+         rw->type = SDL_RWOPS_UNKNOWN;
+      }
+      wav = SDL_OpenWAVStream_RW(rw, 1, &streamspec);
+      SDLTest_AssertPass("Call to SDL_OpenWAVStream_RW() with %s, %s", tests[t].name, inplace ? "in place" : "through the RWops");
+      SDLTest_AssertCheck(wav != NULL, "Check WAVE stream is not NULL");
+      if (wav == NULL || expected == NULL) {
+         SDL_CloseWAVStream(wav);
+         SDL_FreeWAV(expected);
+         SDL_free(file);
+         continue;
+      }
+      SDLTest_AssertCheck(SDL_memcmp(&spec, &streamspec, sizeof(spec)) == 0, "Verify the stream's audio format matches");
+
+      framesize = (SDL_AUDIO_BITSIZE(spec.format) / 8) * spec.channels;
+      frames = (int) (expected_len / framesize);
+      position = SDL_WAVStreamLength(wav);
+      SDLTest_AssertCheck(position == frames, "Verify stream length; expected: %i, got: %i", frames, (int) position);
+
+      got = (Uint8 *) SDL_calloc(frames + 1, framesize);
+      SDLTest_AssertCheck(got != NULL, "Check output buffer is not NULL");
+      if (got == NULL) {
+         SDL_CloseWAVStream(wav);
+         SDL_FreeWAV(expected);
+         SDL_free(file);
+         return TEST_ABORTED;
+      }
+
+      /* Read everything in pieces that don't line up with ADPCM blocks. */
+      for (i = 0; i < frames; ) {
+         result = SDL_WAVStreamRead(wav, got + i * framesize, 777);
+         if (result <= 0) {
+            break;
+         }
+         i += result;
+      }
+      SDLTest_AssertCheck(i == frames, "Verify frames read; expected: %i, got: %i", frames, i);
+      SDLTest_AssertCheck(SDL_memcmp(got, expected, frames * framesize) == 0, "Verify the stream decodes the same audio");
+      result = SDL_WAVStreamRead(wav, got, 1);
+      SDLTest_AssertCheck(result == 0, "Verify reading at the end; expected: 0, got: %i", result);
+
+      for (i = 0; i < SDL_arraysize(seeks); i++) {
+         const int frame = seeks[i] % frames;
+         const int count = SDL_min(frames - frame, 10);
+         result = SDL_WAVStreamSeek(wav, frame);
+         SDLTest_AssertCheck(result == 0, "Verify SDL_WAVStreamSeek(%i) result; expected: 0, got: %i", frame, result);
+         result = SDL_WAVStreamRead(wav, got, count);
+         SDLTest_AssertCheck(result == count, "Verify frames read after seeking; expected: %i, got: %i", count, result);
+         SDLTest_AssertCheck(SDL_memcmp(got, expected + frame * framesize, count * framesize) == 0,
+                             "Verify audio after seeking to frame %i", frame);
+         position = SDL_WAVStreamTell(wav);
+         SDLTest_AssertCheck(position == frame + count, "Verify position; expected: %i, got: %i", frame + count, (int) position);
+      }
+      result = SDL_WAVStreamSeek(wav, frames + 1);
+      SDLTest_AssertCheck(result == -1, "Verify seeking past the end fails; expected: -1, got: %i", result);
+
+      stream = SDL_NewAudioStream(spec.format, spec.channels, spec.freq, spec.format, spec.channels, spec.freq);
+      SDLTest_AssertCheck(stream != NULL, "Check audio stream is not NULL");
+      if (stream != NULL) {
+         SDL_WAVStreamSeek(wav, 0);
+         result = SDL_AudioStreamPutWAV(stream, wav, frames + 100);
+         SDLTest_AssertCheck(result == frames, "Verify SDL_AudioStreamPutWAV() result; expected: %i, got: %i", frames, result);
+         SDL_AudioStreamFlush(stream);
+         result = SDL_AudioStreamGet(stream, got, (frames + 1) * framesize);
+         SDLTest_AssertCheck(result == frames * framesize, "Verify bytes from the audio stream; expected: %i, got: %i", frames * framesize, result);
+         SDLTest_AssertCheck(SDL_memcmp(got, expected, frames * framesize) == 0, "Verify the audio stream got the same audio");
+         SDL_FreeAudioStream(stream);
+      }
+
+      SDL_CloseWAVStream(wav);
+      SDL_FreeWAV(expected);
+      SDL_free(got);
+      SDL_free(file);
+   }
+
+   return TEST_COMPLETED;
+}
+
+/* Reference A-law and mu-law expansion, the formulas from the G.711 standard. */
+static Sint16
+_audio_refLaw(Uint16 formattag, Uint8 byte)
+{
+   if (formattag == 0x0006) {
+      Uint8 exponent = (byte & 0x7f) ^ 0x55;
+      Sint16 mantissa = exponent & 0xf;
+      exponent >>= 4;
+      if (exponent > 0) {
+         mantissa |= 0x10;
+      }
+      mantissa = (mantissa << 4) | 0x8;
+      if (exponent > 1) {
+         mantissa <<= exponent - 1;
+      }
+      return byte & 0x80 ? mantissa : -mantissa;
+   } else {
+      const Uint8 nibble = ~byte;
+      const Uint8 exponent = (nibble >> 4) & 0x7;
+      const Sint16 step = 4 << (exponent + 1);
+      const Sint16 mantissa = (0x80 << exponent) + step * (nibble & 0xf) + step / 2 - 132;
+      return nibble & 0x80 ? -mantissa : mantissa;
+   }
+}
+
+/* Reference IMA ADPCM decoder for one sample frame of channel (c) in a block. */
+static Sint16
+_audio_refIMANibble(Sint32 *index, Sint32 sample, Uint8 nybble)
+{
+   static const Sint8 index_table[16] = { -1, -1, -1, -1, 2, 4, 6, 8, -1, -1, -1, -1, 2, 4, 6, 8 };
+   static const Uint16 step_table[89] = {
+      7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
+      34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130,
+      143, 157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408,
+      449, 494, 544, 598, 658, 724, 796, 876, 963, 1060, 1166, 1282,
+      1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024, 3327,
+      3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630,
+      9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+      22385, 24623, 27086, 29794, 32767
+   };
+   const Sint32 step = step_table[*index];
+   Sint32 delta = step >> 3;
+
+   if (nybble & 0x04) delta += step;
+   if (nybble & 0x02) delta += step >> 1;
+   if (nybble & 0x01) delta += step >> 2;
+   if (nybble & 0x08) delta = -delta;
+
+   *index += index_table[nybble];
+   if (*index < 0) *index = 0;
+   if (*index > 88) *index = 88;
+
+   sample += delta;
+   if (sample > 32767) sample = 32767;
+   if (sample < -32768) sample = -32768;
+   return (Sint16) sample;
+}
+
+/**
+ * \brief Compares A-law, mu-law and IMA ADPCM decoding against reference decoders.
+ *
+ * \sa https://wiki.libsdl.org/SDL_LoadWAV_RW
+ */
+int audio_wavDecodeReference()
+{
+   static const struct {
+      const char *name;
+      Uint16 formattag, channels, blockalign, samplesperblock;
+      Uint32 datalen;
+   } tests[] = {
+      { "A-law mono", 0x0006, 1, 1, 0, 256 * 3 + 5 },
+      { "mu-law stereo", 0x0007, 2, 2, 0, 256 * 3 + 6 },
+      { "IMA ADPCM mono", 0x0011, 1, 256, 500, 256 * 8 },
+      { "IMA ADPCM stereo", 0x0011, 2, 256, 245, 256 * 8 },
+      { "IMA ADPCM 3 channels", 0x0011, 3, 240, 150, 240 * 8 },
+      { "IMA ADPCM stereo, truncated", 0x0011, 2, 512, 505, 512 * 4 + 200 }
+   };
+   int t;
+
+   for (t = 0; t < SDL_arraysize(tests); t++) {
+      const Uint16 channels = tests[t].channels;
+      const Uint16 blockalign = tests[t].blockalign;
+      const int isima = (tests[t].formattag == 0x0011);
+      SDL_AudioSpec spec;
+      Uint8 *file, *data, *audio = NULL;
+      Sint16 *samples;
+      Uint32 audio_len = 0, i, frames, mismatches = 0;
+      int file_len = 0;
+
+      file = _audio_makeWAV(tests[t].formattag, channels, blockalign, isima ? 4 : 8,
+                            tests[t].samplesperblock, tests[t].datalen, &file_len);
+      SDLTest_AssertCheck(file != NULL, "Build %s WAVE file", tests[t].name);
+      if (file == NULL) {
+         return TEST_ABORTED;
+      }
+      data = file + (isima ? 48 : 44);
+      if (!isima) {
+         /* Make sure every byte value gets expanded. */
+         for (i = 0; i < tests[t].datalen; i++) {
+            data[i] = (Uint8) (i * 7);
+         }
+      }
+
+      SDLTest_AssertCheck(SDL_LoadWAV_RW(SDL_RWFromConstMem(file, file_len), 1, &spec, &audio, &audio_len) != NULL,
+                          "Call to SDL_LoadWAV_RW() with %s", tests[t].name);
+      if (audio == NULL) {
+         SDL_free(file);
+         continue;
+      }
+      samples = (Sint16 *) audio;
+      frames = audio_len / (channels * sizeof (Sint16));
+
+      if (!isima) {
+         SDLTest_AssertCheck(frames == tests[t].datalen / channels, "Validate frame count, expected: %u, got: %u",
+                             (unsigned int) (tests[t].datalen / channels), (unsigned int) frames);
+         for (i = 0; i < frames * channels; i++) {
+            if (samples[i] != _audio_refLaw(tests[t].formattag, data[i])) {
+               mismatches++;
+            }
+         }
+      } else {
+         const Uint32 spb = tests[t].samplesperblock;
+         Uint32 frame, c;
+         for (frame = 0; frame < frames; frame++) {
+            const Uint32 block = frame / spb, inblock = frame % spb;
+            const Uint8 *header = data + block * blockalign;
+            if (inblock != 0) {
+               continue;
+            } else if (block * blockalign + channels * 4 > tests[t].datalen) {
+               /* The decoder produced a frame without a block header. */
+               mismatches++;
+               continue;
+            }
+            for (c = 0; c < channels; c++) {
+               Sint32 index = (Sint8) header[c * 4 + 2];
+               Sint16 sample = (Sint16) (header[c * 4] | (header[c * 4 + 1] << 8));
+               Uint32 n;
+               if (index < 0) index = 0;
+               if (index > 88) index = 88;
+               if (samples[frame * channels + c] != sample) {
+                  mismatches++;
+               }
+               for (n = 0; n < spb - 1 && frame + 1 + n < frames; n++) {
+                  const Uint8 byte = header[channels * 4 + (n / 8) * channels * 4 + c * 4 + (n % 8) / 2];
+                  sample = _audio_refIMANibble(&index, sample, (byte >> ((n & 1) * 4)) & 0x0f);
+                  if (samples[(frame + 1 + n) * channels + c] != sample) {
+                     mismatches++;
+                  }
+               }
+            }
+         }
+      }
+      SDLTest_AssertCheck(frames > 0 && mismatches == 0, "Validate %s against the reference decoder, %u frames, %u mismatches",
+                          tests[t].name, (unsigned int) frames, (unsigned int) mismatches);
+
+      SDL_FreeWAV(audio);
+      SDL_free(file);
+   }
+
+   return TEST_COMPLETED;
+}
 
 /* ================= Test Case References ================== */
 
@@ -1022,11 +2259,43 @@ static const SDLTest_TestCaseReference audioTest14 =
 static const SDLTest_TestCaseReference audioTest15 =
         { (SDLTest_TestCaseFp)audio_pauseUnpauseAudio, "audio_pauseUnpauseAudio", "Pause and Unpause audio for various audio specs while testing callback.", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference audioTest16 =
+        { (SDLTest_TestCaseFp)audio_resamplerQuality, "audio_resamplerQuality", "Resample audio streams at every resampler quality.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest17 =
+        { (SDLTest_TestCaseFp)audio_mixAudioFormat, "audio_mixAudioFormat", "Mix S16, S32 and F32 audio and compare against a reference.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest18 =
+        { (SDLTest_TestCaseFp)audio_convertAudioTypes, "audio_convertAudioTypes", "Compare the sample type converters against plain C conversions.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest19 =
+        { (SDLTest_TestCaseFp)audio_convertChannels, "audio_convertChannels", "Compare every channel conversion against a reference mix.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest20 =
+        { (SDLTest_TestCaseFp)audio_convertAudioSamples, "audio_convertAudioSamples", "Convert audio on several threads and compare against an audio stream.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest21 =
+        { (SDLTest_TestCaseFp)audio_queueAudioLockFree, "audio_queueAudioLockFree", "Queue audio through the lock-free ring.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest22 =
+        { (SDLTest_TestCaseFp)audio_getAudioDeviceStats, "audio_getAudioDeviceStats", "Check the audio device statistics.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest23 =
+        { (SDLTest_TestCaseFp)audio_wavStream, "audio_wavStream", "Decode WAVE files with a WAVE stream and compare against SDL_LoadWAV_RW.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest24 =
+        { (SDLTest_TestCaseFp)audio_wavDecodeReference, "audio_wavDecodeReference", "Compare companded and IMA ADPCM decoding against reference decoders.", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference audioTest25 =
+        { (SDLTest_TestCaseFp)audio_convertAudioTypeTiers, "audio_convertAudioTypeTiers", "Force each SIMD tier of the sample type converters and compare against scalar.", TEST_ENABLED };
+
 /* Sequence of Audio test cases */
 static const SDLTest_TestCaseReference *audioTests[] =  {
     &audioTest1, &audioTest2, &audioTest3, &audioTest4, &audioTest5, &audioTest6,
     &audioTest7, &audioTest8, &audioTest9, &audioTest10, &audioTest11,
-    &audioTest12, &audioTest13, &audioTest14, &audioTest15, NULL
+    &audioTest12, &audioTest13, &audioTest14, &audioTest15, &audioTest16,
+    &audioTest17, &audioTest18, &audioTest19, &audioTest20, &audioTest21, &audioTest22, &audioTest23,
+    &audioTest24, &audioTest25, NULL
 };
 
 /* Audio test suite (global) */
@@ -73,6 +73,131 @@ events_pushPumpAndPollUserevent(void *arg)
 }
 
 
+/**
+ * @brief Test draining several events with a single call.
+ *
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_PollEvents
+ */
+int
+events_pushAndPollEvents(void *arg)
+{
+   SDL_Event events[8];
+   int i, result;
+
+   /* Start from an empty queue */
+   SDL_PumpEvents();
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+   SDLTest_AssertPass("Call to SDL_FlushEvents()");
+
+   /* Push three user events onto the queue */
+   for (i = 0; i < 3; ++i) {
+      SDL_zero(events[0]);
+      events[0].type = SDL_USEREVENT;
+      events[0].user.code = i;
+      SDL_PushEvent(&events[0]);
+   }
+   SDLTest_AssertPass("Call to SDL_PushEvent()");
+
+   /* Drain only part of the queue */
+   result = SDL_PollEvents(events, 2);
+   SDLTest_AssertPass("Call to SDL_PollEvents()");
+   SDLTest_AssertCheck(result == 2, "Check result from SDL_PollEvents, expected: 2, got: %d", result);
+   for (i = 0; i < 2; ++i) {
+      SDLTest_AssertCheck(events[i].type == SDL_USEREVENT && events[i].user.code == i, "Check event %d, expected: code %d, got: type %u code %d", i, i, (unsigned)events[i].type, events[i].user.code);
+   }
+
+   /* Drain the rest */
+   result = SDL_PollEvents(events, SDL_arraysize(events));
+   SDLTest_AssertPass("Call to SDL_PollEvents()");
+   SDLTest_AssertCheck(result == 1, "Check result from SDL_PollEvents, expected: 1, got: %d", result);
+   SDLTest_AssertCheck(events[0].type == SDL_USEREVENT && events[0].user.code == 2, "Check event 2, expected: code 2, got: type %u code %d", (unsigned)events[0].type, events[0].user.code);
+
+   /* Nothing left */
+   result = SDL_PollEvents(events, SDL_arraysize(events));
+   SDLTest_AssertPass("Call to SDL_PollEvents()");
+   SDLTest_AssertCheck(result == 0, "Check result from SDL_PollEvents, expected: 0, got: %d", result);
+
+   /* Invalid buffer */
+   result = SDL_PollEvents(NULL, 1);
+   SDLTest_AssertPass("Call to SDL_PollEvents(NULL, 1)");
+   SDLTest_AssertCheck(result == -1, "Check result from SDL_PollEvents, expected: -1, got: %d", result);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Test merging of consecutive motion events with SDL_HINT_EVENT_COALESCING.
+ *
+ * @sa http://wiki.libsdl.org/moin.cgi/SDL_GetCoalescedEventCount
+ */
+int
+events_coalesceMouseMotion(void *arg)
+{
+   SDL_Event events[8];
+   Uint32 merged;
+   int i, result;
+
+   SDL_SetHint(SDL_HINT_EVENT_COALESCING, "1");
+   SDL_PumpEvents();
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+   merged = SDL_GetCoalescedEventCount(SDL_MOUSEMOTION);
+
+   /* Three motion events, a button press, then one more motion event */
+   for (i = 0; i < 5; ++i) {
+      SDL_zero(events[0]);
+      if (i == 3) {
+         events[0].type = SDL_MOUSEBUTTONDOWN;
+         events[0].button.button = SDL_BUTTON_LEFT;
+      } else {
+         events[0].type = SDL_MOUSEMOTION;
+         events[0].motion.x = 10 + i;
+         events[0].motion.y = 20 + i;
+         events[0].motion.xrel = 1;
+         events[0].motion.yrel = -1;
+      }
+      SDL_PushEvent(&events[0]);
+   }
+   SDLTest_AssertPass("Call to SDL_PushEvent()");
+
+   result = SDL_PollEvents(events, SDL_arraysize(events));
+   SDLTest_AssertPass("Call to SDL_PollEvents()");
+   SDLTest_AssertCheck(result == 3, "Check result from SDL_PollEvents, expected: 3, got: %d", result);
+   SDLTest_AssertCheck(events[0].type == SDL_MOUSEMOTION, "Check first event type, expected: SDL_MOUSEMOTION, got: 0x%x", (unsigned)events[0].type);
+   SDLTest_AssertCheck(events[0].motion.x == 12 && events[0].motion.y == 22, "Check merged position, expected: 12,22, got: %d,%d", events[0].motion.x, events[0].motion.y);
+   SDLTest_AssertCheck(events[0].motion.xrel == 3 && events[0].motion.yrel == -3, "Check merged relative motion, expected: 3,-3, got: %d,%d", events[0].motion.xrel, events[0].motion.yrel);
+   SDLTest_AssertCheck(events[1].type == SDL_MOUSEBUTTONDOWN, "Check second event type, expected: SDL_MOUSEBUTTONDOWN, got: 0x%x", (unsigned)events[1].type);
+   SDLTest_AssertCheck(events[2].type == SDL_MOUSEMOTION && events[2].motion.xrel == 1, "Check last event, expected: unmerged SDL_MOUSEMOTION, got: 0x%x xrel %d", (unsigned)events[2].type, events[2].motion.xrel);
+
+   merged = SDL_GetCoalescedEventCount(SDL_MOUSEMOTION) - merged;
+   SDLTest_AssertPass("Call to SDL_GetCoalescedEventCount()");
+   SDLTest_AssertCheck(merged == 2, "Check coalesced event count, expected: 2, got: %u", (unsigned)merged);
+
+   /* Fill the queue with motion events that can't merge, alternating mice */
+   SDL_zero(events[0]);
+   events[0].type = SDL_MOUSEMOTION;
+   for (i = 0; ; ++i) {
+      events[0].motion.which = i & 1;
+      if (SDL_PushEvent(&events[0]) <= 0) {
+         break;
+      }
+   }
+   SDLTest_AssertCheck(i > 0, "Check the queue filled up, expected: >0 events, got: %d", i);
+
+   /* A full queue still takes events that merge into its tail */
+   merged = SDL_GetCoalescedEventCount(SDL_MOUSEMOTION);
+   events[0].motion.which = (i - 1) & 1;
+   result = SDL_PushEvent(&events[0]);
+   SDLTest_AssertPass("Call to SDL_PushEvent()");
+   SDLTest_AssertCheck(result == 1, "Check result from SDL_PushEvent on a full queue, expected: 1, got: %d", result);
+   merged = SDL_GetCoalescedEventCount(SDL_MOUSEMOTION) - merged;
+   SDLTest_AssertCheck(merged == 1, "Check coalesced event count, expected: 1, got: %u", (unsigned)merged);
+   SDL_FlushEvents(SDL_FIRSTEVENT, SDL_LASTEVENT);
+
+   SDL_SetHint(SDL_HINT_EVENT_COALESCING, NULL);
+
+   return TEST_COMPLETED;
+}
+
 /**
  * @brief Adds and deletes an event watch function with NULL userdata
  *
@@ -187,9 +312,15 @@ static const SDLTest_TestCaseReference eventsTest2 =
 static const SDLTest_TestCaseReference eventsTest3 =
         { (SDLTest_TestCaseFp)events_addDelEventWatchWithUserdata, "events_addDelEventWatchWithUserdata", "Adds and deletes an event watch function with userdata", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference eventsTest4 =
+        { (SDLTest_TestCaseFp)events_pushAndPollEvents, "events_pushAndPollEvents", "Pushes several user events and drains them with SDL_PollEvents", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference eventsTest5 =
+        { (SDLTest_TestCaseFp)events_coalesceMouseMotion, "events_coalesceMouseMotion", "Merges consecutive mouse motion events with SDL_HINT_EVENT_COALESCING", TEST_ENABLED };
+
 /* Sequence of Events test cases */
 static const SDLTest_TestCaseReference *eventsTests[] =  {
-    &eventsTest1, &eventsTest2, &eventsTest3, NULL
+    &eventsTest1, &eventsTest2, &eventsTest3, &eventsTest4, &eventsTest5, NULL
 };
 
 /* Events test suite (global) */
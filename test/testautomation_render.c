@@ -766,6 +766,72 @@ render_testBlitBlend (void *arg)
 }
 
 
+/**
+ * @brief Tests the counters returned by SDL_RenderGetStats.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderGetStats
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderPresent
+ */
+int
+render_testRenderStats(void *arg)
+{
+   int ret;
+   SDL_Rect rect;
+   SDL_Texture *texture;
+   SDL_RenderStats stats;
+   Uint32 pixels[4 * 4];
+
+   /* Clear surface. */
+   _clearScreen();
+
+   /* Invalid parameters. */
+   ret = SDL_RenderGetStats(renderer, NULL);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_RenderGetStats(renderer, NULL), expected: -1, got: %i", ret);
+
+   texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 4, 4);
+   SDLTest_AssertCheck(texture != NULL, "Verify SDL_CreateTexture() result");
+   if (texture == NULL) {
+       return TEST_ABORTED;
+   }
+   SDL_memset(pixels, 0xFF, sizeof (pixels));
+
+   /* Draw one frame. */
+   rect.x = 10;
+   rect.y = 10;
+   rect.w = 20;
+   rect.h = 20;
+   SDL_RenderClear(renderer);
+   SDL_RenderFillRect(renderer, &rect);
+   rect.x = 40;
+   SDL_RenderFillRect(renderer, &rect);
+   ret = SDL_UpdateTexture(texture, NULL, pixels, 4 * sizeof (Uint32));
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_UpdateTexture, expected: 0, got: %i", ret);
+   SDL_RenderPresent(renderer);
+
+   ret = SDL_RenderGetStats(renderer, &stats);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGetStats, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(stats.clear_commands == 1, "Verify clear_commands, expected: 1, got: %u", (unsigned int) stats.clear_commands);
+   SDLTest_AssertCheck(stats.fill_rect_commands == 2, "Verify fill_rect_commands, expected: 2, got: %u", (unsigned int) stats.fill_rect_commands);
+   SDLTest_AssertCheck(stats.draw_calls == 3, "Verify draw_calls, expected: 3, got: %u", (unsigned int) stats.draw_calls);
+   SDLTest_AssertCheck(stats.flushes >= 1, "Verify flushes, expected: >= 1, got: %u", (unsigned int) stats.flushes);
+   SDLTest_AssertCheck(stats.texture_updates == 1, "Verify texture_updates, expected: 1, got: %u", (unsigned int) stats.texture_updates);
+   SDLTest_AssertCheck(stats.texture_update_bytes == sizeof (pixels), "Verify texture_update_bytes, expected: %u, got: %u", (unsigned int) sizeof (pixels), (unsigned int) stats.texture_update_bytes);
+
+   /* An empty frame resets the counters. */
+   SDL_RenderPresent(renderer);
+   ret = SDL_RenderGetStats(renderer, &stats);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderGetStats, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(stats.draw_calls == 0, "Verify draw_calls, expected: 0, got: %u", (unsigned int) stats.draw_calls);
+   SDLTest_AssertCheck(stats.texture_updates == 0, "Verify texture_updates, expected: 0, got: %u", (unsigned int) stats.texture_updates);
+
+   /* Clean up. */
+   SDL_DestroyTexture(texture);
+
+   return TEST_COMPLETED;
+}
+
+
 /**
  * @brief Checks to see if functionality is supported. Helper function.
  */
@@ -1085,9 +1151,12 @@ static const SDLTest_TestCaseReference renderTest6 =
 static const SDLTest_TestCaseReference renderTest7 =
         {  (SDLTest_TestCaseFp)render_testBlitBlend, "render_testBlitBlend", "Tests blitting with blending", TEST_DISABLED };
 
+static const SDLTest_TestCaseReference renderTest8 =
+        { (SDLTest_TestCaseFp)render_testRenderStats, "render_testRenderStats", "Tests call to SDL_RenderGetStats", TEST_ENABLED };
+
 /* Sequence of Render test cases */
 static const SDLTest_TestCaseReference *renderTests[] =  {
-    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, NULL
+    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, &renderTest8, NULL
 };
 
 /* Render test suite (global) */
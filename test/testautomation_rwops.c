@@ -334,6 +334,228 @@ rwops_testFileRead(void)
    return TEST_COMPLETED;
 }
 
+/**
+ * @brief Tests reading from a memory-mapped file.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWFromFile
+ * http://wiki.libsdl.org/moin.cgi/SDL_RWGetMemory
+ * http://wiki.libsdl.org/moin.cgi/SDL_LoadFile_RW
+ */
+int
+rwops_testMappedFileRead(void)
+{
+#if (defined(__LINUX__) || defined(__MACOSX__)) && !defined(__ANDROID__)
+   const Uint32 expectedType = SDL_RWOPS_MAPPED;
+#else
+   const Uint32 expectedType = SDL_RWOPS_STDFILE;
+#endif
+   SDL_RWops *rw;
+   const void *mem;
+   char *data;
+   size_t size = 0;
+   FILE *handle;
+   int result;
+
+   /* Read test. */
+   rw = SDL_RWFromFile(RWopsReadTestFilename, "rbm");
+   SDLTest_AssertPass("Call to SDL_RWFromFile(..,\"rbm\") succeeded");
+   SDLTest_AssertCheck(rw != NULL, "Verify opening file with SDL_RWFromFile in mapped read mode does not return NULL");
+
+   /* Bail out if NULL */
+   if (rw == NULL) return TEST_ABORTED;
+
+#if !defined(__WIN32__) && !defined(__ANDROID__)
+   SDLTest_AssertCheck(
+      rw->type == expectedType,
+      "Verify RWops type; expected: %d, got: %d", (int) expectedType, rw->type);
+#endif
+
+   /* Run generic tests */
+   _testGenericRWopsValidations( rw, 0 );
+
+   /* Mapped files give direct access to their contents */
+   mem = SDL_RWGetMemory(rw, &size);
+   SDLTest_AssertPass("Call to SDL_RWGetMemory() succeeded");
+   if (rw->type == SDL_RWOPS_MAPPED) {
+      SDLTest_AssertCheck(
+         mem != NULL && size == SDL_strlen(RWopsHelloWorldTestString) &&
+         SDL_memcmp(mem, RWopsHelloWorldTestString, size) == 0,
+         "Verify SDL_RWGetMemory() returns the file contents; got size %d", (int) size);
+   } else {
+      SDLTest_AssertCheck(mem == NULL, "Verify SDL_RWGetMemory() returns NULL for a file");
+   }
+
+   /* Load the rest of the file from the middle */
+   SDL_RWseek(rw, 6, RW_SEEK_SET);
+   data = (char *) SDL_LoadFile_RW(rw, &size, 0);
+   SDLTest_AssertPass("Call to SDL_LoadFile_RW() succeeded");
+   SDLTest_AssertCheck(
+      data != NULL && size == 6 && SDL_strcmp(data, "World!") == 0,
+      "Verify SDL_LoadFile_RW() loads the rest of the file; expected: 'World!', got: '%s'", data ? data : "(null)");
+   SDL_free(data);
+   SDLTest_AssertCheck(SDL_RWtell(rw) == SDL_RWsize(rw), "Verify SDL_LoadFile_RW() read to the end of the file");
+
+   /* Close handle */
+   result = SDL_RWclose(rw);
+   SDLTest_AssertPass("Call to SDL_RWclose() succeeded");
+   SDLTest_AssertCheck(result == 0, "Verify result value is 0; got: %d", result);
+
+   /* The hint maps read-only files, but never files opened for writing */
+   SDL_SetHint(SDL_HINT_RWOPS_MMAP, "1");
+   rw = SDL_RWFromFile(RWopsReadTestFilename, "r");
+   SDLTest_AssertCheck(rw != NULL, "Verify opening file with SDL_HINT_RWOPS_MMAP set does not return NULL");
+   if (rw != NULL) {
+#if !defined(__WIN32__) && !defined(__ANDROID__)
+      SDLTest_AssertCheck(
+         rw->type == expectedType,
+         "Verify RWops type with SDL_HINT_RWOPS_MMAP set; expected: %d, got: %d", (int) expectedType, rw->type);
+#endif
+      SDL_RWclose(rw);
+   }
+   rw = SDL_RWFromFile(RWopsReadTestFilename, "r+");
+   SDLTest_AssertCheck(rw != NULL && rw->type != SDL_RWOPS_MAPPED,
+      "Verify files opened for update are not mapped");
+   if (rw != NULL) {
+      _testGenericRWopsValidations( rw, 1 );
+      SDL_RWclose(rw);
+   }
+   SDL_SetHint(SDL_HINT_RWOPS_MMAP, NULL);
+
+#if !defined(__WIN32__) && !defined(__ANDROID__)
+   /* Mapped modes too long to pass on to fopen() are rejected, not truncated */
+   rw = SDL_RWFromFile(RWopsReadTestFilename, "rbme,ccs=UTF-8");
+   SDLTest_AssertCheck(rw == NULL, "Verify opening a file with an over-long mapped mode returns NULL");
+   if (rw != NULL) {
+      SDL_RWclose(rw);
+   }
+#endif
+
+   /* Empty files can't be mapped and are opened as regular files */
+   handle = fopen(RWopsWriteTestFilename, "w");
+   SDLTest_AssertCheck(handle != NULL, "Verify creation of empty file '%s'", RWopsWriteTestFilename);
+   if (handle == NULL) return TEST_ABORTED;
+   fclose(handle);
+   rw = SDL_RWFromFile(RWopsWriteTestFilename, "rbm");
+   SDLTest_AssertCheck(rw != NULL, "Verify opening an empty file with SDL_RWFromFile in mapped read mode does not return NULL");
+   if (rw != NULL) {
+      SDLTest_AssertCheck(rw->type != SDL_RWOPS_MAPPED, "Verify an empty file is not mapped; got type: %d", rw->type);
+      SDLTest_AssertCheck(SDL_RWsize(rw) == 0, "Verify the size of the empty file is 0");
+      SDL_RWclose(rw);
+   }
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests a buffer around memory and file streams.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_CreateBufferedRW
+ */
+int
+rwops_testBuffered(void)
+{
+   char mem[sizeof(RWopsHelloWorldTestString)];
+   char buf[sizeof(RWopsAlphabetString)];
+   const int slen = (int) SDL_strlen(RWopsAlphabetString);
+   SDL_RWops *src, *rw;
+   Sint64 i;
+   size_t s;
+   int n, result;
+
+   /* Memory stream with a tiny buffer, so reads and writes cross it */
+   SDL_zeroa(mem);
+   src = SDL_RWFromMem(mem, sizeof(RWopsHelloWorldTestString)-1);
+   rw = SDL_CreateBufferedRW(src, 5, 1);
+   SDLTest_AssertPass("Call to SDL_CreateBufferedRW() succeeded");
+   SDLTest_AssertCheck(rw != NULL, "Verify buffered memory stream is not NULL");
+   if (rw == NULL) return TEST_ABORTED;
+   SDLTest_AssertCheck(rw->type == SDL_RWOPS_BUFFERED, "Verify RWops type is SDL_RWOPS_BUFFERED; expected: %d, got: %d", SDL_RWOPS_BUFFERED, rw->type);
+   _testGenericRWopsValidations(rw, 1);
+   result = SDL_RWclose(rw);
+   SDLTest_AssertCheck(result == 0, "Verify result value is 0; got: %d", result);
+   SDLTest_AssertCheck(SDL_memcmp(mem, RWopsHelloWorldTestString, sizeof(RWopsHelloWorldTestString)-1) == 0,
+      "Verify the buffered writes reached memory");
+
+   /* Read a file in odd pieces, seeking inside and outside the buffer */
+   src = SDL_RWFromFile(RWopsAlphabetFilename, "rb");
+   SDLTest_AssertCheck(src != NULL, "Verify opening file with SDL_RWFromFile in read mode does not return NULL");
+   if (src == NULL) return TEST_ABORTED;
+   rw = SDL_CreateBufferedRW(src, 7, 0);
+   SDLTest_AssertCheck(rw != NULL, "Verify buffered file stream is not NULL");
+   if (rw == NULL) {
+      SDL_RWclose(src);
+      return TEST_ABORTED;
+   }
+   for (n = 0; n < slen; n++) {
+      s = SDL_RWread(rw, buf, 1, 1);
+      if (s != 1 || buf[0] != RWopsAlphabetString[n]) {
+         break;
+      }
+   }
+   SDLTest_AssertCheck(n == slen, "Verify reading the file a byte at a time; expected: %d bytes, got: %d", slen, n);
+   s = SDL_RWread(rw, buf, 1, 1);
+   SDLTest_AssertCheck(s == 0, "Verify reading at the end of the file returns 0; got: %d", (int) s);
+
+   i = SDL_RWseek(rw, 24, RW_SEEK_SET);
+   SDLTest_AssertCheck(i == 24, "Verify seek to 24 (RW_SEEK_SET), expected 24, got %"SDL_PRIs64, i);
+   i = SDL_RWseek(rw, -22, RW_SEEK_CUR);
+   SDLTest_AssertCheck(i == 2, "Verify seek to -22 (RW_SEEK_CUR), expected 2, got %"SDL_PRIs64, i);
+   s = SDL_RWread(rw, buf, 3, 2);
+   SDLTest_AssertCheck(s == 2 && SDL_memcmp(buf, "CDEFGH", 6) == 0, "Verify reading 2 objects of 3 bytes after seeking");
+   i = SDL_RWseek(rw, -3, RW_SEEK_CUR);
+   SDLTest_AssertCheck(i == 5, "Verify seek to -3 (RW_SEEK_CUR), expected 5, got %"SDL_PRIs64, i);
+   s = SDL_RWread(rw, buf, 1, sizeof(buf));
+   SDLTest_AssertCheck(s == (size_t) (slen - 5) && SDL_memcmp(buf, RWopsAlphabetString + 5, slen - 5) == 0,
+      "Verify reading the rest of the file; expected: %d, got: %d", slen - 5, (int) s);
+   i = SDL_RWseek(rw, -10, RW_SEEK_END);
+   SDLTest_AssertCheck(i == slen - 10, "Verify seek to -10 (RW_SEEK_END), expected %d, got %"SDL_PRIs64, slen - 10, i);
+   s = SDL_RWread(rw, buf, 1, 2);
+   SDLTest_AssertCheck(s == 2 && SDL_memcmp(buf, RWopsAlphabetString + slen - 10, 2) == 0, "Verify reading after seeking from the end");
+   SDLTest_AssertCheck(SDL_RWsize(rw) == slen, "Verify size of the buffered file; expected: %d, got: %d", slen, (int) SDL_RWsize(rw));
+
+   /* Closing the buffer leaves the file where the reader was */
+   result = SDL_RWclose(rw);
+   SDLTest_AssertCheck(result == 0, "Verify result value is 0; got: %d", result);
+   i = SDL_RWtell(src);
+   SDLTest_AssertCheck(i == slen - 8, "Verify the file position after closing the buffer; expected: %d, got: %"SDL_PRIs64, slen - 8, i);
+   SDL_RWclose(src);
+
+   /* Write a file a byte at a time and read it back through the same buffer */
+   rw = SDL_CreateBufferedRW(SDL_RWFromFile(RWopsWriteTestFilename, "w+b"), 8, 1);
+   SDLTest_AssertCheck(rw != NULL, "Verify buffered file stream in write mode is not NULL");
+   if (rw == NULL) return TEST_ABORTED;
+   for (n = 0; n < slen; n++) {
+      if (SDL_RWwrite(rw, RWopsAlphabetString + n, 1, 1) != 1) {
+         break;
+      }
+   }
+   SDLTest_AssertCheck(n == slen, "Verify writing the file a byte at a time; expected: %d bytes, got: %d", slen, n);
+   i = SDL_RWtell(rw);
+   SDLTest_AssertCheck(i == slen, "Verify position after writing; expected: %d, got: %"SDL_PRIs64, slen, i);
+   i = SDL_RWseek(rw, 0, RW_SEEK_SET);
+   SDLTest_AssertCheck(i == 0, "Verify seek to 0 (RW_SEEK_SET), expected 0, got %"SDL_PRIs64, i);
+   s = SDL_RWread(rw, buf, 1, 4);
+   SDLTest_AssertCheck(s == 4 && SDL_memcmp(buf, "ABCD", 4) == 0, "Verify reading back what was written");
+   s = SDL_RWwrite(rw, "xy", 1, 2);
+   SDLTest_AssertCheck(s == 2, "Verify writing after reading; expected: 2, got: %d", (int) s);
+   s = SDL_RWread(rw, buf, 1, 2);
+   SDLTest_AssertCheck(s == 2 && SDL_memcmp(buf, "GH", 2) == 0, "Verify reading after writing continues after the written data");
+   result = SDL_RWclose(rw);
+   SDLTest_AssertCheck(result == 0, "Verify result value is 0; got: %d", result);
+
+   rw = SDL_RWFromFile(RWopsWriteTestFilename, "rb");
+   SDLTest_AssertCheck(rw != NULL, "Verify reopening the written file does not return NULL");
+   if (rw == NULL) return TEST_ABORTED;
+   s = SDL_RWread(rw, buf, 1, sizeof(buf));
+   SDLTest_AssertCheck(s == (size_t) slen && SDL_memcmp(buf, "ABCDxyGHIJ", 10) == 0 &&
+      SDL_memcmp(buf + 10, RWopsAlphabetString + 10, slen - 10) == 0, "Verify the written file contents");
+   SDL_RWclose(rw);
+
+   return TEST_COMPLETED;
+}
+
 /**
  * @brief Tests writing from file.
  *
@@ -733,10 +955,16 @@ static const SDLTest_TestCaseReference rwopsTest9 =
 static const SDLTest_TestCaseReference rwopsTest10 =
         { (SDLTest_TestCaseFp)rwops_testCompareRWFromMemWithRWFromFile, "rwops_testCompareRWFromMemWithRWFromFile", "Compare RWFromMem and RWFromFile RWops for read and seek", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference rwopsTest11 =
+        { (SDLTest_TestCaseFp)rwops_testMappedFileRead, "rwops_testMappedFileRead", "Tests reading from a memory-mapped file", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference rwopsTest12 =
+        { (SDLTest_TestCaseFp)rwops_testBuffered, "rwops_testBuffered", "Tests a buffer around memory and file streams", TEST_ENABLED };
+
 /* Sequence of RWops test cases */
 static const SDLTest_TestCaseReference *rwopsTests[] =  {
     &rwopsTest1, &rwopsTest2, &rwopsTest3, &rwopsTest4, &rwopsTest5, &rwopsTest6,
-    &rwopsTest7, &rwopsTest8, &rwopsTest9, &rwopsTest10, NULL
+    &rwopsTest7, &rwopsTest8, &rwopsTest9, &rwopsTest10, &rwopsTest11, &rwopsTest12, NULL
 };
 
 /* RWops test suite (global) */
@@ -0,0 +1,115 @@
+/*
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Measure how SDL_ConvertAudioSamples() scales with the number of threads,
+   converting a long recording the way a tool or an asset loader would, and
+   check that every thread count gives the same output. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define INPUT_SECONDS   60
+
+static SDL_bool
+RunConvertTest(const int inrate, const int dst_channels, const int outrate, const int max_threads)
+{
+    const int frames = inrate * INPUT_SECONDS;
+    const int src_len = frames * 2 * sizeof (Sint16);
+    Sint16 *input = (Sint16 *) SDL_malloc(src_len);
+    void *reference = NULL;
+    int reference_len = 0;
+    double single_time = 0.0;
+    SDL_bool ok = SDL_TRUE;
+    int threads, i;
+
+    if (!input) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory\n");
+        return SDL_FALSE;
+    }
+
+    for (i = 0; i < frames; i++) {
+        const Sint16 sample = (Sint16) (SDL_sin(i * 2.0 * M_PI * 440.0 / inrate) * 16384.0);
+        input[i * 2] = sample;
+        input[i * 2 + 1] = -sample;
+    }
+
+    for (threads = 1; threads <= max_threads; threads++) {
+        void *output = NULL;
+        int output_len = 0;
+        Uint64 start, elapsed;
+        double seconds;
+
+        start = SDL_GetPerformanceCounter();
+        if (SDL_ConvertAudioSamples(AUDIO_S16SYS, 2, inrate, input, src_len,
+                                    AUDIO_F32SYS, dst_channels, outrate, &output, &output_len, threads) < 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_ConvertAudioSamples failed: %s\n", SDL_GetError());
+            ok = SDL_FALSE;
+            break;
+        }
+        elapsed = SDL_GetPerformanceCounter() - start;
+        seconds = (double) elapsed / (double) SDL_GetPerformanceFrequency();
+
+        if (threads == 1) {
+            reference = output;
+            reference_len = output_len;
+            single_time = seconds;
+        } else {
+            if ((output_len != reference_len) || (SDL_memcmp(output, reference, output_len) != 0)) {
+                ok = SDL_FALSE;
+            }
+            SDL_free(output);
+        }
+
+        SDL_Log("S16 stereo %5d Hz -> F32 %d channels %5d Hz, %2d threads: %7.1fx realtime, %4.2fx speedup%s\n",
+                inrate, dst_channels, outrate, threads, INPUT_SECONDS / seconds, single_time / seconds,
+                ok ? "" : " (DATA MISMATCH!)");
+    }
+
+    SDL_free(reference);
+    SDL_free(input);
+    return ok;
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_bool ok = SDL_TRUE;
+    int max_threads = SDL_GetCPUCount();
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (argc > 1) {
+        max_threads = SDL_atoi(argv[1]);
+    }
+    if (max_threads < 1) {
+        max_threads = 1;
+    }
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Log("Converting %d seconds of audio on 1 to %d threads\n", INPUT_SECONDS, max_threads);
+    ok &= RunConvertTest(44100, 2, 48000, max_threads);
+    ok &= RunConvertTest(48000, 2, 44100, max_threads);
+    ok &= RunConvertTest(44100, 6, 48000, max_threads);
+    ok &= RunConvertTest(48000, 6, 48000, max_threads);
+
+    SDL_Quit();
+    return ok ? 0 : 1;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,410 @@
+/*
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Check SDL's internal data queue, which backs SDL_QueueAudio() and
+   SDL_AudioStream, and measure its throughput next to the packet list it
+   replaced. Both are built into this program, so they're timed the same way. */
+
+/* Build the queue against SDL's public API rather than its internal symbols. */
+#define SDL_dynapi_h_
+#define SDL_DYNAMIC_API 0
+#include "../src/SDL_internal.h"
+#include "../src/SDL_dataqueue.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TOTAL_BYTES     (256 * 1024 * 1024)
+#define READ_SIZE       4096
+#define MAX_WRITE_SIZE  (64 * 1024)
+#define PACKET_SIZE     (8 * 1024)  /* what SDL_QueueAudio() uses. */
+
+
+/* The linked list of fixed-size packets that SDL_DataQueue used to be. */
+
+typedef struct PacketQueuePacket
+{
+    size_t datalen;  /* bytes currently in use in this packet. */
+    size_t startpos;  /* bytes currently consumed in this packet. */
+    struct PacketQueuePacket *next;  /* next item in linked list. */
+    Uint8 data[SDL_VARIABLE_LENGTH_ARRAY];  /* packet data */
+} PacketQueuePacket;
+
+typedef struct PacketQueue
+{
+    PacketQueuePacket *head; /* device fed from here. */
+    PacketQueuePacket *tail; /* queue fills to here. */
+    PacketQueuePacket *pool; /* these are unused packets. */
+    size_t packet_size;   /* size of new packets */
+    size_t queued_bytes;  /* number of bytes of data in the queue. */
+} PacketQueue;
+
+static void
+FreePacketQueueList(PacketQueuePacket *packet)
+{
+    while (packet) {
+        PacketQueuePacket *next = packet->next;
+        SDL_free(packet);
+        packet = next;
+    }
+}
+
+static void *
+NewPacketQueue(const size_t packetlen, const size_t initialslack)
+{
+    PacketQueue *queue = (PacketQueue *) SDL_calloc(1, sizeof (PacketQueue));
+    const size_t wantpackets = (initialslack + (packetlen - 1)) / packetlen;
+    size_t i;
+
+    if (!queue) {
+        return NULL;
+    }
+    queue->packet_size = packetlen;
+
+    for (i = 0; i < wantpackets; i++) {
+        PacketQueuePacket *packet = (PacketQueuePacket *) SDL_malloc(sizeof (PacketQueuePacket) + packetlen);
+        if (packet) {
+            packet->datalen = 0;
+            packet->startpos = 0;
+            packet->next = queue->pool;
+            queue->pool = packet;
+        }
+    }
+    return queue;
+}
+
+static void
+FreePacketQueue(void *_queue)
+{
+    PacketQueue *queue = (PacketQueue *) _queue;
+    FreePacketQueueList(queue->head);
+    FreePacketQueueList(queue->pool);
+    SDL_free(queue);
+}
+
+static PacketQueuePacket *
+AllocatePacket(PacketQueue *queue)
+{
+    PacketQueuePacket *packet = queue->pool;
+
+    if (packet != NULL) {
+        queue->pool = packet->next;
+    } else {
+        packet = (PacketQueuePacket *) SDL_malloc(sizeof (PacketQueuePacket) + queue->packet_size);
+        if (packet == NULL) {
+            return NULL;
+        }
+    }
+
+    packet->datalen = 0;
+    packet->startpos = 0;
+    packet->next = NULL;
+    if (queue->tail == NULL) {
+        queue->head = packet;
+    } else {
+        queue->tail->next = packet;
+    }
+    queue->tail = packet;
+    return packet;
+}
+
+static int
+WriteToPacketQueue(void *_queue, const void *_data, const size_t _len)
+{
+    PacketQueue *queue = (PacketQueue *) _queue;
+    const Uint8 *data = (const Uint8 *) _data;
+    size_t len = _len;
+
+    while (len > 0) {
+        PacketQueuePacket *packet = queue->tail;
+        size_t datalen;
+        if (!packet || (packet->datalen >= queue->packet_size)) {
+            packet = AllocatePacket(queue);
+            if (!packet) {
+                return SDL_OutOfMemory();  /* unlike SDL's, this doesn't roll back. */
+            }
+        }
+
+        datalen = SDL_min(len, queue->packet_size - packet->datalen);
+        SDL_memcpy(packet->data + packet->datalen, data, datalen);
+        data += datalen;
+        len -= datalen;
+        packet->datalen += datalen;
+        queue->queued_bytes += datalen;
+    }
+    return 0;
+}
+
+static size_t
+ReadFromPacketQueue(void *_queue, void *_buf, const size_t _len)
+{
+    PacketQueue *queue = (PacketQueue *) _queue;
+    Uint8 *buf = (Uint8 *) _buf;
+    Uint8 *ptr = buf;
+    size_t len = _len;
+    PacketQueuePacket *packet;
+
+    while ((len > 0) && ((packet = queue->head) != NULL)) {
+        const size_t avail = packet->datalen - packet->startpos;
+        const size_t cpy = SDL_min(len, avail);
+
+        SDL_memcpy(ptr, packet->data + packet->startpos, cpy);
+        packet->startpos += cpy;
+        ptr += cpy;
+        queue->queued_bytes -= cpy;
+        len -= cpy;
+
+        if (packet->startpos == packet->datalen) {  /* packet is done, put it in the pool. */
+            queue->head = packet->next;
+            packet->next = queue->pool;
+            queue->pool = packet;
+        }
+    }
+
+    if (queue->head == NULL) {
+        queue->tail = NULL;  /* in case we drained the queue entirely. */
+    }
+    return (size_t) (ptr - buf);
+}
+
+static size_t
+CountPacketQueue(void *_queue)
+{
+    return ((PacketQueue *) _queue)->queued_bytes;
+}
+
+
+/* The same calls for the ring, so both run through one benchmark loop. */
+
+static void *
+NewRingQueue(const size_t packetlen, const size_t initialslack)
+{
+    return SDL_NewDataQueue(packetlen, initialslack);
+}
+
+static void
+FreeRingQueue(void *queue)
+{
+    SDL_FreeDataQueue((SDL_DataQueue *) queue);
+}
+
+static int
+WriteToRingQueue(void *queue, const void *data, const size_t len)
+{
+    return SDL_WriteToDataQueue((SDL_DataQueue *) queue, data, len);
+}
+
+static size_t
+ReadFromRingQueue(void *queue, void *buf, const size_t len)
+{
+    return SDL_ReadFromDataQueue((SDL_DataQueue *) queue, buf, len);
+}
+
+static size_t
+CountRingQueue(void *queue)
+{
+    return SDL_CountDataQueue((SDL_DataQueue *) queue);
+}
+
+typedef struct
+{
+    const char *name;
+    void *(*create)(const size_t packetlen, const size_t initialslack);
+    void (*destroy)(void *queue);
+    int (*write)(void *queue, const void *data, const size_t len);
+    size_t (*read)(void *queue, void *buf, const size_t len);
+    size_t (*count)(void *queue);
+} QueueImpl;
+
+static const QueueImpl queue_impls[] = {
+    { "packet list", NewPacketQueue, FreePacketQueue, WriteToPacketQueue, ReadFromPacketQueue, CountPacketQueue },
+    { "ring", NewRingQueue, FreeRingQueue, WriteToRingQueue, ReadFromRingQueue, CountRingQueue },
+    { "ring, in place", NewRingQueue, FreeRingQueue, WriteToRingQueue, NULL, CountRingQueue }
+};
+
+static Uint8 pattern[256 + MAX_WRITE_SIZE];
+
+
+/* Reads through SDL_PeekDataQueueSpan() and SDL_CommitDataQueueRead() must
+   see the same bytes, in the same order, as were written, across wraps and
+   growth, and never claim more than is queued. */
+static SDL_bool
+TestDataQueueSpans(void)
+{
+    SDL_DataQueue *queue = SDL_NewDataQueue(64, 64);
+    const void *span;
+    size_t len;
+    int written = 0, read = 0, wraps = 0;
+    int i;
+
+    if (!queue) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create data queue: %s\n", SDL_GetError());
+        return SDL_FALSE;
+    }
+
+    span = SDL_PeekDataQueueSpan(queue, &len);
+    if (span || len) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Span of an empty queue isn't empty\n");
+        SDL_FreeDataQueue(queue);
+        return SDL_FALSE;
+    }
+
+    for (i = 0; i < 10000; ++i) {
+        const int write_size = 1 + ((i * 7) % 61);
+        const size_t consume = 1 + ((i * 13) % 47);
+        const size_t queued = SDL_CountDataQueue(queue);
+
+        if ((queued < 200) && (SDL_WriteToDataQueue(queue, &pattern[written & 0xFF], write_size) == 0)) {
+            written += write_size;
+        }
+
+        span = SDL_PeekDataQueueSpan(queue, &len);
+        if (!span || !len || (len > SDL_CountDataQueue(queue))) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Bad span of %d bytes with %d queued\n", (int) len, (int) SDL_CountDataQueue(queue));
+            SDL_FreeDataQueue(queue);
+            return SDL_FALSE;
+        }
+        if (len < SDL_CountDataQueue(queue)) {
+            ++wraps;  /* the rest is at the start of the buffer. */
+        }
+
+        len = SDL_min(len, consume);
+        if (SDL_memcmp(span, &pattern[read & 0xFF], len) != 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Span data mismatch at byte %d\n", read);
+            SDL_FreeDataQueue(queue);
+            return SDL_FALSE;
+        }
+        SDL_CommitDataQueueRead(queue, len);
+        read += (int) len;
+    }
+
+    /* Committing more than is queued just empties it. */
+    SDL_CommitDataQueueRead(queue, SDL_CountDataQueue(queue) + 100);
+    span = SDL_PeekDataQueueSpan(queue, &len);
+    SDL_FreeDataQueue(queue);
+    if (span || len) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Span of a drained queue isn't empty\n");
+        return SDL_FALSE;
+    }
+    if (wraps == 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "The queue never wrapped, so spans weren't tested across the end\n");
+        return SDL_FALSE;
+    }
+
+    SDL_Log("Span reads: %d bytes through %d wrapped spans, OK\n", read, wraps);
+    return SDL_TRUE;
+}
+
+static double
+RunQueueTest(const QueueImpl *impl, int write_size, SDL_bool *ok)
+{
+    static Uint8 readbuf[READ_SIZE];
+    void *queue = impl->create(PACKET_SIZE, PACKET_SIZE * 2);
+    Uint64 start, elapsed;
+    int written = 0, read = 0;
+    int i;
+
+    if (!queue) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create queue: %s\n", SDL_GetError());
+        *ok = SDL_FALSE;
+        return 0.0;
+    }
+
+    start = SDL_GetPerformanceCounter();
+
+    /* Keep a few reads' worth of data queued, like a device draining SDL_QueueAudio() data */
+    while (read < TOTAL_BYTES) {
+        while (written < TOTAL_BYTES && impl->count(queue) < 4 * READ_SIZE) {
+            if (impl->write(queue, &pattern[written & 0xFF], write_size) < 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Write to %s failed: %s\n", impl->name, SDL_GetError());
+                impl->destroy(queue);
+                *ok = SDL_FALSE;
+                return 0.0;
+            }
+            written += write_size;
+        }
+
+        if (impl->read) {
+            i = (int) impl->read(queue, readbuf, READ_SIZE);
+            if (i <= 0) {
+                break;
+            }
+            if (SDL_memcmp(readbuf, &pattern[read & 0xFF], i) != 0) {
+                *ok = SDL_FALSE;
+            }
+        } else {
+            /* look at the data where it is, without copying it out. */
+            size_t len;
+            const void *span = SDL_PeekDataQueueSpan((SDL_DataQueue *) queue, &len);
+            if (!span) {
+                break;
+            }
+            len = SDL_min(len, READ_SIZE);
+            if (SDL_memcmp(span, &pattern[read & 0xFF], len) != 0) {
+                *ok = SDL_FALSE;
+            }
+            SDL_CommitDataQueueRead((SDL_DataQueue *) queue, len);
+            i = (int) len;
+        }
+        read += i;
+    }
+
+    elapsed = SDL_GetPerformanceCounter() - start;
+    impl->destroy(queue);
+
+    return ((double)read / (1024.0 * 1024.0)) * SDL_GetPerformanceFrequency() / (double)elapsed;
+}
+
+int
+main(int argc, char *argv[])
+{
+    static const int sizes[] = { 4, 64, 256, 1024, 8192, MAX_WRITE_SIZE };
+    SDL_bool ok = SDL_TRUE;
+    int i, j;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    /* Byte N of the data is always (N & 0xFF) */
+    for (i = 0; i < SDL_arraysize(pattern); ++i) {
+        pattern[i] = (Uint8)i;
+    }
+
+    if (!TestDataQueueSpans()) {
+        SDL_Quit();
+        return 1;
+    }
+
+    SDL_Log("Moving %d MB through each queue, %d byte reads, in MB/sec\n", TOTAL_BYTES / (1024 * 1024), READ_SIZE);
+    SDL_Log("%12s %12s %12s %16s\n", "write size", queue_impls[0].name, queue_impls[1].name, queue_impls[2].name);
+    for (i = 0; i < SDL_arraysize(sizes); ++i) {
+        double rates[SDL_arraysize(queue_impls)];
+        SDL_bool matched = SDL_TRUE;
+        for (j = 0; j < SDL_arraysize(queue_impls); ++j) {
+            rates[j] = RunQueueTest(&queue_impls[j], sizes[i], &matched);
+        }
+        SDL_Log("%12d %12.1f %12.1f %16.1f%s\n", sizes[i], rates[0], rates[1], rates[2], matched ? "" : " (DATA MISMATCH!)");
+        if (!matched) {
+            ok = SDL_FALSE;
+        }
+    }
+
+    SDL_Quit();
+    return ok ? 0 : 1;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
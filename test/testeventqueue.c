@@ -0,0 +1,142 @@
+/*
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Measure SDL_PushEvent/SDL_PollEvent throughput with several producer threads,
+   with and without SDL_HINT_EVENT_QUEUE_LOCKFREE */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define MAX_PRODUCERS   16
+#define TOTAL_EVENTS    400000
+
+typedef struct Producer_State {
+    SDL_Thread *thread;
+    Uint32 type;
+    int index;
+    int count;
+    int retries;
+} Producer_State;
+
+static SDL_atomic_t start_flag;
+
+static int SDLCALL
+ProducerThread(void *data)
+{
+    Producer_State *state = (Producer_State *) data;
+    SDL_Event event;
+    int i;
+
+    while (!SDL_AtomicGet(&start_flag)) {
+        /* Spin until everyone is ready */
+    }
+
+    SDL_zero(event);
+    event.type = state->type;
+    event.user.code = state->index;
+    for (i = 0; i < state->count; ++i) {
+        event.user.data1 = (void *)(uintptr_t)i;
+        while (SDL_PushEvent(&event) <= 0) {
+            /* The queue is full, give the consumer a chance */
+            ++state->retries;
+            SDL_Delay(0);
+        }
+    }
+    return 0;
+}
+
+static SDL_bool
+RunProducers(int num_producers, const char *lockfree)
+{
+    Producer_State producers[MAX_PRODUCERS];
+    int expected[MAX_PRODUCERS];
+    int received = 0, total, retries = 0;
+    Uint64 start, elapsed;
+    SDL_bool ordered = SDL_TRUE;
+    SDL_Event event;
+    Uint32 type;
+    int i;
+
+    SDL_SetHint(SDL_HINT_EVENT_QUEUE_LOCKFREE, lockfree);
+    if (SDL_Init(SDL_INIT_EVENTS) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return SDL_FALSE;
+    }
+    type = SDL_RegisterEvents(1);
+
+    SDL_AtomicSet(&start_flag, 0);
+    total = (TOTAL_EVENTS / num_producers) * num_producers;
+    for (i = 0; i < num_producers; ++i) {
+        char name[64];
+        SDL_snprintf(name, sizeof (name), "Producer%d", i);
+        producers[i].type = type;
+        producers[i].index = i;
+        producers[i].count = total / num_producers;
+        producers[i].retries = 0;
+        producers[i].thread = SDL_CreateThread(ProducerThread, name, &producers[i]);
+        expected[i] = 0;
+    }
+
+    start = SDL_GetPerformanceCounter();
+    SDL_AtomicSet(&start_flag, 1);
+
+    while (received < total) {
+        while (SDL_PollEvent(&event)) {
+            if (event.type == type) {
+                const int index = event.user.code;
+                if ((int)(uintptr_t)event.user.data1 != expected[index]) {
+                    ordered = SDL_FALSE;
+                }
+                expected[index] = (int)(uintptr_t)event.user.data1 + 1;
+                ++received;
+            }
+        }
+    }
+
+    elapsed = SDL_GetPerformanceCounter() - start;
+
+    for (i = 0; i < num_producers; ++i) {
+        SDL_WaitThread(producers[i].thread, NULL);
+        retries += producers[i].retries;
+    }
+
+    SDL_Log("%-9s %2d producers: %8.0f events/sec, %d full-queue retries%s\n",
+            (*lockfree == '0') ? "mutex" : "lock-free", num_producers,
+            (double)total * SDL_GetPerformanceFrequency() / (double)elapsed,
+            retries, ordered ? "" : " (EVENTS OUT OF ORDER!)");
+
+    SDL_Quit();
+    return ordered;
+}
+
+int
+main(int argc, char *argv[])
+{
+    static const int counts[] = { 1, 2, 4, 8, 16 };
+    SDL_bool ok = SDL_TRUE;
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    SDL_Log("Pushing %d events through the event queue\n", TOTAL_EVENTS);
+    for (i = 0; i < SDL_arraysize(counts); ++i) {
+        ok &= RunProducers(counts[i], "0");
+        ok &= RunProducers(counts[i], "1");
+    }
+
+    return ok ? 0 : 1;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -60,6 +60,22 @@ rwops_error_quit(unsigned line, SDL_RWops * rwops)
 
 #define RWOP_ERR_QUIT(x)    rwops_error_quit( __LINE__, (x) )
 
+#define BENCHMARK_SIZE      (4 * 1024 * 1024)
+
+/* Reads FBASENAME1 four bytes at a time, the way file format loaders do. */
+static Uint32
+benchmark_small_reads(SDL_RWops * rwops, double *seconds)
+{
+    const Uint64 start = SDL_GetPerformanceCounter();
+    Uint32 sum = 0;
+    int i;
+
+    for (i = 0; i < BENCHMARK_SIZE / 4; i++) {
+        sum = sum * 31 + SDL_ReadLE32(rwops);
+    }
+    *seconds = (double) (SDL_GetPerformanceCounter() - start) / SDL_GetPerformanceFrequency();
+    return sum;
+}
 
 
 int
@@ -67,6 +83,9 @@ main(int argc, char *argv[])
 {
     SDL_RWops *rwops = NULL;
     char test_buf[30];
+    double unbuffered, buffered;
+    Uint32 sum;
+    int i;
 
     /* Enable standard application logging */
     SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
@@ -278,6 +297,57 @@ main(int argc, char *argv[])
         RWOP_ERR_QUIT(rwops);
     rwops->close(rwops);
     SDL_Log("test5 OK\n");
+
+/* test6 : write and read back a byte at a time through a buffer */
+    rwops = SDL_CreateBufferedRW(SDL_RWFromFile(FBASENAME1, "wb+"), 16, 1);
+    if (!rwops)
+        RWOP_ERR_QUIT(rwops);
+    for (i = 0; i < 27; i++) {
+        if (1 != rwops->write(rwops, &"123456789012345678901234567"[i], 1, 1))
+            RWOP_ERR_QUIT(rwops);
+    }
+    if (20 != rwops->seek(rwops, -7, RW_SEEK_END))
+        RWOP_ERR_QUIT(rwops);
+    if (7 != rwops->read(rwops, test_buf, 1, 7))
+        RWOP_ERR_QUIT(rwops);
+    if (SDL_memcmp(test_buf, "1234567", 7))
+        RWOP_ERR_QUIT(rwops);
+    if (0 != rwops->read(rwops, test_buf, 1, 1))
+        RWOP_ERR_QUIT(rwops);
+    if (0 != rwops->seek(rwops, -27, RW_SEEK_CUR))
+        RWOP_ERR_QUIT(rwops);
+    if (2 != rwops->read(rwops, test_buf, 10, 3))
+        RWOP_ERR_QUIT(rwops);
+    if (SDL_memcmp(test_buf, "12345678901234567890", 20))
+        RWOP_ERR_QUIT(rwops);
+    rwops->close(rwops);
+    SDL_Log("test6 OK\n");
+
+/* test7 : small reads with and without a buffer */
+    rwops = SDL_RWFromFile(FBASENAME1, "wb");
+    if (!rwops)
+        RWOP_ERR_QUIT(rwops);
+    for (i = 0; i < BENCHMARK_SIZE / 4; i++) {
+        SDL_WriteLE32(rwops, (Uint32) i * 2654435761u);
+    }
+    rwops->close(rwops);
+
+    rwops = SDL_RWFromFile(FBASENAME1, "rb");
+    if (!rwops)
+        RWOP_ERR_QUIT(rwops);
+    sum = benchmark_small_reads(rwops, &unbuffered);
+    rwops->close(rwops);
+
+    rwops = SDL_CreateBufferedRW(SDL_RWFromFile(FBASENAME1, "rb"), 0, 1);
+    if (!rwops)
+        RWOP_ERR_QUIT(rwops);
+    if (sum != benchmark_small_reads(rwops, &buffered))
+        RWOP_ERR_QUIT(rwops);
+    rwops->close(rwops);
+    SDL_Log("test7 OK: %d KB in 4 byte reads: %.1f MB/s unbuffered, %.1f MB/s buffered\n",
+            BENCHMARK_SIZE / 1024, BENCHMARK_SIZE / unbuffered / (1024.0 * 1024.0),
+            BENCHMARK_SIZE / buffered / (1024.0 * 1024.0));
+
     cleanup();
     return 0;                   /* all ok */
 }
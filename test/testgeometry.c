@@ -0,0 +1,247 @@
+/*
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+/* Simple program:  draw a field of spinning triangles with one SDL_RenderGeometry() call a frame */
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten/emscripten.h>
+#endif
+
+#include "SDL_test_common.h"
+
+static SDLTest_CommonState *state;
+static SDL_Texture **sprites;
+static SDL_Vertex *vertices;
+static int num_triangles = 2000;
+static SDL_bool use_texture = SDL_FALSE;
+static SDL_BlendMode blendMode = SDL_BLENDMODE_BLEND;
+static float angle = 0.0f;
+static int done;
+
+/* Call this instead of exit(), so we can clean up SDL: atexit() is evil. */
+static void
+quit(int rc)
+{
+    SDL_free(vertices);
+    SDL_free(sprites);
+    SDLTest_CommonQuit(state);
+    exit(rc);
+}
+
+static int
+LoadSprite(const char *file)
+{
+    int i;
+    SDL_Surface *temp;
+
+    /* Load the sprite image */
+    temp = SDL_LoadBMP(file);
+    if (temp == NULL) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't load %s: %s", file, SDL_GetError());
+        return -1;
+    }
+
+    /* Set transparent pixel as the pixel at (0,0) */
+    if (temp->format->palette) {
+        SDL_SetColorKey(temp, SDL_TRUE, *(Uint8 *) temp->pixels);
+    } else if (temp->format->BitsPerPixel == 32) {
+        SDL_SetColorKey(temp, SDL_TRUE, *(Uint32 *) temp->pixels);
+    }
+
+    /* Create textures from the image */
+    for (i = 0; i < state->num_windows; ++i) {
+        SDL_Renderer *renderer = state->renderers[i];
+        sprites[i] = SDL_CreateTextureFromSurface(renderer, temp);
+        if (!sprites[i]) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create texture: %s\n", SDL_GetError());
+            SDL_FreeSurface(temp);
+            return -1;
+        }
+        SDL_SetTextureBlendMode(sprites[i], blendMode);
+    }
+    SDL_FreeSurface(temp);
+
+    /* We're ready to roll. :) */
+    return 0;
+}
+
+static void
+Draw(SDL_Renderer *renderer, SDL_Texture *sprite)
+{
+    SDL_Rect viewport;
+    const int columns = (int) SDL_ceil(SDL_sqrt((double) num_triangles));
+    int cell_w, cell_h;
+    int i, j;
+
+    SDL_RenderGetViewport(renderer, &viewport);
+    cell_w = SDL_max(viewport.w / columns, 1);
+    cell_h = SDL_max(viewport.h / ((num_triangles + columns - 1) / columns), 1);
+
+    /* Spin each triangle around the middle of its cell, wrapping the texture over it. */
+    for (i = 0; i < num_triangles; ++i) {
+        const float cx = (float) ((i % columns) * cell_w) + cell_w * 0.5f;
+        const float cy = (float) ((i / columns) * cell_h) + cell_h * 0.5f;
+        const float radius = SDL_min(cell_w, cell_h) * 0.6f;
+        SDL_Vertex *verts = &vertices[i * 3];
+
+        for (j = 0; j < 3; ++j) {
+            const float a = angle + (float) i * 0.1f + (float) j * (float) (2.0 * M_PI / 3.0);
+            verts[j].position.x = cx + radius * SDL_cosf(a);
+            verts[j].position.y = cy + radius * SDL_sinf(a);
+            verts[j].color.r = (j == 0) ? 0xFF : 0x40;
+            verts[j].color.g = (j == 1) ? 0xFF : 0x40;
+            verts[j].color.b = (j == 2) ? 0xFF : 0x40;
+            verts[j].color.a = 0xC0;
+            verts[j].tex_coord.x = 0.5f + 0.5f * SDL_cosf((float) j * (float) (2.0 * M_PI / 3.0));
+            verts[j].tex_coord.y = 0.5f + 0.5f * SDL_sinf((float) j * (float) (2.0 * M_PI / 3.0));
+        }
+    }
+
+    SDL_SetRenderDrawColor(renderer, 0xA0, 0xA0, 0xA0, 0xFF);
+    SDL_RenderClear(renderer);
+
+    SDL_SetRenderDrawBlendMode(renderer, blendMode);
+    if (SDL_RenderGeometry(renderer, use_texture ? sprite : NULL, vertices, num_triangles * 3, NULL, 0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't draw geometry: %s\n", SDL_GetError());
+        done = 1;
+    }
+
+    /* Update the screen! */
+    SDL_RenderPresent(renderer);
+}
+
+static void
+loop()
+{
+    int i;
+    SDL_Event event;
+
+    /* Check for events */
+    while (SDL_PollEvent(&event)) {
+        SDLTest_CommonEvent(state, &event, &done);
+    }
+    angle += 0.02f;
+    for (i = 0; i < state->num_windows; ++i) {
+        if (state->windows[i] == NULL)
+            continue;
+        Draw(state->renderers[i], sprites[i]);
+    }
+#ifdef __EMSCRIPTEN__
+    if (done) {
+        emscripten_cancel_main_loop();
+    }
+#endif
+}
+
+int
+main(int argc, char *argv[])
+{
+    int i;
+    Uint32 then, now, frames;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    /* Initialize test framework */
+    state = SDLTest_CommonCreateState(argv, SDL_INIT_VIDEO);
+    if (!state) {
+        return 1;
+    }
+
+    for (i = 1; i < argc;) {
+        int consumed;
+
+        consumed = SDLTest_CommonArg(state, i);
+        if (consumed == 0) {
+            consumed = -1;
+            if (SDL_strcasecmp(argv[i], "--triangles") == 0) {
+                if (argv[i + 1]) {
+                    num_triangles = SDL_atoi(argv[i + 1]);
+                    consumed = 2;
+                }
+            } else if (SDL_strcasecmp(argv[i], "--use-texture") == 0) {
+                use_texture = SDL_TRUE;
+                consumed = 1;
+            } else if (SDL_strcasecmp(argv[i], "--blend") == 0) {
+                if (argv[i + 1]) {
+                    if (SDL_strcasecmp(argv[i + 1], "none") == 0) {
+                        blendMode = SDL_BLENDMODE_NONE;
+                        consumed = 2;
+                    } else if (SDL_strcasecmp(argv[i + 1], "blend") == 0) {
+                        blendMode = SDL_BLENDMODE_BLEND;
+                        consumed = 2;
+                    } else if (SDL_strcasecmp(argv[i + 1], "add") == 0) {
+                        blendMode = SDL_BLENDMODE_ADD;
+                        consumed = 2;
+                    } else if (SDL_strcasecmp(argv[i + 1], "mod") == 0) {
+                        blendMode = SDL_BLENDMODE_MOD;
+                        consumed = 2;
+                    } else if (SDL_strcasecmp(argv[i + 1], "mul") == 0) {
+                        blendMode = SDL_BLENDMODE_MUL;
+                        consumed = 2;
+                    }
+                }
+            }
+        }
+        if (consumed < 0) {
+            static const char *options[] = { "[--triangles N]", "[--use-texture]", "[--blend none|blend|add|mod|mul]", NULL };
+            SDLTest_CommonLogUsage(state, argv[0], options);
+            quit(1);
+        }
+        i += consumed;
+    }
+    if (num_triangles <= 0) {
+        num_triangles = 1;
+    }
+    if (!SDLTest_CommonInit(state)) {
+        quit(2);
+    }
+
+    /* Create the windows, initialize the renderers, and load the textures */
+    sprites = (SDL_Texture **) SDL_calloc(state->num_windows, sizeof (*sprites));
+    vertices = (SDL_Vertex *) SDL_malloc(num_triangles * 3 * sizeof (*vertices));
+    if (!sprites || !vertices) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory!\n");
+        quit(2);
+    }
+    if (LoadSprite("icon.bmp") < 0) {
+        quit(2);
+    }
+
+    /* Main render loop */
+    frames = 0;
+    then = SDL_GetTicks();
+    done = 0;
+
+#ifdef __EMSCRIPTEN__
+    emscripten_set_main_loop(loop, 0, 1);
+#else
+    while (!done) {
+        ++frames;
+        loop();
+    }
+#endif
+
+    /* Print out some timing information */
+    now = SDL_GetTicks();
+    if (now > then) {
+        double fps = ((double) frames * 1000) / (now - then);
+        SDL_Log("%2.2f frames per second\n", fps);
+    }
+
+    quit(0);
+    return 0;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
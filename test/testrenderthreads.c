@@ -0,0 +1,302 @@
+/*
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Measure how the software renderer scales with SDL_HINT_RENDER_SOFTWARE_THREADS,
+   drawing the testsprite2 scene on the offscreen video driver, and check that
+   every thread count draws exactly the same pixels. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define MAX_SPEED 1
+
+static int window_w = 1280;
+static int window_h = 720;
+static int num_sprites = 2000;
+static int num_frames = 200;
+static SDL_BlendMode blendMode = SDL_BLENDMODE_BLEND;
+static const char *icon = "icon.bmp";
+
+static Uint32 seed;
+
+static int
+RandomInRange(int min, int max)
+{
+    seed = (seed * 1103515245) + 12345;
+    return min + (int) ((seed >> 16) % (Uint32) (max - min + 1));
+}
+
+static SDL_Texture *
+LoadSprite(SDL_Renderer *renderer, int *w, int *h)
+{
+    SDL_Texture *sprite;
+    SDL_Surface *temp = SDL_LoadBMP(icon);
+
+    if (temp == NULL) {
+        SDL_Log("Couldn't load %s: %s\n", icon, SDL_GetError());
+        return NULL;
+    }
+    *w = temp->w;
+    *h = temp->h;
+
+    /* Set transparent pixel as the pixel at (0,0), like testsprite2 */
+    if (temp->format->palette) {
+        SDL_SetColorKey(temp, 1, *(Uint8 *) temp->pixels);
+    } else if (temp->format->BitsPerPixel == 32) {
+        SDL_SetColorKey(temp, 1, *(Uint32 *) temp->pixels);
+    }
+
+    sprite = SDL_CreateTextureFromSurface(renderer, temp);
+    SDL_FreeSurface(temp);
+    if (sprite == NULL) {
+        SDL_Log("Couldn't create texture: %s\n", SDL_GetError());
+        return NULL;
+    }
+    SDL_SetTextureBlendMode(sprite, blendMode);
+    return sprite;
+}
+
+/* Draws num_frames frames of the testsprite2 scene, returning the seconds it
+   took and leaving the last frame's pixels in *pixels. */
+static double
+DrawFrames(int num_threads, Uint32 **pixels)
+{
+    char hint[16];
+    SDL_Window *window;
+    SDL_Renderer *renderer;
+    SDL_Texture *sprite;
+    SDL_Rect *positions, *velocities;
+    SDL_Rect temp;
+    Uint64 start, elapsed = 0;
+    int sprite_w = 0, sprite_h = 0;
+    int frame, i;
+
+    SDL_snprintf(hint, sizeof (hint), "%d", num_threads);
+    SDL_SetHint(SDL_HINT_RENDER_SOFTWARE_THREADS, hint);
+
+    window = SDL_CreateWindow("testrenderthreads", 0, 0, window_w, window_h, 0);
+    if (window == NULL) {
+        SDL_Log("Couldn't create window: %s\n", SDL_GetError());
+        return -1.0;
+    }
+    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+    if (renderer == NULL) {
+        SDL_Log("Couldn't create renderer: %s\n", SDL_GetError());
+        SDL_DestroyWindow(window);
+        return -1.0;
+    }
+    sprite = LoadSprite(renderer, &sprite_w, &sprite_h);
+    positions = (SDL_Rect *) SDL_malloc(num_sprites * sizeof (SDL_Rect));
+    velocities = (SDL_Rect *) SDL_malloc(num_sprites * sizeof (SDL_Rect));
+    *pixels = (Uint32 *) SDL_malloc(window_w * window_h * sizeof (Uint32));
+    if (!sprite || !positions || !velocities || !*pixels) {
+        SDL_free(positions);
+        SDL_free(velocities);
+        SDL_free(*pixels);
+        *pixels = NULL;
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        return -1.0;
+    }
+
+    /* Every run starts from the same positions. */
+    seed = 0x12345;
+    for (i = 0; i < num_sprites; ++i) {
+        positions[i].x = RandomInRange(0, window_w - sprite_w);
+        positions[i].y = RandomInRange(0, window_h - sprite_h);
+        positions[i].w = sprite_w;
+        positions[i].h = sprite_h;
+        velocities[i].x = 0;
+        velocities[i].y = 0;
+        while (!velocities[i].x && !velocities[i].y) {
+            velocities[i].x = RandomInRange(-MAX_SPEED, MAX_SPEED);
+            velocities[i].y = RandomInRange(-MAX_SPEED, MAX_SPEED);
+        }
+    }
+
+    for (frame = 0; frame < num_frames; ++frame) {
+        start = SDL_GetPerformanceCounter();
+
+        SDL_SetTextureColorMod(sprite, 255, (Uint8) frame, (Uint8) frame);
+
+        /* Draw a gray background */
+        SDL_SetRenderDrawColor(renderer, 0xA0, 0xA0, 0xA0, 0xFF);
+        SDL_RenderClear(renderer);
+
+        /* Test points */
+        SDL_SetRenderDrawColor(renderer, 0xFF, 0x00, 0x00, 0xFF);
+        SDL_RenderDrawPoint(renderer, 0, 0);
+        SDL_RenderDrawPoint(renderer, window_w-1, 0);
+        SDL_RenderDrawPoint(renderer, 0, window_h-1);
+        SDL_RenderDrawPoint(renderer, window_w-1, window_h-1);
+
+        /* Test horizontal and vertical lines */
+        SDL_SetRenderDrawColor(renderer, 0x00, 0xFF, 0x00, 0xFF);
+        SDL_RenderDrawLine(renderer, 1, 0, window_w-2, 0);
+        SDL_RenderDrawLine(renderer, 1, window_h-1, window_w-2, window_h-1);
+        SDL_RenderDrawLine(renderer, 0, 1, 0, window_h-2);
+        SDL_RenderDrawLine(renderer, window_w-1, 1, window_w-1, window_h-2);
+
+        /* Test fill and copy */
+        SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+        temp.x = 1;
+        temp.y = 1;
+        temp.w = sprite_w;
+        temp.h = sprite_h;
+        SDL_RenderFillRect(renderer, &temp);
+        SDL_RenderCopy(renderer, sprite, NULL, &temp);
+        temp.x = window_w-sprite_w-1;
+        temp.y = window_h-sprite_h-1;
+        SDL_RenderFillRect(renderer, &temp);
+        SDL_RenderCopy(renderer, sprite, NULL, &temp);
+
+        /* Test diagonal lines */
+        SDL_SetRenderDrawColor(renderer, 0x00, 0xFF, 0x00, 0xFF);
+        SDL_RenderDrawLine(renderer, sprite_w, sprite_h,
+                           window_w-sprite_w-2, window_h-sprite_h-2);
+        SDL_RenderDrawLine(renderer, window_w-sprite_w-2, sprite_h,
+                           sprite_w, window_h-sprite_h-2);
+
+        /* Move the sprites, bounce at the wall */
+        for (i = 0; i < num_sprites; ++i) {
+            SDL_Rect *position = &positions[i];
+            SDL_Rect *velocity = &velocities[i];
+            position->x += velocity->x;
+            if ((position->x < 0) || (position->x >= (window_w - sprite_w))) {
+                velocity->x = -velocity->x;
+                position->x += velocity->x;
+            }
+            position->y += velocity->y;
+            if ((position->y < 0) || (position->y >= (window_h - sprite_h))) {
+                velocity->y = -velocity->y;
+                position->y += velocity->y;
+            }
+            SDL_RenderCopy(renderer, sprite, NULL, position);
+        }
+
+        /* Some sprites again, scaled up; these are drawn on one thread */
+        for (i = 0; i < num_sprites; i += 64) {
+            temp = positions[i];
+            temp.w *= 2;
+            temp.h *= 2;
+            SDL_RenderCopy(renderer, sprite, NULL, &temp);
+        }
+
+        SDL_RenderPresent(renderer);
+        elapsed += SDL_GetPerformanceCounter() - start;
+    }
+
+    SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_ARGB8888, *pixels, window_w * sizeof (Uint32));
+
+    SDL_free(positions);
+    SDL_free(velocities);
+    SDL_DestroyTexture(sprite);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+
+    return (double) elapsed / SDL_GetPerformanceFrequency();
+}
+
+int
+main(int argc, char *argv[])
+{
+    const char *driver = SDL_getenv("SDL_VIDEODRIVER");
+    Uint32 *reference = NULL;
+    double serial = 0.0;
+    int max_threads = SDL_GetCPUCount();
+    int num_threads, i;
+    int failed = 0;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; ++i) {
+        if ((SDL_strcmp(argv[i], "--sprites") == 0) && argv[i + 1]) {
+            num_sprites = SDL_atoi(argv[++i]);
+        } else if ((SDL_strcmp(argv[i], "--frames") == 0) && argv[i + 1]) {
+            num_frames = SDL_atoi(argv[++i]);
+        } else if ((SDL_strcmp(argv[i], "--threads") == 0) && argv[i + 1]) {
+            max_threads = SDL_atoi(argv[++i]);
+        } else if ((SDL_strcmp(argv[i], "--geometry") == 0) && argv[i + 1]) {
+            if (SDL_sscanf(argv[++i], "%dx%d", &window_w, &window_h) != 2) {
+                window_w = window_h = 0;
+            }
+        } else if ((SDL_strcmp(argv[i], "--blend") == 0) && argv[i + 1]) {
+            ++i;
+            if (SDL_strcasecmp(argv[i], "none") == 0) {
+                blendMode = SDL_BLENDMODE_NONE;
+            } else if (SDL_strcasecmp(argv[i], "add") == 0) {
+                blendMode = SDL_BLENDMODE_ADD;
+            } else if (SDL_strcasecmp(argv[i], "mod") == 0) {
+                blendMode = SDL_BLENDMODE_MOD;
+            }
+        } else if (argv[i][0] != '-') {
+            icon = argv[i];
+        } else {
+            window_w = window_h = 0;
+            break;
+        }
+    }
+    if ((window_w <= 0) || (window_h <= 0) || (num_sprites <= 0) || (num_frames <= 0) || (max_threads <= 0)) {
+        SDL_Log("USAGE: %s [--sprites N] [--frames N] [--threads N] [--geometry WxH] [--blend none|blend|add|mod] [icon.bmp]\n", argv[0]);
+        return 1;
+    }
+
+    if (SDL_Init(0) < 0) {
+        SDL_Log("Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+    /* Draw offscreen unless asked for another driver */
+    if ((SDL_VideoInit(driver ? driver : "offscreen") < 0) && (driver || (SDL_VideoInit(NULL) < 0))) {
+        SDL_Log("Couldn't initialize video driver: %s\n", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+    SDL_Log("Video driver: %s, %dx%d, %d sprites, %d frames\n",
+            SDL_GetCurrentVideoDriver(), window_w, window_h, num_sprites, num_frames);
+
+    for (num_threads = 1; ; num_threads = SDL_min(num_threads * 2, max_threads)) {
+        Uint32 *pixels = NULL;
+        const double seconds = DrawFrames(num_threads, &pixels);
+
+        if (seconds < 0.0) {
+            failed = 1;
+            break;
+        }
+
+        if (num_threads == 1) {
+            serial = seconds;
+            reference = pixels;
+            SDL_Log("%2d thread : %7.3f ms/frame\n", num_threads, seconds * 1000.0 / num_frames);
+        } else {
+            const SDL_bool same = (SDL_memcmp(reference, pixels, window_w * window_h * sizeof (Uint32)) == 0);
+            SDL_Log("%2d threads: %7.3f ms/frame, %5.2fx%s\n", num_threads, seconds * 1000.0 / num_frames,
+                    serial / seconds, same ? "" : ", OUTPUT DIFFERS");
+            if (!same) {
+                failed = 1;
+            }
+            SDL_free(pixels);
+        }
+
+        if (num_threads == max_threads) {
+            break;
+        }
+    }
+
+    SDL_free(reference);
+    SDL_Quit();
+    return failed;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
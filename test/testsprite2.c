@@ -271,7 +271,13 @@ loop()
         /* Print out some timing information */
         const Uint32 then = next_fps_check - fps_check_delay;
         const double fps = ((double) frames * 1000) / (now - then);
+        SDL_RenderStats stats;
         SDL_Log("%2.2f frames per second\n", fps);
+        if (state->windows[0] && SDL_RenderGetStats(state->renderers[0], &stats) == 0) {
+            SDL_Log("%u draw calls for %u copies, %.2f ms spent rendering the last frame\n",
+                    (unsigned int) stats.draw_calls, (unsigned int) stats.copies,
+                    (double) stats.execution_time * 1000.0 / SDL_GetPerformanceFrequency());
+        }
         next_fps_check = now + fps_check_delay;
         frames = 0;
     }
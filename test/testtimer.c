@@ -20,8 +20,11 @@
 #include "SDL.h"
 
 #define DEFAULT_RESOLUTION  1
+#define STRESS_TIMERS       10000
+#define JITTER_SAMPLES      1000
 
 static int ticks = 0;
+static SDL_atomic_t stress_fired;
 
 static Uint32 SDLCALL
 ticktock(Uint32 interval, void *param)
@@ -37,6 +40,140 @@ callback(Uint32 interval, void *param)
     return interval;
 }
 
+static Uint32 SDLCALL
+stressfire(Uint32 interval, void *param)
+{
+    SDL_AtomicIncRef(&stress_fired);
+    return 0;
+}
+
+static double
+elapsed_ms(Uint64 start)
+{
+    return (double)((SDL_GetPerformanceCounter() - start)*1000) / SDL_GetPerformanceFrequency();
+}
+
+static void
+stresstest(void)
+{
+    static SDL_TimerID ids[STRESS_TIMERS];
+    Uint64 start;
+    double ms;
+    int i, removed;
+
+    SDL_Log("Testing %d timers...\n", STRESS_TIMERS);
+
+    /* Add timers that won't fire during the test, then remove them */
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < STRESS_TIMERS; ++i) {
+        ids[i] = SDL_AddTimer(60 * 1000 + i, stressfire, NULL);
+    }
+    ms = elapsed_ms(start);
+    SDL_Log("Added %d timers in %f ms (%f adds/sec)\n", STRESS_TIMERS, ms, STRESS_TIMERS * 1000.0 / ms);
+
+    removed = 0;
+    start = SDL_GetPerformanceCounter();
+    for (i = STRESS_TIMERS; i--; ) {
+        removed += SDL_RemoveTimer(ids[i]) ? 1 : 0;
+    }
+    ms = elapsed_ms(start);
+    SDL_Log("Removed %d timers in %f ms (%f removes/sec)\n", removed, ms, STRESS_TIMERS * 1000.0 / ms);
+    if (removed != STRESS_TIMERS) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Only %d of %d timers were removed\n", removed, STRESS_TIMERS);
+    }
+
+    /* Add one-shot timers spread over 100 ms and wait for all of them */
+    SDL_AtomicSet(&stress_fired, 0);
+    start = SDL_GetPerformanceCounter();
+    for (i = 0; i < STRESS_TIMERS; ++i) {
+        SDL_AddTimer(1 + (i % 100), stressfire, NULL);
+    }
+    while (SDL_AtomicGet(&stress_fired) < STRESS_TIMERS && elapsed_ms(start) < 10 * 1000) {
+        SDL_Delay(1);
+    }
+    ms = elapsed_ms(start);
+    SDL_Log("Fired %d of %d timers in %f ms (%f timers/sec)\n", SDL_AtomicGet(&stress_fired), STRESS_TIMERS, ms, SDL_AtomicGet(&stress_fired) * 1000.0 / ms);
+}
+
+typedef struct JitterState {
+    Uint64 target_ns;
+    Uint64 last;
+    int count;
+    Uint64 deviation_ns[JITTER_SAMPLES];
+    SDL_atomic_t done;
+} JitterState;
+
+static SDL_bool
+jitter_record(JitterState *state)
+{
+    const Uint64 now = SDL_GetPerformanceCounter();
+
+    if (state->last) {
+        const Uint64 actual = ((now - state->last) * SDL_NS_PER_SECOND) / SDL_GetPerformanceFrequency();
+        state->deviation_ns[state->count++] = (actual > state->target_ns) ? (actual - state->target_ns) : (state->target_ns - actual);
+    }
+    state->last = now;
+
+    if (state->count == JITTER_SAMPLES) {
+        SDL_AtomicSet(&state->done, 1);
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+static Uint32 SDLCALL
+jitter_ms(Uint32 interval, void *param)
+{
+    return jitter_record((JitterState *) param) ? interval : 0;
+}
+
+static Uint64 SDLCALL
+jitter_ns(Uint64 interval, void *param)
+{
+    return jitter_record((JitterState *) param) ? interval : 0;
+}
+
+static void
+jittertest(const char *name, Uint64 interval_ns, SDL_bool use_ns)
+{
+    static const Uint64 limits_us[] = { 10, 50, 100, 250, 500, 1000 };
+    static JitterState state;
+    int histogram[SDL_arraysize(limits_us) + 1];
+    Uint64 worst = 0, total = 0;
+    int i, j;
+
+    SDL_zero(state);
+    state.target_ns = interval_ns;
+    if (use_ns) {
+        SDL_AddTimerNS(interval_ns, jitter_ns, &state);
+    } else {
+        SDL_AddTimer((Uint32)(interval_ns / SDL_NS_PER_MS), jitter_ms, &state);
+    }
+    while (!SDL_AtomicGet(&state.done)) {
+        SDL_Delay(10);
+    }
+
+    SDL_zeroa(histogram);
+    for (i = 0; i < JITTER_SAMPLES; ++i) {
+        const Uint64 us = state.deviation_ns[i] / 1000;
+        for (j = 0; j < SDL_arraysize(limits_us) && us >= limits_us[j]; ++j) {
+        }
+        ++histogram[j];
+        total += state.deviation_ns[i];
+        worst = SDL_max(worst, state.deviation_ns[i]);
+    }
+
+    SDL_Log("%s, %d intervals of %"SDL_PRIu64" us: mean deviation %"SDL_PRIu64" us, worst %"SDL_PRIu64" us\n",
+            name, JITTER_SAMPLES, interval_ns / 1000, total / JITTER_SAMPLES / 1000, worst / 1000);
+    for (j = 0; j < SDL_arraysize(histogram); ++j) {
+        if (j < SDL_arraysize(limits_us)) {
+            SDL_Log("    < %4"SDL_PRIu64" us: %d\n", limits_us[j], histogram[j]);
+        } else {
+            SDL_Log("   >= %4"SDL_PRIu64" us: %d\n", limits_us[j - 1], histogram[j]);
+        }
+    }
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -100,6 +237,13 @@ main(int argc, char *argv[])
     SDL_RemoveTimer(t2);
     SDL_RemoveTimer(t3);
 
+    stresstest();
+
+    SDL_Log("Testing timer jitter...\n");
+    jittertest("SDL_AddTimer", 1 * SDL_NS_PER_MS, SDL_FALSE);
+    jittertest("SDL_AddTimerNS", 1 * SDL_NS_PER_MS, SDL_TRUE);
+    jittertest("SDL_AddTimerNS", 250 * 1000, SDL_TRUE);
+
     start = SDL_GetPerformanceCounter();
     for (i = 0; i < 1000000; ++i) {
         ticktock(0, NULL);
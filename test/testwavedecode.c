@@ -0,0 +1,140 @@
+/*
+  Copyright (C) 1997-2021 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Measure how fast SDL_LoadWAV_RW() decodes companded and ADPCM WAVE files,
+   building a long recording of each format in memory so the file system
+   does not get in the way. */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#define INPUT_SECONDS   60
+#define SAMPLE_RATE     44100
+
+/* Builds a WAVE file with a fmt chunk and a data chunk of pseudo-random bytes. */
+static Uint8 *
+MakeWAV(Uint16 formattag, Uint16 channels, Uint16 blockalign, Uint16 bits, Uint16 samplesperblock, int *len)
+{
+    const Uint32 fmtlen = (formattag == 0x0002) ? 50 : (samplesperblock > 0) ? 20 : 16;
+    const Uint32 blocks = (Uint32) ((Sint64) SAMPLE_RATE * INPUT_SECONDS / (samplesperblock > 0 ? samplesperblock : 1));
+    const Uint32 datalen = blocks * blockalign;
+    const Uint32 rifflen = 4 + (8 + fmtlen) + (8 + datalen);
+    const Sint16 coeff[14] = { 256, 0, 512, -256, 0, 0, 192, 64, 240, 0, 460, -208, 392, -232 };
+    Uint8 *wav = (Uint8 *) SDL_malloc(8 + rifflen);
+    SDL_RWops *rw;
+    Uint32 i, seed = 0x12345;
+
+    if (!wav) {
+        return NULL;
+    }
+    rw = SDL_RWFromMem(wav, 8 + rifflen);
+    SDL_RWwrite(rw, "RIFF", 4, 1);
+    SDL_WriteLE32(rw, rifflen);
+    SDL_RWwrite(rw, "WAVEfmt ", 8, 1);
+    SDL_WriteLE32(rw, fmtlen);
+    SDL_WriteLE16(rw, formattag);
+    SDL_WriteLE16(rw, channels);
+    SDL_WriteLE32(rw, SAMPLE_RATE);
+    SDL_WriteLE32(rw, SAMPLE_RATE * blockalign / (samplesperblock > 0 ? samplesperblock : 1));
+    SDL_WriteLE16(rw, blockalign);
+    SDL_WriteLE16(rw, bits);
+    if (formattag == 0x0002) {
+        SDL_WriteLE16(rw, 32);
+        SDL_WriteLE16(rw, samplesperblock);
+        SDL_WriteLE16(rw, 7);
+        for (i = 0; i < SDL_arraysize(coeff); i++) {
+            SDL_WriteLE16(rw, coeff[i]);
+        }
+    } else if (samplesperblock > 0) {
+        SDL_WriteLE16(rw, 2);
+        SDL_WriteLE16(rw, samplesperblock);
+    }
+    SDL_RWwrite(rw, "data", 4, 1);
+    SDL_WriteLE32(rw, datalen);
+    for (i = 0; i < datalen; i++) {
+        Uint8 byte;
+        seed = seed * 1103515245 + 12345;
+        byte = (Uint8) (seed >> 16);
+        /* MS ADPCM block headers start with the predictor index of each channel. */
+        if (formattag == 0x0002 && (i % blockalign) < channels) {
+            byte %= 7;
+        }
+        SDL_WriteU8(rw, byte);
+    }
+    SDL_RWclose(rw);
+
+    *len = (int) (8 + rifflen);
+    return wav;
+}
+
+static SDL_bool
+RunDecodeTest(const char *name, Uint16 formattag, Uint16 channels, Uint16 blockalign, Uint16 bits, Uint16 samplesperblock)
+{
+    int file_len = 0;
+    Uint8 *file = MakeWAV(formattag, channels, blockalign, bits, samplesperblock, &file_len);
+    SDL_AudioSpec spec;
+    Uint8 *audio = NULL;
+    Uint32 audio_len = 0;
+    Uint64 start, elapsed;
+    double seconds, duration;
+
+    if (!file) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory\n");
+        return SDL_FALSE;
+    }
+
+    start = SDL_GetPerformanceCounter();
+    if (!SDL_LoadWAV_RW(SDL_RWFromConstMem(file, file_len), 1, &spec, &audio, &audio_len)) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "SDL_LoadWAV_RW failed for %s: %s\n", name, SDL_GetError());
+        SDL_free(file);
+        return SDL_FALSE;
+    }
+    elapsed = SDL_GetPerformanceCounter() - start;
+    seconds = (double) elapsed / (double) SDL_GetPerformanceFrequency();
+    duration = (double) audio_len / (spec.channels * SDL_AUDIO_BITSIZE(spec.format) / 8) / spec.freq;
+
+    SDL_Log("%-20s: %8.1f MB/s in, %8.1f MB/s out, %8.1fx realtime\n", name,
+            file_len / seconds / (1024.0 * 1024.0), audio_len / seconds / (1024.0 * 1024.0), duration / seconds);
+
+    SDL_FreeWAV(audio);
+    SDL_free(file);
+    return SDL_TRUE;
+}
+
+int
+main(int argc, char *argv[])
+{
+    SDL_bool ok = SDL_TRUE;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    if (SDL_Init(0) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Log("Decoding %d seconds of %d Hz audio\n", INPUT_SECONDS, SAMPLE_RATE);
+    ok &= RunDecodeTest("A-law mono", 0x0006, 1, 1, 8, 0);
+    ok &= RunDecodeTest("mu-law stereo", 0x0007, 2, 2, 8, 0);
+    ok &= RunDecodeTest("MS ADPCM mono", 0x0002, 1, 1024, 4, 2036);
+    ok &= RunDecodeTest("MS ADPCM stereo", 0x0002, 2, 2048, 4, 2036);
+    ok &= RunDecodeTest("IMA ADPCM mono", 0x0011, 1, 1024, 4, 2041);
+    ok &= RunDecodeTest("IMA ADPCM stereo", 0x0011, 2, 2048, 4, 2041);
+
+    SDL_Quit();
+    return ok ? 0 : 1;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */